@@ -0,0 +1,80 @@
+#include "pch.h"
+#include "alloc_counter.h"
+
+#ifdef XR_ENABLE_FRAME_ALLOC_COUNTER
+#include <cstdlib>
+#include <new>
+
+namespace {
+    thread_local std::uint64_t gThreadAllocations = 0;
+
+    inline void* Allocate(const std::size_t size) noexcept {
+        ++gThreadAllocations;
+        return std::malloc(size == 0 ? 1 : size);
+    }
+
+    inline void* AllocateAligned(const std::size_t size, const std::align_val_t align) noexcept {
+        ++gThreadAllocations;
+        const std::size_t alignment = static_cast<std::size_t>(align);
+#ifdef _WIN32
+        return _aligned_malloc(size == 0 ? 1 : size, alignment);
+#else
+        // aligned_alloc requires the size to be a multiple of the alignment.
+        const std::size_t alignedSize = ((size == 0 ? 1 : size) + alignment - 1) & ~(alignment - 1);
+        return std::aligned_alloc(alignment, alignedSize);
+#endif
+    }
+
+    inline void FreeAligned(void* const ptr) noexcept {
+#ifdef _WIN32
+        _aligned_free(ptr);
+#else
+        std::free(ptr);
+#endif
+    }
+}
+
+namespace ALXR {
+std::uint64_t AllocCounter::ThreadAllocations() { return gThreadAllocations; }
+}
+
+void* operator new(std::size_t size) {
+    if (void* const ptr = Allocate(size))
+        return ptr;
+    throw std::bad_alloc();
+}
+void* operator new[](std::size_t size) {
+    if (void* const ptr = Allocate(size))
+        return ptr;
+    throw std::bad_alloc();
+}
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return Allocate(size); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return Allocate(size); }
+
+void* operator new(std::size_t size, std::align_val_t align) {
+    if (void* const ptr = AllocateAligned(size, align))
+        return ptr;
+    throw std::bad_alloc();
+}
+void* operator new[](std::size_t size, std::align_val_t align) {
+    if (void* const ptr = AllocateAligned(size, align))
+        return ptr;
+    throw std::bad_alloc();
+}
+void* operator new(std::size_t size, std::align_val_t align, const std::nothrow_t&) noexcept { return AllocateAligned(size, align); }
+void* operator new[](std::size_t size, std::align_val_t align, const std::nothrow_t&) noexcept { return AllocateAligned(size, align); }
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete[](void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { std::free(ptr); }
+
+void operator delete(void* ptr, std::align_val_t) noexcept { FreeAligned(ptr); }
+void operator delete[](void* ptr, std::align_val_t) noexcept { FreeAligned(ptr); }
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept { FreeAligned(ptr); }
+void operator delete[](void* ptr, std::size_t, std::align_val_t) noexcept { FreeAligned(ptr); }
+void operator delete(void* ptr, std::align_val_t, const std::nothrow_t&) noexcept { FreeAligned(ptr); }
+void operator delete[](void* ptr, std::align_val_t, const std::nothrow_t&) noexcept { FreeAligned(ptr); }
+#endif
@@ -0,0 +1,78 @@
+#pragma once
+#ifndef ALXR_ALLOC_COUNTER_H
+#define ALXR_ALLOC_COUNTER_H
+
+#include <cstdint>
+#include <algorithm>
+
+#include "logger.h"
+
+namespace ALXR {
+
+// Number of heap allocations (operator new) made by the calling thread. Only counted when built with
+// XR_ENABLE_FRAME_ALLOC_COUNTER (cmake -DENABLE_FRAME_ALLOC_COUNTER=ON), which replaces the global
+// operator new/delete, otherwise always 0.
+struct AllocCounter {
+#ifdef XR_ENABLE_FRAME_ALLOC_COUNTER
+    constexpr static const bool Enabled = true;
+    static std::uint64_t ThreadAllocations();
+#else
+    constexpr static const bool Enabled = false;
+    constexpr static inline std::uint64_t ThreadAllocations() { return 0; }
+#endif
+};
+
+// Heap allocations made by the render thread between BeginFrame/EndFrame.
+//
+// The first WarmupFrameCount frames after Rewarm(), called on a render mode or swapchain set change, create
+// swapchain images, pipelines and video textures and may allocate, so may frames which wrote a log message
+// (formatting it allocates). Every other frame is a steady state frame which must not allocate, including the
+// formatting of a message the log level filters out.
+struct FrameAllocStats {
+    constexpr static const std::uint64_t WarmupFrameCount = 90;
+
+    std::uint64_t frameCount            = 0;
+    std::uint64_t allocFrameCount       = 0; // frames with at least one allocation.
+    std::uint64_t allocCount            = 0;
+    std::uint64_t maxFrameAllocCount    = 0;
+    std::uint64_t steadyAllocFrameCount = 0; // steady state frames with at least one allocation.
+
+    inline void Rewarm() { m_warmupFramesLeft = WarmupFrameCount; }
+
+    inline void BeginFrame() {
+        m_frameStart = AllocCounter::ThreadAllocations();
+        m_frameLogWrites = Log::ThreadWriteCount();
+    }
+
+    // Returns the number of allocations made by the frame if it was a steady state frame, otherwise 0.
+    inline std::uint64_t EndFrame() {
+        const std::uint64_t frameAllocs = AllocCounter::ThreadAllocations() - m_frameStart;
+        ++frameCount;
+        if (frameAllocs > 0)
+            ++allocFrameCount;
+        allocCount += frameAllocs;
+        maxFrameAllocCount = std::max(maxFrameAllocCount, frameAllocs);
+
+        const bool isWarmingUp = m_warmupFramesLeft > 0;
+        if (isWarmingUp)
+            --m_warmupFramesLeft;
+        if (frameAllocs == 0 || isWarmingUp || Log::ThreadWriteCount() != m_frameLogWrites)
+            return 0;
+        ++steadyAllocFrameCount;
+        return frameAllocs;
+    }
+
+    // Clears the counts, a warm up in progress carries on.
+    inline void Reset() {
+        const std::uint64_t warmupFramesLeft = m_warmupFramesLeft;
+        *this = {};
+        m_warmupFramesLeft = warmupFramesLeft;
+    }
+
+private:
+    std::uint64_t m_frameStart       = 0;
+    std::uint64_t m_frameLogWrites   = 0;
+    std::uint64_t m_warmupFramesLeft = WarmupFrameCount;
+};
+}
+#endif
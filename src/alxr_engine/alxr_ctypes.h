@@ -159,11 +159,18 @@ typedef struct ALXRClientCtx
     // In the absence of native support, will attempt to simulate a headless session.
     // Caution: May not be compatible with all runtimes and could lead to unexpected behavior.
     bool simulateHeadless;
+    // Headless sessions only: decoded video frames are consumed by a CPU video sink
+    // (frame selection, checksums, foveation remap) instead of not being decoded at all.
+    bool headlessVideoSink;
 
 #ifdef XR_USE_PLATFORM_ANDROID
     void* applicationVM;
     void* applicationActivity;
 #endif
+    // Optional (may be null), inclusive range of video packet counters declared lost. Losses are
+    // reported through videoErrorReportSend either way. Kept last so the layout of the members
+    // above is unchanged for callers built without it.
+    void (*packetLossReportSend)(uint32_t fromPacketCounter, uint32_t toPacketCounter);
 } ALXRClientCtx;
 
 struct ALXRGuardianData {
@@ -192,6 +199,7 @@ struct ALXRDecoderConfig
     uint32_t      cpuThreadCount; // only used for software decoding.
     bool          enableFEC;
     bool          realtimePriority;
+    uint32_t      jitterBufferMaxDelayUs; // 0 disables the video jitter buffer.
 };
 
 struct ALXRStreamConfig {
@@ -201,6 +209,91 @@ struct ALXRStreamConfig {
     bool              clientPrediction;
 };
 
+// Latency distribution of a single pipeline stage over the last rolling window, values in microseconds.
+struct ALXRLatencyPercentiles {
+    uint64_t count;
+    uint64_t p50;
+    uint64_t p90;
+    uint64_t p99;
+    uint64_t p999;
+    uint64_t max;
+};
+
+struct ALXRLatencyStats {
+    ALXRLatencyPercentiles transport;  // estimated server send -> last video packet received.
+    ALXRLatencyPercentiles decode;     // decoder input -> decoder output.
+    ALXRLatencyPercentiles upload;     // decoded frame copy into a video texture.
+    ALXRLatencyPercentiles renderWait; // decoder output -> first rendered.
+    ALXRLatencyPercentiles total;      // tracking sampled -> first rendered.
+    uint64_t windowDurationUs;
+};
+
+// Video frame accounting since the stream started, see alxr_get_frame_accounting_stats.
+struct ALXRFrameAccountingStats {
+    uint64_t displayFrames;  // display frames rendered while streaming.
+    uint64_t newFrames;      // display frames showing a video frame for the first time.
+    uint64_t repeatedFrames; // display frames showing the same video frame as the previous one.
+    uint64_t lateFrames;     // new frames shown more than half a display period after the display time they were rendered for.
+    uint64_t noFrames;       // display frames without any video frame to show.
+    uint64_t decodedFrames;
+    uint64_t skippedFrames;  // decoded frames never displayed, a newer frame was shown first.
+    uint64_t maxRepeatRun;   // longest run of display frames showing the same video frame.
+    ALXRLatencyPercentiles staleness; // display time - video frame display time of displayed frames, last rolling window.
+};
+
+// How the views each video frame was drawn with were found, see alxr_get_pose_history_stats.
+struct ALXRPoseHistoryStats {
+    uint64_t lookups;      // video frames drawn while streaming.
+    uint64_t exact;        // drawn with the views located for the frame's tracking frame index.
+    uint64_t interpolated; // drawn with views interpolated between the neighbouring tracking frames.
+    uint64_t nearest;      // drawn with the nearest tracking frame's views, the neighbours were too far apart.
+    uint64_t newest;       // frame index newer than any tracking frame, drawn with the newest views.
+    uint64_t expired;      // frame index older than any kept tracking frame, drawn with the oldest views.
+    uint64_t misses;       // no tracking frame located yet, drawn with the views for the display time.
+};
+
+// Heap allocations made by the render loop, see alxr_get_frame_alloc_stats. Only counted by engines built with
+// ENABLE_FRAME_ALLOC_COUNTER, the counts restart each time they are logged (every few thousand frames).
+struct ALXRFrameAllocStats {
+    uint64_t frameCount;
+    uint64_t allocFrameCount;       // frames with at least one allocation.
+    uint64_t allocCount;
+    uint64_t maxFrameAllocCount;
+    uint64_t steadyAllocFrameCount; // frames past the warm up, without a log message written, which allocated.
+};
+
+// Server - client clock offset estimated from the time sync round trips, see alxr_get_clock_sync_stats.
+struct ALXRClockSyncStats {
+    int64_t  offsetUs;      // server clock - client clock, now.
+    double   driftPpm;      // rate at which the offset changes.
+    uint64_t minRttUs;      // smallest time sync round trip in the sample window.
+    uint64_t uncertaintyUs; // half the min RTT plus the fit's residual deviation.
+    float    confidence;    // 0 (no/poor samples) .. 1 (full window, tight fit).
+    uint32_t sampleCount;   // sample intervals used by the current fit.
+    uint32_t rejectedCount; // sample intervals rejected as RTT or offset outliers.
+};
+
+// Gaze driven foveation, see alxr_set_foveation_gaze_options.
+struct ALXRFoveationGazeOptions {
+    float minCutoff;           // one-euro filter minimum cutoff frequency, Hz.
+    float beta;                // one-euro filter speed coefficient.
+    float derivativeCutoff;    // cutoff frequency of the center shift velocity, Hz.
+    float latencyCompensation; // seconds the center shift is extrapolated ahead, e.g. the motion-to-photon latency.
+    float deadband;            // minimum change of the normalized center shift before a new one is published.
+    float maxCenterShift;      // normalized center shift limit, at most 0.9.
+    bool  enabled;
+    // Apply the gaze driven center shift to the local foveated decode directly, only valid
+    // when the server encodes with the same center shift (the one read with alxr_get_foveation_gaze).
+    bool  applyToDecode;
+};
+
+struct ALXRFoveationGaze {
+    uint64_t timestamp; // XrTime of the gaze sample the center shift was made from.
+    float    centerShiftX;
+    float    centerShiftY;
+    bool     isValid;   // false when following the configured center shift.
+};
+
 enum ALXRLogOptions : uint32_t {
     ALXR_LOG_OPTION_NONE = 0,
     ALXR_LOG_OPTION_TIMESTAMP = (1u << 0),
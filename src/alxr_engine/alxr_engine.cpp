@@ -14,6 +14,7 @@
 
 #include <cassert>
 #include <cstdint>
+#include <cstdlib>
 #include <type_traits>
 #include <memory>
 #include <mutex>
@@ -24,6 +25,8 @@
 #include "timing.h"
 #include "interaction_manager.h"
 #include "latency_manager.h"
+#include "latency_stats.h"
+#include "frame_accounting.h"
 #include "decoder_thread.h"
 #include "foveation.h"
 #include "input_thread.h"
@@ -98,7 +101,8 @@ bool alxr_init(const ALXRClientCtx* rCtx, /*[out]*/ ALXRSystemProperties* system
         LatencyManager::Instance().Init(LatencyManager::CallbackCtx {
             .sendFn = ctx.inputSend,
             .timeSyncSendFn = ctx.timeSyncSend,
-            .videoErrorReportSendFn = ctx.videoErrorReportSend
+            .videoErrorReportSendFn = ctx.videoErrorReportSend,
+            .packetLossReportSendFn = ctx.packetLossReportSend
         });
 
         const auto options = std::make_shared<Options>();
@@ -120,11 +124,15 @@ bool alxr_init(const ALXRClientCtx* rCtx, /*[out]*/ ALXRSystemProperties* system
         options->firmwareVersion = { fmVersion.major, fmVersion.minor, fmVersion.patch };
         options->TrackingServerPortNo = static_cast<std::uint16_t>(ctx.trackingServerPortNo);
         options->SimulateHeadless = ctx.simulateHeadless;
+        options->HeadlessVideoSink = ctx.headlessVideoSink;
+        // Only used by offline decode quality runs, set from the environment rather than ALXRClientCtx.
+        if (const char* const referenceFile = std::getenv("ALXR_VIDEO_SINK_REFERENCE_FILE"))
+            options->VideoSinkReferenceFile = referenceFile;
         options->PassthroughMode = ctx.passthroughMode;
         if (options->GraphicsPlugin.empty())
             options->GraphicsPlugin = graphics_api_str(ctx.graphicsApi);
         if (options->EnableHeadless())
-            options->GraphicsPlugin = "Headless";
+            options->GraphicsPlugin = options->HeadlessVideoSink ? "CpuSink" : "Headless";
 
         const auto platformData = std::make_shared<PlatformData>();
 #ifdef XR_USE_PLATFORM_ANDROID
@@ -292,7 +300,8 @@ void alxr_set_stream_config(const ALXRStreamConfig config)
     }
 
 #ifndef XR_DISABLE_DECODER_THREAD
-    if (!programPtr->IsHeadlessSession()) {
+    const auto graphicsPtr = programPtr->GetGraphicsPlugin();
+    if (!programPtr->IsHeadlessSession() || (graphicsPtr && graphicsPtr->IsHeadlessVideoSink())) {
         Log::Write(Log::Level::Info, "Starting decoder thread.");
 
         const XrDecoderThread::StartCtx startCtx{
@@ -434,3 +443,70 @@ void alxr_set_log_custom_output(ALXRLogOptions options, ALXRLogOutputFn outputFn
         reinterpret_cast<Log::OutputFn>(outputFn)
     );
 }
+
+bool alxr_get_latency_stats(ALXRLatencyStats* stats) {
+    if (stats == nullptr)
+        return false;
+    ALXR::LatencyStats::Instance().GetStats(*stats);
+    return true;
+}
+
+bool alxr_get_frame_accounting_stats(ALXRFrameAccountingStats* stats) {
+    if (stats == nullptr)
+        return false;
+    ALXR::FrameAccounting::Instance().GetStats(*stats);
+    return true;
+}
+
+bool alxr_get_pose_history_stats(ALXRPoseHistoryStats* stats) {
+    if (stats == nullptr)
+        return false;
+    if (const auto programPtr = gProgram)
+        return programPtr->GetPoseHistoryStats(*stats);
+    return false;
+}
+
+bool alxr_get_frame_alloc_stats(const bool videoStream, ALXRFrameAllocStats* stats) {
+    if (stats == nullptr)
+        return false;
+    if (const auto programPtr = gProgram) {
+        // written by RenderFrame.
+        std::scoped_lock lk(gRenderMutex);
+        return programPtr->GetFrameAllocStats(videoStream ? IOpenXrProgram::RenderMode::VideoStream : IOpenXrProgram::RenderMode::Lobby, *stats);
+    }
+    return false;
+}
+
+bool alxr_get_clock_sync_stats(ALXRClockSyncStats* stats) {
+    if (stats == nullptr)
+        return false;
+    const ALXR::ClockSyncEstimate estimate = LatencyManager::Instance().GetClockSyncEstimate();
+    *stats = {
+        .offsetUs      = estimate.offsetUs,
+        .driftPpm      = estimate.driftPpm,
+        .minRttUs      = estimate.minRttUs,
+        .uncertaintyUs = estimate.uncertaintyUs,
+        .confidence    = estimate.confidence,
+        .sampleCount   = estimate.sampleCount,
+        .rejectedCount = estimate.rejectedCount,
+    };
+    return true;
+}
+
+void alxr_set_foveation_gaze_options(const ALXRFoveationGazeOptions options) {
+    if (const auto programPtr = gProgram)
+        programPtr->SetFoveationGazeOptions(options);
+}
+
+bool alxr_get_foveation_gaze(ALXRFoveationGaze* gaze) {
+    if (gaze == nullptr)
+        return false;
+    if (const auto programPtr = gProgram)
+        return programPtr->GetFoveationGaze(*gaze);
+    return false;
+}
+
+void alxr_set_foveation_center_shift(float centerShiftX, float centerShiftY) {
+    if (const auto programPtr = gProgram)
+        programPtr->SetFoveationCenterShift({ centerShiftX, centerShiftY });
+}
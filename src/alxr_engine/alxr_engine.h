@@ -37,6 +37,20 @@ DLLEXPORT void alxr_on_time_sync(const TimeSync* packet);
 
 DLLEXPORT void alxr_set_log_custom_output(ALXRLogOptions options, ALXRLogOutputFn outputFn);
 
+DLLEXPORT bool alxr_get_latency_stats(ALXRLatencyStats* stats);
+DLLEXPORT bool alxr_get_frame_accounting_stats(ALXRFrameAccountingStats* stats);
+DLLEXPORT bool alxr_get_pose_history_stats(ALXRPoseHistoryStats* stats);
+DLLEXPORT bool alxr_get_clock_sync_stats(ALXRClockSyncStats* stats);
+// false if the engine was not built with ENABLE_FRAME_ALLOC_COUNTER.
+DLLEXPORT bool alxr_get_frame_alloc_stats(bool videoStream, ALXRFrameAllocStats* stats);
+
+DLLEXPORT void alxr_set_foveation_gaze_options(const ALXRFoveationGazeOptions options);
+DLLEXPORT bool alxr_get_foveation_gaze(ALXRFoveationGaze* gaze);
+// Sets the foveation center shift used for decoding from the next rendered frame on, without rebuilding
+// the video pipelines. Use when the server switches to a new center shift, e.g. one read with
+// alxr_get_foveation_gaze.
+DLLEXPORT void alxr_set_foveation_center_shift(float centerShiftX, float centerShiftY);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,218 @@
+#include "pch.h"
+#include "clock_sync_estimator.h"
+#include <mutex>
+
+namespace ALXR {
+
+void ClockSyncEstimator::AddSample(const std::uint64_t clientSendUs, const std::uint64_t serverTimeUs, const std::uint64_t clientRecvUs)
+{
+    if (m_resetRequested.exchange(false, std::memory_order_acq_rel)) {
+        m_sampleCount = 0;
+        m_nextSample = 0;
+        m_bucketOpen = false;
+    }
+    if (clientRecvUs < clientSendUs)
+        return;
+    const std::uint64_t rtt = clientRecvUs - clientSendUs;
+    const Sample sample {
+        .clientTimeUs = clientRecvUs,
+        .rttUs = rtt,
+        .offsetUs = (static_cast<std::int64_t>(serverTimeUs) + static_cast<std::int64_t>(rtt / 2)) - static_cast<std::int64_t>(clientRecvUs),
+    };
+
+    if (m_bucketOpen && clientRecvUs >= m_bucketStartUs + BucketDurationUs) {
+        m_samples[m_nextSample] = m_bucketBest;
+        m_nextSample = (m_nextSample + 1) % m_samples.size();
+        m_sampleCount = std::min(m_sampleCount + 1, m_samples.size());
+        m_bucketOpen = false;
+    }
+    if (!m_bucketOpen) {
+        m_bucketBest = sample;
+        m_bucketStartUs = clientRecvUs;
+        m_bucketOpen = true;
+    } else if (sample.rttUs <= m_bucketBest.rttUs) {
+        m_bucketBest = sample;
+    }
+
+    const Fit newFit = ComputeFit();
+    std::unique_lock lock(m_fitMutex);
+    // a reset requested meanwhile also drops this fit, it was made from the old window.
+    if (!m_resetRequested.load(std::memory_order_acquire))
+        m_fit = newFit;
+}
+
+namespace {
+struct LinearFit {
+    double offset; // at baseTime
+    double slope;
+};
+
+template < typename SampleT >
+inline LinearFit FitLine(const SampleT* samples, const std::size_t count, const std::uint64_t baseTimeUs, const bool fitSlope)
+{
+    const auto timeOf = [baseTimeUs](const SampleT& s) {
+        return static_cast<double>(static_cast<std::int64_t>(s.clientTimeUs - baseTimeUs));
+    };
+    double meanT = 0.0, meanO = 0.0;
+    for (std::size_t idx = 0; idx < count; ++idx) {
+        meanT += timeOf(samples[idx]);
+        meanO += static_cast<double>(samples[idx].offsetUs);
+    }
+    meanT /= count;
+    meanO /= count;
+    if (!fitSlope)
+        return { meanO, 0.0 };
+
+    double covTO = 0.0, varT = 0.0;
+    for (std::size_t idx = 0; idx < count; ++idx) {
+        const double dt = timeOf(samples[idx]) - meanT;
+        covTO += dt * (static_cast<double>(samples[idx].offsetUs) - meanO);
+        varT  += dt * dt;
+    }
+    constexpr const double MaxSlope = ClockSyncEstimator::MaxDriftPpm * 1e-6;
+    const double slope = varT > 0.0 ? std::clamp(covTO / varT, -MaxSlope, MaxSlope) : 0.0;
+    return { meanO - slope * meanT, slope };
+}
+
+// Theil-Sen line: the median of the pairwise slopes, then the median offset along it. Unlike least squares
+// it is not dragged by a few outliers, e.g. a spike in the newest sample, so it is used to find them.
+template < std::size_t MaxCount, typename SampleT >
+inline LinearFit FitLineMedian(const SampleT* samples, const std::size_t count, const std::uint64_t baseTimeUs, const bool fitSlope)
+{
+    const auto timeOf = [baseTimeUs](const SampleT& s) {
+        return static_cast<double>(static_cast<std::int64_t>(s.clientTimeUs - baseTimeUs));
+    };
+    const auto median = [](auto begin, const std::size_t n) {
+        const auto mid = begin + n / 2;
+        std::nth_element(begin, mid, begin + n);
+        return *mid;
+    };
+    constexpr const double MaxSlope = ClockSyncEstimator::MaxDriftPpm * 1e-6;
+    double slope = 0.0;
+    if (fitSlope) {
+        std::array<double, MaxCount * (MaxCount - 1) / 2> slopes;
+        std::size_t slopeCount = 0;
+        for (std::size_t i = 0; i < count; ++i) {
+            for (std::size_t j = i + 1; j < count; ++j) {
+                const double dt = timeOf(samples[j]) - timeOf(samples[i]);
+                if (dt != 0.0)
+                    slopes[slopeCount++] = static_cast<double>(samples[j].offsetUs - samples[i].offsetUs) / dt;
+            }
+        }
+        if (slopeCount > 0)
+            slope = std::clamp(median(slopes.begin(), slopeCount), -MaxSlope, MaxSlope);
+    }
+    std::array<double, MaxCount> offsets;
+    for (std::size_t idx = 0; idx < count; ++idx)
+        offsets[idx] = static_cast<double>(samples[idx].offsetUs) - slope * timeOf(samples[idx]);
+    return { median(offsets.begin(), count), slope };
+}
+}
+
+ClockSyncEstimator::Fit ClockSyncEstimator::ComputeFit() const
+{
+    Fit fit{};
+    if (!m_bucketOpen)
+        return fit;
+
+    std::array<Sample, WindowSize> candidates;
+    std::size_t candidateCount = 0;
+    const std::size_t totalCount = m_sampleCount + 1;
+    const auto sampleAt = [this](const std::size_t idx) -> const Sample& {
+        return idx < m_sampleCount ? m_samples[idx] : m_bucketBest;
+    };
+
+    // 1. min-RTT filter: intervals which only saw samples with noticeably longer queueing carry a biased offset.
+    fit.minRttUs = std::uint64_t(-1);
+    for (std::size_t idx = 0; idx < totalCount; ++idx)
+        fit.minRttUs = std::min(fit.minRttUs, sampleAt(idx).rttUs);
+    const std::uint64_t maxRtt = fit.minRttUs + std::max(fit.minRttUs / 2, RttSlackUs);
+    std::uint64_t minTime = std::uint64_t(-1), maxTime = 0;
+    for (std::size_t idx = 0; idx < totalCount; ++idx) {
+        const Sample& sample = sampleAt(idx);
+        if (sample.rttUs > maxRtt)
+            continue;
+        candidates[candidateCount++] = sample;
+        minTime = std::min(minTime, sample.clientTimeUs);
+        maxTime = std::max(maxTime, sample.clientTimeUs);
+    }
+    fit.baseTimeUs = maxTime;
+
+    // 2. offset outliers by median absolute deviation from a robust first pass fit.
+    const bool fitSlope = candidateCount >= MinDriftSamples && (maxTime - minTime) >= MinDriftSpanUs;
+    const LinearFit firstPass = FitLineMedian<WindowSize>(candidates.data(), candidateCount, maxTime, fitSlope);
+    const auto residualOf = [&](const Sample& sample, const LinearFit& line) {
+        const double dt = static_cast<double>(static_cast<std::int64_t>(sample.clientTimeUs - maxTime));
+        return static_cast<double>(sample.offsetUs) - (line.offset + line.slope * dt);
+    };
+    std::array<double, WindowSize> deviations;
+    for (std::size_t idx = 0; idx < candidateCount; ++idx)
+        deviations[idx] = std::abs(residualOf(candidates[idx], firstPass));
+    const auto mid = deviations.begin() + candidateCount / 2;
+    std::nth_element(deviations.begin(), mid, deviations.begin() + candidateCount);
+    // floor the threshold, a perfectly stable trace would otherwise reject its own jitter.
+    const double maxDeviation = std::max(3.0 * 1.4826 * (*mid), static_cast<double>(RttSlackUs) / 2.0);
+    std::size_t acceptedCount = 0;
+    for (std::size_t idx = 0; idx < candidateCount; ++idx) {
+        if (std::abs(residualOf(candidates[idx], firstPass)) <= maxDeviation)
+            candidates[acceptedCount++] = candidates[idx];
+    }
+    fit.sampleCount   = static_cast<std::uint32_t>(acceptedCount);
+    fit.rejectedCount = static_cast<std::uint32_t>(totalCount - acceptedCount);
+
+    // 3. least squares offset = a + b * (t - t0), relative to the newest candidate.
+    const LinearFit line = FitLine(candidates.data(), acceptedCount, maxTime, fitSlope);
+    fit.baseOffsetUs = line.offset;
+    fit.slope = line.slope;
+
+    double sumSq = 0.0;
+    for (std::size_t idx = 0; idx < acceptedCount; ++idx) {
+        const double residual = residualOf(candidates[idx], line);
+        sumSq += residual * residual;
+    }
+    fit.residualUs = std::sqrt(sumSq / acceptedCount);
+    return fit;
+}
+
+std::int64_t ClockSyncEstimator::OffsetAt(const std::uint64_t clientTimeUs) const
+{
+    std::shared_lock lock(m_fitMutex);
+    if (m_fit.sampleCount == 0)
+        return 0;
+    const double dt = static_cast<double>(static_cast<std::int64_t>(clientTimeUs - m_fit.baseTimeUs));
+    return static_cast<std::int64_t>(std::llround(m_fit.baseOffsetUs + m_fit.slope * dt));
+}
+
+ClockSyncEstimate ClockSyncEstimator::GetEstimate(const std::uint64_t clientTimeUs) const
+{
+    Fit fit;
+    {
+        std::shared_lock lock(m_fitMutex);
+        fit = m_fit;
+    }
+    if (fit.sampleCount == 0)
+        return ClockSyncEstimate{};
+
+    const double dt = static_cast<double>(static_cast<std::int64_t>(clientTimeUs - fit.baseTimeUs));
+    const double uncertainty = static_cast<double>(fit.minRttUs) / 2.0 + fit.residualUs;
+    // fill factor of the window times a term which halves at 1ms of uncertainty.
+    const double fillFactor = static_cast<double>(fit.sampleCount) / WindowSize;
+    const double confidence = fillFactor / (1.0 + uncertainty / 1000.0);
+    return {
+        .offsetUs      = static_cast<std::int64_t>(std::llround(fit.baseOffsetUs + fit.slope * dt)),
+        .driftPpm      = fit.slope * 1e6,
+        .minRttUs      = fit.minRttUs,
+        .uncertaintyUs = static_cast<std::uint64_t>(uncertainty),
+        .confidence    = static_cast<float>(confidence),
+        .sampleCount   = fit.sampleCount,
+        .rejectedCount = fit.rejectedCount,
+    };
+}
+
+void ClockSyncEstimator::Reset()
+{
+    std::unique_lock lock(m_fitMutex);
+    m_resetRequested.store(true, std::memory_order_release);
+    m_fit = {};
+}
+}
@@ -0,0 +1,78 @@
+#pragma once
+#ifndef ALXR_CLOCK_SYNC_ESTIMATOR_H
+#define ALXR_CLOCK_SYNC_ESTIMATOR_H
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+#include <atomic>
+#include <shared_mutex>
+
+namespace ALXR {
+
+struct ClockSyncEstimate {
+    std::int64_t  offsetUs;      // server clock - client clock, at the requested client time.
+    double        driftPpm;      // rate at which the offset changes.
+    std::uint64_t minRttUs;      // smallest round trip in the sample window.
+    std::uint64_t uncertaintyUs; // half the min RTT plus the fit's residual deviation.
+    float         confidence;    // 0 (no/poor samples) .. 1 (full window, tight fit).
+    std::uint32_t sampleCount;   // intervals used by the current fit.
+    std::uint32_t rejectedCount; // intervals rejected as RTT or offset outliers by the current fit.
+};
+
+// NTP style server/client clock offset estimator fed by time sync round trips:
+//  * keeps the minimum RTT (least queueing delay) sample of each BucketDurationUs interval,
+//    for a window of the most recent WindowSize intervals,
+//  * only trusts intervals whose RTT is close to the window's minimum,
+//  * rejects offset outliers by median absolute deviation of their residuals from a Theil-Sen line,
+//  * fits offset = a + b * t by least squares to follow clock drift between syncs.
+// AddSample is expected to be called from a single thread, queries and Reset are thread-safe; the
+// sample window is only cleared by the next AddSample call.
+struct ClockSyncEstimator {
+    constexpr static const std::size_t   WindowSize       = 32;
+    constexpr static const std::uint64_t BucketDurationUs = 1'000'000;
+    constexpr static const std::size_t   MinDriftSamples  = 6;
+    constexpr static const std::uint64_t MinDriftSpanUs   = 5'000'000;
+    constexpr static const std::uint64_t RttSlackUs       = 1'000;
+    constexpr static const double        MaxDriftPpm      = 500.0;
+
+    // clientSendUs: client time the request was sent (echoed back by the server),
+    // serverTimeUs: server time the response was sent, clientRecvUs: client time the response arrived.
+    void AddSample(const std::uint64_t clientSendUs, const std::uint64_t serverTimeUs, const std::uint64_t clientRecvUs);
+
+    std::int64_t OffsetAt(const std::uint64_t clientTimeUs) const;
+    ClockSyncEstimate GetEstimate(const std::uint64_t clientTimeUs) const;
+
+    void Reset();
+
+private:
+    struct Sample {
+        std::uint64_t clientTimeUs;
+        std::uint64_t rttUs;
+        std::int64_t  offsetUs;
+    };
+    struct Fit {
+        std::uint64_t baseTimeUs = 0;
+        double        baseOffsetUs = 0.0;
+        double        slope = 0.0; // us per us
+        std::uint64_t minRttUs = 0;
+        double        residualUs = 0.0;
+        std::uint32_t sampleCount = 0;
+        std::uint32_t rejectedCount = 0;
+    };
+    Fit ComputeFit() const;
+
+    // closed intervals, plus the (provisional) best sample of the current one.
+    std::array<Sample, WindowSize - 1> m_samples{};
+    std::size_t m_sampleCount = 0;
+    std::size_t m_nextSample = 0;
+    Sample m_bucketBest{};
+    std::uint64_t m_bucketStartUs = 0;
+    bool m_bucketOpen = false;
+    std::atomic<bool> m_resetRequested{ false };
+
+    mutable std::shared_mutex m_fitMutex{};
+    Fit m_fit{};
+};
+}
+#endif
@@ -12,6 +12,9 @@
 #include <memory>
 #include <stdarg.h>
 #include <stddef.h>
+#if defined(__linux__)
+#include <sys/prctl.h>
+#endif
 
 #include <openxr/openxr_reflection.h>
 
@@ -101,5 +104,26 @@ constexpr inline size_t ArraySizeOf(const std::array<T,Size>&) noexcept {
     return sizeof(T) * Size;
 }
 
+// Names the calling thread for debuggers and profilers (e.g. the XR_APILAYER_ALXR_profiler layer, which
+// uses it to tell render, input and decoder threads apart), names longer than 15 chars are truncated on linux.
+inline void SetCurrentThreadName(const char* name) {
+#if defined(__linux__)
+    prctl(PR_SET_NAME, name, 0, 0, 0);
+#elif defined(XR_USE_PLATFORM_WIN32)
+    // SetThreadDescription is only available from Windows 10 1607.
+    using PFN_SetThreadDescription = HRESULT(WINAPI*)(HANDLE, PCWSTR);
+    static const auto setThreadDescription = reinterpret_cast<PFN_SetThreadDescription>(
+        reinterpret_cast<void(*)()>(GetProcAddress(GetModuleHandleW(L"kernel32.dll"), "SetThreadDescription")));
+    if (setThreadDescription == nullptr)
+        return;
+    std::wstring wideName;
+    for (const char* c = name; *c != '\0'; ++c)
+        wideName += static_cast<wchar_t>(*c);
+    setThreadDescription(GetCurrentThread(), wideName.c_str());
+#else
+    (void)name;
+#endif
+}
+
 #include "logger.h"
 #include "check.h"
@@ -1,4 +1,6 @@
+#include "pch.h"
 #include "decoder_thread.h"
+#include "common.h"
 #include "logger.h"
 #include "decoderplugin.h"
 #include "latency_manager.h"
@@ -10,17 +12,25 @@ bool XrDecoderThread::QueuePacket(const VideoFrame& header, const XrDecoderThrea
 		return false;
 	LatencyManager::Instance().OnPreVideoPacketRecieved(header);
 
+	const auto jitterBuffer = m_jitterBuffer;
+	const auto queueFrame = [&](const VideoPacket& framePacket) {
+		if (jitterBuffer)
+			jitterBuffer->Push(framePacket, header.trackingFrameIndex, header.sentTime);
+		else
+			decoderPlugin->QueuePacket(framePacket, header.trackingFrameIndex);
+	};
+
 	bool fecFailure = false, isComplete = true;
 	if (const auto fecQueue = m_fecQueue) {
 		fecQueue->addVideoPacket(header, packet, fecFailure);
 		if (isComplete = fecQueue->reconstruct()) {
 			const size_t frameBufferSize = fecQueue->getFrameByteSize();
 			const auto frameBufferPtr = reinterpret_cast<const std::uint8_t*>(fecQueue->getFrameBuffer());
-			decoderPlugin->QueuePacket({ frameBufferPtr, frameBufferSize }, header.trackingFrameIndex);
+			queueFrame({ frameBufferPtr, frameBufferSize });
 			fecQueue->clearFecFailure();
 		}
 	} else { // then FEC is disabled
-		decoderPlugin->QueuePacket(packet, header.trackingFrameIndex);
+		queueFrame(packet);
 	}
 
 	LatencyManager::Instance().OnPostVideoPacketRecieved(header, { isComplete, fecFailure });
@@ -43,6 +53,7 @@ void XrDecoderThread::Stop()
 		Log::Write(Log::Level::Info, "Waiting for decoder thread to shutdown...");
 		m_decoderThread.join();
 	}
+	m_jitterBuffer.reset();
 	m_fecQueue.reset();
 
 	Log::Write(Log::Level::Info, "m_decoderPlugin destroying");
@@ -91,6 +102,14 @@ void XrDecoderThread::Start(const XrDecoderThread::StartCtx& ctx)
 	m_decoderPlugin = CreateDecoderPlugin(runCtx);
 	LatencyManager::Instance().ResetAll();
 
+	if (ctx.decoderConfig.jitterBufferMaxDelayUs > 0 && m_decoderPlugin) {
+		Log::Write(Log::Level::Info, Fmt("Video jitter buffer enabled, max playout delay: %uus", ctx.decoderConfig.jitterBufferMaxDelayUs));
+		m_jitterBuffer = std::make_shared<VideoJitterBuffer>(ctx.decoderConfig.jitterBufferMaxDelayUs,
+			[decoderPlugin = m_decoderPlugin](const VideoJitterBuffer::PacketType& packet, const std::uint64_t trackingFrameIndex) {
+				decoderPlugin->QueuePacket(packet, trackingFrameIndex);
+			});
+	}
+
 	if (const auto clientCtx = ctx.clientCtx) {
 		Log::Write(Log::Level::Verbose, "Sending IDR request");
 		clientCtx->setWaitingNextIDR(true);
@@ -103,6 +122,7 @@ void XrDecoderThread::Start(const XrDecoderThread::StartCtx& ctx)
 	{
 		[this]()
 		{
+			SetCurrentThreadName("alxr-decoder");
 			m_decoderPlugin->Run(m_isRuningToken);
 			Log::Write(Log::Level::Info, "Decoder thread exiting.");
 		}
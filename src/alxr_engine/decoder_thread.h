@@ -9,6 +9,7 @@
 #include "alxr_ctypes.h"
 #include "ALVR-common/packet_types.h"
 #include "fec.h"
+#include "video_jitter_buffer.h"
 
 struct IDecoderPlugin;
 struct IOpenXrProgram;
@@ -16,10 +17,12 @@ struct IOpenXrProgram;
 class XrDecoderThread {
 	using DecoderPluginPtr = std::shared_ptr<IDecoderPlugin>;
 	using FECQueuePtr = std::shared_ptr<FECQueue>;
+	using JitterBufferPtr = std::shared_ptr<VideoJitterBuffer>;
 	using CodecType = std::atomic<ALVR_CODEC>;
 
 	DecoderPluginPtr  m_decoderPlugin{ nullptr };
 	FECQueuePtr		  m_fecQueue{ nullptr };
+	JitterBufferPtr	  m_jitterBuffer{ nullptr };
 	std::atomic<bool> m_isRuningToken{ false };
 	std::thread		  m_decoderThread;
 
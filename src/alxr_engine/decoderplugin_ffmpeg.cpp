@@ -440,14 +440,17 @@ struct FFMPEGDecoderPlugin final : public IDecoderPlugin {
             pkt->pts = duration_cast<microseconds64>(ClockType::now().time_since_epoch()).count();
 
             LatencyCollector::Instance().decoderInput(nalPacket.frameIndex);
+            ALXR::LatencyStats::Instance().DecoderInput(nalPacket.frameIndex);
             const auto result = decode_packet(pkt.get(), codecCtx.get(), hwFrame.get());
             LatencyCollector::Instance().decoderOutput(nalPacket.frameIndex);
+            ALXR::LatencyStats::Instance().DecoderOutput(nalPacket.frameIndex);
             //av_packet_unref(pkt.get());
             if (result < 0)
             {
                 LogLibAV(Log::Level::Warning, result, "Failed to decode packet");
                 continue;
             }
+            ALXR::FrameAccounting::Instance().Decoded(nalPacket.frameIndex);
 
             const auto& avFrame = [&/*, isBTS = isBufferInteropSupported*/]() -> const AVFramePtr& {
                 if (isBufferInteropSupported || type == AV_HWDEVICE_TYPE_NONE)
@@ -498,7 +501,10 @@ struct FFMPEGDecoderPlugin final : public IDecoderPlugin {
                     .height = uvHeight
                 };
             }
-            std::invoke(UpdateVideoTextures, graphicsPluginPtr, buffer);
+            const auto uploadTimeMs = time_call_ms<true>([&]() {
+                std::invoke(UpdateVideoTextures, graphicsPluginPtr, buffer);
+            });
+            ALXR::LatencyStats::Instance().Upload(static_cast<std::uint64_t>(uploadTimeMs * 1000.0f));
         }
         return true;
     }
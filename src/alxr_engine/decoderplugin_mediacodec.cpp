@@ -212,7 +212,10 @@ struct XrImageListener final
                 },
                 .frameIndex = frameIndex
             };
-            graphicsPluginPtr->UpdateVideoTextureMediaCodec(buf);
+            const auto uploadTimeMs = time_call_ms<true>([&]() {
+                graphicsPluginPtr->UpdateVideoTextureMediaCodec(buf);
+            });
+            ALXR::LatencyStats::Instance().Upload(static_cast<std::uint64_t>(uploadTimeMs * 1000.0f));
         }
     }
 
@@ -311,6 +314,7 @@ struct MediaCodecDecoderPlugin final : IDecoderPlugin
         const bool is_config_packet = is_config(packet_data, selectedCodec);
         if (!is_config_packet) {
             LatencyCollector::Instance().decoderInput(trackingFrameIndex);
+            ALXR::LatencyStats::Instance().DecoderInput(trackingFrameIndex);
         }
 
         const auto bufferId = static_cast<std::size_t>(inputBufferId);
@@ -535,6 +539,8 @@ struct MediaCodecDecoderPlugin final : IDecoderPlugin
             const auto frameIndex = codecCtx->imgListener.frameIndexMap.get(ptsUs);
             if (frameIndex != FrameIndexMap::NullIndex) {
                 LatencyCollector::Instance().decoderOutput(frameIndex);
+                ALXR::LatencyStats::Instance().DecoderOutput(frameIndex);
+                ALXR::FrameAccounting::Instance().Decoded(frameIndex);
             }
             AMediaCodec_releaseOutputBuffer(codecCtx->codec.get(), buffInfo.bufferId, true);
         }
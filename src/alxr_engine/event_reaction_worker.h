@@ -0,0 +1,121 @@
+#pragma once
+#ifndef ALXR_EVENT_REACTION_WORKER_H
+#define ALXR_EVENT_REACTION_WORKER_H
+
+#include <cstdint>
+#include <cstddef>
+#include <chrono>
+#include <deque>
+#include <future>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <functional>
+#include <utility>
+
+#include "common.h"
+#include "logger.h"
+#include "timing.h"
+
+namespace ALXR {
+
+// A single worker thread which runs the expensive reactions to OpenXR and stream config events, e.g.
+// creating reference spaces, requesting display refresh rates or querying the guardian bounds, off the
+// frame loop.
+//
+// The work of a reaction runs on the worker and returns a function applying its result, the render thread
+// runs those from ApplyCompleted at the next frame boundary so state used by the frame loop only ever
+// changes between frames. Reactions are worked on and applied in submission order, anything the work
+// threw is rethrown by ApplyCompleted on the render thread.
+class EventReactionWorker final {
+public:
+    using ApplyFn = std::function<void()>;
+    using WorkFn  = std::function<ApplyFn()>;
+
+    EventReactionWorker() = default;
+    ~EventReactionWorker() { Stop(); }
+
+    EventReactionWorker(const EventReactionWorker&) = delete;
+    EventReactionWorker& operator=(const EventReactionWorker&) = delete;
+    EventReactionWorker(EventReactionWorker&&) = delete;
+    EventReactionWorker& operator=(EventReactionWorker&&) = delete;
+
+    // Render thread only.
+    void Submit(const char* const reactionName, WorkFn&& workFn) {
+        std::packaged_task<ApplyFn()> task([reactionName, workFn = std::move(workFn)]() {
+            ApplyFn applyFn;
+            const float workTimeMs = time_call_ms<true>([&]() { applyFn = workFn(); });
+            Log::Write(Log::Level::Verbose, Fmt("Event reaction %s took %.3f ms", reactionName, workTimeMs));
+            return applyFn;
+        });
+        m_pending.push_back(task.get_future());
+        {
+            std::scoped_lock lk(m_queueMutex);
+            if (!m_thread.joinable()) {
+                m_isRunning = true;
+                m_thread = std::thread([this]() {
+                    SetCurrentThreadName("alxr-events");
+                    Run();
+                });
+            }
+            m_jobs.push_back(std::move(task));
+        }
+        m_jobsCV.notify_one();
+    }
+
+    // Render thread only, applies the finished reactions up to the first unfinished one and returns how
+    // many were applied.
+    std::size_t ApplyCompleted() {
+        using namespace std::chrono_literals;
+        std::size_t appliedCount = 0;
+        while (!m_pending.empty() && m_pending.front().wait_for(0s) == std::future_status::ready) {
+            auto result = std::move(m_pending.front());
+            m_pending.pop_front();
+            if (const ApplyFn applyFn = result.get())
+                applyFn();
+            ++appliedCount;
+        }
+        return appliedCount;
+    }
+
+    std::size_t PendingCount() const { return m_pending.size(); }
+
+    // Pending work is still run, results which were not applied are dropped.
+    void Stop() {
+        {
+            std::scoped_lock lk(m_queueMutex);
+            m_isRunning = false;
+        }
+        m_jobsCV.notify_one();
+        if (m_thread.joinable())
+            m_thread.join();
+        m_pending.clear();
+    }
+
+private:
+    void Run() {
+        while (true) {
+            std::packaged_task<ApplyFn()> job;
+            {
+                std::unique_lock lk(m_queueMutex);
+                m_jobsCV.wait(lk, [this]() { return !m_jobs.empty() || !m_isRunning; });
+                if (m_jobs.empty())
+                    return;
+                job = std::move(m_jobs.front());
+                m_jobs.pop_front();
+            }
+            job();
+        }
+    }
+
+    std::mutex m_queueMutex{};
+    std::condition_variable m_jobsCV{};
+    std::deque<std::packaged_task<ApplyFn()>> m_jobs{};
+    std::thread m_thread{};
+    bool m_isRunning = false;
+
+    // render thread state.
+    std::deque<std::future<ApplyFn>> m_pending{};
+};
+}
+#endif
@@ -59,10 +59,7 @@ inline EyeGazeInteraction::~EyeGazeInteraction() {
 }
 
 inline XrPath EyeGazeInteraction::GetXrPath(const char* const str) const {
-	XrPath path{ XR_NULL_PATH };
-	CHECK_XRCMD(xrStringToPath(m_instance, str, &path));
-	assert(path != XR_NULL_PATH);
-	return path;
+	return XrPathCache::Instance().Get(m_instance, str);
 }
 
 inline XrPath EyeGazeInteraction::GetXrPath(const InteractionProfile& profile) const {
@@ -114,13 +111,11 @@ inline EyeGazeInteraction::EyeGazeInteraction(
 	CHECK_XRCMD(xrCreateActionSpace(m_session, &actionSpaceInfo, &m_eyeGazeSpace));
 	CHECK(m_eyeGazeSpace != XR_NULL_HANDLE);
 
-	using namespace std::string_literals;
-	const auto fullPath = EyeGazeProfile.userEyesPath + "/input/"s + EyeGazeProfile.eyeGazePosePath;
-
+	const XrPathSpec eyeGazePoseSpec{ EyeGazeProfile.userEyesPath, "input", EyeGazeProfile.eyeGazePosePath };
 	const std::vector<XrActionSuggestedBinding> bindings{
 		XrActionSuggestedBinding {
 			.action = m_eyeGazePoseAction,
-			.binding = GetXrPath(fullPath.c_str())
+			.binding = XrPathCache::Instance().Get(m_instance, eyeGazePoseSpec)
 		}
 	};
 
@@ -3,6 +3,9 @@
 #define ALXR_FOVEATION_H
 #include <type_traits>
 #include <cmath>
+#include <cstdint>
+#include <vector>
+#include <algorithm>
 #include "alxr_ctypes.h"
 
 namespace ALXR {
@@ -148,5 +151,100 @@ namespace ALXR {
             XrVector2f{ rc.foveationEdgeRatioX,   rc.foveationEdgeRatioY   }
         );
     }
+    // CPU reference of DecodeFoveationUV in decodeFoveation.glsl/.hlsl, keep in sync with the shaders.
+    inline XrVector2f TextureToEyeUV(const XrVector2f& textureUV, const float isRightEye) {
+        // flip distortion horizontally for right eye
+        // left: x * 2; right: (1 - x) * 2
+        return { (textureUV.x + isRightEye * (1.f - 2.f * textureUV.x)) * 2.f, textureUV.y };
+    }
+
+    inline XrVector2f EyeToTextureUV(const XrVector2f& eyeUV, const float isRightEye) {
+        // left: x / 2; right 1 - (x / 2)
+        return { eyeUV.x * 0.5f + isRightEye * (1.f - eyeUV.x), eyeUV.y };
+    }
+
+    // Maps an eye-space uv of the foveated (compressed) frame to the eye-space uv to sample from.
+    inline XrVector2f DecodeFoveationEyeUV(const FoveatedDecodeParams& fp, const XrVector2f& eyeUV) {
+        const auto decodeAxis = [&](float XrVector2f::* const c) {
+            const float v = eyeUV.*c;
+            if (v > fp.hiBound.*c) {
+                const float a = fp.aRight.*c, b = fp.bRight.*c;
+                return (-b + std::sqrt(b * b - 4.f * (fp.cRight.*c - a * v))) / (2.f * a);
+            }
+            if (v < fp.loBound.*c) {
+                const float a = fp.aLeft.*c, b = fp.bLeft.*c;
+                return (-b + std::sqrt(b * b + 4.f * a * v)) / (2.f * a);
+            }
+            return (v - fp.c1.*c) * fp.edgeRatio.*c / fp.c2.*c;
+        };
+        return {
+            decodeAxis(&XrVector2f::x) * fp.eyeSizeRatio.x,
+            decodeAxis(&XrVector2f::y) * fp.eyeSizeRatio.y
+        };
+    }
+
+    inline XrVector2f DecodeFoveationUV(const FoveatedDecodeParams& fp, const XrVector2f& uv, const bool isRightEye) {
+        const float rightEye = isRightEye ? 1.f : 0.f;
+        return EyeToTextureUV(DecodeFoveationEyeUV(fp, TextureToEyeUV(uv, rightEye)), rightEye);
+    }
+
+    // Eye-space foveation decode baked into a RG32F lookup table, shared by both eyes
+    // (the right eye is mirrored by TextureToEyeUV). Texel centres follow GPU conventions
+    // so texels can be uploaded as-is and sampled with a linear, clamp-to-edge sampler.
+    // Only the cpu sink plugin decodes through it, the vulkan/d3d shaders have no LUT sampling
+    // variant and always evaluate the analytic decode.
+    struct FoveatedDecodeLUT {
+        std::uint32_t width  = 0;
+        std::uint32_t height = 0;
+        std::vector<XrVector2f> texels{};
+
+        inline bool empty() const { return texels.empty(); }
+
+        inline XrVector2f SampleEyeUV(const XrVector2f& eyeUV) const {
+            const auto texel = [this](const std::int64_t x, const std::int64_t y) -> const XrVector2f& {
+                const auto cx = std::clamp<std::int64_t>(x, 0, width  - 1);
+                const auto cy = std::clamp<std::int64_t>(y, 0, height - 1);
+                return texels[cy * width + cx];
+            };
+            const float fx = eyeUV.x * width  - 0.5f;
+            const float fy = eyeUV.y * height - 0.5f;
+            const float x0 = std::floor(fx), y0 = std::floor(fy);
+            const float tx = fx - x0, ty = fy - y0;
+            const auto ix = static_cast<std::int64_t>(x0);
+            const auto iy = static_cast<std::int64_t>(y0);
+            const auto lerp = [](const XrVector2f& a, const XrVector2f& b, const float t) {
+                return XrVector2f{ a.x + (b.x - a.x) * t, a.y + (b.y - a.y) * t };
+            };
+            return lerp
+            (
+                lerp(texel(ix, iy),     texel(ix + 1, iy),     tx),
+                lerp(texel(ix, iy + 1), texel(ix + 1, iy + 1), tx),
+                ty
+            );
+        }
+
+        inline XrVector2f DecodeFoveationUV(const XrVector2f& uv, const bool isRightEye) const {
+            const float rightEye = isRightEye ? 1.f : 0.f;
+            return EyeToTextureUV(SampleEyeUV(TextureToEyeUV(uv, rightEye)), rightEye);
+        }
+    };
+
+    inline FoveatedDecodeLUT MakeFoveatedDecodeLUT
+    (
+        const FoveatedDecodeParams& fp,
+        const std::uint32_t width  = 512,
+        const std::uint32_t height = 512
+    )
+    {
+        FoveatedDecodeLUT lut{ .width = width, .height = height };
+        lut.texels.reserve(std::size_t(width) * height);
+        for (std::uint32_t y = 0; y < height; ++y) {
+            for (std::uint32_t x = 0; x < width; ++x) {
+                const XrVector2f eyeUV{ (x + 0.5f) / width, (y + 0.5f) / height };
+                lut.texels.push_back(DecodeFoveationEyeUV(fp, eyeUV));
+            }
+        }
+        return lut;
+    }
 }
 #endif
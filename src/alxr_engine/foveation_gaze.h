@@ -0,0 +1,205 @@
+#pragma once
+#ifndef ALXR_FOVEATION_GAZE_H
+#define ALXR_FOVEATION_GAZE_H
+#include <cstdint>
+#include <cmath>
+#include <array>
+#include <algorithm>
+#include <optional>
+
+#include "alxr_ctypes.h"
+#include "foveation.h"
+#include "one_euro_filter.h"
+
+namespace ALXR {
+
+    constexpr inline ALXRFoveationGazeOptions DefaultFoveationGazeOptions() {
+        return ALXRFoveationGazeOptions {
+            .minCutoff = 1.0f,
+            .beta = 0.5f,
+            .derivativeCutoff = 1.0f,
+            .latencyCompensation = 0.0f,
+            .deadband = 0.05f,
+            .maxCenterShift = 0.75f,
+            .enabled = false,
+            .applyToDecode = false
+        };
+    }
+
+    // Turns eye gaze (in view space) into a foveation center shift that follows it.
+    //
+    // The center region of the foveated frame spans [c0 * (shift + 1), c0 * (shift - 1) + 1] in normalized
+    // eye image coordinates where c0 = (1 - centerSize) / 2, so a shift of (u - 0.5) / c0 centers it on the
+    // gaze point u. The shift is one-euro filtered, extrapolated by the filtered shift velocity over the
+    // configured latency (the time until a frame encoded with it is displayed) and only published once it
+    // moves more than the deadband, which keeps the number of distinct decode parameter sets small.
+    //
+    // Eye gaze is taken relative to the eye views, canted displays are not accounted for.
+    class FoveationGazeTracker final {
+    public:
+        using EyeGazePoses = std::array<XrPosef, 2>;
+        using EyeGazeValid = std::array<std::uint8_t, 2>;
+        using EyeFovs      = std::array<XrFovf, 2>;
+
+        // Time without a valid gaze after which the configured (static) center shift is restored.
+        constexpr static const XrDuration InvalidGazeTimeout = 500'000'000; // 500ms
+
+        void SetOptions(const ALXRFoveationGazeOptions& options) {
+            m_options = options;
+            m_options.maxCenterShift = std::clamp(options.maxCenterShift, 0.0f, MaxCenterShiftLimit);
+            m_options.deadband = std::max(options.deadband, 0.0f);
+            m_options.latencyCompensation = std::max(options.latencyCompensation, 0.0f);
+            m_shiftFilter = Vector3OneEuroFilter{ Vector3OneEuroFilter::Params {
+                .mincutoff = std::max(options.minCutoff, 0.001f),
+                .beta = std::max(options.beta, 0.0f),
+                .dcutoff = std::max(options.derivativeCutoff, 0.001f)
+            }};
+            Reset();
+        }
+
+        const ALXRFoveationGazeOptions& GetOptions() const { return m_options; }
+
+        bool IsEnabled() const {
+            return m_options.enabled && m_renderConfig.enableFoveation;
+        }
+
+        void SetRenderConfig(const ALXRRenderConfig& rc) {
+            m_renderConfig = rc;
+            Reset();
+        }
+
+        const ALXRRenderConfig& GetRenderConfig() const { return m_renderConfig; }
+
+        void Reset() {
+            m_shiftFilter.reset();
+            m_velocityFilter.reset();
+            m_lastFilteredShift.reset();
+            m_lastValidTime = 0;
+            m_lastTime = 0;
+            m_gaze = ALXRFoveationGaze {
+                .timestamp = 0,
+                .centerShiftX = m_renderConfig.foveationCenterShiftX,
+                .centerShiftY = m_renderConfig.foveationCenterShiftY,
+                .isValid = false
+            };
+        }
+
+        // Returns true when the published center shift changed.
+        bool Update(const XrTime time, const EyeGazePoses& gazePoses, const EyeGazeValid& isGazeValid, const EyeFovs& fovs) {
+            if (!IsEnabled() || time <= m_lastTime)
+                return false;
+
+            const auto newShift = ComputeCenterShift(gazePoses, isGazeValid, fovs);
+            if (!newShift.has_value()) {
+                if (!m_gaze.isValid || (time - m_lastValidTime) < InvalidGazeTimeout)
+                    return false;
+                Reset();
+                return true;
+            }
+
+            const float dt = m_lastTime == 0 ? DefaultDeltaTime :
+                std::clamp(static_cast<float>(time - m_lastTime) * 1e-9f, MinDeltaTime, MaxDeltaTime);
+            m_lastTime = time;
+            m_lastValidTime = time;
+
+            const Eigen::Vector3f filteredShift = m_shiftFilter.filter(dt, *newShift);
+            const Eigen::Vector3f velocity = m_lastFilteredShift.has_value() ?
+                Eigen::Vector3f((filteredShift - *m_lastFilteredShift) * (1.0f / dt)) : Eigen::Vector3f::Zero();
+            m_lastFilteredShift = filteredShift;
+            const Eigen::Vector3f smoothedVelocity = m_velocityFilter.filter(velocity, Alpha(dt, m_options.derivativeCutoff));
+
+            const Eigen::Vector3f predictedShift = filteredShift + smoothedVelocity * m_options.latencyCompensation;
+            const XrVector2f centerShift {
+                std::clamp(predictedShift.x(), -m_options.maxCenterShift, m_options.maxCenterShift),
+                std::clamp(predictedShift.y(), -m_options.maxCenterShift, m_options.maxCenterShift)
+            };
+
+            const bool wasValid = m_gaze.isValid;
+            m_gaze.timestamp = static_cast<std::uint64_t>(time);
+            if (wasValid &&
+                std::fabs(centerShift.x - m_gaze.centerShiftX) < m_options.deadband &&
+                std::fabs(centerShift.y - m_gaze.centerShiftY) < m_options.deadband)
+                return false;
+            m_gaze.centerShiftX = centerShift.x;
+            m_gaze.centerShiftY = centerShift.y;
+            m_gaze.isValid = true;
+            return true;
+        }
+
+        const ALXRFoveationGaze& GetGaze() const { return m_gaze; }
+
+        XrVector2f GetCenterShift() const {
+            return { m_gaze.centerShiftX, m_gaze.centerShiftY };
+        }
+
+        FoveatedDecodeParams MakeDecodeParams(const XrVector2f& centerShift) const {
+            ALXRRenderConfig rc = m_renderConfig;
+            rc.foveationCenterShiftX = centerShift.x;
+            rc.foveationCenterShiftY = centerShift.y;
+            return MakeFoveatedDecodeParams(rc);
+        }
+
+    private:
+        // Keeps the center region off the frame edges where the edge decode constants are undefined.
+        constexpr static const float MaxCenterShiftLimit = 0.9f;
+        constexpr static const float DefaultDeltaTime = 1.0f / 90.0f;
+        constexpr static const float MinDeltaTime = 0.0001f;
+        constexpr static const float MaxDeltaTime = 0.1f;
+
+        static inline float Alpha(const float dt, const float cutoff) {
+            const float tau = static_cast<float>(1.0 / (2.0 * M_PI * std::max(cutoff, 0.001f)));
+            return 1.0f / (1.0f + tau / dt);
+        }
+
+        // Normalized (top-left origin) image position of the gaze direction within the eye fov.
+        static inline std::optional<XrVector2f> GazeToImagePos(const XrPosef& gazePose, const XrFovf& fov) {
+            const Eigen::Vector3f dir = ToQuaternionf(gazePose.orientation) * Eigen::Vector3f(0.0f, 0.0f, -1.0f);
+            if (dir.z() > -0.01f)
+                return std::nullopt;
+            const float tanX = dir.x() / -dir.z();
+            const float tanY = dir.y() / -dir.z();
+            const float tanLeft  = std::tan(fov.angleLeft);
+            const float tanRight = std::tan(fov.angleRight);
+            const float tanUp    = std::tan(fov.angleUp);
+            const float tanDown  = std::tan(fov.angleDown);
+            if (tanRight - tanLeft <= 0.0f || tanUp - tanDown <= 0.0f)
+                return std::nullopt;
+            return XrVector2f {
+                (tanX - tanLeft) / (tanRight - tanLeft),
+                (tanUp - tanY) / (tanUp - tanDown)
+            };
+        }
+
+        std::optional<Eigen::Vector3f> ComputeCenterShift(const EyeGazePoses& gazePoses, const EyeGazeValid& isGazeValid, const EyeFovs& fovs) const {
+            const float c0X = (1.0f - m_renderConfig.foveationCenterSizeX) * 0.5f;
+            const float c0Y = (1.0f - m_renderConfig.foveationCenterSizeY) * 0.5f;
+            if (c0X <= 0.0f || c0Y <= 0.0f)
+                return std::nullopt;
+
+            Eigen::Vector3f shiftSum = Eigen::Vector3f::Zero();
+            std::uint32_t eyeCount = 0;
+            for (std::size_t eyeIdx = 0; eyeIdx < gazePoses.size(); ++eyeIdx) {
+                if (!isGazeValid[eyeIdx])
+                    continue;
+                const auto imagePos = GazeToImagePos(gazePoses[eyeIdx], fovs[eyeIdx]);
+                if (!imagePos.has_value())
+                    continue;
+                shiftSum += Eigen::Vector3f{ (imagePos->x - 0.5f) / c0X, (imagePos->y - 0.5f) / c0Y, 0.0f };
+                ++eyeCount;
+            }
+            if (eyeCount == 0)
+                return std::nullopt;
+            return Eigen::Vector3f(shiftSum / static_cast<float>(eyeCount));
+        }
+
+        ALXRFoveationGazeOptions m_options{ DefaultFoveationGazeOptions() };
+        ALXRRenderConfig         m_renderConfig{};
+        ALXRFoveationGaze        m_gaze{};
+        Vector3OneEuroFilter     m_shiftFilter{};
+        Vector3LowPassFilter     m_velocityFilter{};
+        std::optional<Eigen::Vector3f> m_lastFilteredShift{};
+        XrTime                   m_lastValidTime{ 0 };
+        XrTime                   m_lastTime{ 0 };
+    };
+}
+#endif
@@ -0,0 +1,129 @@
+#include "pch.h"
+#include "common.h"
+#include "frame_accounting.h"
+#include "timing.h"
+
+namespace ALXR {
+
+FrameAccounting FrameAccounting::m_instance{};
+
+void FrameAccounting::Decoded(const std::uint64_t frameIndex)
+{
+    const std::uint64_t head = m_decodedHead.load(std::memory_order_relaxed);
+    if (head - m_decodedTail.load(std::memory_order_acquire) >= DecodedRingSize) {
+        m_decodedOverflow.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    m_decodedRing[head % DecodedRingSize] = frameIndex;
+    m_decodedHead.store(head + 1, std::memory_order_release);
+}
+
+void FrameAccounting::ApplyReset()
+{
+    m_decodedTail.store(m_decodedHead.load(std::memory_order_acquire), std::memory_order_release);
+    m_decodedOverflow.store(0, std::memory_order_relaxed);
+    for (auto counter : { &m_counters.displayFrames, &m_counters.newFrames, &m_counters.repeatedFrames,
+                          &m_counters.lateFrames, &m_counters.noFrames, &m_counters.decodedFrames,
+                          &m_counters.skippedFrames, &m_counters.maxRepeatRun })
+        counter->store(0, std::memory_order_relaxed);
+    m_staleness.Reset();
+    m_lastFrameIndex = std::uint64_t(-1);
+    m_repeatRun = 0;
+    m_lastLogUs = 0;
+    m_lastLogCounts = {};
+}
+
+void FrameAccounting::DrainDecoded(const std::uint64_t displayedFrameIndex)
+{
+    // Frames which did not fit into the ring were decoded while nothing was displayed for a while.
+    const std::uint64_t overflowCount = m_decodedOverflow.exchange(0, std::memory_order_relaxed);
+    std::uint64_t decodedCount = overflowCount;
+    std::uint64_t skippedCount = overflowCount;
+    if (displayedFrameIndex != std::uint64_t(-1)) {
+        std::uint64_t tail = m_decodedTail.load(std::memory_order_relaxed);
+        const std::uint64_t head = m_decodedHead.load(std::memory_order_acquire);
+        for (; tail != head; ++tail) {
+            const std::uint64_t frameIndex = m_decodedRing[tail % DecodedRingSize];
+            // not displayable yet, frames decoded after it are neither.
+            if (frameIndex > displayedFrameIndex)
+                break;
+            ++decodedCount;
+            if (frameIndex < displayedFrameIndex)
+                ++skippedCount;
+        }
+        m_decodedTail.store(tail, std::memory_order_release);
+    }
+    Increment(m_counters.decodedFrames, decodedCount);
+    Increment(m_counters.skippedFrames, skippedCount);
+}
+
+void FrameAccounting::Displayed(const std::uint64_t frameIndex, const std::uint64_t frameTime,
+                                const std::uint64_t displayTime, const std::uint64_t displayPeriod)
+{
+    if (m_resetRequested.exchange(false, std::memory_order_acq_rel))
+        ApplyReset();
+
+    const std::uint64_t now = GetSystemTimestampUs();
+    Increment(m_counters.displayFrames);
+    DrainDecoded(frameIndex);
+    if (frameIndex == std::uint64_t(-1)) {
+        Increment(m_counters.noFrames);
+        m_repeatRun = 0;
+    } else {
+        const std::uint64_t stalenessNs = displayTime > frameTime ? displayTime - frameTime : 0;
+        m_staleness.Record(stalenessNs / 1000, now);
+        if (frameIndex != m_lastFrameIndex) {
+            Increment(m_counters.newFrames);
+            if (stalenessNs * 2 > displayPeriod)
+                Increment(m_counters.lateFrames);
+            m_repeatRun = 1;
+        } else {
+            Increment(m_counters.repeatedFrames);
+            ++m_repeatRun;
+        }
+        if (m_repeatRun > m_counters.maxRepeatRun.load(std::memory_order_relaxed))
+            m_counters.maxRepeatRun.store(m_repeatRun, std::memory_order_relaxed);
+    }
+    m_lastFrameIndex = frameIndex;
+
+    if (m_lastLogUs == 0)
+        m_lastLogUs = now;
+    else if (now - m_lastLogUs >= LogIntervalUs)
+        LogStats(now);
+}
+
+void FrameAccounting::LogStats(const std::uint64_t nowUs)
+{
+    const std::array<std::uint64_t, 5> counts {
+        m_counters.newFrames.load(std::memory_order_relaxed),
+        m_counters.repeatedFrames.load(std::memory_order_relaxed),
+        m_counters.lateFrames.load(std::memory_order_relaxed),
+        m_counters.skippedFrames.load(std::memory_order_relaxed),
+        m_counters.noFrames.load(std::memory_order_relaxed),
+    };
+    const auto delta = [&](const std::size_t idx) {
+        return static_cast<unsigned long long>(counts[idx] - m_lastLogCounts[idx]);
+    };
+    const auto staleness = m_staleness.GetPercentiles(nowUs);
+    Log::Write(Log::Level::Verbose, Fmt("Video frames over %.1fs: new=%llu repeated=%llu late=%llu skipped=%llu none=%llu, staleness p50=%lluus p99=%lluus",
+        (nowUs - m_lastLogUs) * 1e-6, delta(0), delta(1), delta(2), delta(3), delta(4),
+        static_cast<unsigned long long>(staleness.p50), static_cast<unsigned long long>(staleness.p99)));
+    m_lastLogCounts = counts;
+    m_lastLogUs = nowUs;
+}
+
+void FrameAccounting::GetStats(ALXRFrameAccountingStats& stats) const
+{
+    stats = {
+        .displayFrames  = m_counters.displayFrames.load(std::memory_order_relaxed),
+        .newFrames      = m_counters.newFrames.load(std::memory_order_relaxed),
+        .repeatedFrames = m_counters.repeatedFrames.load(std::memory_order_relaxed),
+        .lateFrames     = m_counters.lateFrames.load(std::memory_order_relaxed),
+        .noFrames       = m_counters.noFrames.load(std::memory_order_relaxed),
+        .decodedFrames  = m_counters.decodedFrames.load(std::memory_order_relaxed),
+        .skippedFrames  = m_counters.skippedFrames.load(std::memory_order_relaxed),
+        .maxRepeatRun   = m_counters.maxRepeatRun.load(std::memory_order_relaxed),
+        .staleness      = m_staleness.GetPercentiles(GetSystemTimestampUs()),
+    };
+}
+}
@@ -0,0 +1,87 @@
+#pragma once
+#ifndef ALXR_FRAME_ACCOUNTING_H
+#define ALXR_FRAME_ACCOUNTING_H
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+#include <atomic>
+#include <bit>
+#include "alxr_ctypes.h"
+#include "latency_stats.h"
+
+namespace ALXR {
+
+// Classifies every display frame (new, repeated, late or without a video frame) and every decoded
+// video frame (displayed or skipped, i.e. replaced by a newer frame before it was ever displayed).
+//
+// Video frames are identified by their tracking frame index (a monotonic clock timestamp in ns), which is
+// not in the same clock domain as XrTime. The staleness of a displayed frame is the display time it is
+// shown at minus the time it was rendered for, both given by the caller in one clock domain.
+//
+// Decoded is called from a single decoder thread, Displayed and Reset from the render thread; the
+// decoded frame indices are handed over through a lock-free ring. GetStats may be called from any thread.
+struct FrameAccounting {
+
+    // Called once a video frame has been decoded, frame indices must be increasing.
+    void Decoded(const std::uint64_t frameIndex);
+
+    // Called once per display frame while streaming, with the video frame index drawn (-1 when there is
+    // none yet), the time that frame was rendered for, the display time it is drawn for and the display
+    // period. frameTime and displayTime must be in the same clock domain.
+    void Displayed(const std::uint64_t frameIndex, const std::uint64_t frameTime,
+                   const std::uint64_t displayTime, const std::uint64_t displayPeriod);
+
+    void GetStats(ALXRFrameAccountingStats& stats) const;
+
+    // May be called from any thread, applied by the render thread on the next display frame.
+    void Reset() { m_resetRequested.store(true, std::memory_order_release); }
+
+    static FrameAccounting& Instance() { return m_instance; }
+
+private:
+    void ApplyReset();
+    void DrainDecoded(const std::uint64_t displayedFrameIndex);
+    void LogStats(const std::uint64_t nowUs);
+
+    struct Counters {
+        std::atomic<std::uint64_t> displayFrames{ 0 };
+        std::atomic<std::uint64_t> newFrames{ 0 };
+        std::atomic<std::uint64_t> repeatedFrames{ 0 };
+        std::atomic<std::uint64_t> lateFrames{ 0 };
+        std::atomic<std::uint64_t> noFrames{ 0 };
+        std::atomic<std::uint64_t> decodedFrames{ 0 };
+        std::atomic<std::uint64_t> skippedFrames{ 0 };
+        std::atomic<std::uint64_t> maxRepeatRun{ 0 };
+    };
+
+    // Render thread only, simple increment without a locked RMW.
+    static inline void Increment(std::atomic<std::uint64_t>& counter, const std::uint64_t count = 1) {
+        counter.store(counter.load(std::memory_order_relaxed) + count, std::memory_order_relaxed);
+    }
+
+    constexpr static const std::size_t DecodedRingSize = 128;
+    static_assert(std::has_single_bit(DecodedRingSize));
+    constexpr static const std::uint64_t LogIntervalUs = RollingLatencyHistogram::WindowDurationUs;
+
+    // Single producer (decoder thread), single consumer (render thread).
+    std::array<std::uint64_t, DecodedRingSize> m_decodedRing{};
+    std::atomic<std::uint64_t> m_decodedHead{ 0 };
+    std::atomic<std::uint64_t> m_decodedTail{ 0 };
+    // Decoded frames which did not fit into the ring, the render thread has not drained it for a while.
+    std::atomic<std::uint64_t> m_decodedOverflow{ 0 };
+    std::atomic<bool>          m_resetRequested{ false };
+
+    Counters m_counters{};
+    RollingLatencyHistogram m_staleness{};
+
+    // render thread state.
+    std::uint64_t m_lastFrameIndex = std::uint64_t(-1);
+    std::uint64_t m_repeatRun = 0;
+    std::uint64_t m_lastLogUs = 0;
+    std::array<std::uint64_t, 5> m_lastLogCounts{};
+
+    static FrameAccounting m_instance;
+};
+}
+#endif
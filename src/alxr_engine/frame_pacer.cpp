@@ -0,0 +1,121 @@
+#include "pch.h"
+#include "frame_pacer.h"
+#include <thread>
+#if defined(__linux__)
+#include <time.h>
+#include <cerrno>
+#endif
+
+namespace ALXR {
+
+void FramePacer::SetPeriod(const nanoseconds period)
+{
+    if (period == m_period)
+        return;
+    if (m_started)
+        m_nextDeadline += period - m_period;
+    m_period = period;
+}
+
+void FramePacer::Reset()
+{
+    m_started = false;
+}
+
+FramePacerTimer::time_point FramePacerTimer::SystemNow()
+{
+    return XrSteadyClock::now();
+}
+
+void FramePacerTimer::SystemSleepUntil(const time_point target)
+{
+#if defined(__linux__)
+    if constexpr (std::is_same_v<XrSteadyClock, std::chrono::steady_clock>) {
+        // libstdc++/libc++ steady_clock is CLOCK_MONOTONIC.
+        using namespace std::chrono;
+        const auto sinceEpoch = duration_cast<nanoseconds>(target.time_since_epoch()).count();
+        const struct timespec ts {
+            .tv_sec  = static_cast<time_t>(sinceEpoch / 1'000'000'000),
+            .tv_nsec = static_cast<long>(sinceEpoch % 1'000'000'000)
+        };
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr) == EINTR) {}
+        return;
+    }
+#endif
+    std::this_thread::sleep_until(target);
+}
+
+void FramePacerTimer::SystemYield()
+{
+    std::this_thread::yield();
+}
+
+void FramePacer::SleepUntil(const time_point deadline)
+{
+    const time_point sleepTarget = deadline - m_spinMargin;
+    time_point now = m_timer.now();
+    if (sleepTarget > now) {
+        m_timer.sleepUntil(sleepTarget);
+
+        // adapt the spin margin to the oversleep of the coarse sleep: grow fast, shrink slowly.
+        now = m_timer.now();
+        const nanoseconds overSleep = now - sleepTarget;
+        const nanoseconds target = std::clamp(overSleep * 2, MinSpinMargin, MaxSpinMargin);
+        m_spinMargin = target > m_spinMargin ? target : m_spinMargin - (m_spinMargin - target) / 16;
+    }
+    while (now < deadline) {
+        m_timer.yield();
+        now = m_timer.now();
+    }
+}
+
+FramePacer::time_point FramePacer::WaitNext()
+{
+    const time_point now = m_timer.now();
+    if (!m_started || m_period.count() <= 0) {
+        m_started = true;
+        m_nextDeadline = now + m_period;
+        return now;
+    }
+
+    time_point deadline = m_nextDeadline;
+    if (now >= deadline + m_period) {
+        // more than a whole period behind, skip the missed deadlines but keep the phase.
+        const auto missed = (now - deadline) / m_period;
+        m_missedDeadlines += missed;
+        deadline += missed * m_period;
+    }
+    SleepUntil(deadline);
+
+    const double errorUs = std::chrono::duration<double, std::micro>(m_timer.now() - deadline).count();
+    ++m_frameCount;
+    m_errorSumUs   += errorUs;
+    m_errorSqSumUs += errorUs * errorUs;
+    m_errorMaxUs    = std::max(m_errorMaxUs, errorUs);
+
+    m_nextDeadline = deadline + m_period;
+    return deadline;
+}
+
+FramePacer::Stats FramePacer::GetStats() const
+{
+    const double count = static_cast<double>(std::max<std::uint64_t>(m_frameCount, 1));
+    return {
+        .frameCount      = m_frameCount,
+        .missedDeadlines = m_missedDeadlines,
+        .meanErrorUs     = m_errorSumUs / count,
+        .rmsErrorUs      = std::sqrt(m_errorSqSumUs / count),
+        .maxErrorUs      = m_errorMaxUs,
+        .spinMarginUs    = std::chrono::duration<double, std::micro>(m_spinMargin).count(),
+    };
+}
+
+void FramePacer::ResetStats()
+{
+    m_frameCount = 0;
+    m_missedDeadlines = 0;
+    m_errorSumUs = 0.0;
+    m_errorSqSumUs = 0.0;
+    m_errorMaxUs = 0.0;
+}
+}
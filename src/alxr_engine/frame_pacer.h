@@ -0,0 +1,82 @@
+#pragma once
+#ifndef ALXR_FRAME_PACER_H
+#define ALXR_FRAME_PACER_H
+
+#include <cstdint>
+#include <chrono>
+#include "timing.h"
+
+namespace ALXR {
+
+// Time source and waits of the FramePacer, defaults to the steady clock and the OS sleep/yield.
+// Tests replace them with a fake clock.
+struct FramePacerTimer {
+    using time_point = XrSteadyClock::time_point;
+
+    static time_point SystemNow();
+    static void SystemSleepUntil(const time_point target);
+    static void SystemYield();
+
+    time_point (*now)()                       = &SystemNow;
+    void       (*sleepUntil)(const time_point) = &SystemSleepUntil;
+    void       (*yield)()                      = &SystemYield;
+};
+
+// Absolute deadline frame pacer: deadlines advance by a fixed period from the previous deadline
+// (not from the previous wake up) so the phase never drifts. Waiting is a hybrid of a coarse OS sleep
+// (clock_nanosleep(TIMER_ABSTIME) on Linux/Android) up to a margin before the deadline, followed by a
+// spin for the remainder. The spin margin adapts to the measured oversleep of the coarse sleep.
+struct FramePacer {
+    using Clock = XrSteadyClock;
+    using time_point = Clock::time_point;
+    using nanoseconds = std::chrono::nanoseconds;
+
+    constexpr static const nanoseconds MinSpinMargin{ 50'000 };
+    constexpr static const nanoseconds MaxSpinMargin{ 2'000'000 };
+
+    struct Stats {
+        std::uint64_t frameCount;
+        std::uint64_t missedDeadlines; // deadlines skipped because the caller was more than a period late.
+        double        meanErrorUs;     // wake up time - deadline.
+        double        rmsErrorUs;
+        double        maxErrorUs;
+        double        spinMarginUs;
+    };
+
+    FramePacer() = default;
+    explicit FramePacer(const FramePacerTimer& timer) : m_timer(timer) {}
+
+    // keeps the current phase when only the period changes.
+    void SetPeriod(const nanoseconds period);
+    inline void SetFrameRate(const float frameRate) {
+        if (frameRate > 0.0f)
+            SetPeriod(std::chrono::duration_cast<nanoseconds>(std::chrono::duration<double>(1.0 / frameRate)));
+    }
+    inline nanoseconds GetPeriod() const { return m_period; }
+
+    // Blocks until the next deadline and returns it.
+    time_point WaitNext();
+
+    // Restarts the phase from now, the next WaitNext returns immediately.
+    void Reset();
+
+    Stats GetStats() const;
+    void ResetStats();
+
+private:
+    void SleepUntil(const time_point deadline);
+
+    FramePacerTimer m_timer{};
+    nanoseconds m_period{ 0 };
+    time_point  m_nextDeadline{};
+    bool        m_started = false;
+    nanoseconds m_spinMargin{ 500'000 };
+
+    std::uint64_t m_frameCount = 0;
+    std::uint64_t m_missedDeadlines = 0;
+    double        m_errorSumUs = 0.0;
+    double        m_errorSqSumUs = 0.0;
+    double        m_errorMaxUs = 0.0;
+};
+}
+#endif
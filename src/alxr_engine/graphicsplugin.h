@@ -4,6 +4,8 @@
 
 #pragma once
 
+#include <span>
+
 #ifdef None // xlib...
 #undef None
 #endif
@@ -16,6 +18,8 @@ struct Cube {
     XrPosef Pose;
     XrVector3f Scale;
 };
+// Cubes visualized in a frame, backed by storage owned by the caller for the duration of the call.
+using CubeList = std::span<const Cube>;
 
 enum class PassthroughMode : std::size_t {
     None = 0,
@@ -67,6 +71,11 @@ struct IGraphicsPlugin {
 
     virtual void ClearSwapchainImageStructs() {}
 
+    // Release the image structs (and any per-image graphics resources) of a single swapchain, plugins that
+    // support this let the program keep several swapchain sets alive and switch between them.
+    virtual bool CanReleaseSwapchainImageStructs() const { return false; }
+    virtual void ReleaseSwapchainImageStructs(const std::vector<XrSwapchainImageBaseHeader*>& /*swapchainImages*/) {}
+
     // Render to a swapchain image for a projection view.
     virtual void RenderView
     (
@@ -74,7 +83,7 @@ struct IGraphicsPlugin {
         const XrSwapchainImageBaseHeader* swapchainImage,
         const std::int64_t swapchainFormat,
         const PassthroughMode /*newMode*/,
-        const std::vector<Cube>& cubes
+        const CubeList cubes
     ) = 0;
 
     virtual void BeginVideoView() {}
@@ -95,7 +104,7 @@ struct IGraphicsPlugin {
         const XrSwapchainImageBaseHeader* /*swapchainImage*/,
         const std::int64_t /*swapchainFormat*/,
         const PassthroughMode /*newMode*/,
-        const std::vector<Cube>& /*cubes*/
+        const CubeList /*cubes*/
     ) {}
 
     virtual void RenderVideoMultiView
@@ -145,6 +154,9 @@ struct IGraphicsPlugin {
 
     virtual void ClearVideoTextures(){};
 
+    // True if the plugin consumes decoded video frames in a headless session.
+    virtual bool IsHeadlessVideoSink() const { return false; }
+
     virtual std::uint64_t GetVideoFrameIndex() const { return std::uint64_t(-1); }
 
     virtual void SetEnableLinearizeRGB(const bool /*enable*/) {}
@@ -0,0 +1,341 @@
+#include "pch.h"
+#include "common.h"
+#include "options.h"
+#include "geometry.h"
+#include "graphicsplugin.h"
+#include "timing.h"
+#include "foveation.h"
+#include <atomic>
+#include <cstring>
+#include <fstream>
+
+namespace {
+
+// A headless graphics plugin which consumes decoded video frames on the CPU, used for
+// benchmarking the decoder -> video texture -> BeginVideoView path on machines without a GPU.
+// Frames are copied into real plane buffers and selected with triple-buffer (latest frame wins)
+// semantics, matching what the GPU plugins do with their video textures.
+struct CpuSinkGraphicsPlugin final : public IGraphicsPlugin {
+
+    CpuSinkGraphicsPlugin(const std::shared_ptr<Options>& options, std::shared_ptr<IPlatformPlugin>)
+    : m_enableChecksum(options == nullptr || options->VideoSinkChecksum),
+      m_referenceFilename(options ? options->VideoSinkReferenceFile : std::string{}) {}
+
+    virtual std::vector<std::string> GetInstanceExtensions() const override { return {}; }
+
+    virtual void InitializeDevice(XrInstance /*instance*/, XrSystemId /*systemId*/, const XrEnvironmentBlendMode /*newMode*/) override { return; }
+
+    virtual int64_t SelectColorSwapchainFormat(const std::vector<int64_t>& /*runtimeFormats*/) const override { return 0; }
+
+    virtual const XrBaseInStructure* GetGraphicsBinding() const override { return nullptr; }
+
+    virtual std::vector<XrSwapchainImageBaseHeader*> AllocateSwapchainImageStructs(
+        uint32_t /*capacity*/, const XrSwapchainCreateInfo& /*swapchainCreateInfo*/) override {
+        return {};
+    }
+
+    virtual void RenderView
+    (
+        const XrCompositionLayerProjectionView& /*layerView*/,
+        const XrSwapchainImageBaseHeader* /*swapchainImage*/,
+        const std::int64_t /*swapchainFormat*/,
+        const PassthroughMode /*newMode*/,
+        const CubeList /*cubes*/
+    ) override {
+        return;
+    }
+
+    virtual bool IsHeadlessVideoSink() const override { return true; }
+
+    virtual void ClearVideoTextures() override
+    {
+        m_stats.Log();
+        m_stats.Reset();
+        m_videoFrames = {};
+        m_writeSlot = 0;
+        m_latestSlot.store(1);
+        m_readSlot = 2;
+        m_consumedFrameCount = 0;
+        m_referenceFile.close();
+    }
+
+    virtual void CreateVideoTextures(const std::size_t width, const std::size_t height, const XrPixelFormat pixfmt) override
+    {
+        CHECK(PlaneCount(pixfmt) > 0);
+        const bool is16Bit = pixfmt == XrPixelFormat::P010LE || pixfmt == XrPixelFormat::G10X6_B10X6_R10X6_3PLANE_420;
+        const std::size_t sampleSize = is16Bit ? 2 : 1;
+        const bool has3Planes = PlaneCount(pixfmt) == 3;
+        const std::size_t chromaSampleSize = has3Planes ? sampleSize : sampleSize * 2;
+
+        for (auto& frame : m_videoFrames) {
+            frame = VideoFrame{
+                .width = width,
+                .height = height,
+                .sampleSize = sampleSize,
+            };
+            frame.planes[0] = Plane{ .rowSize = width * sampleSize, .height = height };
+            frame.planes[1] = Plane{ .rowSize = (width / 2) * chromaSampleSize, .height = height / 2 };
+            if (has3Planes)
+                frame.planes[2] = frame.planes[1];
+            for (auto& plane : frame.planes)
+                plane.data.resize(plane.rowSize * plane.height);
+        }
+
+        if (!m_referenceFilename.empty()) {
+            m_referenceFile.open(m_referenceFilename, std::ios::binary | std::ios::ate);
+            if (!m_referenceFile) {
+                Log::Write(Log::Level::Warning, Fmt("CpuSink: failed to open reference file \"%s\", PSNR disabled.", m_referenceFilename.c_str()));
+            } else {
+                const std::size_t frameSize = m_videoFrames[0].planes[0].data.size();
+                m_referenceFrameCount = static_cast<std::size_t>(m_referenceFile.tellg()) / frameSize;
+                m_referenceFrame.resize(frameSize);
+                Log::Write(Log::Level::Info, Fmt("CpuSink: using %zu reference luma frames from \"%s\"", m_referenceFrameCount, m_referenceFilename.c_str()));
+            }
+        }
+        Log::Write(Log::Level::Info, Fmt("CpuSink: created %zu video frame buffers %zux%zu, %zu planes", m_videoFrames.size(), width, height, PlaneCount(pixfmt)));
+    }
+
+    virtual void UpdateVideoTexture(const YUVBuffer& yuvBuffer) override
+    {
+        auto& frame = m_videoFrames[m_writeSlot];
+        if (frame.planes[0].data.empty())
+            return;
+
+        const auto copyTimeMs = time_call_ms<true>([&]() {
+            const std::array<const Buffer*, 3> srcPlanes{ &yuvBuffer.luma, &yuvBuffer.chroma, &yuvBuffer.chroma2 };
+            for (std::size_t planeIdx = 0; planeIdx < frame.planes.size(); ++planeIdx) {
+                auto& dst = frame.planes[planeIdx];
+                const auto& src = *srcPlanes[planeIdx];
+                if (dst.data.empty() || src.data == nullptr)
+                    continue;
+                const auto srcPtr = reinterpret_cast<const std::uint8_t*>(src.data);
+                const std::size_t rows = std::min(dst.height, src.height);
+                if (src.pitch == dst.rowSize) {
+                    std::memcpy(dst.data.data(), srcPtr, dst.rowSize * rows);
+                    continue;
+                }
+                for (std::size_t row = 0; row < rows; ++row)
+                    std::memcpy(dst.data.data() + row * dst.rowSize, srcPtr + row * src.pitch, dst.rowSize);
+            }
+        });
+        frame.frameIndex = yuvBuffer.frameIndex;
+
+        const std::uint32_t prevLatest = m_latestSlot.exchange(m_writeSlot | FreshBit, std::memory_order_acq_rel);
+        m_writeSlot = prevLatest & ~FreshBit;
+
+        m_stats.framesReceived.fetch_add(1, std::memory_order_relaxed);
+        if (prevLatest & FreshBit)
+            m_stats.framesSkipped.fetch_add(1, std::memory_order_relaxed);
+        m_stats.copyTimeUs.fetch_add(static_cast<std::uint64_t>(copyTimeMs * 1000.0f), std::memory_order_relaxed);
+    }
+
+    virtual void BeginVideoView() override
+    {
+        if ((m_latestSlot.load(std::memory_order_acquire) & FreshBit) == 0) {
+            if (m_videoFrames[m_readSlot].frameIndex != std::uint64_t(-1))
+                ++m_stats.framesRepeated;
+            return;
+        }
+        const std::uint32_t prevLatest = m_latestSlot.exchange(m_readSlot, std::memory_order_acq_rel);
+        m_readSlot = prevLatest & ~FreshBit;
+        ConsumeFrame(m_videoFrames[m_readSlot]);
+    }
+
+    virtual void EndVideoView() override {}
+
+    virtual std::uint64_t GetVideoFrameIndex() const override {
+        return m_videoFrames[m_readSlot].frameIndex;
+    }
+
+    virtual void SetFoveatedDecode(const ALXR::FoveatedDecodeParams* fovDecParm) override {
+        if (fovDecParm == nullptr) {
+            m_fovDecodeLUT = {};
+            return;
+        }
+        const auto bakeTimeMs = time_call_ms<true>([&]() {
+            m_fovDecodeLUT = ALXR::MakeFoveatedDecodeLUT(*fovDecParm);
+        });
+        Log::Write(Log::Level::Verbose, Fmt("CpuSink: foveated decode LUT %ux%u baked in %.3f ms",
+            m_fovDecodeLUT.width, m_fovDecodeLUT.height, bakeTimeMs));
+    }
+
+private:
+    struct Plane {
+        std::vector<std::uint8_t> data{};
+        std::size_t rowSize = 0;
+        std::size_t height = 0;
+    };
+    struct VideoFrame {
+        std::array<Plane, 3> planes{};
+        std::size_t width = 0;
+        std::size_t height = 0;
+        std::size_t sampleSize = 1;
+        std::uint64_t frameIndex = std::uint64_t(-1);
+    };
+
+    static std::uint64_t Checksum(const Plane& plane)
+    {
+        // FNV-1a over 64-bit words, the tail is folded in byte-wise.
+        constexpr const std::uint64_t Prime = 0x100000001b3ULL;
+        std::uint64_t hash = 0xcbf29ce484222325ULL;
+        const std::size_t wordCount = plane.data.size() / sizeof(std::uint64_t);
+        for (std::size_t i = 0; i < wordCount; ++i) {
+            std::uint64_t word;
+            std::memcpy(&word, plane.data.data() + i * sizeof(word), sizeof(word));
+            hash = (hash ^ word) * Prime;
+        }
+        for (std::size_t i = wordCount * sizeof(std::uint64_t); i < plane.data.size(); ++i)
+            hash = (hash ^ plane.data[i]) * Prime;
+        return hash;
+    }
+
+    template < typename SampleT >
+    static double LumaPSNR(const Plane& plane, const std::vector<std::uint8_t>& reference)
+    {
+        const std::size_t sampleCount = plane.data.size() / sizeof(SampleT);
+        const auto lhs = reinterpret_cast<const SampleT*>(plane.data.data());
+        const auto rhs = reinterpret_cast<const SampleT*>(reference.data());
+        double sse = 0.0;
+        for (std::size_t i = 0; i < sampleCount; ++i) {
+            const double diff = double(lhs[i]) - double(rhs[i]);
+            sse += diff * diff;
+        }
+        if (sse == 0.0)
+            return std::numeric_limits<double>::infinity();
+        constexpr const double Peak = double(std::numeric_limits<SampleT>::max());
+        return 10.0 * std::log10((Peak * Peak) / (sse / double(sampleCount)));
+    }
+
+    template < typename SampleT >
+    void RemapFoveatedLuma(const VideoFrame& frame)
+    {
+        const auto& luma = frame.planes[0];
+        const auto src = reinterpret_cast<const SampleT*>(luma.data.data());
+        m_remapBuffer.resize(luma.data.size());
+        const auto dst = reinterpret_cast<SampleT*>(m_remapBuffer.data());
+        const float invW = 1.0f / frame.width, invH = 1.0f / frame.height;
+        for (std::size_t y = 0; y < frame.height; ++y) {
+            for (std::size_t x = 0; x < frame.width; ++x) {
+                const XrVector2f uv{ (x + 0.5f) * invW, (y + 0.5f) * invH };
+                const auto srcUV = m_fovDecodeLUT.DecodeFoveationUV(uv, uv.x > 0.5f);
+                const auto sx = std::min(static_cast<std::size_t>(std::max(srcUV.x, 0.0f) * frame.width),  frame.width - 1);
+                const auto sy = std::min(static_cast<std::size_t>(std::max(srcUV.y, 0.0f) * frame.height), frame.height - 1);
+                dst[y * frame.width + x] = src[sy * frame.width + sx];
+            }
+        }
+    }
+
+    void ConsumeFrame(const VideoFrame& frame)
+    {
+        ++m_stats.framesConsumed;
+        const std::size_t frameOrdinal = m_consumedFrameCount++;
+        const bool is16Bit = frame.sampleSize == 2;
+
+        if (m_enableChecksum) {
+            m_stats.lastChecksum = Checksum(frame.planes[0]);
+        }
+
+        if (m_referenceFile.is_open() && m_referenceFrameCount > 0) {
+            const std::size_t refIndex = frameOrdinal % m_referenceFrameCount;
+            m_referenceFile.seekg(refIndex * m_referenceFrame.size());
+            if (m_referenceFile.read(reinterpret_cast<char*>(m_referenceFrame.data()), m_referenceFrame.size())) {
+                const double psnr = is16Bit ?
+                    LumaPSNR<std::uint16_t>(frame.planes[0], m_referenceFrame) :
+                    LumaPSNR<std::uint8_t>(frame.planes[0], m_referenceFrame);
+                m_stats.AddPSNR(psnr);
+            } else {
+                m_referenceFile.clear();
+            }
+        }
+
+        if (!m_fovDecodeLUT.empty()) {
+            const auto remapTimeMs = time_call_ms<true>([&]() {
+                if (is16Bit)
+                    RemapFoveatedLuma<std::uint16_t>(frame);
+                else
+                    RemapFoveatedLuma<std::uint8_t>(frame);
+            });
+            m_stats.remapTimeMs += remapTimeMs;
+        }
+
+        if (m_stats.framesConsumed % Stats::LogInterval == 0)
+            m_stats.Log();
+    }
+
+    struct Stats {
+        constexpr static const std::uint64_t LogInterval = 300;
+
+        // written by the decoder thread.
+        std::atomic<std::uint64_t> framesReceived{ 0 };
+        std::atomic<std::uint64_t> framesSkipped{ 0 };
+        std::atomic<std::uint64_t> copyTimeUs{ 0 };
+        // written by the render thread.
+        std::uint64_t framesConsumed = 0;
+        std::uint64_t framesRepeated = 0;
+        std::uint64_t lastChecksum = 0;
+        std::uint64_t psnrCount = 0;
+        std::uint64_t identicalCount = 0;
+        double psnrSum = 0.0;
+        double psnrMin = std::numeric_limits<double>::max();
+        double remapTimeMs = 0.0;
+
+        void Reset() {
+            framesReceived = 0;
+            framesSkipped = 0;
+            copyTimeUs = 0;
+            framesConsumed = framesRepeated = lastChecksum = psnrCount = identicalCount = 0;
+            psnrSum = remapTimeMs = 0.0;
+            psnrMin = std::numeric_limits<double>::max();
+        }
+
+        void AddPSNR(const double psnr) {
+            if (std::isinf(psnr)) {
+                ++identicalCount;
+                return;
+            }
+            ++psnrCount;
+            psnrSum += psnr;
+            psnrMin = std::min(psnrMin, psnr);
+        }
+
+        void Log() const {
+            const std::uint64_t received = framesReceived.load();
+            if (received == 0)
+                return;
+            const double avgCopyMs = (copyTimeUs.load() / 1000.0) / received;
+            const double avgRemapMs = framesConsumed > 0 ? remapTimeMs / framesConsumed : 0.0;
+            std::string msg = Fmt("CpuSink: received: %llu, consumed: %llu, skipped: %llu, repeated: %llu, avg copy: %.3f ms, avg foveation remap: %.3f ms, last checksum: %016llx",
+                received, framesConsumed, framesSkipped.load(), framesRepeated, avgCopyMs, avgRemapMs, lastChecksum);
+            if (psnrCount > 0 || identicalCount > 0) {
+                msg += Fmt(", luma PSNR avg: %.2f dB, min: %.2f dB, identical frames: %llu",
+                    psnrCount > 0 ? psnrSum / psnrCount : 0.0, psnrCount > 0 ? psnrMin : 0.0, identicalCount);
+            }
+            Log::Write(Log::Level::Info, msg);
+        }
+    };
+
+    constexpr static const std::uint32_t FreshBit = 0x4;
+
+    std::array<VideoFrame, 3> m_videoFrames{};
+    std::uint32_t m_writeSlot = 0;                 // decoder thread only.
+    std::atomic<std::uint32_t> m_latestSlot{ 1 }; // last published frame, FreshBit is set until consumed.
+    std::uint32_t m_readSlot = 2;                  // render thread only.
+
+    const bool m_enableChecksum;
+    const std::string m_referenceFilename;
+    std::ifstream m_referenceFile{};
+    std::vector<std::uint8_t> m_referenceFrame{};
+    std::size_t m_referenceFrameCount = 0;
+    std::size_t m_consumedFrameCount = 0;
+
+    ALXR::FoveatedDecodeLUT m_fovDecodeLUT{};
+    std::vector<std::uint8_t> m_remapBuffer{};
+
+    Stats m_stats{};
+};
+}  // namespace
+
+std::shared_ptr<IGraphicsPlugin> CreateGraphicsPlugin_CpuSink(const std::shared_ptr<Options>& options,
+    std::shared_ptr<IPlatformPlugin> platformPlugin) {
+    return std::make_shared<CpuSinkGraphicsPlugin>(options, platformPlugin);
+}
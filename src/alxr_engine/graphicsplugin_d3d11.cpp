@@ -12,6 +12,7 @@
 #include <array>
 #include <vector>
 #include <atomic>
+#include <optional>
 
 #include "xr_eigen.h"
 #include <DirectXColors.h>
@@ -24,6 +25,7 @@
 #include "cuda/d3d11cuda_interop.h"
 #endif
 #include "foveation.h"
+#include "timing.h"
 
 using namespace Microsoft::WRL;
 using namespace DirectX;
@@ -198,12 +200,20 @@ struct D3D11GraphicsPlugin final : public IGraphicsPlugin {
             m_videoVertexShader.ReleaseAndGetAddressOf())
         );
 
-        std::size_t shaderIndex = 0;
-        for (const auto& videoPixelShader : m_coreShaders.videoPSMap[0])
-        {
-            CHECK_HRCMD(m_device->CreatePixelShader(videoPixelShader.data(), videoPixelShader.size(), nullptr,
-                m_videoPixelShader[shaderIndex++].ReleaseAndGetAddressOf()));
-        }
+        // Both foveated decode on/off variants are created up front so a stream config change only swaps them.
+        const float psCreateTimeMs = time_call_ms<true>([this]() {
+            assert(m_coreShaders.videoPSMap.size() == m_videoPixelShaders.size());
+            for (std::size_t fovDecodeIndex = 0; fovDecodeIndex < m_videoPixelShaders.size(); ++fovDecodeIndex) {
+                std::size_t shaderIndex = 0;
+                for (const auto& videoPixelShader : m_coreShaders.videoPSMap[fovDecodeIndex])
+                {
+                    CHECK_HRCMD(m_device->CreatePixelShader(videoPixelShader.data(), videoPixelShader.size(), nullptr,
+                        m_videoPixelShaders[fovDecodeIndex][shaderIndex++].ReleaseAndGetAddressOf()));
+                }
+            }
+        });
+        Log::Write(Log::Level::Info, Fmt("Video pixel shaders created in %.3f ms", psCreateTimeMs));
+        m_videoPixelShader = m_videoPixelShaders[0];
 
         // Create the sample state
         const D3D11_SAMPLER_DESC sampDesc {
@@ -353,6 +363,20 @@ struct D3D11GraphicsPlugin final : public IGraphicsPlugin {
         m_swapchainImageBuffers.clear();
     }
 
+    virtual bool CanReleaseSwapchainImageStructs() const override { return true; }
+
+    virtual void ReleaseSwapchainImageStructs(const std::vector<XrSwapchainImageBaseHeader*>& swapchainImages) override
+    {
+        if (swapchainImages.empty())
+            return;
+        for (const auto swapchainImage : swapchainImages) {
+            const auto colorTexture = reinterpret_cast<const XrSwapchainImageD3D11KHR*>(swapchainImage)->texture;
+            m_colorToDepthMap.erase(colorTexture);
+        }
+        const auto firstImage = reinterpret_cast<const XrSwapchainImageD3D11KHR*>(swapchainImages[0]);
+        m_swapchainImageBuffers.remove_if([firstImage](const auto& buffer) { return !buffer.empty() && buffer.data() == firstImage; });
+    }
+
     template < typename RenderFun >
     void RenderMultiViewImpl(const XrCompositionLayerProjectionView& layerView, const XrSwapchainImageBaseHeader* swapchainImage,
         int64_t swapchainFormat, const ALXR::CColorType& clearColour, RenderFun&& renderFn) {
@@ -398,7 +422,7 @@ struct D3D11GraphicsPlugin final : public IGraphicsPlugin {
         const std::array<XrCompositionLayerProjectionView, 2>& layerViews,
         const XrSwapchainImageBaseHeader* swapchainImage,
         const std::int64_t swapchainFormat, const PassthroughMode mode,
-        const std::vector<Cube>& cubes
+        const CubeList cubes
     ) override
     {
         RenderMultiViewImpl(layerViews[0], swapchainImage, swapchainFormat, ALXR::ClearColors[ClearColorIndex(mode)], [&]()
@@ -452,9 +476,8 @@ struct D3D11GraphicsPlugin final : public IGraphicsPlugin {
 
             m_deviceContext->VSSetShader(m_videoVertexShader.Get(), nullptr, 0);
 
-            if (const auto fovDecParmPtr = m_fovDecodeParams) {
-                alignas(16) const ALXR::FoveatedDecodeParams fdParam = *fovDecParmPtr;
-                m_deviceContext->UpdateSubresource(m_fovDecodeCBuffer.Get(), 0, nullptr, &fdParam, 0, 0);
+            if (m_fovDecodeParams.has_value()) {
+                m_deviceContext->UpdateSubresource(m_fovDecodeCBuffer.Get(), 0, nullptr, &*m_fovDecodeParams, 0, 0);
                 ID3D11Buffer* const psConstantBuffers[] = { m_fovDecodeCBuffer.Get() };
                 m_deviceContext->PSSetConstantBuffers(2, (UINT)std::size(psConstantBuffers), psConstantBuffers);
             }
@@ -520,7 +543,7 @@ struct D3D11GraphicsPlugin final : public IGraphicsPlugin {
     (
         const XrCompositionLayerProjectionView& layerView, const XrSwapchainImageBaseHeader* swapchainImage,
         const std::int64_t swapchainFormat, const PassthroughMode mode,
-        const std::vector<Cube>& cubes
+        const CubeList cubes
     ) override
     {
         RenderViewImpl(layerView, swapchainImage, swapchainFormat, ALXR::ClearColors[ClearColorIndex(mode)], [&]()
@@ -980,9 +1003,8 @@ struct D3D11GraphicsPlugin final : public IGraphicsPlugin {
             m_deviceContext->VSSetConstantBuffers(1, (UINT)std::size(constantBuffers), constantBuffers);
             m_deviceContext->VSSetShader(m_videoVertexShader.Get(), nullptr, 0);
 
-            if (const auto fovDecParmPtr = m_fovDecodeParams) {
-                alignas(16) const ALXR::FoveatedDecodeParams fdParam = *fovDecParmPtr;
-                m_deviceContext->UpdateSubresource(m_fovDecodeCBuffer.Get(), 0, nullptr, &fdParam, 0, 0);
+            if (m_fovDecodeParams.has_value()) {
+                m_deviceContext->UpdateSubresource(m_fovDecodeCBuffer.Get(), 0, nullptr, &*m_fovDecodeParams, 0, 0);
                 ID3D11Buffer* const psConstantBuffers[] = { m_fovDecodeCBuffer.Get() };
                 m_deviceContext->PSSetConstantBuffers(2, (UINT)std::size(psConstantBuffers), psConstantBuffers);
             }
@@ -1020,24 +1042,15 @@ struct D3D11GraphicsPlugin final : public IGraphicsPlugin {
 
     virtual void SetFoveatedDecode(const ALXR::FoveatedDecodeParams* newFovDecParmPtr) override {
         CHECK(m_device != nullptr);
-        const auto fovDecodeParams = m_fovDecodeParams;
-        const bool changePShaders  = (fovDecodeParams == nullptr && newFovDecParmPtr != nullptr) ||
-                                     (fovDecodeParams != nullptr && newFovDecParmPtr == nullptr);
+        const bool changePShaders = m_fovDecodeParams.has_value() != (newFovDecParmPtr != nullptr);
         if (changePShaders) {
-            CHECK(m_coreShaders.IsValid());
-            decltype(m_videoPixelShader) newVideoPixelShaders{};
-            const auto& pixelShaderByteList = m_coreShaders.videoPSMap[newFovDecParmPtr ? 1 : 0];
-            assert(pixelShaderByteList.size() == newVideoPixelShaders.size());
-            std::size_t shaderIndex = 0;
-            for (const auto& pixelShaderBytes : pixelShaderByteList)
-            {
-                CHECK_HRCMD(m_device->CreatePixelShader(pixelShaderBytes.data(), pixelShaderBytes.size(), nullptr,
-                    newVideoPixelShaders[shaderIndex++].ReleaseAndGetAddressOf()));
-            }
-            m_videoPixelShader = newVideoPixelShaders;
+            m_videoPixelShader = m_videoPixelShaders[newFovDecParmPtr ? 1 : 0];
         }
-        m_fovDecodeParams = newFovDecParmPtr ?
-            std::make_shared<ALXR::FoveatedDecodeParams>(*newFovDecParmPtr) : nullptr;
+        // Called per frame with a new center shift, the params are stored in place.
+        if (newFovDecParmPtr)
+            m_fovDecodeParams = *newFovDecParmPtr;
+        else
+            m_fovDecodeParams.reset();
     }
 
 #include "cuda/d3d11cuda_interop.inl"
@@ -1058,15 +1071,17 @@ struct D3D11GraphicsPlugin final : public IGraphicsPlugin {
     ComPtr<ID3D11Buffer> m_cubeVertexBuffer;
     ComPtr<ID3D11Buffer> m_cubeIndexBuffer;
 //video textures /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-    using FoveatedDecodeParamsPtr = std::shared_ptr<ALXR::FoveatedDecodeParams>;
-    FoveatedDecodeParamsPtr m_fovDecodeParams{};
+    std::optional<ALXR::FoveatedDecodeParams> m_fovDecodeParams{};
 
     ComPtr<ID3D11DeviceContext> m_uploadContext;
     
     ComPtr<ID3D11SamplerState> m_lumaSampler;
     ComPtr<ID3D11SamplerState> m_chromaSampler;
     ComPtr<ID3D11VertexShader> m_videoVertexShader;
-    std::array<ComPtr<ID3D11PixelShader>,VideoPShader::TypeCount> m_videoPixelShader;
+    using VideoPixelShaderList = std::array<ComPtr<ID3D11PixelShader>, VideoPShader::TypeCount>;
+    VideoPixelShaderList m_videoPixelShader;
+    // foveated decode off/on.
+    std::array<VideoPixelShaderList, 2> m_videoPixelShaders;
 
     D3D11FenceEvent                 m_texRendereComplete{};
     D3D11FenceEvent                 m_texCopy{};
@@ -14,6 +14,8 @@
 #include <variant>
 #include <thread>
 #include <chrono>
+#include <optional>
+#include <tuple>
 #include "xr_eigen.h"
 
 #include <DirectXColors.h>
@@ -23,6 +25,7 @@
 #include "d3d_common.h"
 #include "d3d_fence_event.h"
 #include "foveation.h"
+#include "pipeline_build_worker.h"
 #include "concurrent_queue.h"
 #include "cuda/WindowsSecurityAttributes.h"
 #ifdef XR_ENABLE_CUDA_INTEROP
@@ -189,12 +192,10 @@ ComPtr<ID3D12Resource> CreateTextureUploadBuffer
 
 struct SwapchainImageContext {
 
-    using FoveatedDecodeParamsPtr = std::shared_ptr<ALXR::FoveatedDecodeParams>;
-
     std::vector<XrSwapchainImageBaseHeader*> Create
     (
         ID3D12Device* d3d12Device, const std::uint32_t capacity, const std::uint32_t viewProjbufferSize,
-        const FoveatedDecodeParamsPtr fdParamPtr = nullptr // don't pass by ref.
+        const ALXR::FoveatedDecodeParams* fdParamPtr = nullptr
     ) {
         m_d3d12Device = d3d12Device;
 
@@ -229,6 +230,11 @@ struct SwapchainImageContext {
         return (uint32_t)(p - &m_swapchainImages[0]);
     }
 
+    bool Contains(const XrSwapchainImageBaseHeader* swapchainImageHeader) const {
+        const auto p = reinterpret_cast<const XrSwapchainImageD3D12KHR*>(swapchainImageHeader);
+        return std::less_equal<>{}(m_swapchainImages.data(), p) && std::less<>{}(p, m_swapchainImages.data() + m_swapchainImages.size());
+    }
+
     ID3D12Resource* GetDepthStencilTexture(ID3D12Resource* colorTexture) {
         if (!m_depthStencilTexture) {
             // This back-buffer has no corresponding depth-stencil texture, so create one with matching dimensions.
@@ -285,9 +291,14 @@ struct SwapchainImageContext {
         return m_foveationParamCBuffer.Get();
     }
 
+    // Only writes the constant buffer when the params changed, callers must have waited for the frame fence.
     void SetFoveationDecodeData(const ALXR::FoveatedDecodeParams& fdParams) {
         if (m_foveationParamCBuffer == nullptr)
             return;
+        if (m_foveationParams.has_value() &&
+            std::memcmp(&*m_foveationParams, &fdParams, sizeof(fdParams)) == 0)
+            return;
+        m_foveationParams = fdParams;
         constexpr const std::size_t AlignSize = D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT;
         const alignas(AlignSize) ALXR::FoveatedDecodeParams fovParams = fdParams;
         {
@@ -309,6 +320,7 @@ struct SwapchainImageContext {
     ComPtr<ID3D12Resource> m_modelCBuffer;
     ComPtr<ID3D12Resource> m_viewProjectionCBuffer;
     ComPtr<ID3D12Resource> m_foveationParamCBuffer;
+    std::optional<ALXR::FoveatedDecodeParams> m_foveationParams{};
     uint64_t m_fenceValue = 0;
 };
 
@@ -333,7 +345,11 @@ struct D3D12GraphicsPlugin final : public IGraphicsPlugin {
 
     D3D12GraphicsPlugin(const std::shared_ptr<Options>&, std::shared_ptr<IPlatformPlugin>) {}
 
-    inline ~D3D12GraphicsPlugin() override { CloseHandle(m_fenceEvent); }
+    inline ~D3D12GraphicsPlugin() override {
+        m_pipelineBuildWorker.Stop();
+        m_pipelineBuildWorker.LogStats();
+        CloseHandle(m_fenceEvent);
+    }
 
     std::vector<std::string> GetInstanceExtensions() const override { return { XR_KHR_D3D12_ENABLE_EXTENSION_NAME }; }
 
@@ -605,35 +621,56 @@ struct D3D12GraphicsPlugin final : public IGraphicsPlugin {
     }
 
     std::vector<XrSwapchainImageBaseHeader*> AllocateSwapchainImageStructs(
-        uint32_t capacity, const XrSwapchainCreateInfo& /*swapchainCreateInfo*/) override {
+        uint32_t capacity, const XrSwapchainCreateInfo& swapchainCreateInfo) override {
         // Allocate and initialize the buffer of image structs (must be sequential in memory for xrEnumerateSwapchainImages).
         // Return back an array of pointers to each swapchain image struct so the consumer doesn't need to know the type/size.
 
+        // Video pipelines are built in the background now instead of on the render thread on the first video frame,
+        // both foveated decode variants are reachable by a stream config change.
+        const auto swapchainFormat = static_cast<DXGI_FORMAT>(swapchainCreateInfo.format);
+        PrecompileVideoPipelineStates(swapchainFormat, false);
+        PrecompileVideoPipelineStates(swapchainFormat, true);
+
         m_swapchainImageContexts.emplace_back();
         SwapchainImageContext& swapchainImageContext = m_swapchainImageContexts.back();
 
-        std::vector<XrSwapchainImageBaseHeader*> bases = swapchainImageContext.Create
+        return swapchainImageContext.Create
         (
-            m_device.Get(), capacity, GetViewProjectionBufferSize(), m_fovDecodeParams
+            m_device.Get(), capacity, GetViewProjectionBufferSize(), m_fovDecodeParams ? &*m_fovDecodeParams : nullptr
         );
+    }
 
-        // Map every swapchainImage base pointer to this context
-        for (auto& base : bases) {
-            m_swapchainImageContextMap[base] = &swapchainImageContext;
+    // The image structs of a context are one packed array, the owning context is found by address range
+    // over the few live contexts (one per swapchain) instead of a per image map lookup every view.
+    SwapchainImageContext* FindSwapchainImageContext(const XrSwapchainImageBaseHeader* swapchainImage) {
+        for (auto& swapchainContext : m_swapchainImageContexts) {
+            if (swapchainContext.Contains(swapchainImage))
+                return &swapchainContext;
         }
-
-        return bases;
+        return nullptr;
     }
 
     virtual void ClearSwapchainImageStructs() override
     {
-        m_swapchainImageContextMap.clear();
         for (auto& swapchainContext : m_swapchainImageContexts) {
             CpuWaitForFence(swapchainContext.GetFrameFenceValue());
         }
         m_swapchainImageContexts.clear();
     }
 
+    virtual bool CanReleaseSwapchainImageStructs() const override { return true; }
+
+    virtual void ReleaseSwapchainImageStructs(const std::vector<XrSwapchainImageBaseHeader*>& swapchainImages) override
+    {
+        if (swapchainImages.empty())
+            return;
+        SwapchainImageContext* const swapchainContext = FindSwapchainImageContext(swapchainImages[0]);
+        if (swapchainContext == nullptr)
+            return;
+        CpuWaitForFence(swapchainContext->GetFrameFenceValue());
+        m_swapchainImageContexts.remove_if([swapchainContext](const auto& ctx) { return &ctx == swapchainContext; });
+    }
+
     struct PipelineStateStream
     {
         CD3DX12_PIPELINE_STATE_STREAM_ROOT_SIGNATURE pRootSignature;
@@ -822,30 +859,64 @@ struct D3D12GraphicsPlugin final : public IGraphicsPlugin {
         return static_cast<const std::size_t>(newMode) + (is3PlaneFmt ? VideoPShader::Normal3Plane : VideoPShader::Normal);
     }
 
-    ID3D12PipelineState* GetOrCreateVideoPipelineState(const DXGI_FORMAT swapchainFormat, const PassthroughMode newMode) {
-        const bool is3PlaneFormat = m_is3PlaneFormat.load();
-        const auto iter = m_VideoPipelineStates.find(swapchainFormat);
-        if (iter != m_VideoPipelineStates.end()) {
-            return iter->second[VideoPipelineIndex(is3PlaneFormat, newMode)].Get();
-        }
+    using ID3D12PipelineStatePtr = ComPtr<ID3D12PipelineState>;
+    using VidePipelineStateList = std::array<ID3D12PipelineStatePtr, VideoPShader::TypeCount>;
+    struct VideoPipelineStateEntry {
+        // Written by the pipeline build worker, only read once build is ready.
+        VidePipelineStateList pipelineStates{};
+        ALXR::PipelineBuildWorker::Future build{};
+    };
+    // swapchain format, foveated decode.
+    using VideoPipelineKey = std::tuple<DXGI_FORMAT, bool>;
+    // std::map, entries must not move while their build is pending.
+    using PipelineStateMap = std::map<VideoPipelineKey, VideoPipelineStateEntry>;
 
+    VidePipelineStateList MakeVideoPipelineStates(const DXGI_FORMAT swapchainFormat, const bool isFoveated) const {
         constexpr static const std::array<const D3D12_INPUT_ELEMENT_DESC, 0> EmptyInputElementDescs {};
         const auto makePipeline = [&, this](const ShaderByteCodeList<2>& shaders) -> ComPtr<ID3D12PipelineState>
         {
             return MakePipelineState(swapchainFormat, shaders, EmptyInputElementDescs);
         };
-        
-        const auto videoShaderBCodes = m_coreShaders.GetVideoByteCodes(m_fovDecodeParams != nullptr);
-        const auto newPipelineState = m_VideoPipelineStates.emplace(swapchainFormat, VidePipelineStateList{
+
+        const auto videoShaderBCodes = m_coreShaders.GetVideoByteCodes(isFoveated);
+        return VidePipelineStateList{
             makePipeline({ videoShaderBCodes[0], videoShaderBCodes[1+VideoPShader::Normal] }),
             makePipeline({ videoShaderBCodes[0], videoShaderBCodes[1+VideoPShader::PassthroughBlend] }),
             makePipeline({ videoShaderBCodes[0], videoShaderBCodes[1+VideoPShader::PassthroughMask] }),
             makePipeline({ videoShaderBCodes[0], videoShaderBCodes[1+VideoPShader::Normal3Plane] }),
             makePipeline({ videoShaderBCodes[0], videoShaderBCodes[1+VideoPShader::PassthroughBlend3Plane] }),
             makePipeline({ videoShaderBCodes[0], videoShaderBCodes[1+VideoPShader::PassthroughMask3Plane] }),
-        });
-        CHECK(newPipelineState.second);
-        return newPipelineState.first->second[VideoPipelineIndex(is3PlaneFormat, newMode)].Get();
+        };
+    }
+
+    // Queues a build of every passthrough mode and plane count variant of the video pipelines on the pipeline
+    // build worker, once per swapchain format and foveated decode on/off.
+    VideoPipelineStateEntry& PrecompileVideoPipelineStates(const DXGI_FORMAT swapchainFormat, const bool isFoveated) {
+        const auto [iter, isNewEntry] = m_VideoPipelineStates.try_emplace(VideoPipelineKey{ swapchainFormat, isFoveated });
+        auto& entry = iter->second;
+        if (isNewEntry) {
+            entry.build = m_pipelineBuildWorker.Submit(isFoveated ? "foveated decode video pipelines" : "video pipelines",
+                [this, &entry, swapchainFormat, isFoveated]() {
+                    entry.pipelineStates = MakeVideoPipelineStates(swapchainFormat, isFoveated);
+                });
+        }
+        return entry;
+    }
+
+    ID3D12PipelineState* GetOrCreateVideoPipelineState(const DXGI_FORMAT swapchainFormat, const PassthroughMode newMode) {
+        const bool is3PlaneFormat = m_is3PlaneFormat.load();
+        const bool isFoveated = m_fovDecodeParams.has_value();
+        auto& entry = PrecompileVideoPipelineStates(swapchainFormat, isFoveated);
+        if (entry.build.valid()) {
+            // Only stalls when the first video frame is drawn before the precompiled variant is done.
+            try {
+                m_pipelineBuildWorker.Wait(std::exchange(entry.build, {}), "video pipelines");
+            } catch (...) {
+                m_VideoPipelineStates.erase(VideoPipelineKey{ swapchainFormat, isFoveated });
+                throw;
+            }
+        }
+        return entry.pipelineStates[VideoPipelineIndex(is3PlaneFormat, newMode)].Get();
     }
 
     enum class RenderPipelineType {
@@ -875,7 +946,9 @@ struct D3D12GraphicsPlugin final : public IGraphicsPlugin {
         const PassthroughMode newMode = PassthroughMode::None
     )
     {
-        auto& swapchainContext = *m_swapchainImageContextMap[swapchainImage];
+        SwapchainImageContext* const swapchainContextPtr = FindSwapchainImageContext(swapchainImage);
+        assert(swapchainContextPtr != nullptr);
+        auto& swapchainContext = *swapchainContextPtr;
         CpuWaitForFence(swapchainContext.GetFrameFenceValue());
         swapchainContext.ResetCommandAllocator();
 
@@ -981,7 +1054,7 @@ struct D3D12GraphicsPlugin final : public IGraphicsPlugin {
     (
         const std::array<XrCompositionLayerProjectionView,2>& layerViews, const XrSwapchainImageBaseHeader* swapchainImage,
         const std::int64_t swapchainFormat, const PassthroughMode ptMode,
-        const std::vector<Cube>& cubes
+        const CubeList cubes
     ) override
     {
         assert(m_isMultiViewSupported);
@@ -1027,7 +1100,7 @@ struct D3D12GraphicsPlugin final : public IGraphicsPlugin {
     (
         const XrCompositionLayerProjectionView& layerView, const XrSwapchainImageBaseHeader* swapchainImage,
         const std::int64_t swapchainFormat, const PassthroughMode ptMode,
-        const std::vector<Cube>& cubes
+        const CubeList cubes
     ) override
     {
         assert(layerView.subImage.imageArrayIndex == 0);
@@ -1069,7 +1142,7 @@ struct D3D12GraphicsPlugin final : public IGraphicsPlugin {
         }, RenderPipelineType::Default);
     }
 
-    void RenderVisCubes(const std::vector<Cube>& cubes, SwapchainImageContext& swapchainContext, const ComPtr<ID3D12GraphicsCommandList>& cmdList)
+    void RenderVisCubes(const CubeList cubes, SwapchainImageContext& swapchainContext, const ComPtr<ID3D12GraphicsCommandList>& cmdList)
     {
         // Set cube primitive data.
         if (cubes.empty())
@@ -1590,8 +1663,10 @@ struct D3D12GraphicsPlugin final : public IGraphicsPlugin {
             cmdList->SetGraphicsRootDescriptorTable(RootParamIndex::ChromaTexture, videoTex.chromaGpuHandle);
             if (m_is3PlaneFormat)
                 cmdList->SetGraphicsRootDescriptorTable(RootParamIndex::ChromaVTexture, videoTex.chromaVGpuHandle);
-            if (m_fovDecodeParams)
+            if (m_fovDecodeParams.has_value()) {
+                swapchainContext.SetFoveationDecodeData(*m_fovDecodeParams);
                 cmdList->SetGraphicsRootConstantBufferView(RootParamIndex::FoveatedDecodeParams, swapchainContext.GetFoveationParamCBuffer()->GetGPUVirtualAddress());
+            }
             
             cmdList->ClearRenderTargetView(renderTargetView, ALXR::VideoClearColors[ClearColorIndex(newMode)], 0, nullptr);
             cmdList->ClearDepthStencilView(depthStencilView, D3D12_CLEAR_FLAG_DEPTH, 1.0f, 0, 0, nullptr);
@@ -1630,8 +1705,10 @@ struct D3D12GraphicsPlugin final : public IGraphicsPlugin {
             cmdList->SetGraphicsRootDescriptorTable(RootParamIndex::ChromaTexture, videoTex.chromaGpuHandle);
             if (m_is3PlaneFormat)
                 cmdList->SetGraphicsRootDescriptorTable(RootParamIndex::ChromaVTexture, videoTex.chromaVGpuHandle);
-            if (m_fovDecodeParams)
+            if (m_fovDecodeParams.has_value()) {
+                swapchainContext.SetFoveationDecodeData(*m_fovDecodeParams);
                 cmdList->SetGraphicsRootConstantBufferView(RootParamIndex::FoveatedDecodeParams, swapchainContext.GetFoveationParamCBuffer()->GetGPUVirtualAddress());
+            }
 
             // Set shaders and constant buffers.
             ID3D12Resource* const viewProjectionCBuffer = swapchainContext.GetViewProjectionCBuffer();
@@ -1669,18 +1746,13 @@ struct D3D12GraphicsPlugin final : public IGraphicsPlugin {
     }
 
     virtual void SetFoveatedDecode(const ALXR::FoveatedDecodeParams* newFovDecParm) override {
-        const auto fovDecodeParams = m_fovDecodeParams;
-        const bool changePipelines = (fovDecodeParams == nullptr && newFovDecParm != nullptr) ||
-                                     (fovDecodeParams != nullptr && newFovDecParm == nullptr);        
-        if (changePipelines) {
-            m_VideoPipelineStates.clear();
-        }
-        if (newFovDecParm) {
-            for (auto& swapchainCtx : m_swapchainImageContexts)
-                swapchainCtx.SetFoveationDecodeData(*newFovDecParm);
-        }
-        m_fovDecodeParams = newFovDecParm ?
-            std::make_shared<ALXR::FoveatedDecodeParams>(*newFovDecParm) : nullptr;
+        // Video pipelines of both foveated decode on/off are precompiled per swapchain format, see AllocateSwapchainImageStructs.
+        // The swapchain contexts constant buffers are updated when next rendered to, once the
+        // GPU is done with the frame that last used them, so the params can change every frame.
+        if (newFovDecParm)
+            m_fovDecodeParams = *newFovDecParm;
+        else
+            m_fovDecodeParams.reset();
     }
 
     virtual inline bool IsMultiViewEnabled() const override {
@@ -1700,7 +1772,6 @@ struct D3D12GraphicsPlugin final : public IGraphicsPlugin {
     uint64_t m_fenceValue = 0;
     HANDLE m_fenceEvent = INVALID_HANDLE_VALUE;
     std::list<SwapchainImageContext> m_swapchainImageContexts;
-    std::map<const XrSwapchainImageBaseHeader*, SwapchainImageContext*> m_swapchainImageContextMap;
     XrGraphicsBindingD3D12KHR m_graphicsBinding{
         .type = XR_TYPE_GRAPHICS_BINDING_D3D12_KHR,
         .next = nullptr
@@ -1754,18 +1825,15 @@ struct D3D12GraphicsPlugin final : public IGraphicsPlugin {
     ComPtr<ID3D12CommandAllocator> m_videoTexCmdAllocator{};
     ComPtr<ID3D12CommandQueue>     m_videoTexCmdCpyQueue{};
 
-    using ID3D12PipelineStatePtr = ComPtr<ID3D12PipelineState>;
-    using VidePipelineStateList = std::array<ID3D12PipelineStatePtr, VideoPShader::TypeCount>;
-    using PipelineStateMap = std::unordered_map<DXGI_FORMAT, VidePipelineStateList>;
     PipelineStateMap m_VideoPipelineStates;
+    ALXR::PipelineBuildWorker m_pipelineBuildWorker{ "D3D12GraphicsPlugin pipeline builder" };
 
     ComPtr<ID3D12DescriptorHeap> m_srvHeap{};
     ////////////////////////////////////////////////////////////////////////
     ComPtr<ID3D12DescriptorHeap> m_rtvHeap;
     ComPtr<ID3D12DescriptorHeap> m_dsvHeap;
     
-    using FoveatedDecodeParamsPtr = SwapchainImageContext::FoveatedDecodeParamsPtr;
-    FoveatedDecodeParamsPtr m_fovDecodeParams{};
+    std::optional<ALXR::FoveatedDecodeParams> m_fovDecodeParams{};
 
     bool m_isMultiViewSupported = false;
 };
@@ -30,6 +30,9 @@ std::shared_ptr<IGraphicsPlugin> CreateGraphicsPlugin_D3D12(const std::shared_pt
 std::shared_ptr<IGraphicsPlugin> CreateGraphicsPlugin_Headless(const std::shared_ptr<Options>& options,
                                                                std::shared_ptr<IPlatformPlugin> platformPlugin);
 
+std::shared_ptr<IGraphicsPlugin> CreateGraphicsPlugin_CpuSink(const std::shared_ptr<Options>& options,
+                                                              std::shared_ptr<IPlatformPlugin> platformPlugin);
+
 
 namespace {
 using GraphicsPluginFactory = std::function<std::shared_ptr<IGraphicsPlugin>(const std::shared_ptr<Options>& options,
@@ -62,6 +65,10 @@ const std::map<std::string, GraphicsPluginFactory, IgnoreCaseStringLess> graphic
      [](const std::shared_ptr<Options>& options, std::shared_ptr<IPlatformPlugin> platformPlugin) {
          return CreateGraphicsPlugin_Headless(options, std::move(platformPlugin));
      }},
+    {"CpuSink",
+     [](const std::shared_ptr<Options>& options, std::shared_ptr<IPlatformPlugin> platformPlugin) {
+         return CreateGraphicsPlugin_CpuSink(options, std::move(platformPlugin));
+     }},
 };
 }  // namespace
 
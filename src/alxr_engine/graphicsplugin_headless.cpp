@@ -32,7 +32,7 @@ struct HeadlessGraphicsPlugin final : public IGraphicsPlugin {
         const XrSwapchainImageBaseHeader* /*swapchainImage*/,
         const std::int64_t /*swapchainFormat*/,
         const PassthroughMode /*newMode*/,
-        const std::vector<Cube>& /*cubes*/
+        const CubeList /*cubes*/
     ) override {
         return ;
     }
@@ -20,6 +20,8 @@
 #include <algorithm>
 #include <array>
 #include <atomic>
+#include <optional>
+#include <tuple>
 
 #ifdef USE_ONLINE_VULKAN_SHADERC
 #include <shaderc/shaderc.hpp>
@@ -56,6 +58,7 @@
 #include "concurrent_queue.h"
 #include "timing.h"
 #include "foveation.h"
+#include "pipeline_build_worker.h"
 
 namespace {
 
@@ -587,6 +590,103 @@ struct CmdBuffer {
 #undef LIST_CMDBUFFER_STATES
 };
 
+// SecondaryCmdBufferCache - pre-recorded secondary command buffers for render pass contents which
+// only depend on long lived state (framebuffer, pipeline, descriptor sets), replayed with vkCmdExecuteCommands.
+// Any cached command buffer becomes invalid when one of the objects it refers to is destroyed or updated,
+// owners must call Clear() before that happens.
+template < typename KeyT >
+struct SecondaryCmdBufferCache {
+    using Key = KeyT;
+
+    VkCommandPool pool{ VK_NULL_HANDLE };
+    std::map<Key, VkCommandBuffer> cmdBuffers{};
+    std::uint64_t hitCount = 0;
+    std::uint64_t missCount = 0;
+
+    SecondaryCmdBufferCache() = default;
+
+    SecondaryCmdBufferCache(const SecondaryCmdBufferCache&) = delete;
+    SecondaryCmdBufferCache& operator=(const SecondaryCmdBufferCache&) = delete;
+    SecondaryCmdBufferCache(SecondaryCmdBufferCache&&) = delete;
+    SecondaryCmdBufferCache& operator=(SecondaryCmdBufferCache&&) = delete;
+
+    ~SecondaryCmdBufferCache() {
+        Clear();
+        if (m_vkDevice != VK_NULL_HANDLE && pool != VK_NULL_HANDLE) {
+            vkDestroyCommandPool(m_vkDevice, pool, nullptr);
+        }
+        pool = VK_NULL_HANDLE;
+        m_vkDevice = VK_NULL_HANDLE;
+    }
+
+    bool Init(VkDevice device, uint32_t queueFamilyIndex) {
+        assert(device != VK_NULL_HANDLE && pool == VK_NULL_HANDLE);
+        m_vkDevice = device;
+        const VkCommandPoolCreateInfo cmdPoolInfo {
+            .sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+            .pNext = nullptr,
+            .flags = 0,
+            .queueFamilyIndex = queueFamilyIndex
+        };
+        CHECK_VKCMD(vkCreateCommandPool(m_vkDevice, &cmdPoolInfo, nullptr, &pool));
+        return true;
+    }
+
+    inline bool IsValid() const { return pool != VK_NULL_HANDLE; }
+
+    // The caller must ensure no primary command buffer referring to the cached buffers is pending execution.
+    void Clear() {
+        if (m_vkDevice != VK_NULL_HANDLE && pool != VK_NULL_HANDLE && !cmdBuffers.empty()) {
+            std::vector<VkCommandBuffer> bufs;
+            bufs.reserve(cmdBuffers.size());
+            for (const auto& [key, buf] : cmdBuffers)
+                bufs.push_back(buf);
+            vkFreeCommandBuffers(m_vkDevice, pool, static_cast<std::uint32_t>(bufs.size()), bufs.data());
+        }
+        cmdBuffers.clear();
+    }
+
+    // Returns the cached command buffer for key, recording it with recordFn on a cache miss.
+    template < typename RecordFn >
+    VkCommandBuffer GetOrRecord(const Key& key, const VkCommandBufferInheritanceInfo& inheritanceInfo, RecordFn&& recordFn) {
+        assert(IsValid());
+        const auto itr = cmdBuffers.find(key);
+        if (itr != cmdBuffers.end()) {
+            ++hitCount;
+            return itr->second;
+        }
+        ++missCount;
+
+        const VkCommandBufferAllocateInfo allocInfo {
+            .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+            .pNext = nullptr,
+            .commandPool = pool,
+            .level = VK_COMMAND_BUFFER_LEVEL_SECONDARY,
+            .commandBufferCount = 1
+        };
+        VkCommandBuffer buf{ VK_NULL_HANDLE };
+        CHECK_VKCMD(vkAllocateCommandBuffers(m_vkDevice, &allocInfo, &buf));
+
+        // Simultaneous use as the same secondary may be referenced by the next frame's primary
+        // while the previous one is still in-flight (see CmdBuffer::Wait & SetCmdBufferWaitNextFrame).
+        const VkCommandBufferBeginInfo beginInfo {
+            .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+            .pNext = nullptr,
+            .flags = VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT | VK_COMMAND_BUFFER_USAGE_SIMULTANEOUS_USE_BIT,
+            .pInheritanceInfo = &inheritanceInfo
+        };
+        CHECK_VKCMD(vkBeginCommandBuffer(buf, &beginInfo));
+        recordFn(buf);
+        CHECK_VKCMD(vkEndCommandBuffer(buf));
+
+        cmdBuffers.emplace(key, buf);
+        return buf;
+    }
+
+   private:
+    VkDevice m_vkDevice{ VK_NULL_HANDLE };
+};
+
 // ShaderProgram to hold a pair of vertex & fragment shaders
 struct ShaderProgram {
     std::array<VkPipelineShaderStageCreateInfo, 2> shaderInfo{{
@@ -774,6 +874,68 @@ struct VertexBuffer final : public VertexBufferBase {
     }
 };
 
+// Persistently mapped host coherent uniform buffer of a single T, for constants which change per frame.
+// The caller must ensure no submitted command buffer reading the buffer is still pending when it is updated.
+template <typename T>
+struct HostUniformBuffer {
+    VkBuffer buf{ VK_NULL_HANDLE };
+    VkDeviceMemory mem{ VK_NULL_HANDLE };
+
+    HostUniformBuffer() = default;
+    ~HostUniformBuffer() { Clear(); }
+
+    HostUniformBuffer(const HostUniformBuffer&) = delete;
+    HostUniformBuffer& operator=(const HostUniformBuffer&) = delete;
+    HostUniformBuffer(HostUniformBuffer&&) = delete;
+    HostUniformBuffer& operator=(HostUniformBuffer&&) = delete;
+
+    void Create(VkDevice device, const MemoryAllocator& memAllocator) {
+        assert(device != VK_NULL_HANDLE && buf == VK_NULL_HANDLE);
+        m_vkDevice = device;
+        const VkBufferCreateInfo bufInfo {
+            .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+            .pNext = nullptr,
+            .size = sizeof(T),
+            .usage = VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
+            .sharingMode = VK_SHARING_MODE_EXCLUSIVE
+        };
+        CHECK_VKCMD(vkCreateBuffer(m_vkDevice, &bufInfo, nullptr, &buf));
+        VkMemoryRequirements memReq = {};
+        vkGetBufferMemoryRequirements(m_vkDevice, buf, &memReq);
+        memAllocator.Allocate(memReq, &mem);
+        CHECK_VKCMD(vkBindBufferMemory(m_vkDevice, buf, mem, 0));
+        CHECK_VKCMD(vkMapMemory(m_vkDevice, mem, 0, sizeof(T), 0, reinterpret_cast<void**>(&m_mapped)));
+    }
+
+    void Clear() {
+        if (m_vkDevice != VK_NULL_HANDLE) {
+            if (m_mapped != nullptr)
+                vkUnmapMemory(m_vkDevice, mem);
+            if (buf != VK_NULL_HANDLE)
+                vkDestroyBuffer(m_vkDevice, buf, nullptr);
+            if (mem != VK_NULL_HANDLE)
+                vkFreeMemory(m_vkDevice, mem, nullptr);
+        }
+        m_mapped = nullptr;
+        buf = VK_NULL_HANDLE;
+        mem = VK_NULL_HANDLE;
+        m_vkDevice = VK_NULL_HANDLE;
+    }
+
+    inline void Update(const T& value) {
+        assert(m_mapped != nullptr);
+        std::memcpy(m_mapped, &value, sizeof(T));
+    }
+
+    inline VkDescriptorBufferInfo DescriptorInfo() const {
+        return { .buffer = buf, .offset = 0, .range = sizeof(T) };
+    }
+
+private:
+    VkDevice m_vkDevice{ VK_NULL_HANDLE };
+    T* m_mapped = nullptr;
+};
+
 struct Texture {
     std::vector<std::size_t> totalImageMemSizes{};
     std::vector<VkDeviceMemory> texMemory{};// { VK_NULL_HANDLE };
@@ -1448,7 +1610,11 @@ struct RenderPass {
 
     RenderPass() = default;
 
-    bool Create(VkDevice device, VkFormat aColorFmt, VkFormat aDepthFmt, const std::uint32_t arraySizeParam) {
+    bool Create
+    (
+        VkDevice device, VkFormat aColorFmt, VkFormat aDepthFmt, const std::uint32_t arraySizeParam,
+        const VkAttachmentLoadOp colorLoadOp = VK_ATTACHMENT_LOAD_OP_CLEAR
+    ) {
         m_vkDevice = device;
         colorFmt = aColorFmt;
         depthFmt = aDepthFmt;
@@ -1515,7 +1681,7 @@ struct RenderPass {
             at[colorRef.attachment] = {
                 .format = colorFmt,
                 .samples = VK_SAMPLE_COUNT_1_BIT,
-                .loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR,
+                .loadOp = colorLoadOp,
                 .storeOp = VK_ATTACHMENT_STORE_OP_STORE,
                 .stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE,
                 .stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE,
@@ -1738,6 +1904,8 @@ struct PipelineLayout {
                 vkDestroyPipelineLayout(m_vkDevice, layout, nullptr);
             if (descriptorSetLayout != VK_NULL_HANDLE)
                 vkDestroyDescriptorSetLayout(m_vkDevice, descriptorSetLayout, nullptr);
+            if (fdParamsSetLayout != VK_NULL_HANDLE)
+                vkDestroyDescriptorSetLayout(m_vkDevice, fdParamsSetLayout, nullptr);
             if (textureSampler != VK_NULL_HANDLE)
                 vkDestroySampler(m_vkDevice, textureSampler, nullptr);
             if (m_vkinstance != VK_NULL_HANDLE &&
@@ -1760,6 +1928,7 @@ struct PipelineLayout {
         ycbcrSamplerConversion = VK_NULL_HANDLE;
         textureSampler = VK_NULL_HANDLE;
         descriptorSetLayout = VK_NULL_HANDLE;
+        fdParamsSetLayout = VK_NULL_HANDLE;
         layout = VK_NULL_HANDLE;
         m_vkDevice = VK_NULL_HANDLE;
         m_vkinstance = VK_NULL_HANDLE;
@@ -1799,6 +1968,8 @@ struct PipelineLayout {
     VkSamplerYcbcrConversion ycbcrSamplerConversion{ VK_NULL_HANDLE };
     VkSampler textureSampler{ VK_NULL_HANDLE };
     VkDescriptorSetLayout descriptorSetLayout{ VK_NULL_HANDLE };
+    // set = 1, the foveated decode params uniform buffer.
+    VkDescriptorSetLayout fdParamsSetLayout{ VK_NULL_HANDLE };
 
     void CreateVideoStreamLayout
     (
@@ -1868,6 +2039,22 @@ struct PipelineLayout {
         };
         CHECK_VKCMD(vkCreateDescriptorSetLayout(device, &layoutInfo, nullptr, &descriptorSetLayout));
 
+        constexpr const VkDescriptorSetLayoutBinding fdParamsBinding {
+            .binding = 0,
+            .descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
+            .descriptorCount = 1,
+            .stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT,
+            .pImmutableSamplers = nullptr,
+        };
+        const VkDescriptorSetLayoutCreateInfo fdParamsLayoutInfo {
+            .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
+            .pNext = nullptr,
+            .bindingCount = 1,
+            .pBindings = &fdParamsBinding
+        };
+        CHECK_VKCMD(vkCreateDescriptorSetLayout(device, &fdParamsLayoutInfo, nullptr, &fdParamsSetLayout));
+        const std::array<VkDescriptorSetLayout, 2> setLayouts{ descriptorSetLayout, fdParamsSetLayout };
+
         constexpr const VkPushConstantRange pcr {
             .stageFlags = VK_SHADER_STAGE_VERTEX_BIT,
             .offset = 0,
@@ -1877,8 +2064,8 @@ struct PipelineLayout {
         const VkPipelineLayoutCreateInfo pipelineLayoutCreateInfo {
             .sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
             .pNext = nullptr,
-            .setLayoutCount = 1,
-            .pSetLayouts = &descriptorSetLayout,
+            .setLayoutCount = (std::uint32_t)setLayouts.size(),
+            .pSetLayouts = setLayouts.data(),
             .pushConstantRangeCount = isMultiview ? 0u : 1u,
             .pPushConstantRanges = isMultiview ? nullptr : &pcr,
         };
@@ -1910,6 +2097,12 @@ struct Pipeline {
 
     void Create(VkDevice device, VkExtent2D size, const PipelineLayout& layout, const RenderPass& rp, const ShaderProgram& sp,
                 const VertexBufferBase* vb = nullptr) {
+        Create(device, size, layout, rp, sp.shaderInfo, vb);
+    }
+
+    using ShaderStages = std::array<VkPipelineShaderStageCreateInfo, 2>;
+    void Create(VkDevice device, VkExtent2D size, const PipelineLayout& layout, const RenderPass& rp, const ShaderStages& shaderStages,
+                const VertexBufferBase* vb = nullptr) {
         m_vkDevice = device;
 
         const VkPipelineDynamicStateCreateInfo dynamicState {
@@ -1975,13 +2168,7 @@ struct Pipeline {
             }
         };
         const VkRect2D scissor = {{0, 0}, size};
-#if defined(ORIGIN_BOTTOM_LEFT)
-        // Flipped view so origin is bottom-left like GL (requires VK_KHR_maintenance1)
-        const VkViewport viewport = {0.0f, (float)size.height, (float)size.width, -(float)size.height, 0.0f, 1.0f};
-#else
-        // Will invert y after projection
-        const VkViewport viewport = {0.0f, 0.0f, (float)size.width, (float)size.height, 0.0f, 1.0f};
-#endif
+        const VkViewport viewport = MakeViewport(size);
         const VkPipelineViewportStateCreateInfo vp {
             .sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO,
             .pNext = nullptr,
@@ -2016,8 +2203,8 @@ struct Pipeline {
         const VkGraphicsPipelineCreateInfo pipeInfo {
             .sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO,
             .pNext = nullptr,
-            .stageCount = (uint32_t)sp.shaderInfo.size(),
-            .pStages = sp.shaderInfo.data(),
+            .stageCount = (uint32_t)shaderStages.size(),
+            .pStages = shaderStages.data(),
             .pVertexInputState = &vi,
             .pInputAssemblyState = &ia,
             .pTessellationState = nullptr,
@@ -2045,6 +2232,16 @@ struct Pipeline {
         dynamicStateEnables.clear();
     }
 
+    static inline VkViewport MakeViewport(const VkExtent2D& size) {
+#if defined(ORIGIN_BOTTOM_LEFT)
+        // Flipped view so origin is bottom-left like GL (requires VK_KHR_maintenance1)
+        return {0.0f, (float)size.height, (float)size.width, -(float)size.height, 0.0f, 1.0f};
+#else
+        // Will invert y after projection
+        return {0.0f, 0.0f, (float)size.width, (float)size.height, 0.0f, 1.0f};
+#endif
+    }
+
 private:
     VkDevice m_vkDevice{VK_NULL_HANDLE};
 };
@@ -2163,6 +2360,10 @@ struct SwapchainImageContext {
     DepthBuffer depthBuffer{};
     RenderPass rp{};
     Pipeline pipe{};
+    // Video stream views are drawn with a fullscreen, non-blended triangle that writes every pixel,
+    // so they use a color only render pass that neither clears nor depth tests.
+    std::vector<RenderTarget> videoRenderTarget;
+    RenderPass videoRp{};
     XrStructureType swapchainImageType;
     std::uint32_t arraySize = 0;
 
@@ -2187,9 +2388,11 @@ struct SwapchainImageContext {
         depthBuffer.Create(m_vkDevice, memAllocator, depthFormat, swapchainCreateInfo);
         rp.Create(m_vkDevice, colorFormat, depthFormat, arraySize);
         pipe.Create(m_vkDevice, size, layout, rp, sp, &vb);
+        videoRp.Create(m_vkDevice, colorFormat, VK_FORMAT_UNDEFINED, arraySize, VK_ATTACHMENT_LOAD_OP_DONT_CARE);
 
         swapchainImages.resize(capacity);
         renderTarget.resize(capacity);
+        videoRenderTarget.resize(capacity);
         std::vector<XrSwapchainImageBaseHeader*> bases(capacity);
         for (uint32_t i = 0; i < capacity; ++i) {
             swapchainImages[i] = {
@@ -2208,6 +2411,11 @@ struct SwapchainImageContext {
         return (uint32_t)(p - &swapchainImages[0]);
     }
 
+    bool Contains(const XrSwapchainImageBaseHeader* swapchainImageHeader) const {
+        const auto p = reinterpret_cast<const XrSwapchainImageVulkan2KHR*>(swapchainImageHeader);
+        return std::less_equal<>{}(swapchainImages.data(), p) && std::less<>{}(p, swapchainImages.data() + swapchainImages.size());
+    }
+
     inline void BindRenderTarget(const std::uint32_t index, VkRenderPassBeginInfo& renderPassBeginInfo) {
         if (renderTarget[index].fb == VK_NULL_HANDLE) {
             renderTarget[index].Create(m_vkDevice, swapchainImages[index].image, depthBuffer.depthImage, size, rp);
@@ -2218,6 +2426,16 @@ struct SwapchainImageContext {
         renderPassBeginInfo.renderArea.extent = size;
     }
 
+    inline void BindVideoRenderTarget(const std::uint32_t index, VkRenderPassBeginInfo& renderPassBeginInfo) {
+        if (videoRenderTarget[index].fb == VK_NULL_HANDLE) {
+            videoRenderTarget[index].Create(m_vkDevice, swapchainImages[index].image, VK_NULL_HANDLE, size, videoRp);
+        }
+        renderPassBeginInfo.renderPass = videoRp.pass;
+        renderPassBeginInfo.framebuffer = videoRenderTarget[index].fb;
+        renderPassBeginInfo.renderArea.offset = {0, 0};
+        renderPassBeginInfo.renderArea.extent = size;
+    }
+
    private:
     VkDevice m_vkDevice{VK_NULL_HANDLE};
 };
@@ -3013,7 +3231,6 @@ struct VulkanGraphicsPlugin : public IGraphicsPlugin {
 
         for (const auto shaderType : { VideoFragShaderType::Normal,
                                        VideoFragShaderType::FoveatedDecode }) {
-            
             const auto& fragList = fragShaders[shaderType];
             auto& vsList = m_videoShaders[shaderType];
             assert(fragList.size() == vsList.size());
@@ -3028,7 +3245,12 @@ struct VulkanGraphicsPlugin : public IGraphicsPlugin {
             }
         }
 
+        m_fovDecodeParamsBuffer.Create(m_vkDevice, m_memAllocator);
+
         if (!m_videoCpyCmdBuffer.Init(m_vkDevice, m_queueFamilyIndexVideoCpy)) THROW("Failed to create command buffer");
+#if !defined(XR_USE_PLATFORM_ANDROID) && !defined(XR_DISABLE_VIDEO_CMDBUFFER_CACHE)
+        if (!m_videoViewCmdCache.Init(m_vkDevice, m_queueFamilyIndex)) THROW("Failed to create video view command buffer cache");
+#endif
     }
 
     using CodeBuffer = ShaderProgram::CodeBuffer;
@@ -3120,23 +3342,48 @@ struct VulkanGraphicsPlugin : public IGraphicsPlugin {
         m_swapchainImageContexts.emplace_back(GetSwapchainImageType());
         SwapchainImageContext& swapchainImageContext = m_swapchainImageContexts.back();
 
-        std::vector<XrSwapchainImageBaseHeader*> bases = swapchainImageContext.Create(
+        auto swapchainImages = swapchainImageContext.Create(
             m_vkDevice, &m_memAllocator, capacity, swapchainCreateInfo, m_pipelineLayout, m_shaderProgram, m_drawBuffer);
-
-        // Map every swapchainImage base pointer to this context
-        for (auto& base : bases) {
-            m_swapchainImageContextMap[base] = &swapchainImageContext;
+        // A new swapchain format while the video stream layout exists.
+        if (!m_videoStreamLayout.IsNull())
+            PrecompileVideoStreamPipelines(swapchainImageContext);
+        return swapchainImages;
+    }
+
+    // The image structs of a context are one packed array, the owning context is found by address range
+    // over the few live contexts (one per swapchain) instead of a per image map lookup every view.
+    SwapchainImageContext* FindSwapchainImageContext(const XrSwapchainImageBaseHeader* swapchainImage) {
+        for (auto& swapchainContext : m_swapchainImageContexts) {
+            if (swapchainContext.Contains(swapchainImage))
+                return &swapchainContext;
         }
-
-        return bases;
+        return nullptr;
     }
 
     virtual void ClearSwapchainImageStructs() override
     {
-        m_swapchainImageContextMap.clear();
+        ClearVideoViewCmdCache();
         m_swapchainImageContexts.clear();
     }
 
+    virtual bool CanReleaseSwapchainImageStructs() const override { return true; }
+
+    virtual void ReleaseSwapchainImageStructs(const std::vector<XrSwapchainImageBaseHeader*>& swapchainImages) override
+    {
+        if (swapchainImages.empty())
+            return;
+        const SwapchainImageContext* const swapchainContext = FindSwapchainImageContext(swapchainImages[0]);
+        if (swapchainContext == nullptr)
+            return;
+        // all swapchain rendering is submitted through m_cmdBuffer, with m_cmdBufferWaitNextFrame the last
+        // frame may still be executing and referencing the image views/framebuffers about to be destroyed.
+        if (m_cmdBuffer.state == CmdBuffer::CmdBufferState::Executing)
+            m_cmdBuffer.Wait();
+        // cached command buffers are keyed by image address, which may be reused by the next allocation.
+        ClearVideoViewCmdCache();
+        m_swapchainImageContexts.remove_if([swapchainContext](const auto& ctx) { return &ctx == swapchainContext; });
+    }
+
     static inline Eigen::Matrix4f MakeViewProjMatrix(const XrCompositionLayerProjectionView& layerView) {
         
         const Eigen::Matrix4f proj = ALXR::CreateProjectionFov(ALXR::GraphicsAPI::Vulkan, layerView.fov, 0.05f, 100.0f);
@@ -3147,7 +3394,7 @@ struct VulkanGraphicsPlugin : public IGraphicsPlugin {
     template < typename RenderFunc >
     inline void RenderViewImpl(const XrSwapchainImageBaseHeader* swapchainImage, RenderFunc&& renderFun) {
 
-        const auto swapchainContextPtr = m_swapchainImageContextMap[swapchainImage];
+        const auto swapchainContextPtr = FindSwapchainImageContext(swapchainImage);
         assert(swapchainContextPtr != nullptr);
         const std::uint32_t imageIndex = swapchainContextPtr->ImageIndex(swapchainImage);
 
@@ -3215,31 +3462,6 @@ struct VulkanGraphicsPlugin : public IGraphicsPlugin {
     };
     static_assert(ConstClearValues.size() >= 3);
 
-    constexpr static const std::array<const ClearValueT, 3> VideoClearValues{
-        OpaqueClear {
-            //
-            // Typically the alpha channel is ignored for XR_ENVIRONMENT_BLEND_MODE_OPAQUE but
-            // for runtimes which only support passthrough via explicit extensions such as XR_FB_passthrough & XR_HTC_passthrough
-            // and only have the an Opaque blend, the alpha channel is relevent/used in this case.
-            // 
-            VkClearValue {.color {.float32 = { CClear[0], CClear[1], CClear[2], 0.2f }}},
-            ClearDepthStencilValue
-        },
-        AdditiveClear {
-            VkClearValue {.color {.float32 = { CClear[0], CClear[1], CClear[2], 0.0f }}},
-            ClearDepthStencilValue
-        },
-        AlphaBlendClear {
-            //
-            // set the alpha channel to zero to show passthrough, if a video frame isn't rendered for whatever reason
-            // only the passthrough feed will show rather than jarring random black-opaque frames popping in
-            //
-            VkClearValue {.color {.float32 = { CClear[0], CClear[1], CClear[2], 0.0f }}},
-            ClearDepthStencilValue
-        },
-    };
-    static_assert(VideoClearValues.size() >= 3);
-
     inline std::size_t ClearValueIndex(const PassthroughMode /*ptMode*/) const {       
         return m_clearColorIndex;
     }
@@ -3250,7 +3472,7 @@ struct VulkanGraphicsPlugin : public IGraphicsPlugin {
         const XrSwapchainImageBaseHeader* swapchainImage,
         const std::int64_t /*swapchainFormat*/,
         const PassthroughMode newMode,
-        const std::vector<Cube>& cubes
+        const CubeList cubes
     ) override {
         assert(m_isMultiViewSupported);
         RenderViewImpl(swapchainImage, [&, this](const std::uint32_t imageIndex, auto& swapchainContext)
@@ -3304,7 +3526,7 @@ struct VulkanGraphicsPlugin : public IGraphicsPlugin {
     (
         const XrCompositionLayerProjectionView& layerView, const XrSwapchainImageBaseHeader* swapchainImage,
         const std::int64_t /*swapchainFormat*/, const PassthroughMode newMode,
-        const std::vector<Cube>& cubes
+        const CubeList cubes
     ) override {
         assert(layerView.subImage.imageArrayIndex == 0);  // Texture arrays not supported.
         RenderViewImpl(swapchainImage, [&, this](const std::uint32_t imageIndex, auto& swapchainContext)
@@ -3446,6 +3668,7 @@ struct VulkanGraphicsPlugin : public IGraphicsPlugin {
             vkDestroyDescriptorPool(m_vkDevice, m_descriptorPool, nullptr);
         }
         m_descriptorPool = VK_NULL_HANDLE;
+        m_fovDecodeParamsDescriptorSet = VK_NULL_HANDLE;
     }
 
     void CreateImageDescriptorSets()
@@ -3479,22 +3702,27 @@ struct VulkanGraphicsPlugin : public IGraphicsPlugin {
         const std::uint32_t descriptorSetCount = MaxCombinedImageSamplerYcbcrDescriptorCount * static_cast<std::uint32_t>(m_videoTextures.size());
 #endif
 
-        const std::array<const VkDescriptorPoolSize, 1> poolSizes{
+        const std::array<const VkDescriptorPoolSize, 2> poolSizes{
             VkDescriptorPoolSize {
                 .type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
                 .descriptorCount = descriptorSetCount,
+            },
+            VkDescriptorPoolSize {
+                .type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
+                .descriptorCount = 1,
             }
         };
         const VkDescriptorPoolCreateInfo poolInfo {
             .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
             .pNext = nullptr,
             .flags = 0,
-            .maxSets = descriptorSetCount,
+            .maxSets = descriptorSetCount + 1, // + foveated decode params set.
             .poolSizeCount = static_cast<std::uint32_t>(poolSizes.size()),
             .pPoolSizes = poolSizes.data()
         };
         CHECK_VKCMD(vkCreateDescriptorPool(m_vkDevice, &poolInfo, nullptr, &m_descriptorPool));
         CHECK(m_descriptorPool != VK_NULL_HANDLE);
+        CreateFovDecodeParamsDescriptorSet();
 
 #ifdef XR_USE_PLATFORM_ANDROID
         CHECK(m_videoStreamLayout.descriptorSetLayout != VK_NULL_HANDLE);
@@ -3528,130 +3756,142 @@ struct VulkanGraphicsPlugin : public IGraphicsPlugin {
 #endif
     }
 
+    void CreateFovDecodeParamsDescriptorSet()
+    {
+        CHECK(m_videoStreamLayout.fdParamsSetLayout != VK_NULL_HANDLE && m_fovDecodeParamsBuffer.buf != VK_NULL_HANDLE);
+        const VkDescriptorSetAllocateInfo allocInfo = {
+            .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
+            .pNext = nullptr,
+            .descriptorPool = m_descriptorPool,
+            .descriptorSetCount = 1,
+            .pSetLayouts = &m_videoStreamLayout.fdParamsSetLayout
+        };
+        CHECK_VKCMD(vkAllocateDescriptorSets(m_vkDevice, &allocInfo, &m_fovDecodeParamsDescriptorSet));
+
+        const VkDescriptorBufferInfo bufferInfo = m_fovDecodeParamsBuffer.DescriptorInfo();
+        const VkWriteDescriptorSet descriptorWrite {
+            .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+            .pNext = nullptr,
+            .dstSet = m_fovDecodeParamsDescriptorSet,
+            .dstBinding = 0,
+            .dstArrayElement = 0,
+            .descriptorCount = 1,
+            .descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
+            .pImageInfo = nullptr,
+            .pBufferInfo = &bufferInfo,
+            .pTexelBufferView = nullptr
+        };
+        vkUpdateDescriptorSets(m_vkDevice, 1, &descriptorWrite, 0, nullptr);
+        // The buffer contents are written by the next rendered frame.
+        m_fovDecodeParamsChanged = true;
+    }
+
     struct alignas(16) SpecializationData {
-        ALXR::FoveatedDecodeParams fdParams;
         VkBool32 enableSRGBLinearize;
         float alphaValue;     // Blend or Mask mode.
         XrVector3f keyColour; // Mask Mode only.
     };
     using SpecializationMap = std::vector<VkSpecializationMapEntry>;
-    SpecializationMap MakeSpecializationMap
-    (
-        const bool enableFDParams,
-        const PassthroughMode ptMode
-    ) const
+    SpecializationMap MakeSpecializationMap(const PassthroughMode ptMode) const
     {
-#define VEC2_OFFSET_OF(STRUCT, MEMBER)  \
-    offsetof(STRUCT, MEMBER.x),         \
-	offsetof(STRUCT, MEMBER.y)
-
-#define VEC3_OFFSET_OF(STRUCT, MEMBER)  \
-    VEC2_OFFSET_OF(STRUCT, MEMBER),     \
-	offsetof(STRUCT, MEMBER.z)
-
         using SDType = SpecializationData;
         static_assert(std::is_standard_layout<SDType>::value);
-        constexpr static const std::array<std::uint32_t, 27> MemberOffsets {
-            VEC2_OFFSET_OF(SDType, fdParams.eyeSizeRatio),
-            VEC2_OFFSET_OF(SDType, fdParams.edgeRatio),
-            VEC2_OFFSET_OF(SDType, fdParams.c1),
-            VEC2_OFFSET_OF(SDType, fdParams.c2),
-            VEC2_OFFSET_OF(SDType, fdParams.loBound),
-            VEC2_OFFSET_OF(SDType, fdParams.hiBound),
-            VEC2_OFFSET_OF(SDType, fdParams.aLeft),
-            VEC2_OFFSET_OF(SDType, fdParams.bLeft),
-            VEC2_OFFSET_OF(SDType, fdParams.aRight),
-            VEC2_OFFSET_OF(SDType, fdParams.bRight),
-            VEC2_OFFSET_OF(SDType, fdParams.cRight),
+        static_assert(sizeof(VkBool32) == sizeof(float));
+        // Constant ids 0-21 were the foveated decode params which are now a per-frame uniform block,
+        // the remaining ids are kept so the precompiled SPIR-V still matches.
+        constexpr static const std::uint32_t FirstConstantID = 22;
+        constexpr static const std::array<std::uint32_t, 5> MemberOffsets {
             offsetof(SDType, enableSRGBLinearize),
             offsetof(SDType, alphaValue),
-            VEC3_OFFSET_OF(SDType, keyColour),
+            offsetof(SDType, keyColour.x),
+            offsetof(SDType, keyColour.y),
+            offsetof(SDType, keyColour.z),
         };
-#undef VEC2_OFFSET_OF
-#undef VEC3_OFFSET_OF
-
-        std::uint32_t memberOffsetPos = 0;
-        SpecializationMap specializationEMap{};
-        specializationEMap.reserve(MemberOffsets.size());
-        if (enableFDParams) {
-            for (; memberOffsetPos < 22u; ++memberOffsetPos) {
-                assert(memberOffsetPos < MemberOffsets.size());
-                specializationEMap.push_back({
-                    .constantID = memberOffsetPos,
-                    .offset = MemberOffsets[memberOffsetPos],
-                    .size = sizeof(float)
-                    });
-            }
-        } else {
-            memberOffsetPos = 22u;
-        }
-
-        const std::uint32_t constID = memberOffsetPos++;
-        assert(memberOffsetPos < MemberOffsets.size());
-        specializationEMap.push_back({
-            .constantID = constID,
-            .offset = MemberOffsets[constID],
-            .size = sizeof(VkBool32)
-        });
 
+        std::size_t memberCount = 1;
         switch (ptMode) {
-            case PassthroughMode::MaskLayer:
-            case PassthroughMode::BlendLayer:
-            {
-                const std::uint32_t constID = memberOffsetPos++;
-                assert(memberOffsetPos < MemberOffsets.size());
-                specializationEMap.push_back({
-                    .constantID = constID,
-                    .offset = MemberOffsets[constID],
-                    .size = sizeof(float)
-                });
-                break;
-            }
+            case PassthroughMode::BlendLayer: memberCount = 2; break;
+            case PassthroughMode::MaskLayer:  memberCount = MemberOffsets.size(); break;
+            default: break;
         }
 
-        if (ptMode == PassthroughMode::MaskLayer) {
-            for (; memberOffsetPos < MemberOffsets.size(); ++memberOffsetPos) {
-                specializationEMap.push_back({
-                    .constantID = memberOffsetPos,
-                    .offset = MemberOffsets[memberOffsetPos],
-                    .size = sizeof(float)
-                });
-            }
+        SpecializationMap specializationEMap{};
+        specializationEMap.reserve(memberCount);
+        for (std::uint32_t memberIdx = 0; memberIdx < memberCount; ++memberIdx) {
+            specializationEMap.push_back({
+                .constantID = FirstConstantID + memberIdx,
+                .offset = MemberOffsets[memberIdx],
+                .size = sizeof(float)
+            });
         }
-
         return specializationEMap;
     }
 
-    void CreateVideoStreamPipeline(const VkSamplerYcbcrConversionCreateInfo& conversionInfo)
+    using PipelineList = std::array<Pipeline, size_t(PassthroughMode::TypeCount)>;
+    // The video pipelines of a swapchain color format. They are built against their own color only render pass,
+    // compatible with the videoRp of every swapchain context of that format, and set the viewport and scissor
+    // dynamically, so any swapchain set (e.g. one reactivated from the swapchain set cache) can be drawn with them.
+    struct VideoStreamPipelines {
+        // Written by the pipeline build worker, only read once build is ready.
+        RenderPass rp{};
+        PipelineList pipelines{};
+        ALXR::PipelineBuildWorker::Future build{};
+    };
+    // swapchain color format, foveated decode.
+    using VideoPipelineKey = std::tuple<VkFormat, bool>;
+    // std::map, entries must not move while their build is pending.
+    using VideoStreamPipelineMap = std::map<VideoPipelineKey, VideoStreamPipelines>;
+
+    // Everything a video pipeline build reads which the render thread may change, copied by value
+    // when the build is queued.
+    struct VideoPipelineBuildParams {
+        VkFormat            colorFmt;
+        std::uint32_t       arraySize;
+        VkExtent2D          size;
+        VideoFragShaderType shaderType;
+        VkBool32            enableSRGBLinearize;
+        float               blendModeAlpha;
+        float               maskModeAlpha;
+        XrVector3f          maskModeKeyColor;
+    };
+
+    VideoPipelineBuildParams MakeVideoPipelineBuildParams(const SwapchainImageContext& swapchainContext, const bool isFoveated) const
     {
-        //ClearVideoTextures();
-        /////////////////////////
-        assert(m_videoStreamLayout.IsNull());
-        m_videoStreamLayout.CreateVideoStreamLayout(conversionInfo, m_vkDevice, m_vkInstance, m_isMultiViewSupported);
-                
-        const auto fovDecodeParamPtr = m_fovDecodeParams;
-        const auto shaderType = fovDecodeParamPtr ?
-            VideoFragShaderType::FoveatedDecode :
-            VideoFragShaderType::Normal;
-
-        CHECK(m_swapchainImageContexts.size() > 0);
-        const auto& swapChainInfo = m_swapchainImageContexts.back();
+        return {
+            .colorFmt            = swapchainContext.videoRp.colorFmt,
+            .arraySize           = swapchainContext.arraySize,
+            .size                = swapchainContext.size,
+            .shaderType          = isFoveated ? VideoFragShaderType::FoveatedDecode : VideoFragShaderType::Normal,
+            .enableSRGBLinearize = m_enableSRGBLinearize,
+            .blendModeAlpha      = m_blendModeAlpha,
+            .maskModeAlpha       = m_maskModeAlpha,
+            .maskModeKeyColor    = m_maskModeKeyColor
+        };
+    }
+
+    // Run on the pipeline build worker, besides the build params only reads the device, the video stream layout and the
+    // video shaders which do not change while a build is pending (see ClearVideoStreamPipelines).
+    void CreateVideoStreamPipelines(VideoStreamPipelines& videoPipelines, const VideoPipelineBuildParams& buildParams) const
+    {
+        assert(!m_videoStreamLayout.IsNull());
+        videoPipelines.rp.Create(m_vkDevice, buildParams.colorFmt, VK_FORMAT_UNDEFINED,
+            buildParams.arraySize, VK_ATTACHMENT_LOAD_OP_DONT_CARE);
+
         std::size_t pipelineIdx = 0;
-        auto& shaderList = m_videoShaders[shaderType];
-        assert(shaderList.size() <= m_videoStreamPipelines.size());
+        const auto& shaderList = m_videoShaders[buildParams.shaderType];
+        assert(shaderList.size() <= videoPipelines.pipelines.size());
         for (std::size_t videoShaderIdx = 0; videoShaderIdx < shaderList.size(); ++videoShaderIdx) {
-            auto& videoShader = shaderList[videoShaderIdx];
-            auto& fragShaderInfo = videoShader.shaderInfo[1];
+            // Copied, the shader programs are shared with the render thread and pSpecializationInfo refers to local stack vars.
+            Pipeline::ShaderStages shaderStages = shaderList[videoShaderIdx].shaderInfo;
 
             const auto passthroughMode = static_cast<PassthroughMode>(videoShaderIdx);
             const SpecializationData specializationConst{
-                .fdParams = fovDecodeParamPtr ? *fovDecodeParamPtr : ALXR::FoveatedDecodeParams{},
-                .enableSRGBLinearize = m_enableSRGBLinearize,
-                .alphaValue = passthroughMode == PassthroughMode::BlendLayer ? m_blendModeAlpha : m_maskModeAlpha,
-                .keyColour  = m_maskModeKeyColor
+                .enableSRGBLinearize = buildParams.enableSRGBLinearize,
+                .alphaValue = passthroughMode == PassthroughMode::BlendLayer ? buildParams.blendModeAlpha : buildParams.maskModeAlpha,
+                .keyColour  = buildParams.maskModeKeyColor
             };
 
-            const auto specializationMap = MakeSpecializationMap(fovDecodeParamPtr != nullptr, passthroughMode);
+            const auto specializationMap = MakeSpecializationMap(passthroughMode);
             assert(!specializationMap.empty());
             const VkSpecializationInfo speicalizationInfo{
                 .mapEntryCount = (std::uint32_t)specializationMap.size(),
@@ -3660,18 +3900,87 @@ struct VulkanGraphicsPlugin : public IGraphicsPlugin {
                 .pData = &specializationConst
             };
 
-            fragShaderInfo.pSpecializationInfo = &speicalizationInfo;
-            m_videoStreamPipelines[pipelineIdx++].Create
+            shaderStages[1].pSpecializationInfo = &speicalizationInfo;
+            auto& pipeline = videoPipelines.pipelines[pipelineIdx++];
+            pipeline.dynamicStateEnables = { VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR };
+            pipeline.Create
             (
                 m_vkDevice,
-                swapChainInfo.size,
+                buildParams.size,
                 m_videoStreamLayout,
-                swapChainInfo.rp,
-                videoShader
+                videoPipelines.rp,
+                shaderStages
             );
-            // null-out pSpecializationInfo as it refers to local stack vars.
-            fragShaderInfo.pSpecializationInfo = nullptr;
         }
+    }
+
+    // Queues a build of every passthrough mode variant of the video pipelines on the pipeline build worker,
+    // once per swapchain format and foveated decode on/off.
+    VideoStreamPipelines& PrecompileVideoStreamPipelines(const SwapchainImageContext& swapchainContext, const bool isFoveated)
+    {
+        const auto [iter, isNewEntry] = m_videoStreamPipelines.try_emplace(VideoPipelineKey{ swapchainContext.videoRp.colorFmt, isFoveated });
+        auto& entry = iter->second;
+        if (isNewEntry) {
+            entry.build = m_pipelineBuildWorker.Submit(isFoveated ? "foveated decode video pipelines" : "video pipelines",
+                [this, &entry, buildParams = MakeVideoPipelineBuildParams(swapchainContext, isFoveated)]() {
+                    CreateVideoStreamPipelines(entry, buildParams);
+                });
+        }
+        return entry;
+    }
+
+    void PrecompileVideoStreamPipelines(const SwapchainImageContext& swapchainContext)
+    {
+        // Both foveated decode variants are reachable by a stream config change, the one in use is queued first.
+        const bool isFoveated = m_fovDecodeParams.has_value();
+        PrecompileVideoStreamPipelines(swapchainContext, isFoveated);
+        PrecompileVideoStreamPipelines(swapchainContext, !isFoveated);
+    }
+
+    const PipelineList& GetVideoStreamPipelines(const SwapchainImageContext& swapchainContext)
+    {
+        const bool isFoveated = m_fovDecodeParams.has_value();
+        auto& entry = PrecompileVideoStreamPipelines(swapchainContext, isFoveated);
+        if (entry.build.valid()) {
+            // Only stalls when the first video frame is drawn before the precompiled variant is done.
+            try {
+                m_pipelineBuildWorker.Wait(std::exchange(entry.build, {}), "video pipelines");
+            } catch (...) {
+                m_videoStreamPipelines.erase(VideoPipelineKey{ swapchainContext.videoRp.colorFmt, isFoveated });
+                throw;
+            }
+        }
+        return entry.pipelines;
+    }
+
+    void ClearVideoStreamPipelines()
+    {
+        // Pending builds refer to their entries and the video stream layout.
+        for (auto& [key, entry] : m_videoStreamPipelines) {
+            if (!entry.build.valid())
+                continue;
+            try {
+                m_pipelineBuildWorker.Wait(std::exchange(entry.build, {}), "video pipelines to clear");
+            } catch (const std::exception& ex) {
+                Log::Write(Log::Level::Warning, Fmt("Discarding failed video pipeline build: %s", ex.what()));
+            }
+        }
+        m_videoStreamPipelines.clear();
+    }
+
+    void CreateVideoStreamPipeline(const VkSamplerYcbcrConversionCreateInfo& conversionInfo)
+    {
+        //ClearVideoTextures();
+        /////////////////////////
+        ClearVideoViewCmdCache();
+        assert(m_videoStreamLayout.IsNull());
+        m_videoStreamLayout.CreateVideoStreamLayout(conversionInfo, m_vkDevice, m_vkInstance, m_isMultiViewSupported);
+
+        ClearVideoStreamPipelines();
+        // Built on the pipeline build worker for every swapchain format in use, including parked swapchain sets,
+        // the first video frame drawn only waits if its variant is not done yet.
+        for (const auto& swapchainContext : m_swapchainImageContexts)
+            PrecompileVideoStreamPipelines(swapchainContext);
         CreateImageDescriptorSets();
     }
 
@@ -3702,9 +4011,16 @@ struct VulkanGraphicsPlugin : public IGraphicsPlugin {
         m_enableSRGBLinearize = enable;
     }
 
+    // Render thread only. Enabling/disabling foveation switches shaders and takes effect when the video
+    // pipelines are next (re)created, a change of params (per frame center shift) is written to the
+    // params uniform buffer by the next rendered frame.
     virtual void SetFoveatedDecode(const ALXR::FoveatedDecodeParams* fovDecParm) override {
-        m_fovDecodeParams = fovDecParm ?
-            std::make_shared<ALXR::FoveatedDecodeParams>(*fovDecParm) : nullptr;
+        if (fovDecParm == nullptr) {
+            m_fovDecodeParams.reset();
+            return;
+        }
+        m_fovDecodeParams = *fovDecParm;
+        m_fovDecodeParamsChanged = true;
     }
 
     virtual void SetCmdBufferWaitNextFrame(const bool enable) override {
@@ -3734,6 +4050,7 @@ struct VulkanGraphicsPlugin : public IGraphicsPlugin {
 #ifdef XR_ENABLE_CUDA_INTEROP
         ClearVideoTexturesCUDA();
 #endif
+        ClearVideoViewCmdCache();
         m_renderTex = std::size_t(-1);
         m_currentVideoTex = 0;
         
@@ -3746,8 +4063,7 @@ struct VulkanGraphicsPlugin : public IGraphicsPlugin {
         textureIdx = std::size_t(-1);
 #endif
         ClearImageDescriptorSets();
-        for (auto& pipeline : m_videoStreamPipelines)
-            pipeline.Clear();
+        ClearVideoStreamPipelines();
         m_videoStreamLayout.Clear();
     }
 
@@ -4342,49 +4658,119 @@ struct VulkanGraphicsPlugin : public IGraphicsPlugin {
 #endif
     }
 
-    virtual void RenderVideoMultiView
+    // ViewID used for multiview keys, no per-view push constant is recorded in this case.
+    constexpr static const std::uint32_t MultiViewID = std::uint32_t(-1);
+
+    inline void RecordVideoViewDraw
     (
-        const std::array<XrCompositionLayerProjectionView, 2>& /*layerViews*/,
-        const XrSwapchainImageBaseHeader* swapchainImage, const std::int64_t /*swapchainFormat*/,
-        const PassthroughMode newMode /*= PassthroughMode::None*/
-    ) override
+        VkCommandBuffer cmdBuffer, const PipelineList& videoPipelines, const VkExtent2D& size,
+        const VkDescriptorSet videoTexDescriptorSet, const std::uint32_t viewID, const PassthroughMode mode
+    ) const
     {
-        assert(m_isMultiViewSupported);
-        RenderViewImpl(swapchainImage, [&, this](const std::uint32_t imageIndex, auto& swapchainContext)
+        vkCmdBindPipeline(cmdBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, videoPipelines[static_cast<std::size_t>(mode)].pipe);
+
+        const VkViewport viewport = Pipeline::MakeViewport(size);
+        const VkRect2D scissor = { {0, 0}, size };
+        vkCmdSetViewport(cmdBuffer, 0, 1, &viewport);
+        vkCmdSetScissor(cmdBuffer, 0, 1, &scissor);
+
+        assert(videoTexDescriptorSet != VK_NULL_HANDLE && m_fovDecodeParamsDescriptorSet != VK_NULL_HANDLE);
+        // The params set only refers to the uniform buffer, pre-recorded draws stay valid when the params change.
+        const std::array<VkDescriptorSet, 2> descriptorSets{ videoTexDescriptorSet, m_fovDecodeParamsDescriptorSet };
+        vkCmdBindDescriptorSets(cmdBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_videoStreamLayout.layout, 0,
+            (std::uint32_t)descriptorSets.size(), descriptorSets.data(), 0, nullptr);
+
+        if (viewID != MultiViewID)
+            vkCmdPushConstants(cmdBuffer, m_videoStreamLayout.layout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(std::uint32_t), &viewID);
+        vkCmdDraw(cmdBuffer, 3, 1, 0, 0);
+    }
+
+    void RenderVideoViewImpl
+    (
+        const std::uint32_t viewID, const XrSwapchainImageBaseHeader* swapchainImage,
+        const PassthroughMode mode
+    )
+    {
+        const float recordTimeMs = time_call_ms<true>([&, this]()
         {
-            const auto& clearValues = VideoClearValues[ClearValueIndex(newMode)];
-            VkRenderPassBeginInfo renderPassBeginInfo{
-                .sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO,
-                .pNext = nullptr,
-                .clearValueCount = (uint32_t)clearValues.size(),
-                .pClearValues = clearValues.data()
-            };
-            // Bind and clear eye render target
-            swapchainContext.BindRenderTarget(imageIndex, /*out*/ renderPassBeginInfo);
+            RenderViewImpl(swapchainImage, [&, this](const std::uint32_t imageIndex, auto& swapchainContext)
+            {
+                // The video view pass is only begun once there is a frame to draw and the fullscreen
+                // triangle overwrites every pixel, so the color attachment is neither cleared nor loaded
+                // and there is no depth attachment to clear or store.
+                // There is no blit/copy path straight into the swapchain image even without passthrough or
+                // foveated decode, the video textures are multi-planar YCbCr which vkCmdBlitImage cannot
+                // convert and the sRGB swapchain formats cannot be written as storage images by a compute pass.
+                VkRenderPassBeginInfo renderPassBeginInfo{
+                    .sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO,
+                    .pNext = nullptr,
+                    .clearValueCount = 0,
+                    .pClearValues = nullptr
+                };
+                swapchainContext.BindVideoRenderTarget(imageIndex, /*out*/ renderPassBeginInfo);
 
 #ifdef XR_USE_PLATFORM_ANDROID
-            constexpr const std::size_t VidTextureIndex = VidTextureIndex::Current;
+                constexpr const std::size_t VidTextureIndex = VidTextureIndex::Current;
 #else
-            if (textureIdx == std::size_t(-1))
-                return;
-            const std::size_t VidTextureIndex = textureIdx;
+                if (textureIdx == std::size_t(-1))
+                    return;
+                const std::size_t VidTextureIndex = textureIdx;
 #endif
-            auto& currentTexture = m_videoTextures[VidTextureIndex];
-            if (currentTexture.texture.texImage == VK_NULL_HANDLE)
-                return;
-            currentTexture.texture.TransitionLayout(m_cmdBuffer, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
-
-            vkCmdBeginRenderPass(m_cmdBuffer.buf, &renderPassBeginInfo, VK_SUBPASS_CONTENTS_INLINE);
+                auto& currentTexture = m_videoTextures[VidTextureIndex];
+                if (currentTexture.texture.texImage == VK_NULL_HANDLE)
+                    return;
+                currentTexture.texture.TransitionLayout(m_cmdBuffer, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
 
-            vkCmdBindPipeline(m_cmdBuffer.buf, VK_PIPELINE_BIND_POINT_GRAPHICS, m_videoStreamPipelines[static_cast<std::size_t>(newMode)].pipe);
+                // The previous frame's command buffer has been waited on, nothing reads the params buffer.
+                if (m_fovDecodeParams.has_value() && std::exchange(m_fovDecodeParamsChanged, false))
+                    m_fovDecodeParamsBuffer.Update(*m_fovDecodeParams);
+                const auto& videoPipelines = GetVideoStreamPipelines(swapchainContext);
 
-            assert(currentTexture.descriptorSet != VK_NULL_HANDLE);
-            vkCmdBindDescriptorSets(m_cmdBuffer.buf, VK_PIPELINE_BIND_POINT_GRAPHICS, m_videoStreamLayout.layout, 0, 1, &currentTexture.descriptorSet, 0, nullptr);
+                if (!m_videoViewCmdCache.IsValid()) {
+                    vkCmdBeginRenderPass(m_cmdBuffer.buf, &renderPassBeginInfo, VK_SUBPASS_CONTENTS_INLINE);
+                    RecordVideoViewDraw(m_cmdBuffer.buf, videoPipelines, swapchainContext.size, currentTexture.descriptorSet, viewID, mode);
+                    vkCmdEndRenderPass(m_cmdBuffer.buf);
+                    return;
+                }
 
-            vkCmdDraw(m_cmdBuffer.buf, 3, 1, 0, 0);
+                const VkCommandBufferInheritanceInfo inheritanceInfo{
+                    .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO,
+                    .pNext = nullptr,
+                    .renderPass = renderPassBeginInfo.renderPass,
+                    .subpass = 0,
+                    .framebuffer = renderPassBeginInfo.framebuffer,
+                    .occlusionQueryEnable = VK_FALSE,
+                    .queryFlags = 0,
+                    .pipelineStatistics = 0
+                };
+                const VideoViewCmdKey key{
+                    .swapchainImage = swapchainImage,
+                    .videoTexIndex = VidTextureIndex,
+                    .passthroughMode = static_cast<std::size_t>(mode),
+                    .viewID = viewID
+                };
+                const VkCommandBuffer videoViewCmdBuffer = m_videoViewCmdCache.GetOrRecord(key, inheritanceInfo,
+                    [&, this](VkCommandBuffer secondaryCmdBuffer) {
+                        RecordVideoViewDraw(secondaryCmdBuffer, videoPipelines, swapchainContext.size, currentTexture.descriptorSet, viewID, mode);
+                    });
 
-            vkCmdEndRenderPass(m_cmdBuffer.buf);
+                vkCmdBeginRenderPass(m_cmdBuffer.buf, &renderPassBeginInfo, VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
+                vkCmdExecuteCommands(m_cmdBuffer.buf, 1, &videoViewCmdBuffer);
+                vkCmdEndRenderPass(m_cmdBuffer.buf);
+            });
         });
+        m_videoRecordStats.Add(recordTimeMs, m_videoViewCmdCache);
+    }
+
+    virtual void RenderVideoMultiView
+    (
+        const std::array<XrCompositionLayerProjectionView, 2>& /*layerViews*/,
+        const XrSwapchainImageBaseHeader* swapchainImage, const std::int64_t /*swapchainFormat*/,
+        const PassthroughMode newMode /*= PassthroughMode::None*/
+    ) override
+    {
+        assert(m_isMultiViewSupported);
+        RenderVideoViewImpl(MultiViewID, swapchainImage, newMode);
     }
 
     virtual void RenderVideoView
@@ -4394,42 +4780,7 @@ struct VulkanGraphicsPlugin : public IGraphicsPlugin {
         const PassthroughMode mode /*= PassthroughMode::None*/
     ) override
     {
-        RenderViewImpl(swapchainImage, [&, this](const std::uint32_t imageIndex, auto& swapchainContext)
-        {
-            const auto& clearValues = VideoClearValues[ClearValueIndex(mode)];
-            VkRenderPassBeginInfo renderPassBeginInfo{
-                .sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO,
-                .pNext = nullptr,
-                .clearValueCount = (uint32_t)clearValues.size(),
-                .pClearValues = clearValues.data()
-            };
-            // Bind and clear eye render target
-            swapchainContext.BindRenderTarget(imageIndex, /*out*/ renderPassBeginInfo);
-
-#ifdef XR_USE_PLATFORM_ANDROID
-            constexpr const std::size_t VidTextureIndex = VidTextureIndex::Current;
-#else
-            if (textureIdx == std::size_t(-1))
-                return;
-            const std::size_t VidTextureIndex = textureIdx;
-#endif
-            auto& currentTexture = m_videoTextures[VidTextureIndex];
-            if (currentTexture.texture.texImage == VK_NULL_HANDLE)
-                return;
-            currentTexture.texture.TransitionLayout(m_cmdBuffer, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
-
-            vkCmdBeginRenderPass(m_cmdBuffer.buf, &renderPassBeginInfo, VK_SUBPASS_CONTENTS_INLINE);
-
-            vkCmdBindPipeline(m_cmdBuffer.buf, VK_PIPELINE_BIND_POINT_GRAPHICS, m_videoStreamPipelines[static_cast<std::size_t>(mode)].pipe);
-
-            assert(currentTexture.descriptorSet != VK_NULL_HANDLE);
-            vkCmdBindDescriptorSets(m_cmdBuffer.buf, VK_PIPELINE_BIND_POINT_GRAPHICS, m_videoStreamLayout.layout, 0, 1, &currentTexture.descriptorSet, 0, nullptr);
-
-            vkCmdPushConstants(m_cmdBuffer.buf, m_videoStreamLayout.layout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(std::uint32_t), &viewID);
-            vkCmdDraw(m_cmdBuffer.buf, 3, 1, 0, 0);
-
-            vkCmdEndRenderPass(m_cmdBuffer.buf);
-        });
+        RenderVideoViewImpl(viewID, swapchainImage, mode);
     }
 
     virtual inline void SetEnvironmentBlendMode(const XrEnvironmentBlendMode newMode) override {
@@ -4443,6 +4794,8 @@ struct VulkanGraphicsPlugin : public IGraphicsPlugin {
     }
     
     virtual ~VulkanGraphicsPlugin() override {
+        m_pipelineBuildWorker.Stop();
+        m_pipelineBuildWorker.LogStats();
         ClearImageDescriptorSets();
         Log::Write(Log::Level::Verbose, "VulkanGraphicsPlugin destroyed.");
     }
@@ -4460,7 +4813,6 @@ struct VulkanGraphicsPlugin : public IGraphicsPlugin {
         .queueIndex = 0,
     };
     std::list<SwapchainImageContext> m_swapchainImageContexts;
-    std::map<const XrSwapchainImageBaseHeader*, SwapchainImageContext*> m_swapchainImageContextMap;
 
     VkInstance m_vkInstance{VK_NULL_HANDLE};
     VkPhysicalDevice m_vkPhysicalDevice{VK_NULL_HANDLE};
@@ -4500,12 +4852,14 @@ struct VulkanGraphicsPlugin : public IGraphicsPlugin {
     VideoShaderMap m_videoShaders {};
     
     PipelineLayout m_videoStreamLayout{};
-    using PipelineList = std::array<Pipeline, size_t(PassthroughMode::TypeCount)>;
-    PipelineList m_videoStreamPipelines{};
+    VideoStreamPipelineMap m_videoStreamPipelines{};
+    ALXR::PipelineBuildWorker m_pipelineBuildWorker{ "VulkanGraphicsPlugin pipeline builder" };
     bool m_enableSRGBLinearize = true;
 
-    using FoveatedDecodeParamsPtr = std::shared_ptr<ALXR::FoveatedDecodeParams>;
-    FoveatedDecodeParamsPtr m_fovDecodeParams{};
+    std::optional<ALXR::FoveatedDecodeParams> m_fovDecodeParams{};
+    bool m_fovDecodeParamsChanged = false;
+    HostUniformBuffer<ALXR::FoveatedDecodeParams> m_fovDecodeParamsBuffer{};
+    VkDescriptorSet m_fovDecodeParamsDescriptorSet{ VK_NULL_HANDLE };
 
     XrVector3f m_maskModeKeyColor = { 0.01f, 0.01f, 0.01f };
     float      m_maskModeAlpha = 0.3f;
@@ -4656,6 +5010,7 @@ struct VulkanGraphicsPlugin : public IGraphicsPlugin {
         assert(m_vkDevice != VK_NULL_HANDLE && m_descriptorPool != VK_NULL_HANDLE);
         assert(m_videoStreamLayout.descriptorSetLayout != VK_NULL_HANDLE);
         assert(vidTex.IsValid());
+        ClearVideoViewCmdCache();
 
         const VkDescriptorSetAllocateInfo allocInfo = {
             .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
@@ -4705,6 +5060,48 @@ struct VulkanGraphicsPlugin : public IGraphicsPlugin {
     VideoTextureQueue m_videoTexQueue{ VideoQueueSize };
 #endif
 
+    struct VideoViewCmdKey {
+        const XrSwapchainImageBaseHeader* swapchainImage = nullptr;
+        std::size_t   videoTexIndex = 0;
+        std::size_t   passthroughMode = 0; // also selects the video stream pipeline.
+        std::uint32_t viewID = MultiViewID;
+
+        constexpr inline auto operator<=>(const VideoViewCmdKey&) const = default;
+    };
+    // Only initialized when video texture descriptor sets are long lived, on android they are re-written per decoded
+    // frame which would invalidate any pre-recorded command buffer referencing them.
+    SecondaryCmdBufferCache<VideoViewCmdKey> m_videoViewCmdCache{};
+
+    void ClearVideoViewCmdCache() {
+        if (m_videoViewCmdCache.cmdBuffers.empty())
+            return;
+        if (m_cmdBuffer.state == CmdBuffer::CmdBufferState::Executing)
+            m_cmdBuffer.Wait();
+        m_videoViewCmdCache.Clear();
+    }
+
+    // CPU time spent recording video view command buffers, periodically logged to compare
+    // the cached (pre-recorded secondary command buffers) vs inline recording paths.
+    struct VideoRecordStats {
+        constexpr static const std::uint32_t LogInterval = 1000;
+        float         totalMs = 0.0f;
+        float         maxMs = 0.0f;
+        std::uint32_t count = 0;
+
+        template < typename CmdCache >
+        void Add(const float recordTimeMs, const CmdCache& cmdCache) {
+            totalMs += recordTimeMs;
+            maxMs = std::max(maxMs, recordTimeMs);
+            if (++count < LogInterval)
+                return;
+            Log::Write(Log::Level::Verbose, Fmt("Video view CPU record time (cmd-buffer cache %s): avg %.4f ms, max %.4f ms over %u views, cache hits: %llu, misses: %llu",
+                cmdCache.IsValid() ? "enabled" : "disabled", totalMs / count, maxMs, count,
+                static_cast<unsigned long long>(cmdCache.hitCount), static_cast<unsigned long long>(cmdCache.missCount)));
+            *this = {};
+        }
+    };
+    VideoRecordStats m_videoRecordStats{};
+
     static_assert(XR_ENVIRONMENT_BLEND_MODE_OPAQUE == 1);
     std::size_t m_clearColorIndex{ (XR_ENVIRONMENT_BLEND_MODE_OPAQUE - 1) };
     
@@ -57,6 +57,7 @@ void XrInputThread::Update(const XrInputThread::StartCtx& ctx) {
 void XrInputThread::Run(const XrInputThread::StartCtx& ctx) {    
     CHECK(ctx.clientCtx);
     CHECK(ctx.programPtr);
+    SetCurrentThreadName("alxr-input");
 
     using namespace std::chrono;
     using namespace std::chrono_literals;
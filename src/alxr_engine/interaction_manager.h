@@ -8,7 +8,6 @@
 #include <algorithm>
 #include <atomic>
 #include <array>
-#include <unordered_map>
 #include <string_view>
 #include <string>
 #include <chrono>
@@ -110,6 +109,11 @@ struct InteractionManager {
         const XrTime& time
     ) const;
 
+    inline XrSpace GetHandSpace(const std::size_t hand) const {
+        assert(hand < Side::COUNT);
+        return m_handSpace[hand];
+    }
+
     void LogActions() const;
 
     using ControllerInfo     = ::TrackingInfo::Controller;
@@ -127,7 +131,7 @@ private:
     void InitSuggestedBindings(IsProfileSupportedFn&& isProfileSupported) const;
 
     using SuggestedBindingList = std::vector<XrActionSuggestedBinding>;
-    SuggestedBindingList MakeSuggestedBindings(const InteractionProfile& profile) const;
+    void MakeSuggestedBindings(const InteractionProfile& profile, SuggestedBindingList& bindings) const;
 
     bool IsClicked(const std::size_t hand, const ALVR_INPUT button, bool& changedSinceLastSync) const;
 
@@ -165,57 +169,119 @@ private:
 
     struct ALVRAction
     {
+        const char* name = nullptr;
+        const char* localizedName = nullptr;
+        XrAction xrAction{ XR_NULL_HANDLE };
+    };
+    // Indexed by ALVR_INPUT, entries without a name have no action of that type.
+    using ALVRActionTable = std::array<ALVRAction, ALVR_INPUT_COUNT>;
+    struct ALVRActionDesc
+    {
+        const ALVR_INPUT  input;
         const char* const name;
         const char* const localizedName;
-        XrAction xrAction{ XR_NULL_HANDLE };
     };
-    using ALVRActionMap = std::unordered_map<ALVR_INPUT, ALVRAction>;
-
-    ALVRActionMap m_boolActionMap =
+    template < const std::size_t N >
+    constexpr static inline ALVRActionTable MakeActionTable(const std::array<ALVRActionDesc, N>& actionDescs) {
+        ALVRActionTable table{};
+        for (const auto& desc : actionDescs)
+            table[desc.input] = { .name = desc.name, .localizedName = desc.localizedName };
+        return table;
+    }
+    ALVRActionTable m_boolActionTable = MakeActionTable(std::to_array<ALVRActionDesc>(
+    {
+        { ALVR_INPUT_SYSTEM_CLICK, "system_click", "System Click" },
+        { ALVR_INPUT_APPLICATION_MENU_CLICK, "appliction_click", "Appliction Click" },
+        { ALVR_INPUT_GRIP_CLICK, "grip_click", "Grip Click" },
+        { ALVR_INPUT_GRIP_TOUCH, "grip_touch", "Grip Touch" },
+        { ALVR_INPUT_A_CLICK, "a_click", "A Click" },
+        { ALVR_INPUT_A_TOUCH, "a_touch", "A Touch" },
+        { ALVR_INPUT_B_CLICK, "b_click", "B Click" },
+        { ALVR_INPUT_B_TOUCH, "b_touch", "B Touch" },
+        { ALVR_INPUT_X_CLICK, "x_click", "X Click" },
+        { ALVR_INPUT_X_TOUCH, "x_touch", "X Touch" },
+        { ALVR_INPUT_Y_CLICK, "y_click", "Y Click" },
+        { ALVR_INPUT_Y_TOUCH, "y_touch", "Y Touch" },
+        { ALVR_INPUT_JOYSTICK_CLICK, "joystick_click", "Joystick Click" },
+        { ALVR_INPUT_JOYSTICK_TOUCH, "joystick_touch", "Joystick Touch" },
+        { ALVR_INPUT_BACK_CLICK, "back_click", "Back Click" },
+        { ALVR_INPUT_TRIGGER_CLICK, "trigger_click", "Trigger Click" },
+        { ALVR_INPUT_TRIGGER_TOUCH, "trigger_touch", "Trigger Touch" },
+        { ALVR_INPUT_TRACKPAD_CLICK, "trackpad_click", "Trackpad Click" },
+        { ALVR_INPUT_TRACKPAD_TOUCH, "trackpad_touch", "Trackpad Touch" },
+        { ALVR_INPUT_THUMB_REST_TOUCH, "thumbrest_touch", "Thumbrest Touch" },
+    }));
+    ALVRActionTable m_scalarActionTable = MakeActionTable(std::to_array<ALVRActionDesc>(
+    {
+        { ALVR_INPUT_GRIP_VALUE,    "grip_value", "Grip Value" },
+        { ALVR_INPUT_JOYSTICK_X,    "joystick_x", "Joystick X" },
+        { ALVR_INPUT_JOYSTICK_Y,    "joystick_y", "Joystick Y" },
+        { ALVR_INPUT_TRIGGER_VALUE, "trigger_value", "Trigger Value" },
+        { ALVR_INPUT_TRACKPAD_X,    "trackpad_x", "Trackpad X" },
+        { ALVR_INPUT_TRACKPAD_Y,    "trackpad_y", "Trackpad Y" },
+    }));
+    ALVRActionTable m_vector2fActionTable = MakeActionTable(std::to_array<ALVRActionDesc>(
+    {
+        { ALVR_INPUT_JOYSTICK_X, "joystick_pos", "Joystick Pos" },
+    }));
+    ALVRActionTable m_scalarToBoolActionTable = MakeActionTable(std::to_array<ALVRActionDesc>(
+    {
+        { ALVR_INPUT_GRIP_CLICK,    "grip_value_to_click", "Grip Value To Click" },
+        { ALVR_INPUT_TRIGGER_CLICK, "trigger_value_to_click", "Trigger Value To Click" },
+    }));
+    ALVRActionTable m_boolToScalarActionTable = MakeActionTable(std::to_array<ALVRActionDesc>(
     {
-        { ALVR_INPUT_SYSTEM_CLICK, { "system_click", "System Click" }},
-        { ALVR_INPUT_APPLICATION_MENU_CLICK, { "appliction_click", "Appliction Click" }},
-        { ALVR_INPUT_GRIP_CLICK, { "grip_click", "Grip Click" }},
-        { ALVR_INPUT_GRIP_TOUCH, { "grip_touch", "Grip Touch" }},
-        { ALVR_INPUT_A_CLICK, { "a_click", "A Click" }},
-        { ALVR_INPUT_A_TOUCH, { "a_touch", "A Touch" }},
-        { ALVR_INPUT_B_CLICK, { "b_click", "B Click" }},
-        { ALVR_INPUT_B_TOUCH, { "b_touch", "B Touch" }},
-        { ALVR_INPUT_X_CLICK, { "x_click", "X Click" }},
-        { ALVR_INPUT_X_TOUCH, { "x_touch", "X Touch" }},
-        { ALVR_INPUT_Y_CLICK, { "y_click", "Y Click" }},
-        { ALVR_INPUT_Y_TOUCH, { "y_touch", "Y Touch" }},
-        { ALVR_INPUT_JOYSTICK_CLICK, { "joystick_click", "Joystick Click" }},
-        { ALVR_INPUT_JOYSTICK_TOUCH, { "joystick_touch", "Joystick Touch" }},
-        { ALVR_INPUT_BACK_CLICK, { "back_click", "Back Click" }},
-        { ALVR_INPUT_TRIGGER_CLICK, { "trigger_click", "Trigger Click" }},
-        { ALVR_INPUT_TRIGGER_TOUCH, { "trigger_touch", "Trigger Touch" }},
-        { ALVR_INPUT_TRACKPAD_CLICK, { "trackpad_click", "Trackpad Click" }},
-        { ALVR_INPUT_TRACKPAD_TOUCH, { "trackpad_touch", "Trackpad Touch" }},
-        { ALVR_INPUT_THUMB_REST_TOUCH, { "thumbrest_touch", "Thumbrest Touch" }},
+        { ALVR_INPUT_GRIP_VALUE, "grip_click_to_value", "Grip Click To Value" },
+    }));
+
+    // Flat list of the actions bound by an interaction profile for one hand,
+    // in the order the action tables were polled in (later types may override earlier values).
+    enum class BoundActionType : std::uint8_t {
+        Boolean, Scalar, Vector2f, BooleanToScalar, ScalarToBoolean
     };
-    ALVRActionMap m_scalarActionMap =
+    struct BoundAction
     {
-        { ALVR_INPUT_GRIP_VALUE,    { "grip_value", "Grip Value" }},
-        { ALVR_INPUT_JOYSTICK_X,    { "joystick_x", "Joystick X" }},
-        { ALVR_INPUT_JOYSTICK_Y,    { "joystick_y", "Joystick Y" }},
-        { ALVR_INPUT_TRIGGER_VALUE, { "trigger_value", "Trigger Value" }},
-        { ALVR_INPUT_TRACKPAD_X,    { "trackpad_x", "Trackpad X" }},
-        { ALVR_INPUT_TRACKPAD_Y,    { "trackpad_y", "Trackpad Y" }},
+        constexpr static const std::uint8_t NoOtherHand = 0xFF;
+
+        XrAction        xrAction;
+        ALVR_INPUT      button;
+        BoundActionType type;
+        // Index of the same action in the other hand's list of the profile, NoOtherHand if only bound for this hand.
+        std::uint8_t    otherHandIdx = NoOtherHand;
     };
-    ALVRActionMap m_vector2fActionMap =
+    struct BoundActionList
     {
-        { ALVR_INPUT_JOYSTICK_X, { "joystick_pos", "Joystick Pos" }},
+        constexpr static const std::size_t Capacity = 5 * std::tuple_size_v<InputMap>;
+        std::array<BoundAction, Capacity> actions;
+        std::size_t count = 0;
     };
-    ALVRActionMap m_scalarToBoolActionMap =
+    // Bit per BoundActionList index.
+    using BoundActionMask = std::uint64_t;
+    static_assert(BoundActionList::Capacity <= sizeof(BoundActionMask) * 8);
+    // Indexed by InteractionProfileMap index, then hand.
+    using ProfileBoundActions = std::array<std::array<BoundActionList, Side::COUNT>, ProfileMapSize>;
+    ProfileBoundActions m_profileBoundActions{};
+    void BuildBoundActions();
+    // Mask of the (left hand) bound actions which are released on both hands.
+    BoundActionMask PollRestingActions(const BoundActionList& leftActions, std::uint64_t& runtimeCalls) const;
+
+    // Last polled boolean action states, re-used by the passthrough button combos instead of querying the runtime again.
+    struct BoolActionState
     {
-        { ALVR_INPUT_GRIP_CLICK,    { "grip_value_to_click", "Grip Value To Click" }, },
-        { ALVR_INPUT_TRIGGER_CLICK, { "trigger_value_to_click", "Trigger Value To Click" } }
+        XrBool32 currentState;
+        XrBool32 changedSinceLastSync;
     };
-    ALVRActionMap m_boolToScalarActionMap =
+    using BoolActionStateList = std::array<BoolActionState, ALVR_INPUT_COUNT>;
+    std::array<BoolActionStateList, Side::COUNT> m_boolActionStates{};
+
+    struct PollStats
     {
-        { ALVR_INPUT_GRIP_VALUE, { "grip_click_to_value", "Grip Click To Value" }}
+        std::uint64_t pollCount = 0;
+        std::uint64_t runtimeCalls = 0;
+        std::uint64_t cpuTimeUs = 0;
     };
+    PollStats m_pollStats{};
+
     XrAction m_poseAction    { XR_NULL_HANDLE };
     XrAction m_vibrateAction { XR_NULL_HANDLE };
     XrAction m_quitAction    { XR_NULL_HANDLE };
@@ -268,11 +334,13 @@ inline void InteractionManager::Clear() {
         xrDestroyActionSet(m_actionSet);
         m_actionSet = XR_NULL_HANDLE;
     }
-    m_boolToScalarActionMap.clear();
-    m_scalarToBoolActionMap.clear();
-    m_vector2fActionMap.clear();
-    m_scalarActionMap.clear();
-    m_boolActionMap.clear();
+    for (auto actionTable : { &m_boolActionTable, &m_scalarActionTable, &m_vector2fActionTable,
+                              &m_boolToScalarActionTable, &m_scalarToBoolActionTable }) {
+        for (auto& alvrAction : *actionTable)
+            alvrAction.xrAction = XR_NULL_HANDLE;
+    }
+    m_profileBoundActions = {};
+    m_boolActionStates = {};
     m_quitAction = XR_NULL_HANDLE;
     m_vibrateAction = XR_NULL_HANDLE;
     m_poseAction = XR_NULL_HANDLE;
@@ -285,10 +353,7 @@ inline void InteractionManager::Clear() {
 }
 
 inline XrPath InteractionManager::GetXrPath(const char* const str) const {
-    XrPath path{ XR_NULL_PATH };
-    CHECK_XRCMD(xrStringToPath(m_instance, str, &path));
-    assert(path != XR_NULL_PATH);
-    return path;
+    return XrPathCache::Instance().Get(m_instance, str);
 }
 
 inline XrPath InteractionManager::GetXrPath(const InteractionProfile& profile) const {
@@ -296,15 +361,11 @@ inline XrPath InteractionManager::GetXrPath(const InteractionProfile& profile) c
 }
 
 inline XrPath InteractionManager::GetXrInputPath(const InteractionProfile& profile, const std::size_t hand, const char* const str) const {
-    using namespace std::string_literals;
-    const auto fullPath = profile.userHandPaths[hand] + "/input/"s + str;
-    return GetXrPath(fullPath.c_str());
+    return XrPathCache::Instance().Get(m_instance, XrPathSpec{ profile.userHandPaths[hand], "input", str });
 }
 
 inline XrPath InteractionManager::GetXrOutputPath(const InteractionProfile& profile, const std::size_t hand, const char* const str) const {
-    using namespace std::string_literals;
-    const auto fullPath = profile.userHandPaths[hand] + "/output/"s + str;
-    return GetXrPath(fullPath.c_str());
+    return XrPathCache::Instance().Get(m_instance, XrPathSpec{ profile.userHandPaths[hand], "output", str });
 }
 
 inline XrPath InteractionManager::GetCurrentProfilePath(const std::size_t hand) const
@@ -351,13 +412,11 @@ inline std::optional<XrSpaceLocation> InteractionManager::GetEyeGazeSpaceLocatio
     return m_eyeGazeInteraction->GetSpaceLocation(baseSpace, time);
 }
 
-inline InteractionManager::SuggestedBindingList
-InteractionManager::MakeSuggestedBindings(const InteractionProfile& profile) const
+inline void InteractionManager::MakeSuggestedBindings(const InteractionProfile& profile, SuggestedBindingList& bindings) const
 {
-    SuggestedBindingList bindings{ XrActionSuggestedBinding
-        {m_poseAction, GetXrInputPath(profile, Side::LEFT,  profile.posePath)},
-        {m_poseAction, GetXrInputPath(profile, Side::RIGHT, profile.posePath)},
-    };
+    bindings.clear();
+    bindings.push_back({ m_poseAction, GetXrInputPath(profile, Side::LEFT,  profile.posePath) });
+    bindings.push_back({ m_poseAction, GetXrInputPath(profile, Side::RIGHT, profile.posePath) });
 
     if (profile.hapticPath) {
         for (const auto hand : { Side::LEFT, Side::RIGHT }) {
@@ -379,19 +438,18 @@ InteractionManager::MakeSuggestedBindings(const InteractionProfile& profile) con
     (
         const std::size_t hand,
         const InputMap& inputMap,
-        const auto& actionMap
+        const ALVRActionTable& actionTable
     )
     {
         for (const auto& buttonMap : inputMap) {
             if (buttonMap == MapEnd)
                 break;
-            const auto action_itr = actionMap.find(buttonMap.button);
-            if (action_itr == actionMap.end()) {
+            const auto& alvrAction = actionTable[buttonMap.button];
+            if (alvrAction.xrAction == XR_NULL_HANDLE) {
                 Log::Write(Log::Level::Warning, Fmt("No action for button %d", buttonMap.button));
                 continue;
             }
             const auto binding = GetXrInputPath(profile, hand, buttonMap.path);
-            const auto& alvrAction = action_itr->second;
             bindings.push_back(XrActionSuggestedBinding{
                 .action = alvrAction.xrAction,
                 .binding = binding
@@ -399,19 +457,21 @@ InteractionManager::MakeSuggestedBindings(const InteractionProfile& profile) con
         }
     };
     for (const auto hand : { Side::LEFT, Side::RIGHT }) {
-        helper(hand, profile.boolMap[hand],         m_boolActionMap);
-        helper(hand, profile.scalarMap[hand],       m_scalarActionMap);
-        helper(hand, profile.vector2fMap[hand],     m_vector2fActionMap);
-        helper(hand, profile.boolToScalarMap[hand], m_boolToScalarActionMap);
-        helper(hand, profile.scalarToBoolMap[hand], m_scalarToBoolActionMap);
+        helper(hand, profile.boolMap[hand],         m_boolActionTable);
+        helper(hand, profile.scalarMap[hand],       m_scalarActionTable);
+        helper(hand, profile.vector2fMap[hand],     m_vector2fActionTable);
+        helper(hand, profile.boolToScalarMap[hand], m_boolToScalarActionTable);
+        helper(hand, profile.scalarToBoolMap[hand], m_scalarToBoolActionTable);
     }
-    return bindings;
 }
 
 template < typename IsProfileSupportedFn >
 inline void InteractionManager::InitSuggestedBindings(IsProfileSupportedFn&& IsProfileSupported) const
 {
     CHECK(m_instance != XR_NULL_HANDLE);
+    // re-used for every profile, no profile binds more than the seed list holds.
+    SuggestedBindingList bindings;
+    bindings.reserve(InteractionPathSpecs.size());
     for (const auto& profile : ALXR::InteractionProfileMap)
     {
         if (!IsProfileSupported(profile)) {
@@ -419,7 +479,7 @@ inline void InteractionManager::InitSuggestedBindings(IsProfileSupportedFn&& IsP
             continue;
         }
         Log::Write(Log::Level::Info, Fmt("Creating suggested bindings for profile: \"%s\"", profile.path));
-        const auto bindings = MakeSuggestedBindings(profile);
+        MakeSuggestedBindings(profile, bindings);
         const XrInteractionProfileSuggestedBinding suggestedBindings{
             .type = XR_TYPE_INTERACTION_PROFILE_SUGGESTED_BINDING,
             .next = nullptr,
@@ -439,6 +499,13 @@ inline void InteractionManager::InitializeActions(IsProfileSupportedFn&& isProfi
     CHECK(m_session  != XR_NULL_HANDLE);
     CHECK(m_instance != XR_NULL_HANDLE);
 
+    auto& pathCache = XrPathCache::Instance();
+    const auto startStats = pathCache.GetStats();
+    std::size_t seededPaths = 0;
+    const float seedTimeMs = time_call_ms<true>([&]() {
+        seededPaths = pathCache.Seed(m_instance, InteractionPathSpecs);
+    });
+
     m_handSubactionPath = {
         GetXrPath("/user/hand/left"),
         GetXrPath("/user/hand/right")
@@ -492,7 +559,7 @@ inline void InteractionManager::InitializeActions(IsProfileSupportedFn&& isProfi
         CHECK(m_quitAction != XR_NULL_HANDLE);
     }
 
-    const auto CreateActions = [&](const XrActionType actType, auto& actionMap)
+    const auto CreateActions = [&](const XrActionType actType, ALVRActionTable& actionTable)
     {
         XrActionCreateInfo actionInfo {
             .type = XR_TYPE_ACTION_CREATE_INFO,
@@ -501,19 +568,22 @@ inline void InteractionManager::InitializeActions(IsProfileSupportedFn&& isProfi
             .countSubactionPaths = uint32_t(m_handSubactionPath.size()),
             .subactionPaths = m_handSubactionPath.data()
         };
-        for (auto& [k, alvrAction] : actionMap)
+        for (auto& alvrAction : actionTable)
         {
+            if (alvrAction.name == nullptr)
+                continue;
             std::strcpy(actionInfo.actionName, alvrAction.name);
             std::strcpy(actionInfo.localizedActionName, alvrAction.localizedName);
             CHECK_XRCMD(xrCreateAction(m_actionSet, &actionInfo, &alvrAction.xrAction));
             CHECK(alvrAction.xrAction != XR_NULL_HANDLE);
         }
     };
-    CreateActions(XR_ACTION_TYPE_BOOLEAN_INPUT,  m_boolActionMap);
-    CreateActions(XR_ACTION_TYPE_FLOAT_INPUT,    m_scalarActionMap);
-    CreateActions(XR_ACTION_TYPE_VECTOR2F_INPUT, m_vector2fActionMap);
-    CreateActions(XR_ACTION_TYPE_BOOLEAN_INPUT,  m_boolToScalarActionMap);
-    CreateActions(XR_ACTION_TYPE_BOOLEAN_INPUT,  m_scalarToBoolActionMap);
+    CreateActions(XR_ACTION_TYPE_BOOLEAN_INPUT,  m_boolActionTable);
+    CreateActions(XR_ACTION_TYPE_FLOAT_INPUT,    m_scalarActionTable);
+    CreateActions(XR_ACTION_TYPE_VECTOR2F_INPUT, m_vector2fActionTable);
+    CreateActions(XR_ACTION_TYPE_BOOLEAN_INPUT,  m_boolToScalarActionTable);
+    CreateActions(XR_ACTION_TYPE_BOOLEAN_INPUT,  m_scalarToBoolActionTable);
+    BuildBoundActions();
 
     XrActionSpaceCreateInfo actionSpaceInfo {
         .type = XR_TYPE_ACTION_SPACE_CREATE_INFO,
@@ -539,7 +609,14 @@ inline void InteractionManager::InitializeActions(IsProfileSupportedFn&& isProfi
         CHECK(m_handSpace[hand] != XR_NULL_HANDLE);
     }
 
-    InitSuggestedBindings(std::forward<IsProfileSupportedFn>(isProfileSupported));
+    const float bindingsTimeMs = time_call_ms<true>([&]() {
+        InitSuggestedBindings(std::forward<IsProfileSupportedFn>(isProfileSupported));
+    });
+    const auto endStats = pathCache.GetStats();
+    Log::Write(Log::Level::Info, Fmt("Interaction paths: seeded %zu new paths in %.3fms (%zu cached), suggested bindings made in %.3fms, %llu path lookups with %llu xrStringToPath calls",
+        seededPaths, seedTimeMs, endStats.size, bindingsTimeMs,
+        static_cast<unsigned long long>(endStats.lookups - startStats.lookups),
+        static_cast<unsigned long long>(endStats.runtimeCalls - startStats.runtimeCalls)));
 
     if (isProfileSupported(ALXR::EyeGazeProfile)) {
         m_eyeGazeInteraction = std::make_unique<ALXR::EyeGazeInteraction>(m_instance, m_session, m_actionSet);
@@ -554,11 +631,98 @@ inline void InteractionManager::InitializeActions(IsProfileSupportedFn&& isProfi
     CHECK_XRCMD(xrAttachSessionActionSets(m_session, &attachInfo));
 }
 
+inline void InteractionManager::BuildBoundActions()
+{
+    for (std::size_t profileIdx = 0; profileIdx < InteractionProfileMap.size(); ++profileIdx) {
+        const auto& profile = InteractionProfileMap[profileIdx];
+        for (const auto hand : { Side::LEFT, Side::RIGHT }) {
+            auto& boundActions = m_profileBoundActions[profileIdx][hand];
+            boundActions.count = 0;
+            const auto addActions = [&](const InputMap& inputMap, const ALVRActionTable& actionTable, const BoundActionType type)
+            {
+                for (const auto& buttonMap : inputMap) {
+                    if (buttonMap == MapEnd)
+                        break;
+                    const auto xrAction = actionTable[buttonMap.button].xrAction;
+                    if (xrAction == XR_NULL_HANDLE)
+                        continue;
+                    assert(boundActions.count < boundActions.actions.size());
+                    boundActions.actions[boundActions.count++] = {
+                        .xrAction = xrAction,
+                        .button = buttonMap.button,
+                        .type = type
+                    };
+                }
+            };
+            addActions(profile.boolMap[hand],         m_boolActionTable,         BoundActionType::Boolean);
+            addActions(profile.scalarMap[hand],       m_scalarActionTable,       BoundActionType::Scalar);
+            addActions(profile.vector2fMap[hand],     m_vector2fActionTable,     BoundActionType::Vector2f);
+            addActions(profile.boolToScalarMap[hand], m_boolToScalarActionTable, BoundActionType::BooleanToScalar);
+            addActions(profile.scalarToBoolMap[hand], m_scalarToBoolActionTable, BoundActionType::ScalarToBoolean);
+        }
+
+        auto& leftActions  = m_profileBoundActions[profileIdx][Side::LEFT];
+        auto& rightActions = m_profileBoundActions[profileIdx][Side::RIGHT];
+        for (std::size_t leftIdx = 0; leftIdx < leftActions.count; ++leftIdx) {
+            auto& leftAction = leftActions.actions[leftIdx];
+            for (std::size_t rightIdx = 0; rightIdx < rightActions.count; ++rightIdx) {
+                auto& rightAction = rightActions.actions[rightIdx];
+                if (rightAction.xrAction != leftAction.xrAction || rightAction.type != leftAction.type)
+                    continue;
+                leftAction.otherHandIdx  = static_cast<std::uint8_t>(rightIdx);
+                rightAction.otherHandIdx = static_cast<std::uint8_t>(leftIdx);
+                break;
+            }
+        }
+    }
+}
+
+inline InteractionManager::BoundActionMask InteractionManager::PollRestingActions
+(
+    const BoundActionList& leftActions,
+    std::uint64_t& runtimeCalls
+) const
+{
+#ifdef ALXR_ENGINE_DISABLE_COMBINED_ACTION_QUERIES
+    (void)leftActions;
+    (void)runtimeCalls;
+    return 0;
+#else
+    // One query without a subaction path reads the combined state of both hands, a boolean action which is
+    // released there is released on both hands and the two per hand queries can be skipped. Only boolean
+    // actions whose sole per hand output is the pressed state qualify, a pressed one costs an extra call.
+    BoundActionMask restingMask = 0;
+    XrActionStateGetInfo getInfo{
+        .type = XR_TYPE_ACTION_STATE_GET_INFO,
+        .next = nullptr,
+        .action = XR_NULL_HANDLE,
+        .subactionPath = XR_NULL_PATH
+    };
+    for (std::size_t actionIdx = 0; actionIdx < leftActions.count; ++actionIdx) {
+        const auto& boundAction = leftActions.actions[actionIdx];
+        if (boundAction.otherHandIdx == BoundAction::NoOtherHand || boundAction.type == BoundActionType::Scalar ||
+            boundAction.type == BoundActionType::Vector2f)
+            continue;
+        getInfo.action = boundAction.xrAction;
+        XrActionStateBoolean boolValue{ .type = XR_TYPE_ACTION_STATE_BOOLEAN, .next = nullptr, .isActive = XR_FALSE };
+        ++runtimeCalls;
+        if (XR_FAILED(xrGetActionStateBoolean(m_session, &getInfo, &boolValue)) ||
+            (boolValue.isActive == XR_TRUE && boolValue.currentState == XR_TRUE))
+            continue;
+        restingMask |= BoundActionMask(1) << actionIdx;
+    }
+    return restingMask;
+#endif
+}
+
 inline void InteractionManager::PollActions(InteractionManager::ControllerInfoList& controllerInfoList)
 {
     if (m_session == XR_NULL_HANDLE)
         return;
 
+    const auto pollStartTime = XrSteadyClock::now();
+    std::uint64_t runtimeCalls = 1; // xrSyncActions
+
     m_handActive = { XR_FALSE, XR_FALSE };
 
     // Sync actions
@@ -582,6 +746,20 @@ inline void InteractionManager::PollActions(InteractionManager::ControllerInfoLi
         m_activeProfiles[Side::RIGHT].load(),
     };
 
+    // Both hands on the same profile, the actions bound for both can be queried for the two hands at once.
+    std::array<BoundActionMask, Side::COUNT> restingActions{ 0, 0 };
+    if (activeProfilePtrs[Side::LEFT] != nullptr && activeProfilePtrs[Side::LEFT] == activeProfilePtrs[Side::RIGHT]) {
+        const auto profileIdx = static_cast<std::size_t>(activeProfilePtrs[Side::LEFT] - InteractionProfileMap.data());
+        if (profileIdx < m_profileBoundActions.size()) {
+            const auto& leftActions = m_profileBoundActions[profileIdx][Side::LEFT];
+            restingActions[Side::LEFT] = PollRestingActions(leftActions, runtimeCalls);
+            for (std::size_t actionIdx = 0; actionIdx < leftActions.count; ++actionIdx) {
+                if ((restingActions[Side::LEFT] & (BoundActionMask(1) << actionIdx)) != 0)
+                    restingActions[Side::RIGHT] |= BoundActionMask(1) << leftActions.actions[actionIdx].otherHandIdx;
+            }
+        }
+    }
+
     for (const auto hand : { Side::LEFT, Side::RIGHT })
     {
         XrActionStateGetInfo getInfo{
@@ -592,6 +770,7 @@ inline void InteractionManager::PollActions(InteractionManager::ControllerInfoLi
         };
         XrActionStatePose poseState{ .type = XR_TYPE_ACTION_STATE_POSE, .next = nullptr, .isActive = XR_FALSE };
         xrGetActionStatePose(m_session, &getInfo, &poseState);
+        ++runtimeCalls;
         m_handActive[hand] = poseState.isActive;
 
         auto& controllerInfo = controllerInfoList[hand];
@@ -601,32 +780,6 @@ inline void InteractionManager::PollActions(InteractionManager::ControllerInfoLi
         const auto activeProfilePtr = activeProfilePtrs[hand];
         if (activeProfilePtr == nullptr)
             continue;
-        const auto forEachButton = [this, &getInfo](/*const*/ auto& actionMap, const ALXR::InputMap& inputMap, auto&& fn) -> void
-        {
-            for (const auto& buttonMap : inputMap) {
-                if (buttonMap == ALXR::MapEnd)
-                    break;
-                const auto actionItr = actionMap.find(buttonMap.button);
-                if (actionItr == actionMap.end())
-                    continue;
-                /*const*/ auto& alvrAction = actionItr->second;
-                if (alvrAction.xrAction == XR_NULL_HANDLE)
-                    continue;
-                getInfo.action = alvrAction.xrAction;
-                fn(buttonMap.button);
-            }
-        };
-        const auto& activeProfile = *activeProfilePtr;
-        forEachButton(m_boolActionMap, activeProfile.boolMap[hand], [&](const ALVR_INPUT button)
-        {
-            XrActionStateBoolean boolValue{ .type = XR_TYPE_ACTION_STATE_BOOLEAN, .next = nullptr, .isActive = XR_FALSE };
-            if (XR_FAILED(xrGetActionStateBoolean(m_session, &getInfo, &boolValue)))
-                return;
-            if (boolValue.isActive == XR_TRUE && boolValue.currentState == XR_TRUE) {
-                controllerInfo.buttons |= ALVR_BUTTON_FLAG(button);
-            }
-        });
-
         constexpr static const auto GetFloatRef = [](ControllerInfo& c, const ALVR_INPUT input) -> float&
         {
             switch (input) {
@@ -645,17 +798,6 @@ inline void InteractionManager::PollActions(InteractionManager::ControllerInfoLi
                 return c.gripValue;
             }
         };
-        forEachButton(m_scalarActionMap, activeProfile.scalarMap[hand], [&](const ALVR_INPUT button)
-        {
-            XrActionStateFloat floatValue{ .type = XR_TYPE_ACTION_STATE_FLOAT, .next = nullptr, .isActive = XR_FALSE };
-            if (XR_FAILED(xrGetActionStateFloat(m_session, &getInfo, &floatValue)) ||
-                floatValue.isActive == XR_FALSE)
-                return;
-            auto& val = GetFloatRef(controllerInfo, button);
-            val = floatValue.currentState;
-            controllerInfo.enabled = true;
-        });
-
         constexpr static const auto GetVector2fRef = [](ControllerInfo& c, const ALVR_INPUT input) -> decltype(ControllerInfo::trackpadPosition)&
         {
             switch (input) {
@@ -667,39 +809,62 @@ inline void InteractionManager::PollActions(InteractionManager::ControllerInfoLi
             default: return c.joystickPosition;
             }
         };
-        forEachButton(m_vector2fActionMap, activeProfile.vector2fMap[hand], [&](const ALVR_INPUT button)
-        {
-            XrActionStateVector2f vec2Value{ .type = XR_TYPE_ACTION_STATE_VECTOR2F, .next = nullptr, .isActive = XR_FALSE };
-            if (XR_FAILED(xrGetActionStateVector2f(m_session, &getInfo, &vec2Value)) ||
-                vec2Value.isActive == XR_FALSE)
-                return;
-            auto& val = GetVector2fRef(controllerInfo, button);
-            val.x = vec2Value.currentState.x;
-            val.y = vec2Value.currentState.y;
-            controllerInfo.enabled = true;
-        });
 
-        forEachButton(m_boolToScalarActionMap, activeProfile.boolToScalarMap[hand], [&](const ALVR_INPUT button)
-        {
-            XrActionStateBoolean boolValue{ .type = XR_TYPE_ACTION_STATE_BOOLEAN, .next = nullptr, .isActive = XR_FALSE };
-            if (XR_FAILED(xrGetActionStateBoolean(m_session, &getInfo, &boolValue)))
-                return;
-            if (boolValue.isActive == XR_TRUE && boolValue.currentState == XR_TRUE) {
-                auto& val = GetFloatRef(controllerInfo, button);
-                val = 1.0f;
+        const auto profileIdx = static_cast<std::size_t>(activeProfilePtr - InteractionProfileMap.data());
+        if (profileIdx >= m_profileBoundActions.size())
+            continue;
+        const auto& boundActions = m_profileBoundActions[profileIdx][hand];
+        auto& boolStates = m_boolActionStates[hand];
+        boolStates = {};
+        for (std::size_t actionIdx = 0; actionIdx < boundActions.count; ++actionIdx) {
+            // released on both hands, the reset state already matches.
+            if ((restingActions[hand] & (BoundActionMask(1) << actionIdx)) != 0)
+                continue;
+            const auto& boundAction = boundActions.actions[actionIdx];
+            const ALVR_INPUT button = boundAction.button;
+            getInfo.action = boundAction.xrAction;
+            ++runtimeCalls;
+            switch (boundAction.type) {
+            case BoundActionType::Boolean:
+            case BoundActionType::ScalarToBoolean: {
+                XrActionStateBoolean boolValue{ .type = XR_TYPE_ACTION_STATE_BOOLEAN, .next = nullptr, .isActive = XR_FALSE };
+                if (XR_FAILED(xrGetActionStateBoolean(m_session, &getInfo, &boolValue)))
+                    break;
+                const XrBool32 isPressed = boolValue.isActive == XR_TRUE && boolValue.currentState == XR_TRUE;
+                if (boundAction.type == BoundActionType::Boolean)
+                    boolStates[button] = { isPressed, boolValue.changedSinceLastSync };
+                if (isPressed)
+                    controllerInfo.buttons |= ALVR_BUTTON_FLAG(button);
+            } break;
+            case BoundActionType::Scalar: {
+                XrActionStateFloat floatValue{ .type = XR_TYPE_ACTION_STATE_FLOAT, .next = nullptr, .isActive = XR_FALSE };
+                if (XR_FAILED(xrGetActionStateFloat(m_session, &getInfo, &floatValue)) ||
+                    floatValue.isActive == XR_FALSE)
+                    break;
+                GetFloatRef(controllerInfo, button) = floatValue.currentState;
                 controllerInfo.enabled = true;
+            } break;
+            case BoundActionType::Vector2f: {
+                XrActionStateVector2f vec2Value{ .type = XR_TYPE_ACTION_STATE_VECTOR2F, .next = nullptr, .isActive = XR_FALSE };
+                if (XR_FAILED(xrGetActionStateVector2f(m_session, &getInfo, &vec2Value)) ||
+                    vec2Value.isActive == XR_FALSE)
+                    break;
+                auto& val = GetVector2fRef(controllerInfo, button);
+                val.x = vec2Value.currentState.x;
+                val.y = vec2Value.currentState.y;
+                controllerInfo.enabled = true;
+            } break;
+            case BoundActionType::BooleanToScalar: {
+                XrActionStateBoolean boolValue{ .type = XR_TYPE_ACTION_STATE_BOOLEAN, .next = nullptr, .isActive = XR_FALSE };
+                if (XR_FAILED(xrGetActionStateBoolean(m_session, &getInfo, &boolValue)))
+                    break;
+                if (boolValue.isActive == XR_TRUE && boolValue.currentState == XR_TRUE) {
+                    GetFloatRef(controllerInfo, button) = 1.0f;
+                    controllerInfo.enabled = true;
+                }
+            } break;
             }
-        });
-
-        forEachButton(m_scalarToBoolActionMap, activeProfile.scalarToBoolMap[hand], [&](const ALVR_INPUT button)
-        {
-            XrActionStateBoolean boolValue{ .type = XR_TYPE_ACTION_STATE_BOOLEAN, .next = nullptr, .isActive = XR_FALSE };
-            if (XR_FAILED(xrGetActionStateBoolean(m_session, &getInfo, &boolValue)))
-                return;
-            if (boolValue.isActive == XR_TRUE && boolValue.currentState == XR_TRUE) {
-                controllerInfo.buttons |= ALVR_BUTTON_FLAG(button);
-            }
-        });
+        }
 
         if (controllerInfo.buttons != 0)
             controllerInfo.enabled = true;
@@ -715,9 +880,21 @@ inline void InteractionManager::PollActions(InteractionManager::ControllerInfoLi
             const auto& activeProfile = *activeProfilePtr;
             PollPassthrougMode(activeProfile);
             PollQuitAction(activeProfile);
-            return;
+            if (activeProfile.quitPath != nullptr && m_quitAction != XR_NULL_HANDLE)
+                ++runtimeCalls;
+            break;
         }
     }
+
+    auto& pollStats = m_pollStats;
+    pollStats.runtimeCalls += runtimeCalls;
+    pollStats.cpuTimeUs += std::chrono::duration_cast<std::chrono::microseconds>(XrSteadyClock::now() - pollStartTime).count();
+    if (++pollStats.pollCount >= 3000) {
+        const double pollCount = static_cast<double>(pollStats.pollCount);
+        Log::Write(Log::Level::Verbose, Fmt("Input polling: %.1f runtime calls/poll, %.1fus/poll",
+            pollStats.runtimeCalls / pollCount, pollStats.cpuTimeUs / pollCount));
+        pollStats = {};
+    }
 }
 
 inline bool InteractionManager::PollQuitAction(const InteractionProfile& activeProfile) {
@@ -774,24 +951,13 @@ constexpr inline void forEachButton(const ALXR::ButtonFlags buttons, Fn&& fn) {
 inline bool InteractionManager::IsClicked(const std::size_t hand, const ALVR_INPUT button, bool& changedSinceLastSync) const
 {
     assert(m_session != XR_NULL_HANDLE);
-    const auto actionItr = m_boolActionMap.find(button);
-    if (actionItr == m_boolActionMap.end())
-        return false;
-    const auto& alvrAction = actionItr->second;
-    if (alvrAction.xrAction == XR_NULL_HANDLE)
+    assert(hand < m_boolActionStates.size() && button < ALVR_INPUT_COUNT);
+    // states are cached by PollActions for the current sync, inactive/unbound actions read as released.
+    const auto& state = m_boolActionStates[hand][button];
+    if (state.currentState == XR_FALSE)
         return false;
-    const XrActionStateGetInfo getInfo{
-        .type = XR_TYPE_ACTION_STATE_GET_INFO,
-        .next = nullptr,
-        .action = alvrAction.xrAction,
-        .subactionPath = m_handSubactionPath[hand]
-    };
-    XrActionStateBoolean value{ .type = XR_TYPE_ACTION_STATE_BOOLEAN, .next = nullptr, .isActive = XR_FALSE };
-    CHECK_XRCMD(xrGetActionStateBoolean(m_session, &getInfo, &value));
-    if (value.isActive == XR_FALSE)
-        return false;
-    changedSinceLastSync = value.changedSinceLastSync;
-    return value.currentState == XR_TRUE;
+    changedSinceLastSync = state.changedSinceLastSync == XR_TRUE;
+    return true;
 };
 
 inline bool InteractionManager::PollPassthrougMode(const InteractionProfile& activeProfile) const
@@ -951,16 +1117,13 @@ inline void InteractionManager::LogActions() const {
     LogActionSourceName(m_quitAction, "Quit");
     LogActionSourceName(m_poseAction, "Pose");
     LogActionSourceName(m_vibrateAction, "Vibrate");
-    for (const auto& [k, v] : m_boolActionMap)
-        LogActionSourceName(v.xrAction, v.localizedName);
-    for (const auto& [k, v] : m_boolToScalarActionMap)
-        LogActionSourceName(v.xrAction, v.localizedName);
-    for (const auto& [k, v] : m_scalarActionMap)
-        LogActionSourceName(v.xrAction, v.localizedName);
-    for (const auto& [k, v] : m_scalarToBoolActionMap)
-        LogActionSourceName(v.xrAction, v.localizedName);
-    for (const auto& [k, v] : m_vector2fActionMap)
-        LogActionSourceName(v.xrAction, v.localizedName);
+    for (const auto actionTable : { &m_boolActionTable, &m_boolToScalarActionTable, &m_scalarActionTable,
+                                    &m_scalarToBoolActionTable, &m_vector2fActionTable }) {
+        for (const auto& alvrAction : *actionTable) {
+            if (alvrAction.xrAction != XR_NULL_HANDLE)
+                LogActionSourceName(alvrAction.xrAction, alvrAction.localizedName);
+        }
+    }
 }
 
 }
@@ -7,6 +7,7 @@
 #include <array>
 #include <optional>
 #include "xrpaths.h"
+#include "xr_path_cache.h"
 #include "ALVR-common/packet_types.h"
 
 namespace ALXR {;
@@ -670,5 +671,54 @@ constexpr inline const std::array<const InteractionProfile, ProfileMapSize> Inte
         .quitPath = nullptr,
     },
 };
+
+// Calls fn with every path used by the suggested bindings of profile.
+template < typename Fn >
+constexpr inline void ForEachProfilePathSpec(const InteractionProfile& profile, Fn&& fn) {
+    fn(XrPathSpec{ .prefix = profile.path });
+    if (profile.userEyesPath != nullptr && profile.eyeGazePosePath != nullptr)
+        fn(XrPathSpec{ profile.userEyesPath, "input", profile.eyeGazePosePath });
+    for (std::size_t hand = 0; hand < HandSize; ++hand) {
+        const char* const handPath = profile.userHandPaths[hand];
+        if (profile.posePath != nullptr)
+            fn(XrPathSpec{ handPath, "input", profile.posePath });
+        if (profile.hapticPath != nullptr)
+            fn(XrPathSpec{ handPath, "output", profile.hapticPath });
+        if (hand == 0 && profile.quitPath != nullptr)
+            fn(XrPathSpec{ handPath, "input", profile.quitPath });
+        for (const auto inputMap : { &profile.boolMap[hand], &profile.scalarMap[hand], &profile.vector2fMap[hand],
+                                     &profile.boolToScalarMap[hand], &profile.scalarToBoolMap[hand] }) {
+            for (const auto& buttonMap : *inputMap) {
+                if (buttonMap == MapEnd)
+                    break;
+                fn(XrPathSpec{ handPath, "input", buttonMap.path });
+            }
+        }
+    }
+}
+
+template < typename Fn >
+constexpr inline void ForEachInteractionPathSpec(Fn&& fn) {
+    for (const auto handPath : UserHandPaths)
+        fn(XrPathSpec{ .prefix = handPath });
+    for (const auto& profile : InteractionProfileMap)
+        ForEachProfilePathSpec(profile, fn);
+    ForEachProfilePathSpec(EyeGazeProfile, fn);
+}
+
+constexpr inline std::size_t CountInteractionPathSpecs() {
+    std::size_t count = 0;
+    ForEachInteractionPathSpec([&count](const XrPathSpec&) { ++count; });
+    return count;
+}
+
+// Every (possibly duplicate) path used by the interaction profiles, used to seed XrPathCache in one pass.
+constexpr inline const auto InteractionPathSpecs = []()
+{
+    std::array<XrPathSpec, CountInteractionPathSpecs()> specs{};
+    std::size_t index = 0;
+    ForEachInteractionPathSpec([&](const XrPathSpec& spec) { specs[index++] = spec; });
+    return specs;
+}();
 }
 #endif
@@ -13,10 +13,8 @@ void LatencyManager::OnTimeSyncRecieved(const TimeSync& timeSync)
     if (timeSync.mode == 1) {
         LatencyCollector::Instance().setTotalLatency(timeSync.serverTotalLatency);
         const std::uint64_t Current = GetSystemTimestampUs();
-        const std::uint64_t RTT = Current - timeSync.clientTime;
-        m_rt_state.timeDiff =
-            ((std::int64_t)timeSync.serverTime + (std::int64_t)RTT / 2) - (std::int64_t)Current;
-        //LOG("TimeSync: server - client = %ld us RTT = %lu us", m_rt_state.timeDiff, RTT);
+        m_clockSync.AddSample(timeSync.clientTime, timeSync.serverTime, Current);
+        //LOG("TimeSync: server - client = %ld us RTT = %lu us", m_clockSync.OffsetAt(Current), Current - timeSync.clientTime);
         if (m_callbackCtx.timeSyncSendFn) {
             TimeSync sendBuf = timeSync;
             sendBuf.mode = 2;
@@ -28,16 +26,23 @@ void LatencyManager::OnTimeSyncRecieved(const TimeSync& timeSync)
         LatencyCollector::Instance().received(timeSync.trackingRecvFrameIndex);
 }
 
+ALXR::ClockSyncEstimate LatencyManager::GetClockSyncEstimate() const
+{
+    return m_clockSync.GetEstimate(GetSystemTimestampUs());
+}
+
 void LatencyManager::OnPreVideoPacketRecieved(const VideoFrame& header)
 {
     if (m_rt_state.lastFrameIndex != header.trackingFrameIndex) {
         LatencyCollector::Instance().receivedFirst(header.trackingFrameIndex);
-        const std::int64_t timeDiff = m_rt_state.timeDiff.load();
-        const auto diff = static_cast<std::int64_t>(header.sentTime) - timeDiff;
         const auto timeStamp = static_cast<std::int64_t>(GetSystemTimestampUs());
+        const std::int64_t timeDiff = m_clockSync.OffsetAt(static_cast<std::uint64_t>(timeStamp));
+        const auto diff = static_cast<std::int64_t>(header.sentTime) - timeDiff;
         const auto offset = diff > timeStamp ?
             0 : ((std::int64_t)header.sentTime - timeDiff - timeStamp);
         LatencyCollector::Instance().estimatedSent(header.trackingFrameIndex, offset);
+        if (diff > 0)
+            ALXR::LatencyStats::Instance().EstimatedSent(header.trackingFrameIndex, static_cast<std::uint64_t>(diff));
         m_rt_state.lastFrameIndex = header.trackingFrameIndex;
     }
     if (const auto lostCount = ProcessVideoSeq(header))
@@ -50,28 +55,33 @@ void LatencyManager::OnPostVideoPacketRecieved
     const LatencyManager::PacketRecievedStatus& status
 )
 {
-    if (status.complete)
+    if (status.complete) {
         LatencyCollector::Instance().receivedLast(header.trackingFrameIndex);
+        ALXR::LatencyStats::Instance().ReceivedLast(header.trackingFrameIndex);
+    }
     if (status.fecFailed) {
         LatencyCollector::Instance().fecFailure();
-        SendPacketLossReport(0, 0);
+        SendVideoErrorReport();
     }
 }
 
 std::int64_t LatencyManager::ProcessVideoSeq(const VideoFrame& header)
 {
-    const auto nextSeq = m_rt_state.prevVideoSequence + 1;
-    const bool isPacketsLost = m_rt_state.prevVideoSequence != 0 && nextSeq != header.packetCounter;
-    m_rt_state.prevVideoSequence = header.packetCounter;
-    return isPacketsLost ?
-        std::abs(static_cast<std::int32_t>(header.packetCounter - nextSeq)) : 0;
+    const auto lostRanges = m_rt_state.videoSeqTracker.Process(header.packetCounter);
+    if (lostRanges.empty())
+        return 0;
+    const auto& counters = m_rt_state.videoSeqTracker.GetCounters();
+    for (const auto& range : lostRanges) {
+        Log::Write(Log::Level::Verbose, Fmt("Video packets lost: [%u, %u], totals - lost: %llu, reordered: %llu, duplicated: %llu, late: %llu",
+            range.from, range.to, counters.lost, counters.reordered, counters.duplicated, counters.late));
+    }
+    return static_cast<std::int64_t>(ALXR::ReportLostRanges(lostRanges, {
+        .videoErrorReportSend = m_callbackCtx.videoErrorReportSendFn,
+        .lostRangeSend = m_callbackCtx.packetLossReportSendFn
+    }));
 }
 
-void LatencyManager::SendPacketLossReport
-(
-    const std::uint32_t /*fromPacketCounter*/,
-    const std::uint32_t /*toPacketCounter*/
-)
+void LatencyManager::SendVideoErrorReport()
 {
     if (m_callbackCtx.videoErrorReportSendFn)
         m_callbackCtx.videoErrorReportSendFn();
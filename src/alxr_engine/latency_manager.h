@@ -3,6 +3,10 @@
 #define ALXR_LATENCY_MANAGER_H
 
 #include "latency_collector.h"
+#include "latency_stats.h"
+#include "frame_accounting.h"
+#include "clock_sync_estimator.h"
+#include "packet_sequence_tracker.h"
 #include <cstdint>
 #include <atomic>
 #include <mutex>
@@ -28,6 +32,9 @@ struct LatencyManager
 	);
 	void OnTimeSyncRecieved(const TimeSync& timeSync);
 
+	// Filtered server - client clock offset (with drift, RTT and confidence) at the current client time.
+	ALXR::ClockSyncEstimate GetClockSyncEstimate() const;
+
 	inline void SubmitAndSync(const std::uint64_t frameIndex, const bool reRenderOnly = false)
 	{
 		if (frameIndex == std::uint64_t(-1))
@@ -41,20 +48,24 @@ struct LatencyManager
 
 	inline void ResetAll() {
 		m_rt_state.isFecFailed = false;
-		m_rt_state.prevVideoSequence = 0;
+		m_rt_state.videoSeqTracker.Reset();
 		m_rt_state.lastFrameIndex = 0;
-		m_rt_state.timeDiff = 0;
+		m_clockSync.Reset();
 		m_timeSyncSequence = uint64_t(-1);
 		LatencyCollector::Instance().resetAll();
+		ALXR::LatencyStats::Instance().Reset();
+		ALXR::FrameAccounting::Instance().Reset();
 	}
 	
 	using SendFn = void (*)(const TrackingInfo* data);
 	using TimeSyncSendFn = void (*)(const TimeSync* data);
 	using VideoErrorReportSendFn = void (*)();
+	using PacketLossReportSendFn = void (*)(std::uint32_t fromPacketCounter, std::uint32_t toPacketCounter);
 	struct CallbackCtx {
-		SendFn					sendFn;
-		TimeSyncSendFn			timeSyncSendFn;
-		VideoErrorReportSendFn	videoErrorReportSendFn;
+		SendFn					sendFn = nullptr;
+		TimeSyncSendFn			timeSyncSendFn = nullptr;
+		VideoErrorReportSendFn	videoErrorReportSendFn = nullptr;
+		PacketLossReportSendFn	packetLossReportSendFn = nullptr;
 	};
 	void Init(const CallbackCtx& ctx)
 	{
@@ -65,11 +76,7 @@ struct LatencyManager
 
 private:
 	std::int64_t ProcessVideoSeq(const VideoFrame& header);
-	void SendPacketLossReport
-	(
-		const std::uint32_t fromPacketCounter,
-		const std::uint32_t toPacketCounter
-	);
+	void SendVideoErrorReport();
 	void SendTimeSync();
 	void SendFrameReRenderTimeSync();
 
@@ -81,12 +88,12 @@ private:
 	std::uint64_t m_timeSyncSequence = uint64_t(-1);
 	struct RecieveThreadState
 	{
-		std::atomic<std::int64_t>  timeDiff{ 0 };
 		std::uint64_t lastFrameIndex = 0;
-		std::uint32_t prevVideoSequence = 0;
+		ALXR::PacketSequenceTracker videoSeqTracker{};
 		std::atomic<bool> isFecFailed{ false };
 	};
 	RecieveThreadState m_rt_state{};
+	ALXR::ClockSyncEstimator m_clockSync{};
 
 	static LatencyManager m_instance;
 };
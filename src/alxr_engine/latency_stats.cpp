@@ -0,0 +1,185 @@
+#include "pch.h"
+#include "latency_stats.h"
+#include "timing.h"
+
+namespace ALXR {
+
+LatencyStats LatencyStats::m_instance{};
+
+void LatencyHistogram::Reset()
+{
+    for (auto& count : m_counts)
+        count.store(0, std::memory_order_relaxed);
+    m_max.store(0, std::memory_order_relaxed);
+}
+
+void RollingLatencyHistogram::AdvanceEpoch(const std::uint64_t epoch)
+{
+    std::uint64_t currEpoch = m_epoch.load(std::memory_order_acquire);
+    while (currEpoch < epoch) {
+        if (!m_epoch.compare_exchange_weak(currEpoch, epoch, std::memory_order_acq_rel))
+            continue;
+        if (epoch - currEpoch == 1) {
+            // window (epoch + 1) holds epoch - 2 which has now fallen out of the query range.
+            m_windows[(epoch + 1) % m_windows.size()].Reset();
+        } else {
+            for (auto& window : m_windows)
+                window.Reset();
+        }
+        return;
+    }
+}
+
+void RollingLatencyHistogram::Record(const std::uint64_t value, const std::uint64_t nowUs)
+{
+    const std::uint64_t epoch = nowUs / WindowDurationUs;
+    if (epoch != m_epoch.load(std::memory_order_relaxed))
+        AdvanceEpoch(epoch);
+    m_windows[epoch % m_windows.size()].Record(value);
+}
+
+void RollingLatencyHistogram::Reset()
+{
+    for (auto& window : m_windows)
+        window.Reset();
+    m_epoch.store(0, std::memory_order_release);
+}
+
+ALXRLatencyPercentiles RollingLatencyHistogram::GetPercentiles(const std::uint64_t nowUs) const
+{
+    ALXRLatencyPercentiles result{};
+    const std::uint64_t epoch = nowUs / WindowDurationUs;
+    if (epoch == 0 || m_epoch.load(std::memory_order_acquire) + 1 < epoch)
+        return result;
+
+    const auto& currWindow = m_windows[epoch % m_windows.size()];
+    const auto& prevWindow = m_windows[(epoch - 1) % m_windows.size()];
+
+    std::array<std::uint64_t, LatencyHistogram::BucketCount> counts;
+    std::uint64_t totalCount = 0;
+    for (std::size_t idx = 0; idx < counts.size(); ++idx) {
+        counts[idx] = std::uint64_t(currWindow.m_counts[idx].load(std::memory_order_relaxed)) +
+                      prevWindow.m_counts[idx].load(std::memory_order_relaxed);
+        totalCount += counts[idx];
+    }
+    if (totalCount == 0)
+        return result;
+
+    result.count = totalCount;
+    result.max = std::max(currWindow.m_max.load(std::memory_order_relaxed), prevWindow.m_max.load(std::memory_order_relaxed));
+
+    constexpr const std::array<double, 4> Quantiles{ 0.5, 0.9, 0.99, 0.999 };
+    std::array<std::uint64_t*, 4> outputs{ &result.p50, &result.p90, &result.p99, &result.p999 };
+    std::size_t quantileIdx = 0;
+    std::uint64_t rank = static_cast<std::uint64_t>(std::ceil(Quantiles[0] * totalCount));
+    std::uint64_t cumulative = 0;
+    for (std::size_t idx = 0; idx < counts.size() && quantileIdx < Quantiles.size(); ++idx) {
+        cumulative += counts[idx];
+        while (quantileIdx < Quantiles.size() && cumulative >= rank) {
+            *outputs[quantileIdx] = std::min(LatencyHistogram::ValueAt(idx), result.max);
+            if (++quantileIdx < Quantiles.size())
+                rank = static_cast<std::uint64_t>(std::ceil(Quantiles[quantileIdx] * totalCount));
+        }
+    }
+    return result;
+}
+
+LatencyStats::FrameTimes& LatencyStats::Acquire(const std::uint64_t frameIndex)
+{
+    constexpr const std::uint32_t IndexBits = std::bit_width(FrameTableSize) - 1;
+    auto& frame = m_frames[(frameIndex * 0x9E3779B97F4A7C15ull) >> (64 - IndexBits)];
+    if (frame.frameIndex.exchange(frameIndex, std::memory_order_acq_rel) != frameIndex) {
+        frame.tracking.store(0, std::memory_order_relaxed);
+        frame.sent.store(0, std::memory_order_relaxed);
+        frame.decoderInput.store(0, std::memory_order_relaxed);
+        frame.decoderOutput.store(0, std::memory_order_relaxed);
+    }
+    return frame;
+}
+
+const LatencyStats::FrameTimes* LatencyStats::Find(const std::uint64_t frameIndex) const
+{
+    constexpr const std::uint32_t IndexBits = std::bit_width(FrameTableSize) - 1;
+    const auto& frame = m_frames[(frameIndex * 0x9E3779B97F4A7C15ull) >> (64 - IndexBits)];
+    return frame.frameIndex.load(std::memory_order_acquire) == frameIndex ? &frame : nullptr;
+}
+
+void LatencyStats::Tracking(const std::uint64_t frameIndex)
+{
+    Acquire(frameIndex).tracking.store(GetSystemTimestampUs(), std::memory_order_relaxed);
+}
+
+void LatencyStats::EstimatedSent(const std::uint64_t frameIndex, const std::uint64_t sentTimeUs)
+{
+    Acquire(frameIndex).sent.store(sentTimeUs, std::memory_order_relaxed);
+}
+
+void LatencyStats::ReceivedLast(const std::uint64_t frameIndex)
+{
+    const auto frame = Find(frameIndex);
+    if (frame == nullptr)
+        return;
+    const std::uint64_t sent = frame->sent.load(std::memory_order_relaxed);
+    const std::uint64_t now = GetSystemTimestampUs();
+    if (sent != 0 && now >= sent)
+        m_transport.Record(now - sent, now);
+}
+
+void LatencyStats::DecoderInput(const std::uint64_t frameIndex)
+{
+    Acquire(frameIndex).decoderInput.store(GetSystemTimestampUs(), std::memory_order_relaxed);
+}
+
+void LatencyStats::DecoderOutput(const std::uint64_t frameIndex)
+{
+    const std::uint64_t now = GetSystemTimestampUs();
+    auto& frame = Acquire(frameIndex);
+    frame.decoderOutput.store(now, std::memory_order_relaxed);
+    const std::uint64_t input = frame.decoderInput.load(std::memory_order_relaxed);
+    if (input != 0 && now >= input)
+        m_decode.Record(now - input, now);
+}
+
+void LatencyStats::Upload(const std::uint64_t durationUs)
+{
+    m_upload.Record(durationUs, GetSystemTimestampUs());
+}
+
+void LatencyStats::Rendered(const std::uint64_t frameIndex)
+{
+    const auto frame = Find(frameIndex);
+    if (frame == nullptr)
+        return;
+    const std::uint64_t now = GetSystemTimestampUs();
+    const std::uint64_t decoded = frame->decoderOutput.load(std::memory_order_relaxed);
+    if (decoded != 0 && now >= decoded)
+        m_renderWait.Record(now - decoded, now);
+    const std::uint64_t tracking = frame->tracking.load(std::memory_order_relaxed);
+    if (tracking != 0 && now >= tracking)
+        m_total.Record(now - tracking, now);
+}
+
+void LatencyStats::GetStats(ALXRLatencyStats& stats) const
+{
+    const std::uint64_t now = GetSystemTimestampUs();
+    stats = {
+        .transport  = m_transport.GetPercentiles(now),
+        .decode     = m_decode.GetPercentiles(now),
+        .upload     = m_upload.GetPercentiles(now),
+        .renderWait = m_renderWait.GetPercentiles(now),
+        .total      = m_total.GetPercentiles(now),
+        .windowDurationUs = RollingLatencyHistogram::WindowDurationUs + (now % RollingLatencyHistogram::WindowDurationUs),
+    };
+}
+
+void LatencyStats::Reset()
+{
+    for (auto& frame : m_frames)
+        frame.frameIndex.store(std::uint64_t(-1), std::memory_order_relaxed);
+    m_transport.Reset();
+    m_decode.Reset();
+    m_upload.Reset();
+    m_renderWait.Reset();
+    m_total.Reset();
+}
+}
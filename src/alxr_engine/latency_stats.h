@@ -0,0 +1,116 @@
+#pragma once
+#ifndef ALXR_LATENCY_STATS_H
+#define ALXR_LATENCY_STATS_H
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <algorithm>
+#include "alxr_ctypes.h"
+
+namespace ALXR {
+
+// Fixed memory, log-linear (HDR style) histogram of microsecond values.
+// Values below SubBucketCount are exact, above that the relative error is bounded by 1/SubBucketCount (~3%).
+// Recording is a single relaxed atomic increment (plus a CAS loop only when a new maximum is seen).
+struct LatencyHistogram {
+    constexpr static const std::uint32_t SubBucketBits  = 5;
+    constexpr static const std::uint64_t SubBucketCount = 1ull << SubBucketBits;
+    constexpr static const std::uint32_t MaxValueBits   = 27; // ~134s
+    constexpr static const std::uint64_t MaxValue       = (1ull << MaxValueBits) - 1;
+    constexpr static const std::size_t   BucketCount    = SubBucketCount * (MaxValueBits - SubBucketBits + 1);
+
+    constexpr static inline std::size_t IndexOf(std::uint64_t value) {
+        value = std::min(value, MaxValue);
+        if (value < SubBucketCount)
+            return static_cast<std::size_t>(value);
+        const std::uint32_t shift = static_cast<std::uint32_t>(std::bit_width(value)) - 1 - SubBucketBits;
+        return static_cast<std::size_t>(SubBucketCount * (shift + 1) + ((value >> shift) - SubBucketCount));
+    }
+
+    // Mid-point of the value range recorded into bucket index.
+    constexpr static inline std::uint64_t ValueAt(const std::size_t index) {
+        if (index < SubBucketCount)
+            return index;
+        const std::uint64_t shift = (index / SubBucketCount) - 1;
+        const std::uint64_t lowest = (SubBucketCount + (index % SubBucketCount)) << shift;
+        return lowest + ((1ull << shift) >> 1);
+    }
+
+    inline void Record(const std::uint64_t value) {
+        m_counts[IndexOf(value)].fetch_add(1, std::memory_order_relaxed);
+        std::uint64_t currMax = m_max.load(std::memory_order_relaxed);
+        while (value > currMax &&
+               !m_max.compare_exchange_weak(currMax, value, std::memory_order_relaxed)) {}
+    }
+
+    void Reset();
+
+    std::array<std::atomic<std::uint32_t>, BucketCount> m_counts{};
+    std::atomic<std::uint64_t> m_max{ 0 };
+};
+static_assert(LatencyHistogram::IndexOf(LatencyHistogram::MaxValue) == LatencyHistogram::BucketCount - 1);
+
+// Histogram over a rolling time window: values are recorded into the current window,
+// queries merge the current and previous windows.
+struct RollingLatencyHistogram {
+    constexpr static const std::uint64_t WindowDurationUs = 5'000'000;
+
+    void Record(const std::uint64_t value, const std::uint64_t nowUs);
+    ALXRLatencyPercentiles GetPercentiles(const std::uint64_t nowUs) const;
+    void Reset();
+
+private:
+    void AdvanceEpoch(const std::uint64_t epoch);
+
+    std::array<LatencyHistogram, 3> m_windows{};
+    std::atomic<std::uint64_t> m_epoch{ 0 };
+};
+
+// Per-stage latency distributions, recorded next to the LatencyCollector hooks.
+// All methods are thread-safe and lock-free.
+struct LatencyStats {
+
+    void Tracking(const std::uint64_t frameIndex);
+    void EstimatedSent(const std::uint64_t frameIndex, const std::uint64_t sentTimeUs);
+    void ReceivedLast(const std::uint64_t frameIndex);
+    void DecoderInput(const std::uint64_t frameIndex);
+    void DecoderOutput(const std::uint64_t frameIndex);
+    void Upload(const std::uint64_t durationUs);
+    void Rendered(const std::uint64_t frameIndex);
+
+    void GetStats(ALXRLatencyStats& stats) const;
+    void Reset();
+
+    static LatencyStats& Instance() { return m_instance; }
+
+private:
+    // Per-frame stage timestamps (system clock, us), frames are addressed
+    // by a hash of their tracking frame index, colliding frames are overwritten.
+    struct FrameTimes {
+        std::atomic<std::uint64_t> frameIndex{ std::uint64_t(-1) };
+        std::atomic<std::uint64_t> tracking{ 0 };
+        std::atomic<std::uint64_t> sent{ 0 };
+        std::atomic<std::uint64_t> decoderInput{ 0 };
+        std::atomic<std::uint64_t> decoderOutput{ 0 };
+    };
+    constexpr static const std::size_t FrameTableSize = 256;
+    static_assert(std::has_single_bit(FrameTableSize));
+
+    FrameTimes& Acquire(const std::uint64_t frameIndex);
+    const FrameTimes* Find(const std::uint64_t frameIndex) const;
+
+    std::array<FrameTimes, FrameTableSize> m_frames{};
+
+    RollingLatencyHistogram m_transport{};
+    RollingLatencyHistogram m_decode{};
+    RollingLatencyHistogram m_upload{};
+    RollingLatencyHistogram m_renderWait{};
+    RollingLatencyHistogram m_total{};
+
+    static LatencyStats m_instance;
+};
+}
+#endif
@@ -61,15 +61,19 @@ inline void defaultOuput(Log::Level severity, const char* output, std::uint32_t
 }
 
 std::atomic<Log::OutputFn> g_outputFn{ defaultOuput };
+thread_local std::uint64_t g_threadWriteCount = 0;
 
 }  // namespace
 
 void SetLevel(Level minSeverity) { g_minSeverity = minSeverity; }
 
+std::uint64_t ThreadWriteCount() { return g_threadWriteCount; }
+
 void Write(Level severity, const std::string& msg) {
     if (severity < g_minSeverity || msg.length() == 0) {
         return;
     }
+    ++g_threadWriteCount;
 
     const auto now = std::chrono::system_clock::now();
     const time_t now_time = std::chrono::system_clock::to_time_t(now);
@@ -14,6 +14,8 @@ enum class Level : std::uint32_t { Verbose, Info, Warning, Error };
 
 void SetLevel(Level minSeverity);
 void Write(Level severity, const std::string& msg);
+// Number of messages written (not filtered out by the level) by the calling thread.
+std::uint64_t ThreadWriteCount();
 
 enum LogOptions : std::uint32_t {
 	None = 0,
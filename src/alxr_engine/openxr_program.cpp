@@ -23,14 +23,14 @@
 #include <numeric>
 #include <span>
 #include <unordered_map>
-#include <map>
+#include <list>
 #include <string_view>
 #include <string>
 #include <ratio>
 #include <chrono>
 #include <algorithm>
 #include <mutex>
-#include <shared_mutex>
+#include <exception>
 #ifdef XR_USE_PLATFORM_ANDROID
     #include <unistd.h>
 #endif
@@ -38,6 +38,9 @@
 #include "vrcft_proxy_server.h"
 
 #include "xr_utils.h"
+#include "xr_locate_spaces.h"
+#include "pose_history.h"
+#include "event_reaction_worker.h"
 #include "concurrent_queue.h"
 //#include "alxr_engine.h"
 #include "alxr_ctypes.h"
@@ -45,9 +48,12 @@
 #include "ALVR-common/packet_types.h"
 #include "timing.h"
 #include "latency_manager.h"
+#include "frame_pacer.h"
+#include "alloc_counter.h"
 #include "interaction_profiles.h"
 #include "interaction_manager.h"
 #include "eye_gaze_interaction.h"
+#include "foveation_gaze.h"
 
 #ifdef XR_USE_PLATFORM_ANDROID
 #ifndef ALXR_ENGINE_DISABLE_QUIT_ACTION
@@ -374,7 +380,7 @@ struct OpenXrProgram final : IOpenXrProgram {
         m_graphicsPlugin = CreateGraphicsPlugin(options, platformPlugin);
         
         if (headlessRequested && IsExtEnabled(XR_MND_HEADLESS_EXTENSION_NAME)) {
-            assert(graphicsApi == "Headless");
+            assert(graphicsApi == "Headless" || graphicsApi == "CpuSink");
             Log::Write(Log::Level::Info, "Headless session selected, no graphics API has been setup.");
         } else {
             Log::Write(Log::Level::Info, Fmt("Selected Graphics API: %s", graphicsApi.c_str()));
@@ -383,6 +389,9 @@ struct OpenXrProgram final : IOpenXrProgram {
 
     virtual ~OpenXrProgram() override {
         Log::Write(Log::Level::Verbose, "Destroying OpenXrProgram");
+
+        // Reactions still being worked on use the session.
+        m_eventReactionWorker.Stop();
         
         if (IsSessionRunning()) {
             xrEndSession(m_session);
@@ -495,6 +504,7 @@ struct OpenXrProgram final : IOpenXrProgram {
         if (m_instance != XR_NULL_HANDLE) {
             Log::Write(Log::Level::Verbose, "Destroying XrInstance");
             xrDestroyInstance(m_instance);
+            ALXR::XrPathCache::Instance().OnInstanceDestroyed(m_instance);
             m_instance = XR_NULL_HANDLE;
         }
 
@@ -517,6 +527,7 @@ struct OpenXrProgram final : IOpenXrProgram {
     ExtensionMap m_availableSupportedExtMap = {
         // KHR extensions
         { XR_KHR_CONVERT_TIMESPEC_TIME_EXTENSION_NAME, false },
+        { XR_KHR_LOCATE_SPACES_EXTENSION_NAME, false },
 #ifdef XR_USE_PLATFORM_WIN32
         { XR_KHR_WIN32_CONVERT_PERFORMANCE_COUNTER_TIME_EXTENSION_NAME, false },
 #endif
@@ -1065,6 +1076,16 @@ struct OpenXrProgram final : IOpenXrProgram {
                 reinterpret_cast<PFN_xrVoidFunction*>(&m_pfnConvertTimeToTimespecTimeKHR)));
         }
 
+        if (IsExtEnabled(XR_KHR_LOCATE_SPACES_EXTENSION_NAME))
+        {
+            if (XR_FAILED(xrGetInstanceProcAddr(m_instance, "xrLocateSpacesKHR",
+                reinterpret_cast<PFN_xrVoidFunction*>(&m_pfnLocateSpacesKHR)))) {
+                m_pfnLocateSpacesKHR = nullptr;
+            }
+            Log::Write(Log::Level::Info, Fmt("%s %s.", XR_KHR_LOCATE_SPACES_EXTENSION_NAME,
+                m_pfnLocateSpacesKHR ? "enabled" : "is enabled but xrLocateSpacesKHR is unavailable"));
+        }
+
         if (IsExtEnabled(XR_FB_COLOR_SPACE_EXTENSION_NAME))
         {
             Log::Write(Log::Level::Info, Fmt("%s enabled.", XR_FB_COLOR_SPACE_EXTENSION_NAME));
@@ -1966,6 +1987,7 @@ struct OpenXrProgram final : IOpenXrProgram {
         CHECK(m_session != XR_NULL_HANDLE);
 #ifdef ALXR_ENGINE_ENABLE_VIZ_SPACES
         constexpr const std::string_view visualizedSpaces[] = { "ViewFront", "Local", "Stage", "StageLeft", "StageRight", "StageLeftRotated", "StageRightRotated" };
+        static_assert(std::size(visualizedSpaces) <= VizCubeList::MaxVisualizedSpaces);
 
         for (const auto& visualizedSpace : visualizedSpaces) {
             XrReferenceSpaceCreateInfo referenceSpaceCreateInfo = GetXrReferenceSpaceCreateInfo(visualizedSpace);
@@ -2024,6 +2046,24 @@ struct OpenXrProgram final : IOpenXrProgram {
         }
     }
 
+    // The image structs of each swapchain, indexed the same as the swapchain list they belong to.
+    using SwapchainImagesList = std::vector<std::vector<XrSwapchainImageBaseHeader*>>;
+
+    struct SwapchainSetKey {
+        std::uint32_t width;
+        std::uint32_t height;
+        std::int64_t  format;
+        std::uint32_t sampleCount;
+        bool          multiView;
+        constexpr inline auto operator<=>(const SwapchainSetKey&) const = default;
+    };
+    struct SwapchainSet {
+        SwapchainSetKey key;
+        std::vector<XrViewConfigurationView> configViews;
+        std::vector<Swapchain> swapchains;
+        SwapchainImagesList swapchainImages;
+    };
+
     void ClearSwapchains()
     {
         m_swapchainImages.clear();
@@ -2034,32 +2074,24 @@ struct OpenXrProgram final : IOpenXrProgram {
             xrDestroySwapchain(swapchain.handle);
         m_swapchains.clear();
         m_configViews.clear();
+        for (const auto& swapchainSet : m_swapchainSetCache) {
+            for (const auto& swapchain : swapchainSet.swapchains)
+                xrDestroySwapchain(swapchain.handle);
+        }
+        m_swapchainSetCache.clear();
     }
 
-    void CreateSwapchains(const std::uint32_t eyeWidth /*= 0*/, const std::uint32_t eyeHeight /*= 0*/) override {
-        CHECK(m_session != XR_NULL_HANDLE);
-
-        if (m_swapchains.size() > 0)
-        {
-            CHECK(m_configViews.size() > 0 && m_swapchainImages.size() > 0);
-            if (eyeWidth == 0 || eyeHeight == 0)
-                return;
-            const bool isSameSize = std::all_of(m_configViews.begin(), m_configViews.end(), [&](const auto& vp)
-            {
-                const auto eW = std::min(eyeWidth,  vp.maxImageRectWidth);
-                const auto eH = std::min(eyeHeight, vp.maxImageRectHeight);
-                return eW == vp.recommendedImageRectWidth && eH == vp.recommendedImageRectHeight;
-            });
-            if (isSameSize)
-                return;
-            Log::Write(Log::Level::Info, "Clearing current swapchains...");
-            ClearSwapchains();
-            Log::Write(Log::Level::Info, "Creating new swapchains...");
+    void DestroySwapchainSet(SwapchainSet& swapchainSet)
+    {
+        for (std::size_t swapchainIndex = 0; swapchainIndex < swapchainSet.swapchains.size(); ++swapchainIndex) {
+            m_graphicsPlugin->ReleaseSwapchainImageStructs(swapchainSet.swapchainImages[swapchainIndex]);
+            xrDestroySwapchain(swapchainSet.swapchains[swapchainIndex].handle);
         }
-        CHECK(m_swapchainImages.empty());
-        CHECK(m_swapchains.empty());
-        //CHECK(m_configViews.empty());
+        swapchainSet.swapchains.clear();
+        swapchainSet.swapchainImages.clear();
+    }
 
+    void LogSystemProperties() const {
         // Read graphics properties for preferred swapchain length and logging.
         XrSystemProperties systemProperties{
             .type = XR_TYPE_SYSTEM_PROPERTIES,
@@ -2077,6 +2109,35 @@ struct OpenXrProgram final : IOpenXrProgram {
         Log::Write(Log::Level::Info, Fmt("System Tracking Properties: OrientationTracking=%s PositionTracking=%s",
                                          systemProperties.trackingProperties.orientationTracking == XR_TRUE ? "True" : "False",
                                          systemProperties.trackingProperties.positionTracking == XR_TRUE ? "True" : "False"));
+    }
+
+    inline bool CanCacheSwapchainSets() const {
+        return MaxCachedSwapchainSets > 0 && m_graphicsPlugin && m_graphicsPlugin->CanReleaseSwapchainImageStructs();
+    }
+
+    void CreateSwapchains(const std::uint32_t eyeWidth /*= 0*/, const std::uint32_t eyeHeight /*= 0*/) override {
+        CHECK(m_session != XR_NULL_HANDLE);
+
+        if (m_swapchains.size() > 0)
+        {
+            CHECK(m_configViews.size() > 0 && m_swapchainImages.size() > 0);
+            if (eyeWidth == 0 || eyeHeight == 0)
+                return;
+            const bool isSameSize = std::all_of(m_configViews.begin(), m_configViews.end(), [&](const auto& vp)
+            {
+                const auto eW = std::min(eyeWidth,  vp.maxImageRectWidth);
+                const auto eH = std::min(eyeHeight, vp.maxImageRectHeight);
+                return eW == vp.recommendedImageRectWidth && eH == vp.recommendedImageRectHeight;
+            });
+            if (isSameSize)
+                return;
+            if (!CanCacheSwapchainSets()) {
+                Log::Write(Log::Level::Info, "Clearing current swapchains...");
+                ClearSwapchains();
+                Log::Write(Log::Level::Info, "Creating new swapchains...");
+            }
+        }
+        const auto startTime = XrSteadyClock::now();
 
         // Note: No other view configurations exist at the time this code was written. If this
         // condition is not met, the project will need to be audited to see how support should be
@@ -2087,16 +2148,16 @@ struct OpenXrProgram final : IOpenXrProgram {
         uint32_t viewCount = 0;
         CHECK_XRCMD(xrEnumerateViewConfigurationViews(m_instance, m_systemId, m_viewConfigType, 0, &viewCount, nullptr));
         CHECK(viewCount >= 2);
-        m_configViews.resize(viewCount, {
+        std::vector<XrViewConfigurationView> configViews(viewCount, {
             .type = XR_TYPE_VIEW_CONFIGURATION_VIEW,
             .next = nullptr
         });
         CHECK_XRCMD(xrEnumerateViewConfigurationViews(m_instance, m_systemId, m_viewConfigType, viewCount, &viewCount,
-                                                      m_configViews.data()));
+                                                      configViews.data()));
 
         // override recommended eye resolution
         if (eyeWidth != 0 && eyeHeight != 0) {
-            for (auto& configView : m_configViews) {
+            for (auto& configView : configViews) {
                 configView.recommendedImageRectWidth  = std::min(eyeWidth, configView.maxImageRectWidth);
                 configView.recommendedImageRectHeight = std::min(eyeHeight, configView.maxImageRectHeight);
             }
@@ -2104,11 +2165,57 @@ struct OpenXrProgram final : IOpenXrProgram {
 
         // Create and cache view buffer for xrLocateViews later.
         m_views.resize(viewCount, ALXR::IdentityView);
-        if (viewCount < 2)
+        if (viewCount < 2 || IsHeadlessSession()) {
+            LogSystemProperties();
+            m_configViews = std::move(configViews);
             return;
+        }
 
-        if (IsHeadlessSession())
-            return;
+        if (m_colorSwapchainFormat > 0) {
+            const SwapchainSetKey key {
+                .width       = configViews[0].recommendedImageRectWidth,
+                .height      = configViews[0].recommendedImageRectHeight,
+                .format      = m_colorSwapchainFormat,
+                .sampleCount = m_graphicsPlugin->GetSupportedSwapchainSampleCount(configViews[0]),
+                .multiView   = m_isMultiViewEnabled
+            };
+            if (m_swapchains.size() > 0) {
+                // park the active set as the most recently used.
+                m_swapchainSetCache.push_front({
+                    .key             = m_activeSwapchainSetKey,
+                    .configViews     = std::move(m_configViews),
+                    .swapchains      = std::move(m_swapchains),
+                    .swapchainImages = std::move(m_swapchainImages)
+                });
+                m_configViews.clear();
+                m_swapchains.clear();
+                m_swapchainImages.clear();
+            }
+
+            const auto cachedSetItr = std::find_if(m_swapchainSetCache.begin(), m_swapchainSetCache.end(),
+                [&key](const SwapchainSet& swapchainSet) { return swapchainSet.key == key; });
+            if (cachedSetItr != m_swapchainSetCache.end()) {
+                m_configViews     = std::move(cachedSetItr->configViews);
+                m_swapchains      = std::move(cachedSetItr->swapchains);
+                m_swapchainImages = std::move(cachedSetItr->swapchainImages);
+                m_activeSwapchainSetKey = key;
+                m_swapchainSetCache.erase(cachedSetItr);
+                const auto elapsed = std::chrono::duration<float, std::milli>(XrSteadyClock::now() - startTime).count();
+                Log::Write(Log::Level::Info, Fmt("Swapchain cache hit, reusing %ux%u swapchain set, took %.3f ms (%u sets cached)",
+                    key.width, key.height, elapsed, static_cast<std::uint32_t>(m_swapchainSetCache.size())));
+                return;
+            }
+
+            while (m_swapchainSetCache.size() > MaxCachedSwapchainSets) {
+                DestroySwapchainSet(m_swapchainSetCache.back());
+                m_swapchainSetCache.pop_back();
+            }
+        }
+        CHECK(m_swapchainImages.empty());
+        CHECK(m_swapchains.empty());
+        m_configViews = std::move(configViews);
+
+        LogSystemProperties();
 
         // Create the swapchain and get the images.
         // 
@@ -2189,7 +2296,7 @@ struct OpenXrProgram final : IOpenXrProgram {
                 m_graphicsPlugin->AllocateSwapchainImageStructs(imageCount, swapchainCreateInfo);
             CHECK_XRCMD(xrEnumerateSwapchainImages(swapchain.handle, imageCount, &imageCount, swapchainImages[0]));
 
-            m_swapchainImages.insert(std::make_pair(swapchain.handle, std::move(swapchainImages)));
+            m_swapchainImages.push_back(std::move(swapchainImages));
         }
         else
         {
@@ -2230,9 +2337,20 @@ struct OpenXrProgram final : IOpenXrProgram {
                     m_graphicsPlugin->AllocateSwapchainImageStructs(imageCount, swapchainCreateInfo);
                 CHECK_XRCMD(xrEnumerateSwapchainImages(swapchain.handle, imageCount, &imageCount, swapchainImages[0]));
 
-                m_swapchainImages.insert(std::make_pair(swapchain.handle, std::move(swapchainImages)));
+                m_swapchainImages.push_back(std::move(swapchainImages));
             }
         }
+
+        m_activeSwapchainSetKey = {
+            .width       = m_configViews[0].recommendedImageRectWidth,
+            .height      = m_configViews[0].recommendedImageRectHeight,
+            .format      = m_colorSwapchainFormat,
+            .sampleCount = m_graphicsPlugin->GetSupportedSwapchainSampleCount(m_configViews[0]),
+            .multiView   = m_isMultiViewEnabled
+        };
+        const auto elapsed = std::chrono::duration<float, std::milli>(XrSteadyClock::now() - startTime).count();
+        Log::Write(Log::Level::Info, Fmt("Swapchain cache miss, created %ux%u swapchain set, took %.3f ms (%u sets cached)",
+            m_activeSwapchainSetKey.width, m_activeSwapchainSetKey.height, elapsed, static_cast<std::uint32_t>(m_swapchainSetCache.size())));
     }
 
     // Return event if one is available, otherwise return null.
@@ -2258,10 +2376,22 @@ struct OpenXrProgram final : IOpenXrProgram {
     void PollEvents(bool* exitRenderLoop, bool* requestRestart) override {
         *exitRenderLoop = *requestRestart = false;
 
+        // Only the frame loop has a budget to keep, the session is not rendering otherwise.
+        const std::uint64_t pollStartUs = GetSteadyTimestampUs();
+        const std::uint64_t budgetUs = m_sessionRunning ? EventPollBudgetUs : std::uint64_t(-1);
+        std::uint32_t eventCount = 0;
+        bool isOverBudget = false;
+        const auto updateStats = MakeScopeGuard([&]() {
+            UpdateEventPollStats(GetSteadyTimestampUs() - pollStartUs, eventCount, isOverBudget);
+        });
+
+        m_eventReactionWorker.ApplyCompleted();
         PollStreamConfigEvents();
 
-        // Process all pending messages.
+        // Process pending messages, at least one per frame, the rest are left queued for the next frames
+        // once the budget is spent.
         while (const XrEventDataBaseHeader* event = TryReadNextEvent()) {
+            ++eventCount;
             switch (event->type) {
                 case XR_TYPE_EVENT_DATA_DISPLAY_REFRESH_RATE_CHANGED_FB: {
                     const auto& refreshRateChangedEvent = *reinterpret_cast<const XrEventDataDisplayRefreshRateChangedFB*>(event);
@@ -2300,16 +2430,42 @@ struct OpenXrProgram final : IOpenXrProgram {
                     Log::Write(Log::Level::Verbose, Fmt("reference space: %d changing", spaceChangedEvent.referenceSpaceType));
                     const auto appRefSpace = ToXrReferenceSpaceType(m_streamConfig.trackingSpaceType);
                     if (spaceChangedEvent.referenceSpaceType == appRefSpace)
-                        enqueueGuardianChanged(spaceChangedEvent.changeTime);
+                        SubmitGuardianChanged(spaceChangedEvent.changeTime);
                 }  break;
                 default: {
                     Log::Write(Log::Level::Verbose, Fmt("Ignoring event type %d", event->type));
                     break;
                 }
             }
+            if (GetSteadyTimestampUs() - pollStartUs >= budgetUs) {
+                isOverBudget = true;
+                break;
+            }
         }
     }
 
+    void UpdateEventPollStats(const std::uint64_t pollTimeUs, const std::uint32_t eventCount, const bool isOverBudget)
+    {
+        auto& stats = m_eventPollStats;
+        ++stats.frameCount;
+        stats.eventCount += eventCount;
+        stats.totalTimeUs += pollTimeUs;
+        stats.maxTimeUs = std::max(stats.maxTimeUs, pollTimeUs);
+        if (isOverBudget)
+            ++stats.overBudgetCount;
+        if (stats.frameCount < EventPollStatsLogInterval)
+            return;
+        Log::Write(Log::Level::Info, Fmt("Event handling over %llu frames: avg %.1fus, max %lluus, %llu events, %llu frames over the %lluus budget, %llu reactions pending",
+            static_cast<unsigned long long>(stats.frameCount),
+            static_cast<double>(stats.totalTimeUs) / stats.frameCount,
+            static_cast<unsigned long long>(stats.maxTimeUs),
+            static_cast<unsigned long long>(stats.eventCount),
+            static_cast<unsigned long long>(stats.overBudgetCount),
+            static_cast<unsigned long long>(EventPollBudgetUs),
+            static_cast<unsigned long long>(m_eventReactionWorker.PendingCount())));
+        stats = {};
+    }
+
     void HandleSessionStateChangedEvent(const XrEventDataSessionStateChanged& stateChangedEvent, bool* exitRenderLoop,
                                         bool* requestRestart) {
         const XrSessionState oldState = m_sessionState;
@@ -2377,15 +2533,17 @@ struct OpenXrProgram final : IOpenXrProgram {
     }
 
     template < typename ControllerInfoArray >
-    void PollHandTrackers(const XrTime time, ControllerInfoArray& controllerInfo)
+    // Returns the number of runtime calls made.
+    std::uint32_t PollHandTrackers(const XrTime time, ControllerInfoArray& controllerInfo)
     {
         if (m_pfnLocateHandJointsEXT == nullptr || time == 0)
-            return;
+            return 0;
 
         const bool isHandOnControllerPose = //IsRuntime(OxrRuntimeType::HTCWave) ||
                                             IsRuntime(OxrRuntimeType::SteamVR) ||
                                             IsRuntime(OxrRuntimeType::WMR) ||
                                             IsRuntime(OxrRuntimeType::MagicLeap);
+        std::uint32_t runtimeCallCount = 0;
         std::array<Eigen::Affine3f, XR_HAND_JOINT_COUNT_EXT> oculusOrientedJointPoses;
         for (const auto hand : { Side::LEFT,Side::RIGHT })
         {
@@ -2419,6 +2577,7 @@ struct OpenXrProgram final : IOpenXrProgram {
                 .baseSpace = m_appSpace,
                 .time = time
             };
+            ++runtimeCallCount;
             if (XR_FAILED(m_pfnLocateHandJointsEXT(handTracker.tracker, &locateInfo, &locations)) ||
                 locations.isActive == XR_FALSE)
                 continue;
@@ -2466,6 +2625,7 @@ struct OpenXrProgram final : IOpenXrProgram {
             controller.linearVelocity  = { 0,0,0 };
             controller.angularVelocity = { 0,0,0 };
         }
+        return runtimeCallCount;
     }
 
     void PollHandTracking(const XrTime& time, ALXRHandTracking& handTrackingData) {
@@ -2573,22 +2733,40 @@ struct OpenXrProgram final : IOpenXrProgram {
         };
     }
 
-    XrSteadyClock::time_point lastFrameTime = XrSteadyClock::now();
-
+    ALXR::FramePacer m_headlessFramePacer{};
     void HeadlessWaitFrame() {
         assert(IsHeadlessSession());
-        static_assert(XrSteadyClock::is_steady);
-        using millisecondsf = std::chrono::duration<float, std::chrono::milliseconds::period>;
-        const auto targetFrameTime = millisecondsf((1.0f / m_streamConfig.renderConfig.refreshRate) * 1000.0f);
-        const auto currTime = XrSteadyClock::now();
-        const auto elapsed = std::chrono::duration_cast<millisecondsf>(currTime - lastFrameTime);
-        if (elapsed > targetFrameTime) {
-            lastFrameTime = currTime;
-            return;
+        m_headlessFramePacer.SetFrameRate(m_streamConfig.renderConfig.refreshRate);
+        m_headlessFramePacer.WaitNext();
+
+        const auto stats = m_headlessFramePacer.GetStats();
+        if (stats.frameCount >= 10'000) {
+            Log::Write(Log::Level::Verbose, Fmt("Headless frame pacer: period=%.3fms, wake up error mean=%.1fus rms=%.1fus max=%.1fus, spin margin=%.1fus, missed deadlines=%llu",
+                std::chrono::duration<double, std::milli>(m_headlessFramePacer.GetPeriod()).count(),
+                stats.meanErrorUs, stats.rmsErrorUs, stats.maxErrorUs, stats.spinMarginUs,
+                static_cast<unsigned long long>(stats.missedDeadlines)));
+            m_headlessFramePacer.ResetStats();
         }
-        const auto sleepTime = targetFrameTime - elapsed;
-        std::this_thread::sleep_for(sleepTime);
-        lastFrameTime = XrSteadyClock::now();
+    }
+
+    // Drives the video frame selection of a CPU video sink plugin the same way RenderFrameImpl
+    // does for a real graphics plugin, minus any OpenXR frame/swapchain calls.
+    void HeadlessVideoSinkFrame() {
+        m_graphicsPlugin->BeginVideoView();
+        const std::uint64_t videoFrameDisplayTime = m_graphicsPlugin->GetVideoFrameIndex();
+        const bool timeRender = videoFrameDisplayTime != std::uint64_t(-1) &&
+                                videoFrameDisplayTime != m_lastVideoFrameIndex;
+        m_lastVideoFrameIndex = videoFrameDisplayTime;
+        if (timeRender) {
+            LatencyCollector::Instance().rendered2(videoFrameDisplayTime);
+            ALXR::LatencyStats::Instance().Rendered(videoFrameDisplayTime);
+        }
+        // the frame index is a monotonic clock timestamp, compare it with the monotonic half of now.
+        const auto [ignore, nowNs] = XrTimeNow();
+        ALXR::FrameAccounting::Instance().Displayed(videoFrameDisplayTime, videoFrameDisplayTime, static_cast<std::uint64_t>(nowNs),
+            static_cast<std::uint64_t>(m_headlessFramePacer.GetPeriod().count()));
+        LatencyManager::Instance().SubmitAndSync(videoFrameDisplayTime, !timeRender);
+        m_graphicsPlugin->EndVideoView();
     }
 
     void RenderFrame() override {
@@ -2597,6 +2775,39 @@ struct OpenXrProgram final : IOpenXrProgram {
             const auto [displayTime,ignore] = XrTimeNow();
             m_lastPredicatedDisplayTime.store(displayTime);
             PollFaceEyeTracking(displayTime);
+            if (m_graphicsPlugin->IsHeadlessVideoSink() && m_renderMode.load() == RenderMode::VideoStream) {
+                UpdateFoveatedDecode(displayTime, {});
+                HeadlessVideoSinkFrame();
+            }
+            return;
+        }
+        if constexpr (ALXR::AllocCounter::Enabled) {
+            const bool isVideoStream = m_renderMode.load() == RenderMode::VideoStream;
+            auto& allocStats = m_frameAllocStats[isVideoStream ? 1 : 0];
+            if (std::exchange(m_frameAllocStatsIsVideoStream, isVideoStream) != isVideoStream)
+                allocStats.Rewarm();
+            const SwapchainSetKey swapchainSetKey = m_activeSwapchainSetKey;
+            allocStats.BeginFrame();
+            RenderFrameImpl();
+            if (m_activeSwapchainSetKey != swapchainSetKey)
+                allocStats.Rewarm();
+            const std::uint64_t steadyFrameAllocs = allocStats.EndFrame();
+            if (steadyFrameAllocs > 0) {
+                Log::Write(Log::Level::Error, Fmt("Render loop heap allocations (%s): %llu allocations in a steady state frame",
+                    isVideoStream ? "VideoStream" : "Lobby", static_cast<unsigned long long>(steadyFrameAllocs)));
+            }
+            // Debug builds stop at the first steady state frame which allocated, see FrameAllocStats.
+            assert(steadyFrameAllocs == 0);
+            if (allocStats.frameCount >= FrameAllocStatsLogInterval) {
+                Log::Write(Log::Level::Info, Fmt("Render loop heap allocations (%s): %llu of %llu frames allocated (%llu in steady state), %llu allocations, max %llu per frame",
+                    isVideoStream ? "VideoStream" : "Lobby",
+                    static_cast<unsigned long long>(allocStats.allocFrameCount),
+                    static_cast<unsigned long long>(allocStats.frameCount),
+                    static_cast<unsigned long long>(allocStats.steadyAllocFrameCount),
+                    static_cast<unsigned long long>(allocStats.allocCount),
+                    static_cast<unsigned long long>(allocStats.maxFrameAllocCount)));
+                allocStats.Reset();
+            }
             return;
         }
         RenderFrameImpl();
@@ -2637,6 +2848,7 @@ struct OpenXrProgram final : IOpenXrProgram {
         
         XrTime predictedDisplayTime;
         const auto predictedViews = GetPredicatedViews(frameState, renderMode, videoFrameDisplayTime, /*out*/ predictedDisplayTime);
+        UpdateFoveatedDecode(frameState.predictedDisplayTime, predictedViews);
 
         constexpr const XrFrameBeginInfo frameBeginInfo{
             .type = XR_TYPE_FRAME_BEGIN_INFO,
@@ -2681,8 +2893,10 @@ struct OpenXrProgram final : IOpenXrProgram {
             }
         }
 
-        if (timeRender)
+        if (timeRender) {
             LatencyCollector::Instance().rendered2(videoFrameDisplayTime);
+            ALXR::LatencyStats::Instance().Rendered(videoFrameDisplayTime);
+        }
 
         const XrFrameEndInfo frameEndInfo{
             .type = XR_TYPE_FRAME_END_INFO,
@@ -2699,6 +2913,11 @@ struct OpenXrProgram final : IOpenXrProgram {
             Log::Write(Log::Level::Verbose, "xrEndFrame failed!");
         }
 
+        if (isVideoStream) {
+            // predictedDisplayTime is the XrTime the pose history recorded for the video frame.
+            ALXR::FrameAccounting::Instance().Displayed(videoFrameDisplayTime, static_cast<std::uint64_t>(predictedDisplayTime),
+                static_cast<std::uint64_t>(frameState.predictedDisplayTime), static_cast<std::uint64_t>(frameState.predictedDisplayPeriod));
+        }
         LatencyManager::Instance().SubmitAndSync(videoFrameDisplayTime, !timeRender);
         if (isVideoStream)
             m_graphicsPlugin->EndVideoView();
@@ -2706,7 +2925,7 @@ struct OpenXrProgram final : IOpenXrProgram {
         if (m_delayOnGuardianChanged)
         {
             m_delayOnGuardianChanged = false;
-            enqueueGuardianChanged();
+            SubmitGuardianChanged(m_lastPredicatedDisplayTime.load());
         }
     }
 
@@ -2742,15 +2961,29 @@ struct OpenXrProgram final : IOpenXrProgram {
         return true;
     }
 
-    using VizCubeList = std::vector<Cube>;
-    VizCubeList GetVisualizedHandCubes(const XrTime predictedDisplayTime) /*const*/ {
+    // Fixed capacity storage for the cubes visualized in a frame, refilled in place every frame.
+    struct VizCubeList {
+        constexpr static const std::size_t MaxVisualizedSpaces = 8;
+        constexpr static const std::size_t Capacity = XR_HAND_JOINT_COUNT_EXT * Side::COUNT + MaxVisualizedSpaces;
 
-        if (m_pfnLocateHandJointsEXT == nullptr || predictedDisplayTime == 0)
-            return {};
+        std::array<Cube, Capacity> cubes;
+        std::size_t size = 0;
 
-        VizCubeList handCubes;
-        handCubes.reserve(XR_HAND_JOINT_COUNT_EXT * 2);
+        inline void clear() { size = 0; }
+        inline void push_back(const Cube& cube) {
+            if (size < Capacity)
+                cubes[size++] = cube;
+        }
+        inline CubeList view() const { return { cubes.data(), size }; }
+    };
+
+    // Appends the joints of the tracked hands, returns true if any hand is tracked.
+    bool GetVisualizedHandCubes(const XrTime predictedDisplayTime, VizCubeList& handCubes) /*const*/ {
+
+        if (m_pfnLocateHandJointsEXT == nullptr || predictedDisplayTime == 0)
+            return false;
 
+        const std::size_t prevSize = handCubes.size;
         for (const auto hand : { Side::LEFT,Side::RIGHT }) {
 
             auto& handTracker = m_input.handTrackers[hand];
@@ -2781,20 +3014,21 @@ struct OpenXrProgram final : IOpenXrProgram {
                 handCubes.push_back(Cube{ newPose, scale });
             }
         }
-        return handCubes;
+        return handCubes.size > prevSize;
     }
 
-    VizCubeList GetVisualizedCubes(const XrTime predictedDisplayTime) /*const*/ {
+    // The returned list is valid until the next call.
+    CubeList GetVisualizedCubes(const XrTime predictedDisplayTime) /*const*/ {
 
+        VizCubeList& cubes = m_vizCubes;
+        cubes.clear();
         if (predictedDisplayTime == 0)
             return {};
 
-        auto cubes = GetVisualizedHandCubes(predictedDisplayTime);
-        const bool hasHandCubes = cubes.size() > 0;
+        const bool hasHandCubes = GetVisualizedHandCubes(predictedDisplayTime, cubes);
 
 #ifdef ALXR_ENGINE_ENABLE_VIZ_SPACES
         // For each locatable space that we want to visualize, render a 25cm cube.
-        cubes.reserve(cubes.size() + m_visualizedSpaces.size() + Side::COUNT);
         for (XrSpace visualizedSpace : m_visualizedSpaces) {
             XrSpaceLocation spaceLocation{ .type = XR_TYPE_SPACE_LOCATION, .next = nullptr };
             XrResult res = xrLocateSpace(visualizedSpace, m_appSpace, predictedDisplayTime, &spaceLocation);
@@ -2811,7 +3045,7 @@ struct OpenXrProgram final : IOpenXrProgram {
         }
 #endif
         if (hasHandCubes)
-            return cubes;
+            return cubes.view();
         constexpr const std::array<const float, Side::COUNT> HandScale = { {1.0f, 1.0f} };
         // Render a 10cm cube scaled by grabAction for each hand. Note renderHand will only be
         // true when the application has focus.
@@ -2822,7 +3056,7 @@ struct OpenXrProgram final : IOpenXrProgram {
                 cubes.push_back(Cube{ spaceLocation.pose, {scale, scale, scale} });
             }
         }
-        return cubes;
+        return cubes.view();
     }
 
     inline bool RenderLayer
@@ -2886,7 +3120,7 @@ struct OpenXrProgram final : IOpenXrProgram {
         assert(m_isMultiViewEnabled);        
 
         const bool isVideoStream = m_renderMode == RenderMode::VideoStream;
-        const auto vizCubes = isVideoStream ? VizCubeList{} : GetVisualizedCubes(predictedDisplayTime);
+        const CubeList vizCubes = isVideoStream ? CubeList{} : GetVisualizedCubes(predictedDisplayTime);
         const auto ptMode = static_cast<const ::PassthroughMode>(mode);
 
         const Swapchain& viewSwapchain = m_swapchains[0];
@@ -2914,7 +3148,7 @@ struct OpenXrProgram final : IOpenXrProgram {
             };
         }
 
-        const XrSwapchainImageBaseHeader* const swapchainImage = m_swapchainImages[viewSwapchain.handle][swapchainImageIndex];
+        const XrSwapchainImageBaseHeader* const swapchainImage = m_swapchainImages[0][swapchainImageIndex];
         if (isVideoStream)
             m_graphicsPlugin->RenderVideoMultiView(projectionLayerViews, swapchainImage, m_colorSwapchainFormat, ptMode);
         else
@@ -2950,7 +3184,7 @@ struct OpenXrProgram final : IOpenXrProgram {
         assert(projectionLayerViews.size() == views.size());
 
         const bool isVideoStream = m_renderMode == RenderMode::VideoStream;
-        const auto vizCubes = isVideoStream ? VizCubeList{} : GetVisualizedCubes(predictedDisplayTime);
+        const CubeList vizCubes = isVideoStream ? CubeList{} : GetVisualizedCubes(predictedDisplayTime);
         const auto ptMode = static_cast<const ::PassthroughMode>(mode);
         // Render view to the appropriate part of the swapchain image.
         for (std::uint32_t i = 0; i < views.size(); ++i) {
@@ -2975,7 +3209,7 @@ struct OpenXrProgram final : IOpenXrProgram {
                     .imageArrayIndex = 0
                 }
             };
-            const XrSwapchainImageBaseHeader* const swapchainImage = m_swapchainImages[viewSwapchain.handle][swapchainImageIndex];
+            const XrSwapchainImageBaseHeader* const swapchainImage = m_swapchainImages[i][swapchainImageIndex];
             if (isVideoStream)
                 m_graphicsPlugin->RenderVideoView(i, projectionLayerViews[i], swapchainImage, m_colorSwapchainFormat, ptMode);
             else
@@ -3173,6 +3407,51 @@ struct OpenXrProgram final : IOpenXrProgram {
         return GetHandSpaceLocation(hand, m_lastPredicatedDisplayTime, initLoc);
     }
 
+    using HandSpaceLocs = std::array<ALXR::SpaceLoc, Side::COUNT>;
+    // Locates the view space at headTime and both hand spaces at handTime, with a single xrLocateSpacesKHR
+    // call when supported and both times are the same. Returns the number of runtime calls made.
+    // A failed xrLocateSpacesKHR call falls back to locating each space with xrLocateSpace.
+    std::uint32_t LocateTrackingSpaces(const XrTime& headTime, const XrTime& handTime, ALXR::SpaceLoc& headLoc, HandSpaceLocs& handLocs)
+    {
+        assert(m_interactionManager != nullptr);
+        headLoc = ALXR::IdentitySpaceLoc;
+        handLocs = { ALXR::IdentitySpaceLoc, ALXR::IdentitySpaceLoc };
+        std::uint32_t runtimeCallCount = 0;
+        if (m_pfnLocateSpacesKHR != nullptr) {
+            const bool isSameTime = headTime == handTime;
+            const std::array<XrSpace, 1 + Side::COUNT> spaces {
+                m_viewSpace,
+                m_interactionManager->GetHandSpace(Side::LEFT),
+                m_interactionManager->GetHandSpace(Side::RIGHT)
+            };
+            std::array<ALXR::SpaceLoc, 1 + Side::COUNT> spaceLocs{ headLoc, handLocs[0], handLocs[1] };
+            const std::size_t firstSpace = isSameTime ? 0 : 1;
+            const XrResult res = ALXR::LocateSpaces(m_pfnLocateSpacesKHR, m_session,
+                std::span{ spaces }.subspan(firstSpace), m_appSpace, handTime, std::span{ spaceLocs }.subspan(firstSpace));
+            if (XR_UNQUALIFIED_SUCCESS(res)) {
+                handLocs = { spaceLocs[1], spaceLocs[2] };
+                if (isSameTime) {
+                    headLoc = spaceLocs[0];
+                    return 1;
+                }
+                headLoc = GetSpaceLocation(m_viewSpace, headTime);
+                return 2;
+            }
+            runtimeCallCount = 1;
+            if (res == XR_ERROR_FUNCTION_UNSUPPORTED || res == XR_ERROR_VALIDATION_FAILURE) {
+                Log::Write(Log::Level::Warning, Fmt("xrLocateSpacesKHR failed with %s, falling back to xrLocateSpace.", to_string(res)));
+                m_pfnLocateSpacesKHR = nullptr;
+            } else if (m_trackingQueryStats.locateSpacesFailureCount++ == 0) {
+                // Possibly transient (e.g. a pending session loss), only this sample falls back.
+                Log::Write(Log::Level::Warning, Fmt("xrLocateSpacesKHR failed with %s, locating this sample with xrLocateSpace.", to_string(res)));
+            }
+        }
+        headLoc = GetSpaceLocation(m_viewSpace, headTime);
+        for (const auto hand : { Side::LEFT, Side::RIGHT })
+            handLocs[hand] = GetHandSpaceLocation(hand, handTime);
+        return runtimeCallCount + 1 + Side::COUNT;
+    }
+
     inline std::array<XrView,2> GetPredicatedViews
     (
         const XrFrameState& frameState, const RenderMode renderMode, const std::uint64_t videoTimeStampNs,
@@ -3188,20 +3467,15 @@ struct OpenXrProgram final : IOpenXrProgram {
         if (renderMode == RenderMode::Lobby)
             return GetDefaultViews();
 
-        std::shared_lock<std::shared_mutex> l(m_trackingFrameMapMutex);
-        if (videoTimeStampNs != std::uint64_t(-1))
-        {
-            const auto trackingFrameItr = m_trackingFrameMap.find(videoTimeStampNs);
-            if (trackingFrameItr != m_trackingFrameMap.cend()) {
-                predicateDisplayTime = trackingFrameItr->second.displayTime;
-                return trackingFrameItr->second.views;
-            }
-        }
-        const auto result = m_trackingFrameMap.rbegin();
-        if (result == m_trackingFrameMap.rend())
+        ALXR::PoseHistory::Sample trackingFrame;
+        if (videoTimeStampNs == std::uint64_t(-1)) {
+            // No video frame yet, nothing is drawn with these views.
+            if (!m_poseHistory.Latest(trackingFrame))
+                return GetDefaultViews();
+        } else if (m_poseHistory.Find(videoTimeStampNs, trackingFrame) == ALXR::PoseHistory::LookupResult::Miss)
             return GetDefaultViews();
-        predicateDisplayTime = result->second.displayTime;
-        return result->second.views;
+        predicateDisplayTime = trackingFrame.displayTime;
+        return trackingFrame.views;
     }
 
     static inline ALXREyeInfo GetEyeInfo(const XrView& left_view, const XrView& right_view)
@@ -3242,6 +3516,12 @@ struct OpenXrProgram final : IOpenXrProgram {
 
     virtual inline bool GetEyeInfo(ALXREyeInfo& eyeInfo) const override
     {
+        // The views last located for tracking are recent enough for the ipd and fovs, saves locating them again.
+        ALXR::PoseHistory::Sample trackingFrame;
+        if (m_poseHistory.Latest(trackingFrame)) {
+            eyeInfo = GetEyeInfo(trackingFrame.views);
+            return true;
+        }
         return GetEyeInfo(eyeInfo, m_lastPredicatedDisplayTime);
     }
 
@@ -3263,42 +3543,83 @@ struct OpenXrProgram final : IOpenXrProgram {
         const auto predicatedDisplayTimeXR = xrTimeStamp + totalLatencyOffsetNs;      
         const auto predicatedDisplayTimeNs = static_cast<std::uint64_t>(timeStampNs + totalLatencyOffsetNs);
 
+        const std::uint64_t queryStartUs = GetSteadyTimestampUs();
+        std::uint32_t runtimeCallCount = 1;
         std::array<XrView, 2> newViews { ALXR::IdentityView, ALXR::IdentityView };
         LocateViews(predicatedDisplayTimeXR, (const std::uint32_t)newViews.size(), newViews.data());
-        {
-            std::unique_lock<std::shared_mutex> lock(m_trackingFrameMapMutex);
-            m_trackingFrameMap[predicatedDisplayTimeNs] = {
-                .views       = newViews,
-                .displayTime = predicatedDisplayTimeXR
-            };
-            if (m_trackingFrameMap.size() > MaxTrackingFrameCount)
-                m_trackingFrameMap.erase(m_trackingFrameMap.begin());
-        }
+        m_poseHistory.Push({
+            .frameIndex  = predicatedDisplayTimeNs,
+            .displayTime = predicatedDisplayTimeXR,
+            .views       = newViews
+        });
         info.targetTimestampNs = predicatedDisplayTimeNs;
-        
-        const auto hmdSpaceLoc = GetSpaceLocation(m_viewSpace, predicatedDisplayTimeXR);
-        info.headPose = ToALXRPosef(hmdSpaceLoc.pose);
-        // info.HeadPose_LinearVelocity    = ToALXRVector3f(hmdSpaceLoc.linearVelocity);
-        // info.HeadPose_AngularVelocity   = ToALXRVector3f(hmdSpaceLoc.angularVelocity);
 
         const auto lastPredicatedDisplayTime = m_lastPredicatedDisplayTime.load();
         const auto& inputPredicatedTime = clientPredict ? predicatedDisplayTimeXR : lastPredicatedDisplayTime;
 
+        ALXR::SpaceLoc hmdSpaceLoc;
+        HandSpaceLocs handSpaceLocs;
+        runtimeCallCount += LocateTrackingSpaces(predicatedDisplayTimeXR, inputPredicatedTime, hmdSpaceLoc, handSpaceLocs);
+        info.headPose = ToALXRPosef(hmdSpaceLoc.pose);
+        // info.HeadPose_LinearVelocity    = ToALXRVector3f(hmdSpaceLoc.linearVelocity);
+        // info.HeadPose_AngularVelocity   = ToALXRVector3f(hmdSpaceLoc.angularVelocity);
+
         for (const auto hand : { Side::LEFT, Side::RIGHT }) {
             auto& newContInfo = info.controller[hand];
-            const auto spaceLoc = GetHandSpaceLocation(hand, inputPredicatedTime);
+            const auto& spaceLoc = handSpaceLocs[hand];
 
             newContInfo.pose            = ToALXRPosef(spaceLoc.pose);
             newContInfo.linearVelocity  = ToALXRVector3f(spaceLoc.linearVelocity);
             newContInfo.angularVelocity = ToALXRVector3f(spaceLoc.angularVelocity);
         }
 
-        PollHandTrackers(inputPredicatedTime, info.controller);
+        runtimeCallCount += PollHandTrackers(inputPredicatedTime, info.controller);
+        UpdateTrackingQueryStats(runtimeCallCount, GetSteadyTimestampUs() - queryStartUs);
 
         LatencyCollector::Instance().tracking(predicatedDisplayTimeNs);
+        ALXR::LatencyStats::Instance().Tracking(predicatedDisplayTimeNs);
         return true;
     }
 
+    virtual bool GetPoseHistoryStats(ALXRPoseHistoryStats& stats) const override
+    {
+        m_poseHistory.GetStats(stats);
+        return true;
+    }
+
+    virtual bool GetFrameAllocStats(const RenderMode renderMode, ALXRFrameAllocStats& stats) const override
+    {
+        if constexpr (!ALXR::AllocCounter::Enabled)
+            return false;
+        const auto& allocStats = m_frameAllocStats[renderMode == RenderMode::VideoStream ? 1 : 0];
+        stats = {
+            .frameCount            = allocStats.frameCount,
+            .allocFrameCount       = allocStats.allocFrameCount,
+            .allocCount            = allocStats.allocCount,
+            .maxFrameAllocCount    = allocStats.maxFrameAllocCount,
+            .steadyAllocFrameCount = allocStats.steadyAllocFrameCount,
+        };
+        return true;
+    }
+
+    void UpdateTrackingQueryStats(const std::uint32_t runtimeCallCount, const std::uint64_t queryTimeUs)
+    {
+        auto& stats = m_trackingQueryStats;
+        ++stats.sampleCount;
+        stats.runtimeCallCount += runtimeCallCount;
+        stats.totalTimeUs += queryTimeUs;
+        stats.maxTimeUs = std::max(stats.maxTimeUs, queryTimeUs);
+        if (stats.sampleCount < TrackingQueryStatsLogInterval)
+            return;
+        Log::Write(Log::Level::Info, Fmt("Tracking queries (%s): %.2f runtime calls per sample, avg %.1fus, max %lluus, %llu failed xrLocateSpacesKHR calls",
+            m_pfnLocateSpacesKHR ? "xrLocateSpacesKHR" : "xrLocateSpace",
+            static_cast<double>(stats.runtimeCallCount) / stats.sampleCount,
+            static_cast<double>(stats.totalTimeUs) / stats.sampleCount,
+            static_cast<unsigned long long>(stats.maxTimeUs),
+            static_cast<unsigned long long>(stats.locateSpacesFailureCount)));
+        stats = {};
+    }
+
     virtual inline void ApplyHapticFeedback(const ALXR::HapticsFeedback& hapticFeedback) override
     {
         assert(m_interactionManager != nullptr);
@@ -3317,6 +3638,64 @@ struct OpenXrProgram final : IOpenXrProgram {
         return true;
     }
 
+    virtual void SetFoveationGazeOptions(const ALXRFoveationGazeOptions& options) override
+    {
+        std::scoped_lock lk(m_foveationGazeMutex);
+        m_foveationGaze.SetOptions(options);
+        Log::Write(Log::Level::Info, Fmt("Gaze driven foveation %s, latency compensation: %.1fms, deadband: %.3f, apply to decode: %s",
+            options.enabled ? "enabled" : "disabled", options.latencyCompensation * 1000.0f, options.deadband,
+            options.applyToDecode ? "true" : "false"));
+    }
+
+    virtual bool GetFoveationGaze(ALXRFoveationGaze& gaze) const override
+    {
+        std::scoped_lock lk(m_foveationGazeMutex);
+        if (!m_foveationGaze.IsEnabled())
+            return false;
+        gaze = m_foveationGaze.GetGaze();
+        return true;
+    }
+
+    virtual void SetFoveationCenterShift(const XrVector2f& centerShift) override
+    {
+        std::scoped_lock lk(m_foveationGazeMutex);
+        m_pendingFoveationCenterShift = centerShift;
+    }
+
+    // Render thread only, changes the foveated decode params of the graphics plugin which only
+    // updates per-frame constants for a new center shift.
+    void UpdateFoveatedDecode(const XrTime& ptime, const std::span<const XrView> views)
+    {
+        std::optional<XrVector2f> newCenterShift{};
+        bool isGazeEnabled = false;
+        {
+            std::scoped_lock lk(m_foveationGazeMutex);
+            if (!m_foveationGaze.GetRenderConfig().enableFoveation) {
+                m_pendingFoveationCenterShift.reset();
+                return;
+            }
+            newCenterShift.swap(m_pendingFoveationCenterShift);
+            isGazeEnabled = m_foveationGaze.IsEnabled() && views.size() >= 2;
+        }
+
+        if (isGazeEnabled) {
+            const auto& eyeGazes = GetEyeGazes(ptime);
+            const ALXR::FoveationGazeTracker::EyeFovs fovs{ views[0].fov, views[1].fov };
+            std::scoped_lock lk(m_foveationGazeMutex);
+            if (m_foveationGaze.Update(ptime, eyeGazes.poses, eyeGazes.isValid, fovs) &&
+                m_foveationGaze.GetOptions().applyToDecode)
+                newCenterShift = m_foveationGaze.GetCenterShift();
+        }
+
+        if (!newCenterShift.has_value())
+            return;
+        const auto fdParams = [&]() {
+            std::scoped_lock lk(m_foveationGazeMutex);
+            return m_foveationGaze.MakeDecodeParams(*newCenterShift);
+        }();
+        m_graphicsPlugin->SetFoveatedDecode(&fdParams);
+    }
+
     static_assert(XR_FACE_CONFIDENCE_COUNT_FB <= XR_FACE_CONFIDENCE2_COUNT_FB);
     std::array<float, XR_FACE_CONFIDENCE2_COUNT_FB> m_confidences {};
 
@@ -3411,18 +3790,40 @@ struct OpenXrProgram final : IOpenXrProgram {
             }
         }
 
+        const auto& eyeGazes = GetEyeGazes(ptime);
+        if (eyeGazes.trackerType != ALXREyeTrackingType::None) {
+            newPacket.eyeTrackerType = eyeGazes.trackerType;
+            for (std::size_t idx = 0; idx < MaxEyeCount; ++idx) {
+                newPacket.isEyeGazePoseValid[idx] = eyeGazes.isValid[idx];
+                if (eyeGazes.isValid[idx]) {
+                    newPacket.eyeGazePoses[idx] = eyeGazes.poses[idx];
+                }
+            }
+        }
+    }
+
+    struct EyeGazes {
+        ALXR::FoveationGazeTracker::EyeGazePoses poses{ ALXR::IdentityPose, ALXR::IdentityPose };
+        ALXR::FoveationGazeTracker::EyeGazeValid isValid{ 0, 0 };
+        ALXREyeTrackingType trackerType = ALXREyeTrackingType::None;
+    };
+    // Eye gaze poses in view space.
+    inline EyeGazes PollEyeGazes(const XrTime& ptime) const
+    {
+        EyeGazes result{};
+        const bool noOptions = m_options == nullptr;
         if (noOptions || m_options->IsSelected(ALXREyeTrackingType::ExtEyeGazeInteraction))
         {
             if (const auto spaceLocOption = m_interactionManager->GetEyeGazeSpaceLocation(m_viewSpace, ptime)) {
                 const auto& spaceLoc = spaceLocOption.value();
                 const bool hasValidPose = Math::Pose::IsPoseValid(spaceLoc);
                 for (std::size_t idx = 0; idx < MaxEyeCount; ++idx) {
-                    newPacket.isEyeGazePoseValid[idx] = hasValidPose;
+                    result.isValid[idx] = hasValidPose;
                     if (hasValidPose) {
-                        newPacket.eyeGazePoses[idx] = spaceLoc.pose;
+                        result.poses[idx] = spaceLoc.pose;
                     }
                 }
-                newPacket.eyeTrackerType = ALXREyeTrackingType::ExtEyeGazeInteraction;
+                result.trackerType = ALXREyeTrackingType::ExtEyeGazeInteraction;
             }
         }
 
@@ -3442,16 +3843,30 @@ struct OpenXrProgram final : IOpenXrProgram {
                 assert(eyeTrackerFB_ != XR_NULL_HANDLE && m_xrGetEyeGazesFB_ != nullptr);
                 m_xrGetEyeGazesFB_(eyeTrackerFB_, &gazesInfo, &eyeGazes);
 
-                newPacket.eyeTrackerType = ALXREyeTrackingType::FBEyeTrackingSocial;
+                result.trackerType = ALXREyeTrackingType::FBEyeTrackingSocial;
                 for (std::size_t idx = 0; idx < MaxEyeCount; ++idx) {
                     const auto& gaze = eyeGazes.gaze[idx];
-                    newPacket.eyeGazePoses[idx] = gaze.gazePose;
-                    newPacket.isEyeGazePoseValid[idx] = static_cast<std::uint8_t>(gaze.isValid);
+                    result.poses[idx] = gaze.gazePose;
+                    result.isValid[idx] = static_cast<std::uint8_t>(gaze.isValid);
                 }
             }
         }
+        return result;
     }
 
+    // Render thread only, the eye gazes are located once per predicted display time and shared by the
+    // face/eye tracking packets and the gaze driven foveation of that frame.
+    const EyeGazes& GetEyeGazes(const XrTime& ptime)
+    {
+        if (ptime != m_eyeGazesTime) {
+            m_eyeGazes = PollEyeGazes(ptime);
+            m_eyeGazesTime = ptime;
+        }
+        return m_eyeGazes;
+    }
+    EyeGazes m_eyeGazes{};
+    XrTime   m_eyeGazesTime = -1;
+
     ALXRFacialEyePacket newFTPacket {
         .expressionType = ALXRFacialExpressionType::None,
         .eyeTrackerType = ALXREyeTrackingType::None,
@@ -3479,33 +3894,63 @@ struct OpenXrProgram final : IOpenXrProgram {
         if (!m_streamConfigQueue.try_pop(newConfig))
             return;
 
-        if (newConfig.trackingSpaceType != m_streamConfig.trackingSpaceType) {
-            const auto IsRefSpaceTypeSupported = [this](const ALXRTrackingSpace ts) {
-                const auto xrSpaceRefType = ToXrReferenceSpaceType(ts);
+        // Compared against the last requested values, configs arriving before a change is applied do not request it again.
+        const auto requestedTrackingSpace = m_pendingTrackingSpaceChanges > 0 ? m_pendingTrackingSpace : m_streamConfig.trackingSpaceType;
+        if (newConfig.trackingSpaceType != requestedTrackingSpace) {
+            // The new app space is created on the event reaction worker and swapped in at the next frame
+            // boundary, the old one is only destroyed after that.
+            const auto newTrackingSpace = newConfig.trackingSpaceType;
+            ++m_pendingTrackingSpaceChanges;
+            m_pendingTrackingSpace = newTrackingSpace;
+            m_eventReactionWorker.Submit("tracking space change", [this, newTrackingSpace]() -> ALXR::EventReactionWorker::ApplyFn {
+                const auto xrSpaceRefType = ToXrReferenceSpaceType(newTrackingSpace);
                 const auto availSpaces = GetAvailableReferenceSpaces();
-                return std::find(availSpaces.begin(), availSpaces.end(), xrSpaceRefType) != availSpaces.end();
-            };
-            if (IsRefSpaceTypeSupported(newConfig.trackingSpaceType)) {
-                if (m_appSpace != XR_NULL_HANDLE) {
-                    xrDestroySpace(m_appSpace);
-                    m_appSpace = XR_NULL_HANDLE;
+                if (std::find(availSpaces.begin(), availSpaces.end(), xrSpaceRefType) == availSpaces.end()) {
+                    Log::Write(Log::Level::Warning, Fmt("Tracking space %s is not supported, tracking space is not changed.", ToTrackingSpaceName(newTrackingSpace)));
+                    return [this]() { OnTrackingSpaceChangeDone(); };
                 }
-                const auto oldTrackingSpaceName = ToTrackingSpaceName(m_streamConfig.trackingSpaceType);
-                const auto newTrackingSpaceName = ToTrackingSpaceName(newConfig.trackingSpaceType);
-                Log::Write(Log::Level::Info, Fmt("Changing tracking space from %s to %s", oldTrackingSpaceName, newTrackingSpaceName));
-                const auto referenceSpaceCreateInfo = GetXrReferenceSpaceCreateInfo(newTrackingSpaceName);
-                CHECK_XRCMD(xrCreateReferenceSpace(m_session, &referenceSpaceCreateInfo, &m_appSpace));
-
-                m_streamConfig.trackingSpaceType = newConfig.trackingSpaceType;
-            }
-            else {
-                Log::Write(Log::Level::Warning, Fmt("Tracking space %s is not supported, tracking space is not changed.", ToTrackingSpaceName(newConfig.trackingSpaceType)));
-            }
+                const auto referenceSpaceCreateInfo = GetXrReferenceSpaceCreateInfo(newTrackingSpace);
+                XrSpace newAppSpace = XR_NULL_HANDLE;
+                try {
+                    CHECK_XRCMD(xrCreateReferenceSpace(m_session, &referenceSpaceCreateInfo, &newAppSpace));
+                } catch (...) {
+                    // still rethrown on the render thread, after the change is no longer pending.
+                    return [this, error = std::current_exception()]() {
+                        OnTrackingSpaceChangeDone();
+                        std::rethrow_exception(error);
+                    };
+                }
+                return [this, newTrackingSpace, newAppSpace]() {
+                    Log::Write(Log::Level::Info, Fmt("Changing tracking space from %s to %s",
+                        ToTrackingSpaceName(m_streamConfig.trackingSpaceType), ToTrackingSpaceName(newTrackingSpace)));
+                    const XrSpace oldAppSpace = std::exchange(m_appSpace, newAppSpace);
+                    m_streamConfig.trackingSpaceType = newTrackingSpace;
+                    // the recorded views are relative to the old space, video frames rendered for them are
+                    // drawn with the views for their display time until new samples arrive.
+                    m_poseHistory.Clear();
+                    // jobs run in submission order, a guardian query still using the old space finishes first.
+                    if (oldAppSpace != XR_NULL_HANDLE) {
+                        m_eventReactionWorker.Submit("tracking space destroy", [oldAppSpace]() -> ALXR::EventReactionWorker::ApplyFn {
+                            xrDestroySpace(oldAppSpace);
+                            return {};
+                        });
+                    }
+                    OnTrackingSpaceChangeDone();
+                };
+            });
         }
 
         auto& currRenderConfig = m_streamConfig.renderConfig;
         const auto& newRenderConfig = newConfig.renderConfig;        
-        if (newRenderConfig.refreshRate != currRenderConfig.refreshRate) {
+        {
+            // The decode params of the new config are set by alxr_set_stream_config, any pending
+            // center shift belongs to the previous stream.
+            std::scoped_lock lk(m_foveationGazeMutex);
+            m_foveationGaze.SetRenderConfig(newRenderConfig);
+            m_pendingFoveationCenterShift.reset();
+        }
+        const float requestedRefreshRate = m_pendingRefreshRateChanges > 0 ? m_pendingRefreshRate : currRenderConfig.refreshRate;
+        if (newRenderConfig.refreshRate != requestedRefreshRate) {
             [&]() {
                 if (m_pfnRequestDisplayRefreshRateFB == nullptr) {
                     Log::Write(Log::Level::Warning, "This OpenXR runtime does not support setting the display refresh rate.");
@@ -3519,8 +3964,23 @@ struct OpenXrProgram final : IOpenXrProgram {
                 }
 
                 Log::Write(Log::Level::Info, Fmt("Setting display refresh rate from %f Hz to %f Hz.", currRenderConfig.refreshRate, newRenderConfig.refreshRate));
-                CHECK_XRCMD(m_pfnRequestDisplayRefreshRateFB(m_session, newRenderConfig.refreshRate));
-                currRenderConfig.refreshRate = newRenderConfig.refreshRate;
+                const float newRefreshRate = newRenderConfig.refreshRate;
+                ++m_pendingRefreshRateChanges;
+                m_pendingRefreshRate = newRefreshRate;
+                m_eventReactionWorker.Submit("display refresh rate change", [this, newRefreshRate]() -> ALXR::EventReactionWorker::ApplyFn {
+                    try {
+                        CHECK_XRCMD(m_pfnRequestDisplayRefreshRateFB(m_session, newRefreshRate));
+                    } catch (...) {
+                        return [this, error = std::current_exception()]() {
+                            --m_pendingRefreshRateChanges;
+                            std::rethrow_exception(error);
+                        };
+                    }
+                    return [this, newRefreshRate]() {
+                        m_streamConfig.renderConfig.refreshRate = newRefreshRate;
+                        --m_pendingRefreshRateChanges;
+                    };
+                });
             }();
         }
 
@@ -3540,7 +4000,7 @@ struct OpenXrProgram final : IOpenXrProgram {
         return m_guardianChangedQueue.try_pop(gd);
     }
 
-    inline bool GetBoundingStageSpace(const XrTime& time, ALXR::SpaceLoc& space, XrExtent2Df& boundingArea) const
+    inline bool GetBoundingStageSpace(const XrSpace baseSpace, const XrTime& time, ALXR::SpaceLoc& space, XrExtent2Df& boundingArea) const
     {
         if (m_session == XR_NULL_HANDLE ||
             m_boundingStageSpace == XR_NULL_HANDLE)
@@ -3550,15 +4010,15 @@ struct OpenXrProgram final : IOpenXrProgram {
             Log::Write(Log::Level::Info, "xrGetReferenceSpaceBoundsRect FAILED.");
             return false;
         }
-        space = GetSpaceLocation(m_boundingStageSpace, time, ALXR::InfinitySpaceLoc);
+        space = ALXR::GetSpaceLocation(m_boundingStageSpace, baseSpace, time, ALXR::InfinitySpaceLoc);
         return !space.is_infinity();
     }
 
-    inline bool GetBoundingStageSpace(const XrTime& time, ALXRGuardianData& gd) const
+    inline bool GetBoundingStageSpace(const XrSpace baseSpace, const XrTime& time, ALXRGuardianData& gd) const
     {
         ALXR::SpaceLoc loc;
         XrExtent2Df boundingArea;
-        if (!GetBoundingStageSpace(time, loc, boundingArea))
+        if (!GetBoundingStageSpace(baseSpace, time, loc, boundingArea))
             return false;
         gd = {
             .areaWidth = boundingArea.width,
@@ -3568,13 +4028,13 @@ struct OpenXrProgram final : IOpenXrProgram {
         return true;
     }
 
-    inline bool enqueueGuardianChanged(const XrTime& time)
+    inline bool enqueueGuardianChanged(const XrSpace baseSpace, const XrTime& time)
     {
         Log::Write(Log::Level::Verbose, "Enqueuing guardian changed");
         ALXRGuardianData gd {
             .shouldSync = false
         };
-        if (!GetBoundingStageSpace(time, gd))
+        if (!GetBoundingStageSpace(baseSpace, time, gd))
             return false;
         Log::Write(Log::Level::Verbose, "Guardian changed enqueud successfully.");
         m_guardianChangedQueue.push(gd);
@@ -3582,7 +4042,29 @@ struct OpenXrProgram final : IOpenXrProgram {
     }
 
     bool enqueueGuardianChanged() {
-        return enqueueGuardianChanged(m_lastPredicatedDisplayTime);
+        return enqueueGuardianChanged(m_appSpace, m_lastPredicatedDisplayTime);
+    }
+
+    // Queries the new guardian bounds on the event reaction worker, relative to the app space the render
+    // thread uses when the query is submitted. While a tracking space change is still pending the query
+    // is held back until it has been applied, the current app space is about to be replaced.
+    void SubmitGuardianChanged(const XrTime time) {
+        if (m_pendingTrackingSpaceChanges > 0) {
+            m_guardianChangedAfterSpaceChange = true;
+            return;
+        }
+        const XrSpace appSpace = m_appSpace;
+        m_eventReactionWorker.Submit("guardian update", [this, appSpace, time]() -> ALXR::EventReactionWorker::ApplyFn {
+            enqueueGuardianChanged(appSpace, time);
+            return {};
+        });
+    }
+
+    void OnTrackingSpaceChangeDone() {
+        CHECK(m_pendingTrackingSpaceChanges > 0);
+        if (--m_pendingTrackingSpaceChanges > 0 || !std::exchange(m_guardianChangedAfterSpaceChange, false))
+            return;
+        SubmitGuardianChanged(m_lastPredicatedDisplayTime.load());
     }
 
     virtual inline void Resume() override {}
@@ -3613,12 +4095,48 @@ struct OpenXrProgram final : IOpenXrProgram {
 
     std::vector<XrViewConfigurationView> m_configViews;
     std::vector<Swapchain> m_swapchains;
-    std::map<XrSwapchain, std::vector<XrSwapchainImageBaseHeader*>> m_swapchainImages;
+    SwapchainImagesList m_swapchainImages; // indexed the same as m_swapchains.
+
+    // Previously active swapchain sets, most recently used first, reconnecting with the same stream
+    // resolution swaps a cached set back in instead of recreating swapchains & graphics resources.
+    constexpr static const std::size_t MaxCachedSwapchainSets = 2;
+    std::list<SwapchainSet> m_swapchainSetCache;
+    SwapchainSetKey m_activeSwapchainSetKey{};
+
     std::vector<XrView> m_views;
     std::int64_t m_colorSwapchainFormat{-1};
     std::atomic<RenderMode> m_renderMode{ RenderMode::Lobby };
 
     std::vector<XrSpace> m_visualizedSpaces;
+    VizCubeList m_vizCubes{};
+    // [Lobby, VideoStream], only counted when built with XR_ENABLE_FRAME_ALLOC_COUNTER.
+    constexpr static const std::uint64_t FrameAllocStatsLogInterval = 3000;
+
+    // Runtime calls and time spent per GetTrackingInfo sample, input thread only.
+    struct TrackingQueryStats {
+        std::uint64_t sampleCount = 0;
+        std::uint64_t runtimeCallCount = 0;
+        std::uint64_t totalTimeUs = 0;
+        std::uint64_t maxTimeUs = 0;
+        // xrLocateSpacesKHR failures located with xrLocateSpace, the first of each interval is logged.
+        std::uint64_t locateSpacesFailureCount = 0;
+    };
+    constexpr static const std::uint64_t TrackingQueryStatsLogInterval = 3000;
+    TrackingQueryStats m_trackingQueryStats{};
+    // Time PollEvents takes from the render thread per frame, render thread only.
+    struct EventPollStats {
+        std::uint64_t frameCount = 0;
+        std::uint64_t eventCount = 0;
+        std::uint64_t overBudgetCount = 0;
+        std::uint64_t totalTimeUs = 0;
+        std::uint64_t maxTimeUs = 0;
+    };
+    constexpr static const std::uint64_t EventPollStatsLogInterval = 3000;
+    // Once spent, remaining events are handled on the next frames.
+    constexpr static const std::uint64_t EventPollBudgetUs = 1000;
+    EventPollStats m_eventPollStats{};
+    std::array<ALXR::FrameAllocStats, 2> m_frameAllocStats{};
+    bool m_frameAllocStatsIsVideoStream = false;
 
     // Application's current lifecycle state according to the runtime
     XrSessionState m_sessionState{XR_SESSION_STATE_UNKNOWN};
@@ -3666,6 +4184,9 @@ struct OpenXrProgram final : IOpenXrProgram {
     PFN_xrConvertTimespecTimeToTimeKHR  m_pfnConvertTimespecTimeToTimeKHR = nullptr;
     PFN_xrConvertTimeToTimespecTimeKHR  m_pfnConvertTimeToTimespecTimeKHR = nullptr;
     
+    // XR_KHR_locate_spaces, input thread only.
+    PFN_xrLocateSpacesKHR m_pfnLocateSpacesKHR = nullptr;
+
     // XR_FB_color_space
     PFN_xrEnumerateColorSpacesFB m_pfnEnumerateColorSpacesFB = nullptr;
     PFN_xrSetColorSpaceFB        m_pfnSetColorSpaceFB = nullptr;
@@ -3704,18 +4225,18 @@ struct OpenXrProgram final : IOpenXrProgram {
     std::atomic<XrTime>      m_lastPredicatedDisplayTime{ 0 };
 
 /// Tracking Thread State ////////////////////////////////////////////////////////
-    struct TrackingFrame {
-        std::array<XrView, 2> views;
-        XrTime                displayTime;
-    };
-    using TrackingFrameMap = std::map<std::uint64_t, TrackingFrame>;
-    mutable std::shared_mutex m_trackingFrameMapMutex;        
-    TrackingFrameMap          m_trackingFrameMap{};
+    // Views of each tracking frame, pushed by the tracking thread and looked up by the render thread.
+    ALXR::PoseHistory         m_poseHistory{};
     std::atomic<XrDuration>   m_PredicatedLatencyOffset{ 0 };
     std::uint64_t             m_lastVideoFrameIndex = std::uint64_t(-1);
-    static constexpr const std::size_t MaxTrackingFrameCount = 360 * 3;
 /// End Tracking Thread State ////////////////////////////////////////////////////
 
+/// Foveation State ///////////////////////////////////////////////////////////////
+    mutable std::mutex         m_foveationGazeMutex;
+    ALXR::FoveationGazeTracker m_foveationGaze{};
+    std::optional<XrVector2f>  m_pendingFoveationCenterShift{};
+/// End Foveation State ///////////////////////////////////////////////////////////
+
     std::vector<float> m_displayRefreshRates;
     ALXRStreamConfig m_streamConfig {
         .trackingSpaceType = ALXRTrackingSpace::LocalRefSpace,
@@ -3729,7 +4250,15 @@ struct OpenXrProgram final : IOpenXrProgram {
     using GuardianChangedQueue  = xrconcurrency::concurrent_queue<ALXRGuardianData>;
     StreamConfigQueue    m_streamConfigQueue;
     GuardianChangedQueue m_guardianChangedQueue;
+    ALXR::EventReactionWorker m_eventReactionWorker{};
     bool                 m_delayOnGuardianChanged = false;
+    // render thread only, tracking space and refresh rate changes submitted to the event reaction worker but
+    // not yet applied, with the last requested value.
+    std::uint32_t        m_pendingTrackingSpaceChanges = 0;
+    ALXRTrackingSpace    m_pendingTrackingSpace = ALXRTrackingSpace::LocalRefSpace;
+    std::uint32_t        m_pendingRefreshRateChanges = 0;
+    float                m_pendingRefreshRate = 0.0f;
+    bool                 m_guardianChangedAfterSpaceChange = false;
     bool                 m_isMultiViewEnabled = false;
 };
 }  // namespace
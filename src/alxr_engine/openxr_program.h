@@ -13,6 +13,8 @@ struct ALXRGuardianData;
 struct ALXREyeInfo;
 struct ALXRFacialEyePacket;
 struct ALXRHandTracking;
+struct ALXRFoveationGazeOptions;
+struct ALXRFoveationGaze;
 struct TrackingInfo;
 
 namespace ALXR {;
@@ -112,12 +114,19 @@ struct IOpenXrProgram {
     virtual bool GetSystemProperties(ALXRSystemProperties& systemProps) const = 0;
 
     virtual bool GetTrackingInfo(TrackingInfo& info, const bool clientPredict) /*const*/ = 0;
+    virtual bool GetPoseHistoryStats(ALXRPoseHistoryStats& stats) const = 0;
+    virtual bool GetFrameAllocStats(const RenderMode renderMode, ALXRFrameAllocStats& stats) const = 0;
 
     virtual void ApplyHapticFeedback(const ALXR::HapticsFeedback&) = 0;
 
     virtual void SetStreamConfig(const ALXRStreamConfig& config) = 0;
     virtual bool GetStreamConfig(ALXRStreamConfig& config) const = 0;
 
+    virtual void SetFoveationGazeOptions(const ALXRFoveationGazeOptions& options) = 0;
+    virtual bool GetFoveationGaze(ALXRFoveationGaze& gaze) const = 0;
+    // Applied to the foveated decode on the render thread at the start of the next frame.
+    virtual void SetFoveationCenterShift(const XrVector2f& centerShift) = 0;
+
     virtual void RequestExitSession() = 0;
 
     virtual bool GetGuardianData(ALXRGuardianData& gd) /*const*/ = 0;
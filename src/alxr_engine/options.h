@@ -137,6 +137,11 @@ struct Options {
     bool NoPassthrough = false;
     bool NoHandTracking = false;
     bool SimulateHeadless = false;
+    bool HeadlessVideoSink = false;
+    bool VideoSinkChecksum = true;
+    // Raw (tightly packed) luma frames to compute the CpuSink PSNR against, disabled if empty.
+    // Set from the ALXR_VIDEO_SINK_REFERENCE_FILE environment variable.
+    std::string VideoSinkReferenceFile{};
 
     struct {
         XrFormFactor FormFactor{XR_FORM_FACTOR_HEAD_MOUNTED_DISPLAY};
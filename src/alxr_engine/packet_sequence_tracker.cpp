@@ -0,0 +1,102 @@
+#include "pch.h"
+#include "packet_sequence_tracker.h"
+
+namespace ALXR {
+
+void PacketSequenceTracker::ApplyReset()
+{
+    m_bits = {};
+    m_lostRanges.clear();
+    m_counters = {};
+    m_highest = 0;
+    m_lossCheckedUpTo = 0;
+    m_initialized = false;
+}
+
+void PacketSequenceTracker::AddLost(const std::uint32_t from, const std::uint32_t to)
+{
+    m_counters.lost += std::uint64_t(to - from) + 1;
+    if (!m_lostRanges.empty() && m_lostRanges.back().to + 1 == from) {
+        m_lostRanges.back().to = to;
+        return;
+    }
+    m_lostRanges.push_back({ from, to });
+}
+
+std::span<const PacketSequenceTracker::LostRange>
+PacketSequenceTracker::Process(const std::uint32_t seq)
+{
+    // All comparisons are done on signed differences so that counter wrap-around is handled.
+    const auto diff = [](const std::uint32_t lhs, const std::uint32_t rhs) {
+        return static_cast<std::int32_t>(lhs - rhs);
+    };
+    if (m_resetRequested.exchange(false, std::memory_order_acq_rel))
+        ApplyReset();
+    m_lostRanges.clear();
+    if (!m_initialized) {
+        m_initialized = true;
+        m_bits = {};
+        m_highest = seq;
+        m_lossCheckedUpTo = seq - 1;
+        SetReceived(seq, true);
+        return {};
+    }
+
+    const std::int32_t delta = diff(seq, m_highest);
+    if (delta <= 0) {
+        if (delta <= -std::int32_t(Window)) {
+            ++m_counters.late;
+        } else if (IsReceived(seq)) {
+            ++m_counters.duplicated;
+        } else {
+            SetReceived(seq, true);
+            if (diff(seq, m_lossCheckedUpTo) <= 0)
+                ++m_counters.late;
+            else
+                ++m_counters.reordered;
+        }
+        return {};
+    }
+
+    // Declare lost everything which is now more than ReorderDepth behind the new highest counter.
+    const std::uint32_t classifyUpTo = seq - ReorderDepth;
+    if (diff(classifyUpTo, m_lossCheckedUpTo) > 0) {
+        std::uint32_t curr = m_lossCheckedUpTo + 1;
+        // up to the previous highest counter the bitmap tells what was received,
+        const std::uint32_t bitmapEnd = diff(classifyUpTo, m_highest) < 0 ? classifyUpTo : m_highest;
+        for (; diff(bitmapEnd, curr) >= 0; ++curr) {
+            if (!IsReceived(curr))
+                AddLost(curr, curr);
+        }
+        // nothing above it has been received yet.
+        if (diff(classifyUpTo, curr) >= 0)
+            AddLost(curr, classifyUpTo);
+        m_lossCheckedUpTo = classifyUpTo;
+    }
+
+    if (std::uint32_t(delta) >= Window) {
+        m_bits = {};
+    } else {
+        for (std::uint32_t curr = m_highest + 1; curr != seq; ++curr)
+            SetReceived(curr, false);
+    }
+    m_highest = seq;
+    SetReceived(seq, true);
+    return m_lostRanges;
+}
+
+std::uint64_t ReportLostRanges(const std::span<const PacketSequenceTracker::LostRange> lostRanges, const PacketLossReportFns& reportFns)
+{
+    if (lostRanges.empty())
+        return 0;
+    std::uint64_t lostCount = 0;
+    for (const auto& range : lostRanges) {
+        lostCount += std::uint64_t(range.to - range.from) + 1;
+        if (reportFns.lostRangeSend)
+            reportFns.lostRangeSend(range.from, range.to);
+    }
+    if (reportFns.videoErrorReportSend)
+        reportFns.videoErrorReportSend();
+    return lostCount;
+}
+}
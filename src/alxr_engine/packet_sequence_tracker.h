@@ -0,0 +1,75 @@
+#pragma once
+#ifndef ALXR_PACKET_SEQUENCE_TRACKER_H
+#define ALXR_PACKET_SEQUENCE_TRACKER_H
+
+#include <cstdint>
+#include <array>
+#include <atomic>
+#include <span>
+#include <vector>
+
+namespace ALXR {
+
+// Sliding-window receiver of video packet counters which tells lost, reordered and
+// duplicated packets apart. A packet still missing once the highest counter is ReorderDepth
+// ahead of it is declared lost, the bitmap still recognises it as late if it arrives afterwards.
+struct PacketSequenceTracker
+{
+    constexpr static const std::uint32_t Window = 1024;
+    constexpr static const std::uint32_t ReorderDepth = 64;
+    static_assert((Window & (Window - 1)) == 0 && ReorderDepth < Window);
+
+    struct LostRange
+    {
+        std::uint32_t from; // inclusive
+        std::uint32_t to;   // inclusive
+    };
+    struct Counters
+    {
+        std::uint64_t lost = 0;
+        std::uint64_t reordered = 0;
+        std::uint64_t duplicated = 0;
+        std::uint64_t late = 0; // arrived after being declared lost or beyond the window.
+    };
+
+    // Returns the ranges of packets newly declared lost, valid until the next call.
+    std::span<const LostRange> Process(const std::uint32_t packetCounter);
+    // May be called from any thread, the tracker state is only cleared by the next Process call
+    // on the receiving thread.
+    void Reset() { m_resetRequested.store(true, std::memory_order_release); }
+
+    inline const Counters& GetCounters() const { return m_counters; }
+
+private:
+    inline bool IsReceived(const std::uint32_t seq) const {
+        const std::uint32_t bit = seq % Window;
+        return (m_bits[bit / 64] >> (bit % 64)) & 1;
+    }
+    inline void SetReceived(const std::uint32_t seq, const bool received) {
+        const std::uint32_t bit = seq % Window;
+        const std::uint64_t mask = std::uint64_t(1) << (bit % 64);
+        m_bits[bit / 64] = received ? (m_bits[bit / 64] | mask) : (m_bits[bit / 64] & ~mask);
+    }
+    void AddLost(const std::uint32_t from, const std::uint32_t to);
+    void ApplyReset();
+
+    std::array<std::uint64_t, Window / 64> m_bits{};
+    std::vector<LostRange> m_lostRanges{};
+    Counters m_counters{};
+    std::uint32_t m_highest = 0;
+    std::uint32_t m_lossCheckedUpTo = 0;
+    bool m_initialized = false;
+    std::atomic<bool> m_resetRequested{ false };
+};
+
+struct PacketLossReportFns
+{
+    void (*videoErrorReportSend)() = nullptr;
+    void (*lostRangeSend)(std::uint32_t fromPacketCounter, std::uint32_t toPacketCounter) = nullptr; // optional.
+};
+
+// Reports the ranges a single Process call declared lost, each range through lostRangeSend and a single
+// video error report for all of them. Returns the number of packets declared lost.
+std::uint64_t ReportLostRanges(const std::span<const PacketSequenceTracker::LostRange> lostRanges, const PacketLossReportFns& reportFns);
+}
+#endif
@@ -0,0 +1,145 @@
+#pragma once
+#ifndef ALXR_PIPELINE_BUILD_WORKER_H
+#define ALXR_PIPELINE_BUILD_WORKER_H
+
+#include <cstdint>
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <future>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <functional>
+#include <string>
+#include <utility>
+
+#include "common.h"
+#include "logger.h"
+#include "timing.h"
+
+namespace ALXR {
+
+// A single worker thread which builds graphics pipelines off the render thread.
+//
+// Build jobs are run in submission order, the returned future becomes ready once the job has run and
+// rethrows anything it threw. A render thread which cannot continue without a result waits with Wait,
+// the time it was blocked is accounted as a stall. Each build and stall is logged, LogStats summarizes them.
+class PipelineBuildWorker final {
+public:
+    using BuildFn = std::function<void()>;
+    using Future  = std::shared_future<void>;
+
+    explicit PipelineBuildWorker(std::string name) : m_name(std::move(name)) {}
+    ~PipelineBuildWorker() { Stop(); }
+
+    PipelineBuildWorker(const PipelineBuildWorker&) = delete;
+    PipelineBuildWorker& operator=(const PipelineBuildWorker&) = delete;
+    PipelineBuildWorker(PipelineBuildWorker&&) = delete;
+    PipelineBuildWorker& operator=(PipelineBuildWorker&&) = delete;
+
+    Future Submit(const char* const variantName, BuildFn&& buildFn) {
+        std::packaged_task<void()> task([this, variantName, buildFn = std::move(buildFn)]() {
+            const float buildTimeMs = time_call_ms<true>(buildFn);
+            Log::Write(Log::Level::Info, Fmt("%s: built %s in %.3f ms", m_name.c_str(), variantName, buildTimeMs));
+            std::scoped_lock lk(m_statsMutex);
+            ++m_stats.buildCount;
+            m_stats.totalBuildMs += buildTimeMs;
+            m_stats.maxBuildMs = std::max(m_stats.maxBuildMs, buildTimeMs);
+        });
+        Future result = task.get_future().share();
+        {
+            std::scoped_lock lk(m_queueMutex);
+            if (!m_thread.joinable()) {
+                m_isRunning = true;
+                m_thread = std::thread([this]() { Run(); });
+            }
+            m_jobs.push_back(std::move(task));
+        }
+        m_jobsCV.notify_one();
+        return result;
+    }
+
+    // Blocks the calling (render) thread until the build has finished, rethrows any build failure.
+    void Wait(const Future& buildFuture, const char* const reason) {
+        if (!buildFuture.valid())
+            return;
+        using namespace std::chrono_literals;
+        if (buildFuture.wait_for(0s) == std::future_status::ready) {
+            buildFuture.get();
+            return;
+        }
+        const float stallTimeMs = time_call_ms<true>([&]() { buildFuture.wait(); });
+        Log::Write(Log::Level::Warning, Fmt("%s: render thread stalled %.3f ms waiting for %s", m_name.c_str(), stallTimeMs, reason));
+        {
+            std::scoped_lock lk(m_statsMutex);
+            ++m_stats.stallCount;
+            m_stats.totalStallMs += stallTimeMs;
+            m_stats.maxStallMs = std::max(m_stats.maxStallMs, stallTimeMs);
+        }
+        buildFuture.get();
+    }
+
+    static bool IsReady(const Future& buildFuture) {
+        using namespace std::chrono_literals;
+        return buildFuture.valid() && buildFuture.wait_for(0s) == std::future_status::ready;
+    }
+
+    void LogStats() const {
+        std::scoped_lock lk(m_statsMutex);
+        Log::Write(Log::Level::Info, Fmt("%s: %llu builds, avg %.3f ms, max %.3f ms; %llu render thread stalls, avg %.3f ms, max %.3f ms",
+            m_name.c_str(),
+            static_cast<unsigned long long>(m_stats.buildCount),
+            m_stats.buildCount ? m_stats.totalBuildMs / m_stats.buildCount : 0.0f, m_stats.maxBuildMs,
+            static_cast<unsigned long long>(m_stats.stallCount),
+            m_stats.stallCount ? m_stats.totalStallMs / m_stats.stallCount : 0.0f, m_stats.maxStallMs));
+    }
+
+    void Stop() {
+        {
+            std::scoped_lock lk(m_queueMutex);
+            m_isRunning = false;
+        }
+        m_jobsCV.notify_one();
+        if (m_thread.joinable())
+            m_thread.join();
+    }
+
+private:
+    void Run() {
+        while (true) {
+            std::packaged_task<void()> job;
+            {
+                std::unique_lock lk(m_queueMutex);
+                m_jobsCV.wait(lk, [this]() { return !m_jobs.empty() || !m_isRunning; });
+                // Pending jobs are still run on stop, owners may be waiting on them.
+                if (m_jobs.empty())
+                    return;
+                job = std::move(m_jobs.front());
+                m_jobs.pop_front();
+            }
+            job();
+        }
+    }
+
+    struct Stats {
+        std::uint64_t buildCount = 0;
+        std::uint64_t stallCount = 0;
+        float totalBuildMs = 0.0f;
+        float maxBuildMs = 0.0f;
+        float totalStallMs = 0.0f;
+        float maxStallMs = 0.0f;
+    };
+
+    const std::string m_name;
+    std::mutex m_queueMutex{};
+    std::condition_variable m_jobsCV{};
+    std::deque<std::packaged_task<void()>> m_jobs{};
+    std::thread m_thread{};
+    bool m_isRunning = false;
+
+    mutable std::mutex m_statsMutex{};
+    Stats m_stats{};
+};
+}
+#endif
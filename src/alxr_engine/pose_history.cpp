@@ -0,0 +1,169 @@
+#include "pch.h"
+#include "common.h"
+#include "pose_history.h"
+#include "xr_eigen.h"
+
+namespace ALXR {
+
+void PoseHistory::Push(const Sample& sample)
+{
+    std::unique_lock<std::shared_mutex> lock(m_samplesMutex);
+    std::size_t pos = m_size;
+    while (pos > 0 && At(pos - 1).frameIndex > sample.frameIndex)
+        --pos;
+    if (pos > 0 && At(pos - 1).frameIndex == sample.frameIndex) {
+        At(pos - 1) = sample;
+        return;
+    }
+    if (m_size == Capacity) {
+        // older than every sample of a full history, it would be the one dropped.
+        if (pos == 0)
+            return;
+        m_first = (m_first + 1) % Capacity;
+        --m_size;
+        --pos;
+    }
+    for (std::size_t i = m_size; i > pos; --i)
+        At(i) = At(i - 1);
+    At(pos) = sample;
+    ++m_size;
+}
+
+bool PoseHistory::Latest(Sample& sample) const
+{
+    std::shared_lock<std::shared_mutex> lock(m_samplesMutex);
+    if (m_size == 0)
+        return false;
+    sample = At(m_size - 1);
+    return true;
+}
+
+void PoseHistory::Clear()
+{
+    std::unique_lock<std::shared_mutex> lock(m_samplesMutex);
+    m_first = 0;
+    m_size = 0;
+}
+
+std::size_t PoseHistory::LowerBound(const std::uint64_t frameIndex) const
+{
+    std::size_t first = 0;
+    std::size_t count = m_size;
+    while (count > 0) {
+        const std::size_t step = count / 2;
+        if (At(first + step).frameIndex < frameIndex) {
+            first += step + 1;
+            count -= step + 1;
+        } else
+            count = step;
+    }
+    return first;
+}
+
+PoseHistory::LookupResult PoseHistory::Find(const std::uint64_t frameIndex, Sample& sample) const
+{
+    const LookupResult result = [&]() {
+        std::shared_lock<std::shared_mutex> lock(m_samplesMutex);
+        if (m_size == 0)
+            return LookupResult::Miss;
+        const std::size_t nextIdx = LowerBound(frameIndex);
+        if (nextIdx == m_size) {
+            sample = At(m_size - 1);
+            return LookupResult::Newest;
+        }
+        const Sample& next = At(nextIdx);
+        if (next.frameIndex == frameIndex) {
+            sample = next;
+            return LookupResult::Exact;
+        }
+        if (nextIdx == 0) {
+            sample = next;
+            return LookupResult::Expired;
+        }
+        const Sample& prev = At(nextIdx - 1);
+        if (next.frameIndex - prev.frameIndex > MaxInterpolationGapNs) {
+            sample = (frameIndex - prev.frameIndex) < (next.frameIndex - frameIndex) ? prev : next;
+            return LookupResult::Nearest;
+        }
+        sample = Interpolate(prev, next, frameIndex);
+        return LookupResult::Interpolated;
+    }();
+    Count(result);
+    return result;
+}
+
+PoseHistory::Sample PoseHistory::Interpolate(const Sample& lhs, const Sample& rhs, const std::uint64_t frameIndex)
+{
+    const float t = static_cast<float>(static_cast<double>(frameIndex - lhs.frameIndex) /
+                                       static_cast<double>(rhs.frameIndex - lhs.frameIndex));
+    const auto lerp = [t](const float a, const float b) { return a + (b - a) * t; };
+
+    Sample sample{
+        .frameIndex  = frameIndex,
+        .displayTime = lhs.displayTime + static_cast<XrTime>((rhs.displayTime - lhs.displayTime) * static_cast<double>(t)),
+        .views       = lhs.views,
+    };
+    for (std::size_t eye = 0; eye < sample.views.size(); ++eye) {
+        const XrView& a = lhs.views[eye];
+        const XrView& b = rhs.views[eye];
+        XrView& view = sample.views[eye];
+        view.pose.position = ToXrVector3f(ToVector3f(a.pose.position) * (1.0f - t) + ToVector3f(b.pose.position) * t);
+        view.pose.orientation = ToXrQuaternionf(ToQuaternionf(a.pose.orientation).slerp(t, ToQuaternionf(b.pose.orientation)));
+        view.fov = {
+            .angleLeft  = lerp(a.fov.angleLeft, b.fov.angleLeft),
+            .angleRight = lerp(a.fov.angleRight, b.fov.angleRight),
+            .angleUp    = lerp(a.fov.angleUp, b.fov.angleUp),
+            .angleDown  = lerp(a.fov.angleDown, b.fov.angleDown),
+        };
+    }
+    return sample;
+}
+
+void PoseHistory::Count(const LookupResult result) const
+{
+    switch (result) {
+    case LookupResult::Exact:        ++m_counters.exact; break;
+    case LookupResult::Interpolated: ++m_counters.interpolated; break;
+    case LookupResult::Nearest:      ++m_counters.nearest; break;
+    case LookupResult::Newest:       ++m_counters.newest; break;
+    case LookupResult::Expired:      ++m_counters.expired; break;
+    case LookupResult::Miss:         ++m_counters.misses; break;
+    }
+    if (++m_counters.lookups % LogInterval == 0)
+        LogStats();
+}
+
+void PoseHistory::LogStats() const
+{
+    const std::array<std::uint64_t, 6> counts {
+        m_counters.exact.load(std::memory_order_relaxed),
+        m_counters.interpolated.load(std::memory_order_relaxed),
+        m_counters.nearest.load(std::memory_order_relaxed),
+        m_counters.newest.load(std::memory_order_relaxed),
+        m_counters.expired.load(std::memory_order_relaxed),
+        m_counters.misses.load(std::memory_order_relaxed),
+    };
+    const auto delta = [&](const std::size_t idx) {
+        return static_cast<unsigned long long>(counts[idx] - m_lastLogCounts[idx]);
+    };
+    // Only worth a line when video frames were drawn with poses which were not recorded for them.
+    if (delta(0) != LogInterval) {
+        Log::Write(Log::Level::Warning, Fmt("Pose history lookups over the last %llu frames: exact=%llu interpolated=%llu nearest=%llu newest=%llu expired=%llu miss=%llu",
+            static_cast<unsigned long long>(LogInterval), delta(0), delta(1), delta(2), delta(3), delta(4), delta(5)));
+    }
+    m_lastLogCounts = counts;
+}
+
+void PoseHistory::GetStats(ALXRPoseHistoryStats& stats) const
+{
+    stats = {
+        .lookups      = m_counters.lookups.load(std::memory_order_relaxed),
+        .exact        = m_counters.exact.load(std::memory_order_relaxed),
+        .interpolated = m_counters.interpolated.load(std::memory_order_relaxed),
+        .nearest      = m_counters.nearest.load(std::memory_order_relaxed),
+        .newest       = m_counters.newest.load(std::memory_order_relaxed),
+        .expired      = m_counters.expired.load(std::memory_order_relaxed),
+        .misses       = m_counters.misses.load(std::memory_order_relaxed),
+    };
+}
+}
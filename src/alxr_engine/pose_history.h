@@ -0,0 +1,93 @@
+#pragma once
+#ifndef ALXR_POSE_HISTORY_H
+#define ALXR_POSE_HISTORY_H
+
+#include "pch.h"
+#include <cstdint>
+#include <cstddef>
+#include <array>
+#include <atomic>
+#include <shared_mutex>
+#include "alxr_ctypes.h"
+
+namespace ALXR {
+
+// History of the head views located for each tracking frame sent to the server, keyed by the frame's
+// tracking frame index (its predicted display time in ns) which the server echoes back with the video
+// frame rendered for it.
+//
+// The tracking thread pushes a sample per tracking frame, the render thread looks up the views a video
+// frame was rendered with. A lookup which does not hit a sample exactly is interpolated between its
+// neighbouring samples (positions and fovs lerped, orientations slerped) when they are close enough,
+// otherwise it falls back to the nearest sample; every lookup is counted by how it was resolved.
+struct PoseHistory {
+
+    using Views = std::array<XrView, 2>;
+
+    struct Sample {
+        std::uint64_t frameIndex;
+        XrTime        displayTime;
+        Views         views;
+    };
+
+    enum class LookupResult {
+        Exact,
+        Interpolated,
+        Nearest,  // between two samples too far apart to interpolate.
+        Newest,   // newer than every sample.
+        Expired,  // older than every sample, already dropped.
+        Miss,     // empty history.
+    };
+
+    // Samples normally arrive in increasing frame index order but the prediction offset they are made
+    // with varies, out of order samples are inserted in place. Once full the oldest sample is dropped,
+    // samples are stored in a fixed ring so pushing never allocates.
+    void Push(const Sample& sample);
+
+    LookupResult Find(const std::uint64_t frameIndex, Sample& sample) const;
+
+    // The most recently located views, not counted as a lookup.
+    bool Latest(Sample& sample) const;
+
+    // Drops every sample, e.g. once the views are located in a new tracking space. Stats are kept.
+    void Clear();
+
+    void GetStats(ALXRPoseHistoryStats& stats) const;
+
+    constexpr static const std::size_t Capacity = 360 * 3;
+    // Neighbouring samples further apart than this are not interpolated between, the tracking
+    // thread stalled in between.
+    constexpr static const std::uint64_t MaxInterpolationGapNs = 50'000'000;
+
+private:
+    // The i-th oldest sample, i < m_size.
+    inline Sample& At(const std::size_t i) { return m_samples[(m_first + i) % Capacity]; }
+    inline const Sample& At(const std::size_t i) const { return m_samples[(m_first + i) % Capacity]; }
+    // Index of the first sample not older than frameIndex, m_size if there is none.
+    std::size_t LowerBound(const std::uint64_t frameIndex) const;
+
+    static Sample Interpolate(const Sample& lhs, const Sample& rhs, const std::uint64_t frameIndex);
+    void Count(const LookupResult result) const;
+    void LogStats() const;
+
+    struct Counters {
+        std::atomic<std::uint64_t> lookups{ 0 };
+        std::atomic<std::uint64_t> exact{ 0 };
+        std::atomic<std::uint64_t> interpolated{ 0 };
+        std::atomic<std::uint64_t> nearest{ 0 };
+        std::atomic<std::uint64_t> newest{ 0 };
+        std::atomic<std::uint64_t> expired{ 0 };
+        std::atomic<std::uint64_t> misses{ 0 };
+    };
+    constexpr static const std::uint64_t LogInterval = 3000;
+
+    mutable std::shared_mutex    m_samplesMutex{};
+    std::array<Sample, Capacity> m_samples{};
+    std::size_t                  m_first = 0;
+    std::size_t                  m_size  = 0;
+
+    mutable Counters                     m_counters{};
+    mutable std::array<std::uint64_t, 6> m_lastLogCounts{};
+};
+}
+#endif
@@ -0,0 +1,155 @@
+#include "pch.h"
+#include "video_jitter_buffer.h"
+#include "logger.h"
+#include "common.h"
+#include "timing.h"
+
+VideoJitterBuffer::VideoJitterBuffer(const std::uint32_t maxDelayUs, SinkFn&& sink)
+: m_maxDelayUs(maxDelayUs),
+  m_sink(std::move(sink))
+{
+	m_releaseThread = std::thread([this]() { ReleaseLoop(); });
+}
+
+VideoJitterBuffer::~VideoJitterBuffer()
+{
+	{
+		std::scoped_lock lock(m_mutex);
+		m_running = false;
+	}
+	m_cv.notify_one();
+	if (m_releaseThread.joinable())
+		m_releaseThread.join();
+	LogStats(0);
+}
+
+std::int64_t VideoJitterBuffer::Schedule(const std::uint64_t trackingFrameIndex, const std::uint64_t sentTimeUs, const std::int64_t nowUs)
+{
+	// transit time includes the (unknown) server/client clock offset, it cancels out
+	// because only differences & the windowed minimum are used.
+	const std::int64_t transitUs = nowUs - static_cast<std::int64_t>(sentTimeUs);
+	const bool isNewFrame = trackingFrameIndex != m_lastFrameIndex;
+	if (isNewFrame) {
+		if (m_lastFrameIndex != std::uint64_t(-1)) {
+			const double d = static_cast<double>(std::abs(transitUs - m_lastTransitUs));
+			m_jitterUs += (d - m_jitterUs) / 16.0;
+		}
+		m_lastTransitUs = transitUs;
+		m_lastFrameIndex = trackingFrameIndex;
+
+		m_transits[m_nextTransit] = transitUs;
+		m_nextTransit = (m_nextTransit + 1) % m_transits.size();
+		m_transitCount = std::min(m_transitCount + 1, m_transits.size());
+		m_baseTransitUs = *std::min_element(m_transits.begin(), m_transits.begin() + m_transitCount);
+
+		// grow immediately, shrink slowly so a burst of jitter does not make the delay oscillate.
+		const double targetUs = m_jitterUs < CleanJitterUs ? 0.0 :
+			std::min(3.0 * m_jitterUs, static_cast<double>(m_maxDelayUs));
+		m_delayUs = targetUs >= m_delayUs ? targetUs : m_delayUs + (targetUs - m_delayUs) / 32.0;
+
+		m_jitterStat.store(static_cast<std::uint32_t>(m_jitterUs), std::memory_order_relaxed);
+		m_delayStat.store(static_cast<std::uint32_t>(m_delayUs), std::memory_order_relaxed);
+	}
+
+	const std::int64_t delayUs = static_cast<std::int64_t>(m_delayUs);
+	const std::int64_t releaseTimeUs = std::min
+	(
+		static_cast<std::int64_t>(sentTimeUs) + m_baseTransitUs + delayUs,
+		nowUs + static_cast<std::int64_t>(m_maxDelayUs)
+	);
+	if (delayUs > 0 && releaseTimeUs < nowUs && isNewFrame)
+		m_framesLate.fetch_add(1, std::memory_order_relaxed);
+	return releaseTimeUs;
+}
+
+void VideoJitterBuffer::Push(const PacketType& packet, const std::uint64_t trackingFrameIndex, const std::uint64_t sentTimeUs)
+{
+	const auto nowUs = static_cast<std::int64_t>(GetSystemTimestampUs());
+	const std::int64_t releaseTimeUs = Schedule(trackingFrameIndex, sentTimeUs, nowUs);
+	if (nowUs - m_lastLogTimeUs >= 5'000'000)
+		LogStats(nowUs);
+
+	std::unique_lock lock(m_mutex);
+	if (m_queue.empty() && !m_releasing && releaseTimeUs <= nowUs) {
+		// fast path, nothing is buffered ahead of this packet and it is already due.
+		lock.unlock();
+		m_framesPassedThrough.fetch_add(1, std::memory_order_relaxed);
+		m_sink(packet, trackingFrameIndex);
+		return;
+	}
+
+	std::vector<std::uint8_t> data;
+	if (!m_freeBuffers.empty()) {
+		data = std::move(m_freeBuffers.back());
+		m_freeBuffers.pop_back();
+	}
+	data.assign(packet.begin(), packet.end());
+	m_queue.push_back({
+		.data = std::move(data),
+		.trackingFrameIndex = trackingFrameIndex,
+		.releaseTimeUs = releaseTimeUs
+	});
+	const auto depth = static_cast<std::uint32_t>(m_queue.size());
+	lock.unlock();
+	m_cv.notify_one();
+
+	m_framesQueued.fetch_add(1, std::memory_order_relaxed);
+	if (depth > m_maxDepth.load(std::memory_order_relaxed))
+		m_maxDepth.store(depth, std::memory_order_relaxed);
+}
+
+void VideoJitterBuffer::ReleaseLoop()
+{
+	std::unique_lock lock(m_mutex);
+	while (m_running) {
+		if (m_queue.empty()) {
+			m_cv.wait(lock);
+			continue;
+		}
+		const auto nowUs = static_cast<std::int64_t>(GetSystemTimestampUs());
+		const std::int64_t releaseTimeUs = m_queue.front().releaseTimeUs;
+		if (releaseTimeUs > nowUs) {
+			m_cv.wait_for(lock, std::chrono::microseconds(releaseTimeUs - nowUs));
+			continue;
+		}
+
+		Entry entry = std::move(m_queue.front());
+		m_queue.pop_front();
+		m_releasing = true;
+		lock.unlock();
+		m_sink(entry.data, entry.trackingFrameIndex);
+		lock.lock();
+		m_releasing = false;
+		entry.data.clear();
+		m_freeBuffers.push_back(std::move(entry.data));
+	}
+}
+
+VideoJitterBuffer::Stats VideoJitterBuffer::GetStats() const
+{
+	std::uint32_t depth = 0;
+	{
+		std::scoped_lock lock(m_mutex);
+		depth = static_cast<std::uint32_t>(m_queue.size());
+	}
+	return {
+		.framesQueued        = m_framesQueued.load(std::memory_order_relaxed),
+		.framesPassedThrough = m_framesPassedThrough.load(std::memory_order_relaxed),
+		.framesLate          = m_framesLate.load(std::memory_order_relaxed),
+		.depth               = depth,
+		.maxDepth            = m_maxDepth.load(std::memory_order_relaxed),
+		.jitterUs            = m_jitterStat.load(std::memory_order_relaxed),
+		.playoutDelayUs      = m_delayStat.load(std::memory_order_relaxed),
+	};
+}
+
+void VideoJitterBuffer::LogStats(const std::int64_t nowUs)
+{
+	m_lastLogTimeUs = nowUs;
+	const auto stats = GetStats();
+	Log::Write(Log::Level::Verbose, Fmt("Video jitter buffer: jitter=%uus delay=%uus depth=%u (max %u), queued=%llu passed-through=%llu late=%llu",
+		stats.jitterUs, stats.playoutDelayUs, stats.depth, stats.maxDepth,
+		static_cast<unsigned long long>(stats.framesQueued),
+		static_cast<unsigned long long>(stats.framesPassedThrough),
+		static_cast<unsigned long long>(stats.framesLate)));
+}
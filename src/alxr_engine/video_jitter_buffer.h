@@ -0,0 +1,93 @@
+#pragma once
+#ifndef ALXR_VIDEO_JITTER_BUFFER_H
+#define ALXR_VIDEO_JITTER_BUFFER_H
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+#include <vector>
+#include <deque>
+#include <span>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <functional>
+
+// Receive side playout buffer between packet reassembly and the decoder.
+//
+// Each frame is scheduled for release at (server sentTime + minimum observed transit + playout delay),
+// the playout delay follows the RFC 3550 inter-arrival jitter estimate (bounded by maxDelayUs).
+// While the network is clean (jitter below CleanJitterUs) the delay is zero and
+// packets are passed straight through to the sink on the caller's thread without copying.
+class VideoJitterBuffer {
+public:
+	using PacketType = std::span<const std::uint8_t>;
+	using SinkFn = std::function<void(const PacketType&, const std::uint64_t /*trackingFrameIndex*/)>;
+
+	constexpr static const std::uint64_t CleanJitterUs = 500;
+	constexpr static const std::size_t   TransitWindowSize = 128;
+
+	struct Stats {
+		std::uint64_t framesQueued;
+		std::uint64_t framesPassedThrough;
+		std::uint64_t framesLate;
+		std::uint32_t depth;
+		std::uint32_t maxDepth;
+		std::uint32_t jitterUs;
+		std::uint32_t playoutDelayUs;
+	};
+
+	VideoJitterBuffer(const std::uint32_t maxDelayUs, SinkFn&& sink);
+	~VideoJitterBuffer();
+
+	VideoJitterBuffer(const VideoJitterBuffer&) = delete;
+	VideoJitterBuffer& operator=(const VideoJitterBuffer&) = delete;
+
+	// Called from the network thread with a complete frame (or, with FEC disabled, a frame fragment).
+	void Push(const PacketType& packet, const std::uint64_t trackingFrameIndex, const std::uint64_t sentTimeUs);
+
+	Stats GetStats() const;
+
+private:
+	struct Entry {
+		std::vector<std::uint8_t> data;
+		std::uint64_t trackingFrameIndex;
+		std::int64_t  releaseTimeUs;
+	};
+
+	// Updates the jitter & delay estimates, returns the release time for the packet.
+	std::int64_t Schedule(const std::uint64_t trackingFrameIndex, const std::uint64_t sentTimeUs, const std::int64_t nowUs);
+	void ReleaseLoop();
+	void LogStats(const std::int64_t nowUs);
+
+	const std::uint32_t m_maxDelayUs;
+	SinkFn m_sink;
+
+	// network thread state.
+	std::array<std::int64_t, TransitWindowSize> m_transits{};
+	std::size_t   m_transitCount = 0;
+	std::size_t   m_nextTransit = 0;
+	std::int64_t  m_baseTransitUs = 0;
+	std::int64_t  m_lastTransitUs = 0;
+	std::uint64_t m_lastFrameIndex = std::uint64_t(-1);
+	double        m_jitterUs = 0.0;
+	double        m_delayUs = 0.0;
+	std::int64_t  m_lastLogTimeUs = 0;
+
+	mutable std::mutex m_mutex;
+	std::condition_variable m_cv;
+	std::deque<Entry> m_queue;
+	std::vector<std::vector<std::uint8_t>> m_freeBuffers;
+	bool m_releasing = false;
+	bool m_running = true;
+	std::thread m_releaseThread;
+
+	std::atomic<std::uint64_t> m_framesQueued{ 0 };
+	std::atomic<std::uint64_t> m_framesPassedThrough{ 0 };
+	std::atomic<std::uint64_t> m_framesLate{ 0 };
+	std::atomic<std::uint32_t> m_maxDepth{ 0 };
+	std::atomic<std::uint32_t> m_jitterStat{ 0 };
+	std::atomic<std::uint32_t> m_delayStat{ 0 };
+};
+#endif
@@ -1,21 +1,19 @@
 precision highp float;
 
-#define MAKE_VEC2_SP_CONST(name, start_id, xval, yval)              \
-    layout(constant_id = start_id)     const float name##X = xval;  \
-    layout(constant_id = (start_id+1)) const float name##Y = yval;  \
-    const vec2 name = vec2(name##X, name##Y);
-
-MAKE_VEC2_SP_CONST(EyeSizeRatio, 0,  0.967592597, 0.988636374)
-MAKE_VEC2_SP_CONST(EdgeRatio,    2,  7.0, 7.0)
-MAKE_VEC2_SP_CONST(C1,           4,  0.0, 0.0)
-MAKE_VEC2_SP_CONST(C2,           6,  0.0, 0.0)
-MAKE_VEC2_SP_CONST(LoBound,      8,  0.0, 0.0)
-MAKE_VEC2_SP_CONST(HiBound,      10, 0.0, 0.0)
-MAKE_VEC2_SP_CONST(ALeft,        12, 0.0, 0.0)
-MAKE_VEC2_SP_CONST(BLeft,        14, 0.0, 0.0)
-MAKE_VEC2_SP_CONST(ARight,       16, 0.0, 0.0)
-MAKE_VEC2_SP_CONST(BRight,       18, 0.0, 0.0)
-MAKE_VEC2_SP_CONST(CRight,       20, 0.0, 0.0)
+// Updated per frame (gaze driven center shift) without rebuilding pipelines, matches ALXR::FoveatedDecodeParams.
+layout(set = 1, binding = 0) uniform FoveatedDecodeParams {
+    vec2 EyeSizeRatio;
+    vec2 EdgeRatio;
+    vec2 C1;
+    vec2 C2;
+    vec2 LoBound;
+    vec2 HiBound;
+    vec2 ALeft;
+    vec2 BLeft;
+    vec2 ARight;
+    vec2 BRight;
+    vec2 CRight;
+};
 
 vec2 TextureToEyeUV(const vec2 textureUV, const float isRightEye) {
     // flip distortion horizontally for right eye
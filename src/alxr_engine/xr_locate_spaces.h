@@ -0,0 +1,115 @@
+#pragma once
+#ifndef ALXR_XR_LOCATE_SPACES_H
+#define ALXR_XR_LOCATE_SPACES_H
+
+#include "pch.h"
+#include <cstdint>
+#include <cassert>
+#include <array>
+#include <span>
+#include "xr_utils.h"
+
+// XR_KHR_locate_spaces (promoted to core in OpenXR 1.1), mirrored from the registry for
+// OpenXR headers which predate it.
+#ifndef XR_KHR_locate_spaces
+#define XR_KHR_locate_spaces 1
+#define XR_KHR_locate_spaces_SPEC_VERSION 1
+#define XR_KHR_LOCATE_SPACES_EXTENSION_NAME "XR_KHR_locate_spaces"
+
+constexpr inline const XrStructureType XR_TYPE_SPACES_LOCATE_INFO_KHR = static_cast<XrStructureType>(1000471000);
+constexpr inline const XrStructureType XR_TYPE_SPACE_LOCATIONS_KHR    = static_cast<XrStructureType>(1000471001);
+constexpr inline const XrStructureType XR_TYPE_SPACE_VELOCITIES_KHR   = static_cast<XrStructureType>(1000471002);
+
+typedef struct XrSpacesLocateInfoKHR {
+    XrStructureType             type;
+    const void* XR_MAY_ALIAS    next;
+    XrSpace                     baseSpace;
+    XrTime                      time;
+    uint32_t                    spaceCount;
+    const XrSpace*              spaces;
+} XrSpacesLocateInfoKHR;
+
+typedef struct XrSpaceLocationDataKHR {
+    XrSpaceLocationFlags    locationFlags;
+    XrPosef                 pose;
+} XrSpaceLocationDataKHR;
+
+typedef struct XrSpaceLocationsKHR {
+    XrStructureType             type;
+    void* XR_MAY_ALIAS          next;
+    uint32_t                    locationCount;
+    XrSpaceLocationDataKHR*     locations;
+} XrSpaceLocationsKHR;
+
+typedef struct XrSpaceVelocityDataKHR {
+    XrSpaceVelocityFlags    velocityFlags;
+    XrVector3f              linearVelocity;
+    XrVector3f              angularVelocity;
+} XrSpaceVelocityDataKHR;
+
+typedef struct XrSpaceVelocitiesKHR {
+    XrStructureType             type;
+    void* XR_MAY_ALIAS          next;
+    uint32_t                    velocityCount;
+    XrSpaceVelocityDataKHR*     velocities;
+} XrSpaceVelocitiesKHR;
+
+typedef XrResult (XRAPI_PTR *PFN_xrLocateSpacesKHR)(XrSession session, const XrSpacesLocateInfoKHR* locateInfo, XrSpaceLocationsKHR* spaceLocations);
+#endif
+
+namespace ALXR {;
+
+constexpr inline const std::size_t MaxLocateSpaces = 8;
+
+// Locates all spaces relative to baseSpace in a single xrLocateSpacesKHR call, spaceLocs are updated
+// the same way GetSpaceLocation updates its initLoc.
+inline XrResult LocateSpaces
+(
+    const PFN_xrLocateSpacesKHR pfnLocateSpaces,
+    const XrSession session,
+    const std::span<const XrSpace> spaces,
+    const XrSpace& baseSpace,
+    const XrTime& time,
+    const std::span<SpaceLoc> spaceLocs
+)
+{
+    assert(pfnLocateSpaces != nullptr);
+    assert(spaces.size() == spaceLocs.size() && spaces.size() <= MaxLocateSpaces);
+
+    std::array<XrSpaceVelocityDataKHR, MaxLocateSpaces> velocityData;
+    std::array<XrSpaceLocationDataKHR, MaxLocateSpaces> locationData;
+    const auto spaceCount = static_cast<std::uint32_t>(spaces.size());
+    XrSpaceVelocitiesKHR velocities{
+        .type = XR_TYPE_SPACE_VELOCITIES_KHR,
+        .next = nullptr,
+        .velocityCount = spaceCount,
+        .velocities = velocityData.data()
+    };
+    XrSpaceLocationsKHR locations{
+        .type = XR_TYPE_SPACE_LOCATIONS_KHR,
+        .next = &velocities,
+        .locationCount = spaceCount,
+        .locations = locationData.data()
+    };
+    const XrSpacesLocateInfoKHR locateInfo{
+        .type = XR_TYPE_SPACES_LOCATE_INFO_KHR,
+        .next = nullptr,
+        .baseSpace = baseSpace,
+        .time = time,
+        .spaceCount = spaceCount,
+        .spaces = spaces.data()
+    };
+    const XrResult res = pfnLocateSpaces(session, &locateInfo, &locations);
+    if (!XR_UNQUALIFIED_SUCCESS(res))
+        return res;
+
+    for (std::size_t idx = 0; idx < spaces.size(); ++idx) {
+        const auto& location = locationData[idx];
+        const auto& velocity = velocityData[idx];
+        spaceLocs[idx] = MakeSpaceLoc(location.locationFlags, location.pose,
+            velocity.velocityFlags, velocity.linearVelocity, velocity.angularVelocity, spaceLocs[idx]);
+    }
+    return res;
+}
+}
+#endif
@@ -0,0 +1,101 @@
+#include "pch.h"
+#include "xr_path_cache.h"
+#include "common.h"
+#include <cassert>
+#include <cstring>
+#include <array>
+
+namespace ALXR {;
+
+XrPathCache XrPathCache::m_instance{};
+
+namespace {
+    using PathBuffer = std::array<char, XR_MAX_PATH_LENGTH>;
+
+    inline std::string_view MakePath(const XrPathSpec& spec, PathBuffer& buffer) {
+        assert(spec.prefix != nullptr);
+        std::size_t length = 0;
+        const auto append = [&](const char* const str) {
+            const std::size_t strLen = std::strlen(str);
+            CHECK(length + strLen < buffer.size());
+            std::memcpy(buffer.data() + length, str, strLen);
+            length += strLen;
+        };
+        append(spec.prefix);
+        if (spec.component != nullptr) {
+            if (spec.io != nullptr) {
+                append("/");
+                append(spec.io);
+            }
+            append("/");
+            append(spec.component);
+        }
+        buffer[length] = '\0';
+        return { buffer.data(), length };
+    }
+}
+
+XrPath XrPathCache::GetLocked(const XrInstance instance, const std::string_view path)
+{
+    assert(instance != XR_NULL_HANDLE);
+    if (instance != m_owner) {
+        m_paths.clear();
+        m_owner = instance;
+    }
+    ++m_lookups;
+    const auto itr = m_paths.find(path);
+    if (itr != m_paths.end())
+        return itr->second;
+
+    std::string pathStr{ path };
+    XrPath xrPath{ XR_NULL_PATH };
+    ++m_runtimeCalls;
+    CHECK_XRCMD(xrStringToPath(instance, pathStr.c_str(), &xrPath));
+    assert(xrPath != XR_NULL_PATH);
+    m_paths.emplace(std::move(pathStr), xrPath);
+    return xrPath;
+}
+
+XrPath XrPathCache::Get(const XrInstance instance, const std::string_view path)
+{
+    std::scoped_lock lock(m_mutex);
+    return GetLocked(instance, path);
+}
+
+XrPath XrPathCache::Get(const XrInstance instance, const XrPathSpec& spec)
+{
+    PathBuffer buffer;
+    const auto path = MakePath(spec, buffer);
+    std::scoped_lock lock(m_mutex);
+    return GetLocked(instance, path);
+}
+
+std::size_t XrPathCache::Seed(const XrInstance instance, const std::span<const XrPathSpec> specs)
+{
+    PathBuffer buffer;
+    std::scoped_lock lock(m_mutex);
+    const auto prevRuntimeCalls = m_runtimeCalls;
+    for (const auto& spec : specs)
+        GetLocked(instance, MakePath(spec, buffer));
+    return static_cast<std::size_t>(m_runtimeCalls - prevRuntimeCalls);
+}
+
+void XrPathCache::OnInstanceDestroyed(const XrInstance instance)
+{
+    std::scoped_lock lock(m_mutex);
+    if (instance != m_owner)
+        return;
+    m_paths.clear();
+    m_owner = XR_NULL_HANDLE;
+}
+
+XrPathCache::Stats XrPathCache::GetStats() const
+{
+    std::scoped_lock lock(m_mutex);
+    return {
+        .lookups      = m_lookups,
+        .runtimeCalls = m_runtimeCalls,
+        .size         = m_paths.size()
+    };
+}
+}
@@ -0,0 +1,67 @@
+#pragma once
+#ifndef ALXR_XR_PATH_CACHE_H
+#define ALXR_XR_PATH_CACHE_H
+
+#include "pch.h"
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <span>
+#include <mutex>
+#include <unordered_map>
+
+namespace ALXR {;
+
+// Components of a semantic path, the full path is "{prefix}" or "{prefix}/{io}/{component}",
+// e.g. { "/user/hand/left", "input", "trigger/value" }.
+struct XrPathSpec {
+    const char* prefix = nullptr;
+    const char* io = nullptr;
+    const char* component = nullptr;
+};
+
+// Process wide XrPath interner, each distinct path string is resolved with xrStringToPath at most once
+// per XrInstance. XrPath values are only valid for the instance they were made with so the cache is
+// dropped when a different instance is used or OnInstanceDestroyed is called.
+class XrPathCache {
+public:
+    struct Stats {
+        std::uint64_t lookups;
+        std::uint64_t runtimeCalls;
+        std::size_t   size;
+    };
+
+    static XrPathCache& Instance() { return m_instance; }
+
+    XrPath Get(const XrInstance instance, const std::string_view path);
+    XrPath Get(const XrInstance instance, const XrPathSpec& spec);
+
+    // Resolves every path in specs (duplicates are skipped), returns the number of runtime calls made.
+    std::size_t Seed(const XrInstance instance, const std::span<const XrPathSpec> specs);
+
+    void OnInstanceDestroyed(const XrInstance instance);
+
+    Stats GetStats() const;
+
+private:
+    struct StringHash {
+        using is_transparent = void;
+        inline std::size_t operator()(const std::string_view str) const noexcept {
+            return std::hash<std::string_view>{}(str);
+        }
+    };
+    using PathMap = std::unordered_map<std::string, XrPath, StringHash, std::equal_to<>>;
+
+    XrPath GetLocked(const XrInstance instance, const std::string_view path);
+
+    mutable std::mutex m_mutex;
+    XrInstance    m_owner{ XR_NULL_HANDLE };
+    PathMap       m_paths;
+    std::uint64_t m_lookups = 0;
+    std::uint64_t m_runtimeCalls = 0;
+
+    static XrPathCache m_instance;
+};
+}
+#endif
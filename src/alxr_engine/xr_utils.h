@@ -59,6 +59,30 @@ constexpr inline const SpaceLoc IdentitySpaceLoc = { IdentityPose, {0,0,0}, {0,0
 constexpr inline const SpaceLoc ZeroSpaceLoc = { ZeroPose, {0,0,0}, {0,0,0} };
 constexpr inline const SpaceLoc InfinitySpaceLoc = { InfinityPose, {0,0,0}, {0,0,0} };
 
+// Takes the valid parts of a located space, the rest is left as in initLoc.
+inline SpaceLoc MakeSpaceLoc
+(
+    const XrSpaceLocationFlags locationFlags, const XrPosef& pose,
+    const XrSpaceVelocityFlags velocityFlags, const XrVector3f& linearVelocity, const XrVector3f& angularVelocity,
+    const SpaceLoc& initLoc = IdentitySpaceLoc
+)
+{
+    SpaceLoc result = initLoc;
+    if ((locationFlags & XR_SPACE_LOCATION_POSITION_VALID_BIT) != 0)
+        result.pose.position = pose.position;
+
+    if ((locationFlags & XR_SPACE_LOCATION_ORIENTATION_VALID_BIT) != 0)
+        result.pose.orientation = pose.orientation;
+
+    if ((velocityFlags & XR_SPACE_VELOCITY_LINEAR_VALID_BIT) != 0)
+        result.linearVelocity = linearVelocity;
+
+    if ((velocityFlags & XR_SPACE_VELOCITY_ANGULAR_VALID_BIT) != 0)
+        result.angularVelocity = angularVelocity;
+
+    return result;
+}
+
 inline SpaceLoc GetSpaceLocation
 (
     const XrSpace& targetSpace,
@@ -72,24 +96,10 @@ inline SpaceLoc GetSpaceLocation
     const auto res = xrLocateSpace(targetSpace, baseSpace, time, &spaceLocation);
     //CHECK_XRRESULT(res, "xrLocateSpace");
 
-    SpaceLoc result = initLoc;
     if (!XR_UNQUALIFIED_SUCCESS(res))
-        return result;
-
-    const auto& pose = spaceLocation.pose;
-    if ((spaceLocation.locationFlags & XR_SPACE_LOCATION_POSITION_VALID_BIT) != 0)
-        result.pose.position = pose.position;
-
-    if ((spaceLocation.locationFlags & XR_SPACE_LOCATION_ORIENTATION_VALID_BIT) != 0)
-        result.pose.orientation = pose.orientation;
-
-    if ((velocity.velocityFlags & XR_SPACE_VELOCITY_LINEAR_VALID_BIT) != 0)
-        result.linearVelocity = velocity.linearVelocity;
-
-    if ((velocity.velocityFlags & XR_SPACE_VELOCITY_ANGULAR_VALID_BIT) != 0)
-        result.angularVelocity = velocity.angularVelocity;
-
-    return result;
+        return initLoc;
+    return MakeSpaceLoc(spaceLocation.locationFlags, spaceLocation.pose,
+        velocity.velocityFlags, velocity.linearVelocity, velocity.angularVelocity, initLoc);
 }
 
 constexpr inline XrVector3f GetHandJointScale(const XrHandJointEXT jointType) {
@@ -20,6 +20,7 @@
 // Author: Dave Houlton <daveh@lunarg.com>
 //
 
+#include "api_dump_output.h"
 #include "hex_and_handles.h"
 #include "platform_utils.hpp"
 #include "xr_generated_api_dump.hpp"
@@ -29,14 +30,19 @@
 #include <openxr/openxr_loader_negotiation.h>
 
 #include <algorithm>
+#include <atomic>
 #include <cctype>
+#include <chrono>
+#include <condition_variable>
 #include <cstring>
 #include <fstream>
 #include <iostream>
+#include <memory>
 #include <mutex>
 #include <sstream>
 #include <stdexcept>
 #include <string>
+#include <thread>
 #include <tuple>
 #include <unordered_map>
 #include <utility>
@@ -58,6 +64,7 @@ enum ApiDumpRecordType {
     RECORD_TEXT_FILE,
     RECORD_HTML_FILE,
     RECORD_CODE_FILE,
+    RECORD_BINARY_FILE,
 };
 
 struct ApiDumpRecordInfo {
@@ -69,6 +76,223 @@ struct ApiDumpRecordInfo {
 static ApiDumpRecordInfo g_record_info = {};
 static std::mutex g_record_mutex = {};
 
+// Records commands in the binary format of api_dump_output.h.  Each thread serializes its commands
+// into its own buffer, full buffers are handed to a background thread that owns the single open
+// output file.  Partially filled buffers are collected by the writer periodically and on Flush().
+// The writer is stopped (flushed and joined) when the last instance is destroyed, never from a static
+// destructor: those run under the loader lock on Windows, where joining a thread can deadlock.
+class ApiDumpBinaryRecorder {
+   public:
+    ApiDumpBinaryRecorder() = default;
+    ApiDumpBinaryRecorder(const ApiDumpBinaryRecorder &) = delete;
+    ApiDumpBinaryRecorder &operator=(const ApiDumpBinaryRecorder &) = delete;
+
+    // A restart after Stop() appends to the file, keeping the sequence numbers and timestamps going.
+    bool Start(const std::string &file_name) {
+        std::unique_lock<std::mutex> lock(queue_mutex_);
+        if (writer_.joinable()) {
+            return true;
+        }
+        if (started_) {
+            file_.open(file_name, std::ios::out | std::ios::binary | std::ios::app);
+        } else {
+            file_.open(file_name, std::ios::out | std::ios::binary | std::ios::trunc);
+        }
+        if (!file_.is_open()) {
+            return false;
+        }
+        if (!started_) {
+            ApiDumpWriteBinaryFileHeader(file_);
+            start_time_ = std::chrono::steady_clock::now();
+            started_ = true;
+        }
+        stop_ = false;
+        writer_ = std::thread(&ApiDumpBinaryRecorder::WriterLoop, this);
+        running_.store(true, std::memory_order_release);
+        return true;
+    }
+
+    bool Record(const ApiDumpContents &contents) {
+        if (!running_.load(std::memory_order_acquire)) {
+            return false;
+        }
+        ThreadBuffer &thread_buffer = GetThreadBuffer();
+        const uint64_t sequence = next_sequence_.fetch_add(1, std::memory_order_relaxed);
+        const uint64_t timestamp_ns = static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start_time_).count());
+
+        std::unique_lock<std::mutex> lock(thread_buffer.mutex);
+        ApiDumpAppendBinaryRecord(thread_buffer.data, sequence, timestamp_ns, thread_buffer.thread_index, contents);
+        if (thread_buffer.data.size() < kBlockSize) {
+            return true;
+        }
+        std::vector<char> block;
+        block.reserve(kBlockSize + kBlockSize / 4);
+        block.swap(thread_buffer.data);
+        lock.unlock();
+        Submit(std::move(block));
+        return true;
+    }
+
+    // Blocks until everything recorded before the call is written to the file.
+    void Flush() {
+        std::unique_lock<std::mutex> lock(queue_mutex_);
+        if (!writer_.joinable()) {
+            return;
+        }
+        const uint64_t request = ++flush_requested_;
+        queue_cv_.notify_all();
+        flushed_cv_.wait(lock, [this, request] { return flush_completed_ >= request || !writer_.joinable(); });
+    }
+
+    // Writes everything recorded so far, then ends the writer thread and closes the file.
+    void Stop() {
+        std::unique_lock<std::mutex> lock(queue_mutex_);
+        if (!writer_.joinable()) {
+            return;
+        }
+        running_.store(false, std::memory_order_release);
+        stop_ = true;
+        queue_cv_.notify_all();
+        lock.unlock();
+        writer_.join();
+        file_.close();
+    }
+
+   private:
+    // Size at which a thread hands its buffer to the writer.
+    static constexpr size_t kBlockSize = 256 * 1024;
+    // Records waiting to be written beyond this make recording threads wait for the writer.
+    static constexpr size_t kMaxQueuedBytes = 64 * 1024 * 1024;
+    // How often the writer collects partially filled thread buffers.
+    static constexpr std::chrono::milliseconds kCollectInterval{250};
+
+    struct ThreadBuffer {
+        std::mutex mutex;  // Only contended while the writer collects a partially filled buffer.
+        std::vector<char> data;
+        uint32_t thread_index = 0;
+    };
+
+    // Hands the remaining records of a thread to the writer when the thread exits.
+    struct ThreadBufferOwner {
+        ApiDumpBinaryRecorder *recorder = nullptr;
+        std::shared_ptr<ThreadBuffer> buffer;
+        ~ThreadBufferOwner() {
+            if (recorder != nullptr) {
+                recorder->ReleaseThreadBuffer(buffer);
+            }
+        }
+    };
+
+    ThreadBuffer &GetThreadBuffer() {
+        thread_local ThreadBufferOwner owner;
+        if (!owner.buffer) {
+            owner.buffer = std::make_shared<ThreadBuffer>();
+            owner.buffer->data.reserve(kBlockSize + kBlockSize / 4);
+            owner.recorder = this;
+            std::unique_lock<std::mutex> lock(thread_buffers_mutex_);
+            owner.buffer->thread_index = next_thread_index_++;
+            thread_buffers_.push_back(owner.buffer);
+        }
+        return *owner.buffer;
+    }
+
+    void ReleaseThreadBuffer(const std::shared_ptr<ThreadBuffer> &buffer) {
+        {
+            std::unique_lock<std::mutex> lock(thread_buffers_mutex_);
+            thread_buffers_.erase(std::remove(thread_buffers_.begin(), thread_buffers_.end(), buffer), thread_buffers_.end());
+        }
+        std::vector<char> block;
+        {
+            std::unique_lock<std::mutex> lock(buffer->mutex);
+            block.swap(buffer->data);
+        }
+        if (!block.empty()) {
+            Submit(std::move(block));
+        }
+    }
+
+    void Submit(std::vector<char> &&block) {
+        std::unique_lock<std::mutex> lock(queue_mutex_);
+        if (!writer_.joinable()) {
+            return;
+        }
+        queue_space_cv_.wait(lock, [this] { return queued_bytes_ < kMaxQueuedBytes || stop_; });
+        queued_bytes_ += block.size();
+        queue_.push_back(std::move(block));
+        queue_cv_.notify_one();
+    }
+
+    // Moves whatever the recording threads have buffered so far into blocks.
+    void CollectThreadBuffers(std::vector<std::vector<char>> &blocks) {
+        std::unique_lock<std::mutex> lock(thread_buffers_mutex_);
+        for (const auto &buffer : thread_buffers_) {
+            std::unique_lock<std::mutex> buffer_lock(buffer->mutex);
+            if (!buffer->data.empty()) {
+                blocks.emplace_back();
+                blocks.back().reserve(kBlockSize + kBlockSize / 4);
+                blocks.back().swap(buffer->data);
+            }
+        }
+    }
+
+    void WriterLoop() {
+        std::vector<std::vector<char>> blocks;
+        std::unique_lock<std::mutex> lock(queue_mutex_);
+        for (;;) {
+            const bool timed_out = !queue_cv_.wait_for(lock, kCollectInterval, [this] {
+                return stop_ || flush_requested_ != flush_completed_ || !queue_.empty();
+            });
+            const bool stopping = stop_;
+            const uint64_t flush_request = flush_requested_;
+            blocks.swap(queue_);
+            queued_bytes_ = 0;
+            queue_space_cv_.notify_all();
+            lock.unlock();
+
+            if (timed_out || stopping || flush_request != flush_completed_) {
+                CollectThreadBuffers(blocks);
+            }
+            for (const auto &block : blocks) {
+                file_.write(block.data(), static_cast<std::streamsize>(block.size()));
+            }
+            blocks.clear();
+            file_.flush();
+
+            lock.lock();
+            flush_completed_ = flush_request;
+            flushed_cv_.notify_all();
+            if (stopping && queue_.empty()) {
+                break;
+            }
+        }
+    }
+
+    std::ofstream file_;
+    std::thread writer_;
+    std::atomic<bool> running_{false};
+    bool started_ = false;
+    std::chrono::steady_clock::time_point start_time_;
+    std::atomic<uint64_t> next_sequence_{0};
+
+    std::mutex thread_buffers_mutex_;
+    std::vector<std::shared_ptr<ThreadBuffer>> thread_buffers_;
+    uint32_t next_thread_index_ = 0;
+
+    std::mutex queue_mutex_;
+    std::condition_variable queue_cv_;
+    std::condition_variable queue_space_cv_;
+    std::condition_variable flushed_cv_;
+    std::vector<std::vector<char>> queue_;
+    size_t queued_bytes_ = 0;
+    bool stop_ = false;
+    uint64_t flush_requested_ = 0;
+    uint64_t flush_completed_ = 0;
+};
+
+// Intentionally never destroyed, see ApiDumpBinaryRecorder.
+static ApiDumpBinaryRecorder &g_binary_recorder = *new ApiDumpBinaryRecorder;
+
 // For routing platform_utils.hpp messages.
 void LogPlatformUtilsError(const std::string &message) {
 #if !defined(NDEBUG)
@@ -88,104 +312,7 @@ bool ApiDumpLayerWriteHtmlHeader() {
         std::unique_lock<std::mutex> mlock(g_record_mutex);
         std::ofstream html_file;
         html_file.open(g_record_info.file_name, std::ios::out);
-        html_file << "<!doctype html>\n"
-                     "<html>\n"
-                     "    <head>\n"
-                     "        <title>OpenXR API Dump</title>\n"
-                     "        <style type='text/css'>\n"
-                     "        html {\n"
-                     "            background-color: #0b1e48;\n"
-                     "            background-image: url('https://vulkan.lunarg.com/img/bg-starfield.jpg');\n"
-                     "            background-position: center;\n"
-                     "            -webkit-background-size: cover;\n"
-                     "            -moz-background-size: cover;\n"
-                     "            -o-background-size: cover;\n"
-                     "            background-size: cover;\n"
-                     "            background-attachment: fixed;\n"
-                     "            background-repeat: no-repeat;\n"
-                     "            height: 100%;\n"
-                     "        }\n"
-                     "        #header {\n"
-                     "            z-index: -1;\n"
-                     "        }\n"
-                     "        #header>img {\n"
-                     "            position: absolute;\n"
-                     "            width: 160px;\n"
-                     "            margin-left: -280px;\n"
-                     "            top: -10px;\n"
-                     "            left: 50%;\n"
-                     "        }\n"
-                     "        #header>h1 {\n"
-                     "            font-family: Arial, 'Helvetica Neue', Helvetica, sans-serif;\n"
-                     "            font-size: 44px;\n"
-                     "            font-weight: 200;\n"
-                     "            text-shadow: 4px 4px 5px #000;\n"
-                     "            color: #eee;\n"
-                     "            position: absolute;\n"
-                     "            width: 400px;\n"
-                     "            margin-left: -80px;\n"
-                     "            top: 8px;\n"
-                     "            left: 50%;\n"
-                     "        }\n"
-                     "        body {\n"
-                     "            font-family: Consolas, monaco, monospace;\n"
-                     "            font-size: 14px;\n"
-                     "            line-height: 20px;\n"
-                     "            color: #eee;\n"
-                     "            height: 100%;\n"
-                     "            margin: 0;\n"
-                     "            overflow: hidden;\n"
-                     "        }\n"
-                     "        #wrapper {\n"
-                     "            background-color: rgba(0, 0, 0, 0.7);\n"
-                     "            border: 1px solid #446;\n"
-                     "            box-shadow: 0px 0px 10px #000;\n"
-                     "            padding: 8px 12px;\n"
-                     "            display: inline-block;\n"
-                     "            position: absolute;\n"
-                     "            top: 80px;\n"
-                     "            bottom: 25px;\n"
-                     "            left: 50px;\n"
-                     "            right: 50px;\n"
-                     "            overflow: auto;\n"
-                     "        }\n"
-                     "        details>*:not(summary) {\n"
-                     "            margin-left: 22px;\n"
-                     "        }\n"
-                     "        summary:only-child {\n"
-                     "            display: block;\n"
-                     "            padding-left: 15px;\n"
-                     "        }\n"
-                     "        details>summary:only-child::-webkit-details-marker {\n"
-                     "            display: none;\n"
-                     "            padding-left: 15px;\n"
-                     "        }\n"
-                     "        .headervar, .headertype, .headerval {\n"
-                     "            display: inline;\n"
-                     "            margin: 0 9px;\n"
-                     "        }\n"
-                     "        .var, .type, .val {\n"
-                     "            display: inline;\n"
-                     "            margin: 0 6px;\n"
-                     "        }\n"
-                     "        .headertype, .type {\n"
-                     "            color: #acf;\n"
-                     "        }\n"
-                     "        .headerval, .val {\n"
-                     "            color: #afa;\n"
-                     "            text-align: right;\n"
-                     "        }\n"
-                     "        .thd {\n"
-                     "            color: #888;\n"
-                     "        }\n"
-                     "        </style>\n"
-                     "    </head>\n"
-                     "    <body>\n"
-                     "        <div id='header'>\n"
-                     "            <img src='https://lunarg.com/wp-content/uploads/2016/02/LunarG-wReg-150.png' />\n"
-                     "            <h1>OpenXR API Dump</h1>\n"
-                     "        </div>\n"
-                     "        <div id='wrapper'>\n";
+        ApiDumpWriteHtmlHeader(html_file);
         return true;
     } catch (...) {
         return false;
@@ -197,9 +324,7 @@ bool ApiDumpLayerWriteHtmlFooter() {
         std::unique_lock<std::mutex> mlock(g_record_mutex);
         std::ofstream html_file;
         html_file.open(g_record_info.file_name, std::ios::out | std::ios::app);
-        html_file << "        </div>\n"
-                     "    </body>\n"
-                     "</html>";
+        ApiDumpWriteHtmlFooter(html_file);
 
         // Writing the footer means we're done.
         if (g_record_info.initialized) {
@@ -227,48 +352,27 @@ XrInstance FindInstanceFromDispatchTable(XrGeneratedDispatchTable *dispatch_tabl
     return instance;
 }
 
-// Function to record all the API dump information
-bool ApiDumpLayerRecordContent(std::vector<std::tuple<std::string, std::string, std::string>> contents) {
+// Function to record all the API dump information.  The generated command wrappers still format every
+// parameter into (type, name, value) strings before calling this, the binary mode only saves the file
+// I/O and the lock shared between threads, not the per-call formatting.
+bool ApiDumpLayerRecordContent(const std::vector<std::tuple<std::string, std::string, std::string>> &contents) {
     bool success = false;
     if (g_record_info.initialized) {
+        if (g_record_info.type == RECORD_BINARY_FILE) {
+            // Serialized into a per-thread buffer, no lock shared between threads.
+            return g_binary_recorder.Record(contents);
+        }
         std::unique_lock<std::mutex> mlock(g_record_mutex);
-        uint32_t count = 0;
         switch (g_record_info.type) {
             case RECORD_TEXT_COUT: {
-                for (const auto &content : contents) {
-                    std::string content_type;
-                    std::string content_name;
-                    std::string content_value;
-                    std::tie(content_type, content_name, content_value) = content;
-                    if (count++ != 0) {
-                        std::cout << "    ";
-                    }
-                    if (!content_value.empty()) {
-                        std::cout << content_type << " " << content_name << " = " << content_value << "\n";
-                    } else {
-                        std::cout << content_type << " " << content_name << "\n";
-                    }
-                }
+                ApiDumpWriteTextRecord(std::cout, contents);
                 success = true;
                 break;
             }
             case RECORD_TEXT_FILE: {
                 std::ofstream text_file;
                 text_file.open(g_record_info.file_name, std::ios::out | std::ios::app);
-                for (const auto &content : contents) {
-                    std::string content_type;
-                    std::string content_name;
-                    std::string content_value;
-                    std::tie(content_type, content_name, content_value) = content;
-                    if (count++ != 0) {
-                        text_file << "    ";
-                    }
-                    if (!content_value.empty()) {
-                        text_file << content_type << " " << content_name << " = " << content_value << "\n";
-                    } else {
-                        text_file << content_type << " " << content_name << "\n";
-                    }
-                }
+                ApiDumpWriteTextRecord(text_file, contents);
                 text_file.close();
                 success = true;
                 break;
@@ -276,138 +380,7 @@ bool ApiDumpLayerRecordContent(std::vector<std::tuple<std::string, std::string,
             case RECORD_HTML_FILE: {
                 std::ofstream text_file;
                 text_file.open(g_record_info.file_name, std::ios::out | std::ios::app);
-                text_file << "<details class='data'>\n";
-                std::vector<std::string> prefixes;
-                uint32_t last_deref_count = 0;
-                for (uint32_t content_index = 0; content_index < contents.size(); ++content_index) {
-                    std::string content_type;
-                    std::string content_name;
-                    std::string content_value;
-                    std::tie(content_type, content_name, content_value) = contents[content_index];
-                    if (content_index == 0) {
-                        text_file << "   <summary>\n"
-                                  << "      <div class='headertype'>" << content_type << "</div>\n"
-                                  << "      <div class='headervar'>" << content_name << "</div>\n"
-                                  << "   </summary>\n";
-                    } else {
-                        uint32_t cur_deref_count = 0;
-                        uint32_t next_deref_count = 0;
-
-                        // Count number of structure and pointer dereferences for the current line
-                        cur_deref_count = static_cast<uint32_t>(std::count(content_name.begin(), content_name.end(), '.'));
-                        std::string::size_type start = 0;
-                        while ((start = content_name.find("->", start)) != std::string::npos) {
-                            ++cur_deref_count;
-                            start += 2;
-                        }
-                        // Now look for array dereferences
-                        start = 0;
-                        while ((start = content_name.find('[', start)) != std::string::npos) {
-                            ++cur_deref_count;
-                            start++;
-                        }
-
-                        // If there's something after this, see if it's a sub-component of this.
-                        if (content_index < contents.size() - 1) {
-                            std::string next_content_type;
-                            std::string next_content_name;
-                            std::string next_content_value;
-                            std::tie(next_content_type, next_content_name, next_content_value) = contents[content_index + 1];
-
-                            // Count number of structure and pointer dereferences for the next line
-                            next_deref_count =
-                                static_cast<uint32_t>(std::count(next_content_name.begin(), next_content_name.end(), '.'));
-                            start = 0;
-                            while ((start = next_content_name.find("->", start)) != std::string::npos) {
-                                ++next_deref_count;
-                                start += 2;
-                            }
-                            // Now look for array dereferences
-                            start = 0;
-                            while ((start = next_content_name.find('[', start)) != std::string::npos) {
-                                ++next_deref_count;
-                                start++;
-                            }
-                        }
-
-                        // If we've reduced the number of dereferences in the name from last time, we need
-                        // to close up those detail sections.
-                        if (cur_deref_count < last_deref_count) {
-                            uint32_t diff_count = last_deref_count - cur_deref_count;
-                            while ((diff_count--) != 0u) {
-                                text_file << "   </details>\n";
-                                prefixes.pop_back();
-                            }
-                        }
-
-                        // Look through any prefixes we've saved (going backwards through the list)
-                        // and find the one that matches our beginning.
-                        std::string short_name = content_name;
-                        if (cur_deref_count > 0) {
-                            for (auto it = prefixes.rbegin(); it != prefixes.rend(); ++it) {
-                                if (content_name.find(*it) == 0) {
-                                    std::string::size_type additional_offset = it->size() + 1;
-                                    if (content_name[additional_offset - 1] == '-') {
-                                        additional_offset++;
-                                    } else if (content_name[additional_offset - 1] == '[') {
-                                        additional_offset--;
-                                    }
-                                    short_name = content_name.substr(additional_offset);
-                                    break;
-                                }
-                            }
-                        }
-
-                        bool writing_summary = false;
-
-                        // If the next item contains this item as a prefix, start the summary.  Otherwise,
-                        // start a <div> marker so that each component lands on its own line.
-                        if (cur_deref_count < next_deref_count) {
-                            text_file << "   <details class='data'>\n"
-                                      << "      <summary>\n";
-                            writing_summary = true;
-                            prefixes.push_back(content_name);
-                        } else {
-                            text_file << "      <div class='data'>\n";
-                        }
-
-                        // Write out the content
-                        text_file << "         <div class='type'>" << content_type << "</div>\n"
-                                  << "         <div class='var'>" << short_name << "</div>\n";
-                        bool value_needs_printing = true;
-                        if (content_type.find("char") != std::string::npos) {
-                            uint64_t star_count = std::count(content_type.begin(), content_type.end(), '*');
-                            uint64_t bracket_count = std::count(content_type.begin(), content_type.end(), '[');
-                            if (star_count + bracket_count < 2) {
-                                text_file << "         <div class='val'>\"" << content_value << "\"</div>";
-                                value_needs_printing = false;
-                            }
-                        }
-                        if (!content_value.empty() && value_needs_printing) {
-                            text_file << "         <div class='val'>" << content_value << "</div>";
-                        }
-                        text_file << "\n";
-
-                        // Wrap up any summary we may have started.  Otherwise, just wrap up the
-                        // <div> marker wrapping this entry.
-                        if (writing_summary) {
-                            text_file << "      </summary>\n";
-                        } else {
-                            text_file << "      </div>\n";
-                        }
-
-                        last_deref_count = cur_deref_count;
-                    }
-                }
-
-                // Wrap up any remaining items
-                if (last_deref_count != 0u) {
-                    while ((last_deref_count--) != 0u) {
-                        text_file << "   </details>\n";
-                        prefixes.pop_back();
-                    }
-                }
-                text_file << "</details>\n";
+                ApiDumpWriteHtmlRecord(text_file, contents);
                 break;
             }
             default:
@@ -464,6 +437,12 @@ XRAPI_ATTR XrResult XRAPI_CALL ApiDumpLayerXrCreateApiLayerInstance(const XrInst
                 }
             } else if (export_type_lower == "code") {
                 g_record_info.type = RECORD_CODE_FILE;
+            } else if (export_type_lower == "binary") {
+                // Also restarts the recorder stopped when the previous last instance was destroyed.
+                if (g_record_info.file_name.empty() || !g_binary_recorder.Start(g_record_info.file_name)) {
+                    return XR_ERROR_INITIALIZATION_FAILED;
+                }
+                g_record_info.type = RECORD_BINARY_FILE;
             }
         }
 
@@ -588,6 +567,11 @@ XRAPI_ATTR XrResult XRAPI_CALL ApiDumpLayerXrDestroyInstance(XrInstance instance
     if (g_instance_dispatch_map.empty() && g_record_info.type == RECORD_HTML_FILE) {
         ApiDumpLayerWriteHtmlFooter();
     }
+    // Complete the recording on disk and end the writer thread once the last instance is gone, the next
+    // instance created restarts it appending to the same file.
+    if (g_instance_dispatch_map.empty() && g_record_info.type == RECORD_BINARY_FILE) {
+        g_binary_recorder.Stop();
+    }
     return XR_SUCCESS;
 }
 
@@ -0,0 +1,143 @@
+// Copyright (c) 2017-2024, The Khronos Group Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Converts a binary recording of the api_dump layer (XR_API_DUMP_EXPORT_TYPE=binary) to the
+// text or HTML output the layer produces directly.
+//
+//   api_dump_convert [--html] [--timing] <recording> [output]
+//
+// Without an output file the result goes to stdout.  --timing adds the recording thread and time
+// of each command to text output.
+
+#include "api_dump_output.h"
+
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <queue>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct LaterSequence {
+    bool operator()(const ApiDumpBinaryRecord &lhs, const ApiDumpBinaryRecord &rhs) const { return lhs.sequence > rhs.sequence; }
+};
+
+void PrintUsage() {
+    std::cerr << "usage: api_dump_convert [--html] [--timing] <recording> [output]\n";
+}
+
+void WriteRecord(std::ostream &out, const ApiDumpBinaryRecord &record, bool html, bool timing) {
+    if (html) {
+        ApiDumpWriteHtmlRecord(out, record.contents);
+        return;
+    }
+    if (timing) {
+        char line[64];
+        snprintf(line, sizeof(line), "[thread %" PRIu32 ", %.6f s]\n", record.thread_index,
+                 static_cast<double>(record.timestamp_ns) / 1e9);
+        out << line;
+    }
+    ApiDumpWriteTextRecord(out, record.contents);
+}
+
+}  // namespace
+
+int main(int argc, char *argv[]) {
+    bool html = false;
+    bool timing = false;
+    std::vector<std::string> files;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--html") == 0) {
+            html = true;
+        } else if (strcmp(argv[i], "--timing") == 0) {
+            timing = true;
+        } else if (argv[i][0] == '-' && argv[i][1] != '\0') {
+            PrintUsage();
+            return 1;
+        } else {
+            files.emplace_back(argv[i]);
+        }
+    }
+    if (files.empty() || files.size() > 2) {
+        PrintUsage();
+        return 1;
+    }
+
+    std::ifstream in(files[0], std::ios::in | std::ios::binary);
+    if (!in.is_open() || !ApiDumpReadBinaryFileHeader(in)) {
+        std::cerr << "api_dump_convert: " << files[0] << " is not an api_dump binary recording\n";
+        return 1;
+    }
+
+    std::ofstream out_file;
+    if (files.size() == 2) {
+        out_file.open(files[1], std::ios::out | std::ios::trunc);
+        if (!out_file.is_open()) {
+            std::cerr << "api_dump_convert: unable to open " << files[1] << "\n";
+            return 1;
+        }
+    }
+    std::ostream &out = out_file.is_open() ? static_cast<std::ostream &>(out_file) : std::cout;
+
+    if (html) {
+        ApiDumpWriteHtmlHeader(out);
+    }
+
+    // Records are stored in per-thread blocks; restore the call order by emitting them in sequence
+    // order.  Only records that arrive ahead of a gap are held back, so memory use is bounded by how
+    // far the threads' blocks are out of step rather than by the size of the recording.
+    std::priority_queue<ApiDumpBinaryRecord, std::vector<ApiDumpBinaryRecord>, LaterSequence> pending;
+    uint64_t next_sequence = 0;
+    uint64_t record_count = 0;
+    bool truncated = false;
+    ApiDumpBinaryRecord record;
+    while (in.peek() != std::char_traits<char>::eof()) {
+        if (!ApiDumpReadBinaryRecord(in, record)) {
+            truncated = true;
+            break;
+        }
+        ++record_count;
+        if (record.sequence != next_sequence) {
+            pending.push(std::move(record));
+            continue;
+        }
+        WriteRecord(out, record, html, timing);
+        ++next_sequence;
+        while (!pending.empty() && pending.top().sequence == next_sequence) {
+            WriteRecord(out, pending.top(), html, timing);
+            pending.pop();
+            ++next_sequence;
+        }
+    }
+    // Anything still pending follows records lost from the recording, e.g. when the application
+    // was terminated before they were written.
+    while (!pending.empty()) {
+        WriteRecord(out, pending.top(), html, timing);
+        pending.pop();
+    }
+    if (truncated) {
+        std::cerr << "api_dump_convert: recording is truncated after " << record_count << " records\n";
+    }
+
+    if (html) {
+        ApiDumpWriteHtmlFooter(out);
+    }
+    return 0;
+}
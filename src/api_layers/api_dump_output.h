@@ -0,0 +1,425 @@
+// Copyright (c) 2017-2024, The Khronos Group Inc.
+// Copyright (c) 2017-2019 Valve Corporation
+// Copyright (c) 2017-2019 LunarG, Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Author: Mark Young <marky@lunarg.com>
+// Author: Dave Houlton <daveh@lunarg.com>
+//
+
+// Output formats shared by the api_dump layer and the offline api_dump_convert tool.
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+// (type, name, value) of each line recorded for a single command.
+using ApiDumpContents = std::vector<std::tuple<std::string, std::string, std::string>>;
+
+// Text format
+
+inline void ApiDumpWriteTextRecord(std::ostream &out, const ApiDumpContents &contents) {
+    uint32_t count = 0;
+    for (const auto &content : contents) {
+        const std::string &content_type = std::get<0>(content);
+        const std::string &content_name = std::get<1>(content);
+        const std::string &content_value = std::get<2>(content);
+        if (count++ != 0) {
+            out << "    ";
+        }
+        if (!content_value.empty()) {
+            out << content_type << " " << content_name << " = " << content_value << "\n";
+        } else {
+            out << content_type << " " << content_name << "\n";
+        }
+    }
+}
+
+// HTML format
+
+inline void ApiDumpWriteHtmlHeader(std::ostream &out) {
+    out << "<!doctype html>\n"
+           "<html>\n"
+           "    <head>\n"
+           "        <title>OpenXR API Dump</title>\n"
+           "        <style type='text/css'>\n"
+           "        html {\n"
+           "            background-color: #0b1e48;\n"
+           "            background-image: url('https://vulkan.lunarg.com/img/bg-starfield.jpg');\n"
+           "            background-position: center;\n"
+           "            -webkit-background-size: cover;\n"
+           "            -moz-background-size: cover;\n"
+           "            -o-background-size: cover;\n"
+           "            background-size: cover;\n"
+           "            background-attachment: fixed;\n"
+           "            background-repeat: no-repeat;\n"
+           "            height: 100%;\n"
+           "        }\n"
+           "        #header {\n"
+           "            z-index: -1;\n"
+           "        }\n"
+           "        #header>img {\n"
+           "            position: absolute;\n"
+           "            width: 160px;\n"
+           "            margin-left: -280px;\n"
+           "            top: -10px;\n"
+           "            left: 50%;\n"
+           "        }\n"
+           "        #header>h1 {\n"
+           "            font-family: Arial, 'Helvetica Neue', Helvetica, sans-serif;\n"
+           "            font-size: 44px;\n"
+           "            font-weight: 200;\n"
+           "            text-shadow: 4px 4px 5px #000;\n"
+           "            color: #eee;\n"
+           "            position: absolute;\n"
+           "            width: 400px;\n"
+           "            margin-left: -80px;\n"
+           "            top: 8px;\n"
+           "            left: 50%;\n"
+           "        }\n"
+           "        body {\n"
+           "            font-family: Consolas, monaco, monospace;\n"
+           "            font-size: 14px;\n"
+           "            line-height: 20px;\n"
+           "            color: #eee;\n"
+           "            height: 100%;\n"
+           "            margin: 0;\n"
+           "            overflow: hidden;\n"
+           "        }\n"
+           "        #wrapper {\n"
+           "            background-color: rgba(0, 0, 0, 0.7);\n"
+           "            border: 1px solid #446;\n"
+           "            box-shadow: 0px 0px 10px #000;\n"
+           "            padding: 8px 12px;\n"
+           "            display: inline-block;\n"
+           "            position: absolute;\n"
+           "            top: 80px;\n"
+           "            bottom: 25px;\n"
+           "            left: 50px;\n"
+           "            right: 50px;\n"
+           "            overflow: auto;\n"
+           "        }\n"
+           "        details>*:not(summary) {\n"
+           "            margin-left: 22px;\n"
+           "        }\n"
+           "        summary:only-child {\n"
+           "            display: block;\n"
+           "            padding-left: 15px;\n"
+           "        }\n"
+           "        details>summary:only-child::-webkit-details-marker {\n"
+           "            display: none;\n"
+           "            padding-left: 15px;\n"
+           "        }\n"
+           "        .headervar, .headertype, .headerval {\n"
+           "            display: inline;\n"
+           "            margin: 0 9px;\n"
+           "        }\n"
+           "        .var, .type, .val {\n"
+           "            display: inline;\n"
+           "            margin: 0 6px;\n"
+           "        }\n"
+           "        .headertype, .type {\n"
+           "            color: #acf;\n"
+           "        }\n"
+           "        .headerval, .val {\n"
+           "            color: #afa;\n"
+           "            text-align: right;\n"
+           "        }\n"
+           "        .thd {\n"
+           "            color: #888;\n"
+           "        }\n"
+           "        </style>\n"
+           "    </head>\n"
+           "    <body>\n"
+           "        <div id='header'>\n"
+           "            <img src='https://lunarg.com/wp-content/uploads/2016/02/LunarG-wReg-150.png' />\n"
+           "            <h1>OpenXR API Dump</h1>\n"
+           "        </div>\n"
+           "        <div id='wrapper'>\n";
+}
+
+inline void ApiDumpWriteHtmlFooter(std::ostream &out) {
+    out << "        </div>\n"
+           "    </body>\n"
+           "</html>";
+}
+
+inline void ApiDumpWriteHtmlRecord(std::ostream &out, const ApiDumpContents &contents) {
+    out << "<details class='data'>\n";
+    std::vector<std::string> prefixes;
+    uint32_t last_deref_count = 0;
+    for (uint32_t content_index = 0; content_index < contents.size(); ++content_index) {
+        std::string content_type;
+        std::string content_name;
+        std::string content_value;
+        std::tie(content_type, content_name, content_value) = contents[content_index];
+        if (content_index == 0) {
+            out << "   <summary>\n"
+                << "      <div class='headertype'>" << content_type << "</div>\n"
+                << "      <div class='headervar'>" << content_name << "</div>\n"
+                << "   </summary>\n";
+        } else {
+            uint32_t cur_deref_count = 0;
+            uint32_t next_deref_count = 0;
+
+            // Count number of structure and pointer dereferences for the current line
+            cur_deref_count = static_cast<uint32_t>(std::count(content_name.begin(), content_name.end(), '.'));
+            std::string::size_type start = 0;
+            while ((start = content_name.find("->", start)) != std::string::npos) {
+                ++cur_deref_count;
+                start += 2;
+            }
+            // Now look for array dereferences
+            start = 0;
+            while ((start = content_name.find('[', start)) != std::string::npos) {
+                ++cur_deref_count;
+                start++;
+            }
+
+            // If there's something after this, see if it's a sub-component of this.
+            if (content_index < contents.size() - 1) {
+                std::string next_content_type;
+                std::string next_content_name;
+                std::string next_content_value;
+                std::tie(next_content_type, next_content_name, next_content_value) = contents[content_index + 1];
+
+                // Count number of structure and pointer dereferences for the next line
+                next_deref_count =
+                    static_cast<uint32_t>(std::count(next_content_name.begin(), next_content_name.end(), '.'));
+                start = 0;
+                while ((start = next_content_name.find("->", start)) != std::string::npos) {
+                    ++next_deref_count;
+                    start += 2;
+                }
+                // Now look for array dereferences
+                start = 0;
+                while ((start = next_content_name.find('[', start)) != std::string::npos) {
+                    ++next_deref_count;
+                    start++;
+                }
+            }
+
+            // If we've reduced the number of dereferences in the name from last time, we need
+            // to close up those detail sections.
+            if (cur_deref_count < last_deref_count) {
+                uint32_t diff_count = last_deref_count - cur_deref_count;
+                while ((diff_count--) != 0u) {
+                    out << "   </details>\n";
+                    prefixes.pop_back();
+                }
+            }
+
+            // Look through any prefixes we've saved (going backwards through the list)
+            // and find the one that matches our beginning.
+            std::string short_name = content_name;
+            if (cur_deref_count > 0) {
+                for (auto it = prefixes.rbegin(); it != prefixes.rend(); ++it) {
+                    if (content_name.find(*it) == 0) {
+                        std::string::size_type additional_offset = it->size() + 1;
+                        if (content_name[additional_offset - 1] == '-') {
+                            additional_offset++;
+                        } else if (content_name[additional_offset - 1] == '[') {
+                            additional_offset--;
+                        }
+                        short_name = content_name.substr(additional_offset);
+                        break;
+                    }
+                }
+            }
+
+            bool writing_summary = false;
+
+            // If the next item contains this item as a prefix, start the summary.  Otherwise,
+            // start a <div> marker so that each component lands on its own line.
+            if (cur_deref_count < next_deref_count) {
+                out << "   <details class='data'>\n"
+                    << "      <summary>\n";
+                writing_summary = true;
+                prefixes.push_back(content_name);
+            } else {
+                out << "      <div class='data'>\n";
+            }
+
+            // Write out the content
+            out << "         <div class='type'>" << content_type << "</div>\n"
+                << "         <div class='var'>" << short_name << "</div>\n";
+            bool value_needs_printing = true;
+            if (content_type.find("char") != std::string::npos) {
+                uint64_t star_count = std::count(content_type.begin(), content_type.end(), '*');
+                uint64_t bracket_count = std::count(content_type.begin(), content_type.end(), '[');
+                if (star_count + bracket_count < 2) {
+                    out << "         <div class='val'>\"" << content_value << "\"</div>";
+                    value_needs_printing = false;
+                }
+            }
+            if (!content_value.empty() && value_needs_printing) {
+                out << "         <div class='val'>" << content_value << "</div>";
+            }
+            out << "\n";
+
+            // Wrap up any summary we may have started.  Otherwise, just wrap up the
+            // <div> marker wrapping this entry.
+            if (writing_summary) {
+                out << "      </summary>\n";
+            } else {
+                out << "      </div>\n";
+            }
+
+            last_deref_count = cur_deref_count;
+        }
+    }
+
+    // Wrap up any remaining items
+    if (last_deref_count != 0u) {
+        while ((last_deref_count--) != 0u) {
+            out << "   </details>\n";
+            prefixes.pop_back();
+        }
+    }
+    out << "</details>\n";
+}
+
+// Binary format
+//
+// A binary recording is a file header followed by a stream of records.  Each thread serializes its
+// records into its own buffer and the buffers are written out as whole blocks, so records are grouped
+// by thread in the file rather than in call order; the sequence number restores the call order.
+//
+//   file header : char magic[8] = "XRAPIDMP", uint32_t version, uint32_t byte_order = 0x01020304
+//   record      : uint32_t size (of the rest of the record), uint64_t sequence, uint64_t timestamp_ns,
+//                 uint32_t thread_index, uint32_t count, then count * (type, name, value) strings
+//   string      : uint32_t length, char data[length]
+//
+// All values are in the byte order of the recording machine.
+
+static const char kApiDumpBinaryMagic[8] = {'X', 'R', 'A', 'P', 'I', 'D', 'M', 'P'};
+static const uint32_t kApiDumpBinaryVersion = 1;
+static const uint32_t kApiDumpBinaryByteOrder = 0x01020304;
+
+struct ApiDumpBinaryRecord {
+    uint64_t sequence;
+    uint64_t timestamp_ns;  // Since recording start.
+    uint32_t thread_index;  // Order in which threads first recorded a command.
+    ApiDumpContents contents;
+};
+
+inline void ApiDumpWriteBinaryFileHeader(std::ostream &out) {
+    out.write(kApiDumpBinaryMagic, sizeof(kApiDumpBinaryMagic));
+    out.write(reinterpret_cast<const char *>(&kApiDumpBinaryVersion), sizeof(kApiDumpBinaryVersion));
+    out.write(reinterpret_cast<const char *>(&kApiDumpBinaryByteOrder), sizeof(kApiDumpBinaryByteOrder));
+}
+
+inline bool ApiDumpReadBinaryFileHeader(std::istream &in) {
+    char magic[sizeof(kApiDumpBinaryMagic)] = {};
+    uint32_t version = 0;
+    uint32_t byte_order = 0;
+    in.read(magic, sizeof(magic));
+    in.read(reinterpret_cast<char *>(&version), sizeof(version));
+    in.read(reinterpret_cast<char *>(&byte_order), sizeof(byte_order));
+    return in.good() && memcmp(magic, kApiDumpBinaryMagic, sizeof(magic)) == 0 && version == kApiDumpBinaryVersion &&
+           byte_order == kApiDumpBinaryByteOrder;
+}
+
+// Serializes a record to the end of buffer.
+inline void ApiDumpAppendBinaryRecord(std::vector<char> &buffer, uint64_t sequence, uint64_t timestamp_ns, uint32_t thread_index,
+                                      const ApiDumpContents &contents) {
+    const auto append = [&buffer](const void *data, size_t size) {
+        const char *bytes = static_cast<const char *>(data);
+        buffer.insert(buffer.end(), bytes, bytes + size);
+    };
+    const auto append_string = [&append](const std::string &str) {
+        const uint32_t length = static_cast<uint32_t>(str.size());
+        append(&length, sizeof(length));
+        append(str.data(), length);
+    };
+
+    const size_t record_start = buffer.size();
+    const uint32_t count = static_cast<uint32_t>(contents.size());
+    uint32_t size = 0;
+    append(&size, sizeof(size));
+    append(&sequence, sizeof(sequence));
+    append(&timestamp_ns, sizeof(timestamp_ns));
+    append(&thread_index, sizeof(thread_index));
+    append(&count, sizeof(count));
+    for (const auto &content : contents) {
+        append_string(std::get<0>(content));
+        append_string(std::get<1>(content));
+        append_string(std::get<2>(content));
+    }
+    size = static_cast<uint32_t>(buffer.size() - record_start - sizeof(size));
+    memcpy(buffer.data() + record_start, &size, sizeof(size));
+}
+
+// Returns false at the end of the stream or on a truncated/corrupt record.
+inline bool ApiDumpReadBinaryRecord(std::istream &in, ApiDumpBinaryRecord &record) {
+    uint32_t size = 0;
+    if (!in.read(reinterpret_cast<char *>(&size), sizeof(size))) {
+        return false;
+    }
+    std::vector<char> payload(size);
+    if (!in.read(payload.data(), size)) {
+        return false;
+    }
+
+    size_t offset = 0;
+    const auto read = [&payload, &offset](void *data, size_t bytes) {
+        if (payload.size() - offset < bytes) {
+            return false;
+        }
+        memcpy(data, payload.data() + offset, bytes);
+        offset += bytes;
+        return true;
+    };
+    const auto read_string = [&payload, &offset, &read](std::string &str) {
+        uint32_t length = 0;
+        if (!read(&length, sizeof(length)) || payload.size() - offset < length) {
+            return false;
+        }
+        str.assign(payload.data() + offset, length);
+        offset += length;
+        return true;
+    };
+
+    uint32_t count = 0;
+    if (!read(&record.sequence, sizeof(record.sequence)) || !read(&record.timestamp_ns, sizeof(record.timestamp_ns)) ||
+        !read(&record.thread_index, sizeof(record.thread_index)) || !read(&count, sizeof(count))) {
+        return false;
+    }
+    // Every (type, name, value) takes at least 3 length fields.
+    if (count > (payload.size() - offset) / (3 * sizeof(uint32_t))) {
+        return false;
+    }
+    record.contents.clear();
+    record.contents.reserve(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        std::string type;
+        std::string name;
+        std::string value;
+        if (!read_string(type) || !read_string(name) || !read_string(value)) {
+            return false;
+        }
+        record.contents.emplace_back(std::move(type), std::move(name), std::move(value));
+    }
+    return true;
+}
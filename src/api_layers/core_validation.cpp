@@ -585,10 +585,7 @@ XRAPI_ATTR XrResult XRAPI_CALL CoreValidationXrCreateApiLayerInstance(const XrIn
 
 void EraseAllInstanceTableMapElements(GenValidUsageXrInstanceInfo *search_value) {
     typedef typename InstanceHandleInfo::value_t value_t;
-    auto map_with_lock = g_instance_info.lockMap();
-    auto &map = map_with_lock.second;
-
-    map_erase_if(map, [=](value_t const &data) { return data.second.get() == search_value; });
+    g_instance_info.eraseIf([=](value_t const &data) { return data.second.get() == search_value; });
 }
 
 XRAPI_ATTR XrResult XRAPI_CALL CoreValidationXrDestroyInstance(XrInstance instance) {
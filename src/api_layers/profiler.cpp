@@ -0,0 +1,743 @@
+// Copyright (c) 2017-2024, The Khronos Group Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Runtime call profiler API layer: records the call count and a latency histogram of each per-frame
+// OpenXR command, broken down by the class of thread calling it, and writes them out as JSON and/or
+// CSV when the session ends.
+//
+
+#include "platform_utils.hpp"
+
+#include <openxr/openxr.h>
+#include <openxr/openxr_loader_negotiation.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cctype>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#if defined(XR_OS_LINUX) || defined(XR_OS_ANDROID)
+#include <sys/prctl.h>
+#endif
+
+#if defined(__GNUC__) && __GNUC__ >= 4
+#define LAYER_EXPORT __attribute__((visibility("default")))
+#elif defined(__SUNPRO_C) && (__SUNPRO_C >= 0x590)
+#define LAYER_EXPORT __attribute__((visibility("default")))
+#elif defined(_WIN32)
+#define LAYER_EXPORT __declspec(dllexport)
+#else
+#define LAYER_EXPORT
+#endif
+
+static constexpr const char *kProfilerLayerName = "XR_APILAYER_ALXR_profiler";
+
+// Which class of thread a call to a command hints at: a thread which runs any of the frame loop
+// commands is a render thread, otherwise one which polls input or tracking is an input thread.
+enum ProfilerThreadHint : std::uint32_t {
+    HINT_NONE = 0,
+    HINT_RENDER = 1 << 0,
+    HINT_INPUT = 1 << 1,
+};
+
+// The profiled commands, all of them are called at least once per frame by a streaming client.
+#define PROFILER_FOR_EACH_COMMAND(X)            \
+    X(xrWaitFrame, HINT_RENDER)                 \
+    X(xrBeginFrame, HINT_RENDER)                \
+    X(xrEndFrame, HINT_RENDER)                  \
+    X(xrLocateViews, HINT_NONE)                 \
+    X(xrAcquireSwapchainImage, HINT_RENDER)     \
+    X(xrWaitSwapchainImage, HINT_RENDER)        \
+    X(xrReleaseSwapchainImage, HINT_RENDER)     \
+    X(xrLocateSpace, HINT_INPUT)                \
+    X(xrSyncActions, HINT_INPUT)                \
+    X(xrGetActionStateBoolean, HINT_INPUT)      \
+    X(xrGetActionStateFloat, HINT_INPUT)        \
+    X(xrGetActionStateVector2f, HINT_INPUT)     \
+    X(xrGetActionStatePose, HINT_INPUT)         \
+    X(xrApplyHapticFeedback, HINT_NONE)         \
+    X(xrStopHapticFeedback, HINT_NONE)          \
+    X(xrPollEvent, HINT_NONE)                   \
+    X(xrLocateHandJointsEXT, HINT_INPUT)        \
+    X(xrGetEyeGazesFB, HINT_INPUT)              \
+    X(xrGetFaceExpressionWeightsFB, HINT_INPUT) \
+    X(xrGetFaceExpressionWeights2FB, HINT_INPUT) \
+    X(xrGetFacialExpressionsHTC, HINT_INPUT)
+
+enum ProfilerCommand : std::uint32_t {
+#define PROFILER_COMMAND_ID(name, hint) PROFILER_COMMAND_##name,
+    PROFILER_FOR_EACH_COMMAND(PROFILER_COMMAND_ID)
+#undef PROFILER_COMMAND_ID
+        PROFILER_COMMAND_COUNT
+};
+
+struct ProfilerCommandInfo {
+    const char *name;
+    ProfilerThreadHint hint;
+};
+
+static constexpr const ProfilerCommandInfo g_command_info[PROFILER_COMMAND_COUNT] = {
+#define PROFILER_COMMAND_INFO(name, hint) {#name, hint},
+    PROFILER_FOR_EACH_COMMAND(PROFILER_COMMAND_INFO)
+#undef PROFILER_COMMAND_INFO
+};
+
+enum ProfilerThreadClass : std::uint32_t {
+    THREAD_CLASS_RENDER = 0,
+    THREAD_CLASS_INPUT,
+    THREAD_CLASS_DECODER,
+    THREAD_CLASS_OTHER,
+    THREAD_CLASS_COUNT
+};
+
+static constexpr const char *g_thread_class_names[THREAD_CLASS_COUNT] = {"render", "input", "decoder", "other"};
+
+// Log-linear latency histogram in nanoseconds, 4 sub-buckets per power of two (at most 25% relative
+// error) up to 2^40ns, longer calls land in the last bucket.  Only ever written by the thread owning
+// it, so counters are updated with plain relaxed load/store pairs instead of locked read-modify-writes,
+// the atomics only make concurrent reads from the dump well defined.
+struct ProfilerHistogram {
+    static constexpr std::uint32_t kSubBucketBits = 2;
+    static constexpr std::uint32_t kSubBucketCount = 1u << kSubBucketBits;
+    static constexpr std::uint32_t kMaxExponent = 40;
+    static constexpr std::uint32_t kBucketCount = kMaxExponent * kSubBucketCount;
+
+    std::atomic<std::uint64_t> count{0};
+    std::atomic<std::uint64_t> total_ns{0};
+    std::atomic<std::uint64_t> max_ns{0};
+    std::array<std::atomic<std::uint64_t>, kBucketCount> buckets{};
+
+    static std::uint32_t BucketIndex(std::uint64_t ns) {
+        if (ns < kSubBucketCount) {
+            return static_cast<std::uint32_t>(ns);
+        }
+        const auto exponent = std::min<std::uint32_t>(static_cast<std::uint32_t>(std::bit_width(ns)) - 1, kMaxExponent);
+        const auto sub_bucket = static_cast<std::uint32_t>(ns >> (exponent - kSubBucketBits)) & (kSubBucketCount - 1);
+        return std::min((exponent - 1) * kSubBucketCount + sub_bucket, kBucketCount - 1);
+    }
+
+    // Exclusive upper bound of a bucket.
+    static std::uint64_t BucketLimit(std::uint32_t index) {
+        if (index < kSubBucketCount) {
+            return index + 1;
+        }
+        const std::uint32_t exponent = index / kSubBucketCount + 1;
+        const std::uint64_t sub_bucket = index % kSubBucketCount;
+        return (kSubBucketCount + sub_bucket + 1) << (exponent - kSubBucketBits);
+    }
+
+    static void Add(std::atomic<std::uint64_t> &counter, std::uint64_t value) {
+        counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    }
+
+    void Record(std::uint64_t ns) {
+        Add(count, 1);
+        Add(total_ns, ns);
+        if (ns > max_ns.load(std::memory_order_relaxed)) {
+            max_ns.store(ns, std::memory_order_relaxed);
+        }
+        Add(buckets[BucketIndex(ns)], 1);
+    }
+
+    void Clear() {
+        count.store(0, std::memory_order_relaxed);
+        total_ns.store(0, std::memory_order_relaxed);
+        max_ns.store(0, std::memory_order_relaxed);
+        for (auto &bucket : buckets) {
+            bucket.store(0, std::memory_order_relaxed);
+        }
+    }
+};
+
+// Non-atomic copy of (the sum of) histograms taken by the dump.
+struct ProfilerSnapshot {
+    std::uint64_t count = 0;
+    std::uint64_t total_ns = 0;
+    std::uint64_t max_ns = 0;
+    std::array<std::uint64_t, ProfilerHistogram::kBucketCount> buckets{};
+
+    void Merge(const ProfilerHistogram &histogram) {
+        count += histogram.count.load(std::memory_order_relaxed);
+        total_ns += histogram.total_ns.load(std::memory_order_relaxed);
+        max_ns = std::max(max_ns, histogram.max_ns.load(std::memory_order_relaxed));
+        for (std::uint32_t i = 0; i < ProfilerHistogram::kBucketCount; ++i) {
+            buckets[i] += histogram.buckets[i].load(std::memory_order_relaxed);
+        }
+    }
+
+    void Merge(const ProfilerSnapshot &other) {
+        count += other.count;
+        total_ns += other.total_ns;
+        max_ns = std::max(max_ns, other.max_ns);
+        for (std::uint32_t i = 0; i < ProfilerHistogram::kBucketCount; ++i) {
+            buckets[i] += other.buckets[i];
+        }
+    }
+
+    // Upper bound of the bucket holding the percentile, never above the longest recorded call.
+    std::uint64_t PercentileNs(double percentile) const {
+        if (count == 0) {
+            return 0;
+        }
+        const auto rank = static_cast<std::uint64_t>(percentile * static_cast<double>(count - 1));
+        std::uint64_t seen = 0;
+        for (std::uint32_t i = 0; i < ProfilerHistogram::kBucketCount; ++i) {
+            seen += buckets[i];
+            if (seen > rank) {
+                return std::min(ProfilerHistogram::BucketLimit(i) - 1, max_ns);
+            }
+        }
+        return max_ns;
+    }
+};
+
+// Per thread profile, allocated on the first profiled call a thread makes and kept until the layer is
+// unloaded so the calls of threads which exited before the session ended are still written out.
+struct ProfilerThreadStats {
+    std::uint32_t index = 0;
+    std::string name;
+    std::atomic<std::uint32_t> hints{HINT_NONE};
+    // Session epoch the histograms belong to, stored last when the owning thread clears them.
+    std::atomic<std::uint64_t> epoch{0};
+    std::array<ProfilerHistogram, PROFILER_COMMAND_COUNT> commands{};
+
+    void Restart(std::uint64_t new_epoch) {
+        for (auto &command : commands) {
+            command.Clear();
+        }
+        epoch.store(new_epoch, std::memory_order_release);
+    }
+};
+
+enum ProfilerExportType : std::uint32_t {
+    EXPORT_JSON = 1 << 0,
+    EXPORT_CSV = 1 << 1,
+};
+
+struct ProfilerSessionInfo {
+    bool active = false;
+    std::uint32_t index = 0;
+    std::chrono::steady_clock::time_point start_time{};
+};
+
+// Next function pointers of the profiled instance, only one instance is profiled at a time, the
+// commands of any other instance are passed straight through.
+static XrInstance g_profiled_instance = XR_NULL_HANDLE;
+static std::array<PFN_xrVoidFunction, PROFILER_COMMAND_COUNT> g_next_commands{};
+static PFN_xrDestroyInstance g_next_destroy_instance = nullptr;
+static PFN_xrCreateSession g_next_create_session = nullptr;
+static PFN_xrDestroySession g_next_destroy_session = nullptr;
+
+static std::mutex g_instance_mutex = {};
+static std::unordered_map<XrInstance, PFN_xrGetInstanceProcAddr> g_next_get_instance_proc_addr_map = {};
+
+static std::atomic<std::uint64_t> g_epoch{0};
+static std::mutex g_thread_stats_mutex = {};
+static std::vector<std::unique_ptr<ProfilerThreadStats>> g_thread_stats = {};
+
+static std::mutex g_session_mutex = {};
+static ProfilerSessionInfo g_session = {};
+
+// For routing platform_utils.hpp messages.
+void LogPlatformUtilsError(const std::string &message) {
+#if !defined(NDEBUG)
+    std::cerr << message << std::endl;
+#if defined(XR_OS_WINDOWS)
+    OutputDebugStringA((message + "\n").c_str());
+#endif
+#else
+    // Unused
+    (void)message;
+#endif
+}
+
+static std::string ProfilerGetCurrentThreadName() {
+#if defined(XR_OS_LINUX) || defined(XR_OS_ANDROID)
+    char name[17] = {};
+    if (prctl(PR_GET_NAME, name, 0, 0, 0) == 0) {
+        return name;
+    }
+#elif defined(XR_OS_WINDOWS)
+    // GetThreadDescription is only available from Windows 10 1607.
+    using PFN_GetThreadDescription = HRESULT(WINAPI *)(HANDLE, PWSTR *);
+    static const auto get_thread_description = reinterpret_cast<PFN_GetThreadDescription>(
+        reinterpret_cast<void (*)()>(GetProcAddress(GetModuleHandleW(L"kernel32.dll"), "GetThreadDescription")));
+    PWSTR description = nullptr;
+    if (get_thread_description != nullptr && SUCCEEDED(get_thread_description(GetCurrentThread(), &description))) {
+        std::string name;
+        for (PWSTR c = description; *c != L'\0'; ++c) {
+            name += (*c < 0x80) ? static_cast<char>(*c) : '?';
+        }
+        LocalFree(description);
+        return name;
+    }
+#endif
+    return {};
+}
+
+static ProfilerThreadStats *ProfilerRegisterThread() {
+    auto stats = std::make_unique<ProfilerThreadStats>();
+    stats->name = ProfilerGetCurrentThreadName();
+    std::unique_lock<std::mutex> mlock(g_thread_stats_mutex);
+    stats->index = static_cast<std::uint32_t>(g_thread_stats.size());
+    g_thread_stats.push_back(std::move(stats));
+    return g_thread_stats.back().get();
+}
+
+static void ProfilerRecord(ProfilerCommand command, std::chrono::steady_clock::duration elapsed) {
+    thread_local ProfilerThreadStats *thread_stats = ProfilerRegisterThread();
+    const std::uint64_t epoch = g_epoch.load(std::memory_order_relaxed);
+    if (thread_stats->epoch.load(std::memory_order_relaxed) != epoch) {
+        thread_stats->Restart(epoch);
+    }
+    const std::uint32_t hint = g_command_info[command].hint;
+    const std::uint32_t hints = thread_stats->hints.load(std::memory_order_relaxed);
+    if ((hints & hint) != hint) {
+        thread_stats->hints.store(hints | hint, std::memory_order_relaxed);
+    }
+    const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+    thread_stats->commands[command].Record(ns > 0 ? static_cast<std::uint64_t>(ns) : 0);
+}
+
+// Wraps the next layer's (or the runtime's) implementation of a command with a timer, Command selects
+// the next function pointer and the histogram.
+template <ProfilerCommand Command, typename Pfn>
+struct ProfiledCommand;
+
+template <ProfilerCommand Command, typename... Args>
+struct ProfiledCommand<Command, XrResult(XRAPI_PTR *)(Args...)> {
+    using Pfn = XrResult(XRAPI_PTR *)(Args...);
+
+    static XRAPI_ATTR XrResult XRAPI_CALL Call(Args... args) {
+        const auto next = reinterpret_cast<Pfn>(g_next_commands[Command]);
+        const auto start = std::chrono::steady_clock::now();
+        const XrResult result = next(args...);
+        ProfilerRecord(Command, std::chrono::steady_clock::now() - start);
+        return result;
+    }
+};
+
+static const std::array<PFN_xrVoidFunction, PROFILER_COMMAND_COUNT> g_profiled_commands = {
+#define PROFILER_COMMAND_WRAPPER(name, hint) \
+    reinterpret_cast<PFN_xrVoidFunction>(&ProfiledCommand<PROFILER_COMMAND_##name, PFN_##name>::Call),
+    PROFILER_FOR_EACH_COMMAND(PROFILER_COMMAND_WRAPPER)
+#undef PROFILER_COMMAND_WRAPPER
+};
+
+static ProfilerThreadClass ProfilerClassifyThread(const ProfilerThreadStats &stats) {
+    // Threads named by the application take precedence over what they were seen calling.
+    std::string name = stats.name;
+    std::transform(name.begin(), name.end(), name.begin(), [](unsigned char c) { return std::tolower(c); });
+    if (name.find("decod") != std::string::npos) {
+        return THREAD_CLASS_DECODER;
+    }
+    if (name.find("render") != std::string::npos) {
+        return THREAD_CLASS_RENDER;
+    }
+    if (name.find("input") != std::string::npos || name.find("track") != std::string::npos) {
+        return THREAD_CLASS_INPUT;
+    }
+    const std::uint32_t hints = stats.hints.load(std::memory_order_relaxed);
+    if ((hints & HINT_RENDER) != 0) {
+        return THREAD_CLASS_RENDER;
+    }
+    if ((hints & HINT_INPUT) != 0) {
+        return THREAD_CLASS_INPUT;
+    }
+    return THREAD_CLASS_OTHER;
+}
+
+static std::string ProfilerJsonEscape(const std::string &value) {
+    std::string escaped;
+    for (const char c : value) {
+        if (c == '"' || c == '\\') {
+            escaped += '\\';
+            escaped += c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            escaped += ' ';
+        } else {
+            escaped += c;
+        }
+    }
+    return escaped;
+}
+
+struct ProfilerThreadSummary {
+    std::uint32_t index;
+    std::string name;
+    ProfilerThreadClass thread_class;
+    std::uint64_t calls;
+};
+
+struct ProfilerCommandSummary {
+    ProfilerCommand command;
+    ProfilerSnapshot all;
+    std::array<ProfilerSnapshot, THREAD_CLASS_COUNT> by_class;
+};
+
+static void ProfilerWriteStats(std::ostream &out, const ProfilerSnapshot &snapshot) {
+    out << std::fixed << std::setprecision(3) << "\"count\": " << snapshot.count
+        << ", \"total_ms\": " << snapshot.total_ns * 1e-6
+        << ", \"mean_us\": " << (snapshot.count ? snapshot.total_ns * 1e-3 / snapshot.count : 0.0)
+        << ", \"p50_us\": " << snapshot.PercentileNs(0.50) * 1e-3 << ", \"p90_us\": " << snapshot.PercentileNs(0.90) * 1e-3
+        << ", \"p99_us\": " << snapshot.PercentileNs(0.99) * 1e-3 << ", \"max_us\": " << snapshot.max_ns * 1e-3;
+}
+
+static void ProfilerWriteJson(std::ostream &out, const ProfilerSessionInfo &session, double duration_s,
+                              const std::vector<ProfilerCommandSummary> &commands,
+                              const std::vector<ProfilerThreadSummary> &threads) {
+    std::uint64_t total_ns = 0;
+    for (const auto &command : commands) {
+        total_ns += command.all.total_ns;
+    }
+    out << "{\n  \"session\": " << session.index << ",\n  \"duration_s\": " << std::fixed << std::setprecision(3)
+        << duration_s << ",\n  \"commands\": [";
+    bool first_command = true;
+    for (const auto &command : commands) {
+        out << (first_command ? "\n" : ",\n") << "    {\"name\": \"" << g_command_info[command.command].name << "\", ";
+        ProfilerWriteStats(out, command.all);
+        out << ", \"time_share\": " << (total_ns ? static_cast<double>(command.all.total_ns) / total_ns : 0.0)
+            << ",\n     \"threads\": {";
+        bool first_class = true;
+        for (std::uint32_t thread_class = 0; thread_class < THREAD_CLASS_COUNT; ++thread_class) {
+            if (command.by_class[thread_class].count == 0) {
+                continue;
+            }
+            out << (first_class ? "" : ", ") << "\"" << g_thread_class_names[thread_class] << "\": {";
+            ProfilerWriteStats(out, command.by_class[thread_class]);
+            out << "}";
+            first_class = false;
+        }
+        out << "}}";
+        first_command = false;
+    }
+    out << "\n  ],\n  \"threads\": [";
+    bool first_thread = true;
+    for (const auto &thread : threads) {
+        out << (first_thread ? "\n" : ",\n") << "    {\"index\": " << thread.index << ", \"name\": \""
+            << ProfilerJsonEscape(thread.name) << "\", \"class\": \"" << g_thread_class_names[thread.thread_class]
+            << "\", \"calls\": " << thread.calls << "}";
+        first_thread = false;
+    }
+    out << "\n  ]\n}\n";
+}
+
+static void ProfilerWriteCsvRow(std::ostream &out, std::uint32_t session_index, ProfilerCommand command,
+                                const char *thread_class, const ProfilerSnapshot &snapshot) {
+    out << session_index << "," << g_command_info[command].name << "," << thread_class << "," << snapshot.count << ","
+        << std::fixed << std::setprecision(3) << snapshot.total_ns * 1e-6 << ","
+        << (snapshot.count ? snapshot.total_ns * 1e-3 / snapshot.count : 0.0) << "," << snapshot.PercentileNs(0.50) * 1e-3
+        << "," << snapshot.PercentileNs(0.90) * 1e-3 << "," << snapshot.PercentileNs(0.99) * 1e-3 << ","
+        << snapshot.max_ns * 1e-3 << "\n";
+}
+
+static void ProfilerWriteCsv(std::ostream &out, const ProfilerSessionInfo &session,
+                             const std::vector<ProfilerCommandSummary> &commands) {
+    out << "session,command,thread_class,count,total_ms,mean_us,p50_us,p90_us,p99_us,max_us\n";
+    for (const auto &command : commands) {
+        ProfilerWriteCsvRow(out, session.index, command.command, "all", command.all);
+        for (std::uint32_t thread_class = 0; thread_class < THREAD_CLASS_COUNT; ++thread_class) {
+            if (command.by_class[thread_class].count != 0) {
+                ProfilerWriteCsvRow(out, session.index, command.command, g_thread_class_names[thread_class],
+                                    command.by_class[thread_class]);
+            }
+        }
+    }
+}
+
+static std::uint32_t ProfilerGetExportTypes() {
+    std::string export_type = PlatformUtilsGetEnv("XR_PROFILER_EXPORT_TYPE");
+    std::transform(export_type.begin(), export_type.end(), export_type.begin(),
+                   [](unsigned char c) { return std::tolower(c); });
+    if (export_type == "json") {
+        return EXPORT_JSON;
+    }
+    if (export_type == "csv") {
+        return EXPORT_CSV;
+    }
+    return EXPORT_JSON | EXPORT_CSV;
+}
+
+// Writes out the profile of the session which just ended, called with g_session_mutex held.
+static void ProfilerDumpSession() {
+    if (!g_session.active) {
+        return;
+    }
+    g_session.active = false;
+    const double duration_s =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - g_session.start_time).count();
+    const std::uint64_t epoch = g_epoch.load(std::memory_order_relaxed);
+
+    std::vector<ProfilerCommandSummary> commands(PROFILER_COMMAND_COUNT);
+    for (std::uint32_t command = 0; command < PROFILER_COMMAND_COUNT; ++command) {
+        commands[command].command = static_cast<ProfilerCommand>(command);
+    }
+    std::vector<ProfilerThreadSummary> threads;
+    {
+        std::unique_lock<std::mutex> mlock(g_thread_stats_mutex);
+        for (const auto &stats : g_thread_stats) {
+            // Threads which made no profiled call during this session still hold an older session's calls.
+            if (stats->epoch.load(std::memory_order_acquire) != epoch) {
+                continue;
+            }
+            const ProfilerThreadClass thread_class = ProfilerClassifyThread(*stats);
+            std::uint64_t calls = 0;
+            for (std::uint32_t command = 0; command < PROFILER_COMMAND_COUNT; ++command) {
+                commands[command].by_class[thread_class].Merge(stats->commands[command]);
+                calls += stats->commands[command].count.load(std::memory_order_relaxed);
+            }
+            threads.push_back({stats->index, stats->name, thread_class, calls});
+        }
+    }
+    for (auto &command : commands) {
+        for (const auto &by_class : command.by_class) {
+            command.all.Merge(by_class);
+        }
+    }
+    commands.erase(std::remove_if(commands.begin(), commands.end(),
+                                  [](const ProfilerCommandSummary &command) { return command.all.count == 0; }),
+                   commands.end());
+    // Most expensive commands first, this is what the profile is read for.
+    std::sort(commands.begin(), commands.end(), [](const ProfilerCommandSummary &lhs, const ProfilerCommandSummary &rhs) {
+        return lhs.all.total_ns > rhs.all.total_ns;
+    });
+
+    std::string file_name = PlatformUtilsGetEnv("XR_PROFILER_FILE_NAME");
+    if (file_name.empty()) {
+        file_name = "xr_profiler";
+    }
+    file_name += "_session" + std::to_string(g_session.index);
+    const std::uint32_t export_types = ProfilerGetExportTypes();
+    if ((export_types & EXPORT_JSON) != 0) {
+        std::ofstream json_file(file_name + ".json", std::ios::out | std::ios::trunc);
+        if (json_file) {
+            ProfilerWriteJson(json_file, g_session, duration_s, commands, threads);
+        } else {
+            std::cerr << kProfilerLayerName << ": failed to open " << file_name << ".json" << std::endl;
+        }
+    }
+    if ((export_types & EXPORT_CSV) != 0) {
+        std::ofstream csv_file(file_name + ".csv", std::ios::out | std::ios::trunc);
+        if (csv_file) {
+            ProfilerWriteCsv(csv_file, g_session, commands);
+        } else {
+            std::cerr << kProfilerLayerName << ": failed to open " << file_name << ".csv" << std::endl;
+        }
+    }
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL ProfilerLayerXrCreateSession(XrInstance instance, const XrSessionCreateInfo *createInfo,
+                                                            XrSession *session) {
+    const XrResult result = g_next_create_session(instance, createInfo, session);
+    if (XR_SUCCEEDED(result)) {
+        std::unique_lock<std::mutex> mlock(g_session_mutex);
+        ProfilerDumpSession();
+        ++g_session.index;
+        g_session.active = true;
+        g_session.start_time = std::chrono::steady_clock::now();
+        // Threads restart their histograms on their next call.
+        g_epoch.fetch_add(1, std::memory_order_relaxed);
+    }
+    return result;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL ProfilerLayerXrDestroySession(XrSession session) {
+    const XrResult result = g_next_destroy_session(session);
+    if (XR_SUCCEEDED(result)) {
+        std::unique_lock<std::mutex> mlock(g_session_mutex);
+        ProfilerDumpSession();
+    }
+    return result;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL ProfilerLayerXrDestroyInstance(XrInstance instance) {
+    PFN_xrDestroyInstance next_destroy_instance = nullptr;
+    {
+        std::unique_lock<std::mutex> mlock(g_instance_mutex);
+        if (instance != g_profiled_instance) {
+            return XR_ERROR_HANDLE_INVALID;
+        }
+        next_destroy_instance = g_next_destroy_instance;
+    }
+
+    // Destroying the instance destroys its session, in case the application did not.
+    {
+        std::unique_lock<std::mutex> mlock(g_session_mutex);
+        ProfilerDumpSession();
+    }
+    const XrResult result = next_destroy_instance(instance);
+
+    std::unique_lock<std::mutex> mlock(g_instance_mutex);
+    g_next_get_instance_proc_addr_map.erase(instance);
+    g_profiled_instance = XR_NULL_HANDLE;
+    return result;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL ProfilerLayerXrGetInstanceProcAddr(XrInstance instance, const char *name,
+                                                                  PFN_xrVoidFunction *function) {
+    if (nullptr == name || nullptr == function) {
+        return XR_ERROR_VALIDATION_FAILURE;
+    }
+    if (0 == strcmp(name, "xrGetInstanceProcAddr")) {
+        *function = reinterpret_cast<PFN_xrVoidFunction>(ProfilerLayerXrGetInstanceProcAddr);
+        return XR_SUCCESS;
+    }
+
+    std::unique_lock<std::mutex> mlock(g_instance_mutex);
+    const auto next_iter = g_next_get_instance_proc_addr_map.find(instance);
+    if (next_iter == g_next_get_instance_proc_addr_map.end()) {
+        *function = nullptr;
+        return XR_ERROR_HANDLE_INVALID;
+    }
+    const PFN_xrGetInstanceProcAddr next_get_instance_proc_addr = next_iter->second;
+    if (instance == g_profiled_instance) {
+        if (0 == strcmp(name, "xrDestroyInstance")) {
+            *function = reinterpret_cast<PFN_xrVoidFunction>(ProfilerLayerXrDestroyInstance);
+            return XR_SUCCESS;
+        }
+        if (0 == strcmp(name, "xrCreateSession")) {
+            *function = reinterpret_cast<PFN_xrVoidFunction>(ProfilerLayerXrCreateSession);
+            return XR_SUCCESS;
+        }
+        if (0 == strcmp(name, "xrDestroySession")) {
+            *function = reinterpret_cast<PFN_xrVoidFunction>(ProfilerLayerXrDestroySession);
+            return XR_SUCCESS;
+        }
+        for (std::uint32_t command = 0; command < PROFILER_COMMAND_COUNT; ++command) {
+            // Commands of extensions which are not enabled are left to the next layer to reject.
+            if (0 == strcmp(name, g_command_info[command].name) && nullptr != g_next_commands[command]) {
+                *function = g_profiled_commands[command];
+                return XR_SUCCESS;
+            }
+        }
+    }
+    mlock.unlock();
+    return next_get_instance_proc_addr(instance, name, function);
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL ProfilerLayerXrCreateApiLayerInstance(const XrInstanceCreateInfo *info,
+                                                                     const struct XrApiLayerCreateInfo *apiLayerInfo,
+                                                                     XrInstance *instance) {
+    try {
+        // Validate the API layer info and next API layer info structures before we try to use them
+        if (nullptr == apiLayerInfo || XR_LOADER_INTERFACE_STRUCT_API_LAYER_CREATE_INFO != apiLayerInfo->structType ||
+            XR_API_LAYER_CREATE_INFO_STRUCT_VERSION > apiLayerInfo->structVersion ||
+            sizeof(XrApiLayerCreateInfo) > apiLayerInfo->structSize || nullptr == apiLayerInfo->nextInfo ||
+            XR_LOADER_INTERFACE_STRUCT_API_LAYER_NEXT_INFO != apiLayerInfo->nextInfo->structType ||
+            XR_API_LAYER_NEXT_INFO_STRUCT_VERSION > apiLayerInfo->nextInfo->structVersion ||
+            sizeof(XrApiLayerNextInfo) > apiLayerInfo->nextInfo->structSize ||
+            0 != strcmp(kProfilerLayerName, apiLayerInfo->nextInfo->layerName) ||
+            nullptr == apiLayerInfo->nextInfo->nextGetInstanceProcAddr ||
+            nullptr == apiLayerInfo->nextInfo->nextCreateApiLayerInstance) {
+            return XR_ERROR_INITIALIZATION_FAILED;
+        }
+
+        // Copy the contents of the layer info struct, but then move the next info up by
+        // one slot so that the next layer gets information.
+        XrApiLayerCreateInfo new_api_layer_info = {};
+        memcpy(&new_api_layer_info, apiLayerInfo, sizeof(XrApiLayerCreateInfo));
+        new_api_layer_info.nextInfo = apiLayerInfo->nextInfo->next;
+
+        const PFN_xrGetInstanceProcAddr next_get_instance_proc_addr = apiLayerInfo->nextInfo->nextGetInstanceProcAddr;
+        const PFN_xrCreateApiLayerInstance next_create_api_layer_instance =
+            apiLayerInfo->nextInfo->nextCreateApiLayerInstance;
+
+        XrInstance returned_instance = *instance;
+        const XrResult result = next_create_api_layer_instance(info, &new_api_layer_info, &returned_instance);
+        *instance = returned_instance;
+        if (XR_FAILED(result)) {
+            return result;
+        }
+
+        std::unique_lock<std::mutex> mlock(g_instance_mutex);
+        g_next_get_instance_proc_addr_map[returned_instance] = next_get_instance_proc_addr;
+        if (XR_NULL_HANDLE != g_profiled_instance) {
+            std::cerr << kProfilerLayerName << ": another instance is already profiled, passing through" << std::endl;
+            return result;
+        }
+
+        const auto get_next = [&](const char *name) {
+            PFN_xrVoidFunction next_function = nullptr;
+            if (XR_FAILED(next_get_instance_proc_addr(returned_instance, name, &next_function))) {
+                next_function = nullptr;
+            }
+            return next_function;
+        };
+        g_next_destroy_instance = reinterpret_cast<PFN_xrDestroyInstance>(get_next("xrDestroyInstance"));
+        g_next_create_session = reinterpret_cast<PFN_xrCreateSession>(get_next("xrCreateSession"));
+        g_next_destroy_session = reinterpret_cast<PFN_xrDestroySession>(get_next("xrDestroySession"));
+        if (nullptr == g_next_destroy_instance || nullptr == g_next_create_session || nullptr == g_next_destroy_session) {
+            // Leave the instance unprofiled rather than fail it.
+            return result;
+        }
+        for (std::uint32_t command = 0; command < PROFILER_COMMAND_COUNT; ++command) {
+            g_next_commands[command] = get_next(g_command_info[command].name);
+        }
+        g_profiled_instance = returned_instance;
+        return result;
+    } catch (...) {
+        return XR_ERROR_INITIALIZATION_FAILED;
+    }
+}
+
+// Function used to negotiate an interface betewen the loader and an API layer.  Each library exposing one or
+// more API layers needs to expose at least this function.
+extern "C" LAYER_EXPORT XRAPI_ATTR XrResult XRAPI_CALL xrNegotiateLoaderApiLayerInterface(
+    const XrNegotiateLoaderInfo *loaderInfo, const char * /*apiLayerName*/, XrNegotiateApiLayerRequest *apiLayerRequest) {
+    if (loaderInfo == nullptr || loaderInfo->structType != XR_LOADER_INTERFACE_STRUCT_LOADER_INFO ||
+        loaderInfo->structVersion != XR_LOADER_INFO_STRUCT_VERSION || loaderInfo->structSize != sizeof(XrNegotiateLoaderInfo)) {
+        LogPlatformUtilsError("loaderInfo struct is not valid");
+        return XR_ERROR_INITIALIZATION_FAILED;
+    }
+
+    if (loaderInfo->minInterfaceVersion > XR_CURRENT_LOADER_API_LAYER_VERSION ||
+        loaderInfo->maxInterfaceVersion < XR_CURRENT_LOADER_API_LAYER_VERSION) {
+        LogPlatformUtilsError("loader interface version is not in the range [minInterfaceVersion, maxInterfaceVersion]");
+        return XR_ERROR_INITIALIZATION_FAILED;
+    }
+
+    if (loaderInfo->minApiVersion > XR_CURRENT_API_VERSION || loaderInfo->maxApiVersion < XR_CURRENT_API_VERSION) {
+        LogPlatformUtilsError("loader api version is not in the range [minApiVersion, maxApiVersion]");
+        return XR_ERROR_INITIALIZATION_FAILED;
+    }
+
+    if (apiLayerRequest == nullptr || apiLayerRequest->structType != XR_LOADER_INTERFACE_STRUCT_API_LAYER_REQUEST ||
+        apiLayerRequest->structVersion != XR_API_LAYER_INFO_STRUCT_VERSION ||
+        apiLayerRequest->structSize != sizeof(XrNegotiateApiLayerRequest)) {
+        LogPlatformUtilsError("apiLayerRequest is not valid");
+        return XR_ERROR_INITIALIZATION_FAILED;
+    }
+
+    apiLayerRequest->layerInterfaceVersion = XR_CURRENT_LOADER_API_LAYER_VERSION;
+    apiLayerRequest->layerApiVersion = XR_CURRENT_API_VERSION;
+    apiLayerRequest->getInstanceProcAddr = ProfilerLayerXrGetInstanceProcAddr;
+    apiLayerRequest->createApiLayerInstance = ProfilerLayerXrCreateApiLayerInstance;
+
+    return XR_SUCCESS;
+}
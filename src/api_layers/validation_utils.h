@@ -32,6 +32,10 @@
 #include <openxr/openxr.h>
 #include <openxr/openxr_platform.h>
 
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
 #include <vector>
 #include <unordered_map>
 #include <string>
@@ -133,6 +137,249 @@ enum GenValidUsageDebugSeverity {
 void EraseAllInstanceTableMapElements(GenValidUsageXrInstanceInfo *search_value);
 
 typedef std::unique_lock<std::mutex> UniqueLock;
+
+/// Epoch based reclamation of the arrays replaced by HandleLookupTable rehashes, shared by all the tables.
+///
+/// Every reader thread owns a record, on its own cache line, in which it announces the epoch it entered find() at, so
+/// concurrent readers never write to a shared cache line. A writer publishes the new array, advances the epoch and
+/// retires the replaced array at the epoch it advanced from: it is freed once every thread inside find() announced a
+/// later epoch, as those loaded the array after it was replaced.
+class HandleLookupEpochs {
+   public:
+    static constexpr uint64_t kInactive = ~uint64_t(0);
+
+   private:
+    struct alignas(64) ReaderRecord {
+        std::atomic<uint64_t> epoch{kInactive};
+        std::atomic<bool> in_use{false};
+        ReaderRecord *next = nullptr;
+    };
+
+   public:
+    /// Announces the calling thread's epoch for the duration of a find(), must not be nested.
+    class ReaderScope {
+       public:
+        ReaderScope() : record_(threadRecord()) {
+            record_.epoch.store(epoch_.load(std::memory_order_seq_cst), std::memory_order_seq_cst);
+        }
+        ~ReaderScope() { record_.epoch.store(kInactive, std::memory_order_release); }
+        ReaderScope(const ReaderScope &) = delete;
+        ReaderScope &operator=(const ReaderScope &) = delete;
+
+       private:
+        ReaderRecord &record_;
+    };
+
+    /// Called by a writer after publishing a new array, returns the epoch to retire the replaced one at.
+    static uint64_t advance() { return epoch_.fetch_add(1, std::memory_order_seq_cst); }
+
+    /// Oldest epoch announced by a thread inside find(), kInactive if there is none.
+    static uint64_t oldestActive() {
+        uint64_t oldest = kInactive;
+        for (const ReaderRecord *record = records_.load(std::memory_order_acquire); record != nullptr; record = record->next) {
+            oldest = (std::min)(oldest, record->epoch.load(std::memory_order_seq_cst));
+        }
+        return oldest;
+    }
+
+   private:
+    // Records are never freed, the record of an exited thread is taken over by the next new reader thread so their
+    // number is bounded by the number of threads reading at the same time.
+    static ReaderRecord &threadRecord() {
+        struct Owner {
+            ReaderRecord *record = acquireRecord();
+            ~Owner() { record->in_use.store(false, std::memory_order_release); }
+        };
+        thread_local Owner owner;
+        return *owner.record;
+    }
+
+    static ReaderRecord *acquireRecord() {
+        for (ReaderRecord *record = records_.load(std::memory_order_acquire); record != nullptr; record = record->next) {
+            bool in_use = false;
+            if (!record->in_use.load(std::memory_order_relaxed) &&
+                record->in_use.compare_exchange_strong(in_use, true, std::memory_order_acquire)) {
+                return record;
+            }
+        }
+        ReaderRecord *record = new ReaderRecord;
+        record->in_use.store(true, std::memory_order_relaxed);
+        record->next = records_.load(std::memory_order_relaxed);
+        while (!records_.compare_exchange_weak(record->next, record, std::memory_order_release, std::memory_order_relaxed)) {
+        }
+        return record;
+    }
+
+    static inline std::atomic<uint64_t> epoch_{0};
+    static inline std::atomic<ReaderRecord *> records_{nullptr};
+};
+
+/// Open addressing (linear probing) index from a generic handle value to its info, readable without locking.
+///
+/// Writers must be serialized by the owner. Readers never block: a value is published before its key with release
+/// stores, erased slots become tombstones that may be re-used by a later insert, and a reader re-checks the key after
+/// loading the value so it never returns the info of a different handle. Once live entries and tombstones fill the
+/// array it is rehashed, at the same capacity when less than half of it is live, so handle churn does not grow it.
+/// Arrays replaced by a rehash may still be probed by readers so they are retired through HandleLookupEpochs, and
+/// freed by the first writer after the readers which could have loaded them left find().
+template <typename InfoType>
+class HandleLookupTable {
+   public:
+    HandleLookupTable() { rehash(kInitialCapacity); }
+    HandleLookupTable(const HandleLookupTable &) = delete;
+    HandleLookupTable &operator=(const HandleLookupTable &) = delete;
+
+    /// Lock-free, returns nullptr if not found.
+    InfoType *find(uint64_t handle) const {
+        const HandleLookupEpochs::ReaderScope reader_scope;
+        const Table *table = table_.load(std::memory_order_seq_cst);
+        size_t index = hash(handle) & table->mask;
+        for (size_t probes = 0; probes <= table->mask; ++probes, index = (index + 1) & table->mask) {
+            const Slot &slot = table->slots[index];
+            const uint64_t key = slot.key.load(std::memory_order_acquire);
+            if (key == kEmptyKey) {
+                return nullptr;
+            }
+            if (key != handle) {
+                continue;
+            }
+            InfoType *value = slot.value.load(std::memory_order_acquire);
+            // The slot may have been erased and re-used for another handle in between the two loads.
+            if (slot.key.load(std::memory_order_acquire) != handle) {
+                return nullptr;
+            }
+            return value;
+        }
+        return nullptr;
+    }
+
+    /// Caller holds the writer lock and has checked the handle is not already present.
+    void insert(uint64_t handle, InfoType *info) {
+        if (handle == kEmptyKey || handle == kTombstoneKey) {
+            reportInternalError("Handle value reserved by HandleLookupTable passed to HandleLookupTable::insert()");
+        }
+        reclaimRetired();
+        Table *table = current_.get();
+        const size_t capacity = table->mask + 1;
+        if ((used_ + 1) * 4 > capacity * 3) {
+            // Mostly tombstones, dropping them is enough.
+            rehash((live_ + 1) * 2 <= capacity ? capacity : capacity * 2);
+            table = current_.get();
+        }
+        Slot *target = nullptr;
+        size_t index = hash(handle) & table->mask;
+        for (;; index = (index + 1) & table->mask) {
+            Slot &slot = table->slots[index];
+            const uint64_t key = slot.key.load(std::memory_order_relaxed);
+            if (key == kTombstoneKey && target == nullptr) {
+                target = &slot;
+            } else if (key == kEmptyKey) {
+                if (target == nullptr) {
+                    target = &slot;
+                    ++used_;
+                }
+                break;
+            }
+        }
+        target->value.store(info, std::memory_order_release);
+        target->key.store(handle, std::memory_order_release);
+        ++live_;
+    }
+
+    /// Caller holds the writer lock.
+    void erase(uint64_t handle) {
+        reclaimRetired();
+        Table *table = current_.get();
+        size_t index = hash(handle) & table->mask;
+        for (size_t probes = 0; probes <= table->mask; ++probes, index = (index + 1) & table->mask) {
+            Slot &slot = table->slots[index];
+            const uint64_t key = slot.key.load(std::memory_order_relaxed);
+            if (key == kEmptyKey) {
+                return;
+            }
+            if (key == handle) {
+                slot.value.store(nullptr, std::memory_order_release);
+                slot.key.store(kTombstoneKey, std::memory_order_release);
+                --live_;
+                return;
+            }
+        }
+    }
+
+    /// Replaced arrays not freed yet, caller holds the writer lock.
+    size_t retiredCount() const { return retired_.size(); }
+
+   private:
+    static constexpr uint64_t kEmptyKey = 0;  // XR_NULL_HANDLE is never inserted
+    static constexpr uint64_t kTombstoneKey = ~uint64_t(0);
+    static constexpr size_t kInitialCapacity = 64;
+
+    struct Slot {
+        std::atomic<uint64_t> key{kEmptyKey};
+        std::atomic<InfoType *> value{nullptr};
+    };
+    struct Table {
+        explicit Table(size_t capacity) : mask(capacity - 1), slots(new Slot[capacity]) {}
+        const size_t mask;
+        std::unique_ptr<Slot[]> slots;
+    };
+
+    // Handles are pointers or runtime chosen integers, mix all the bits into the low ones used for the index.
+    static size_t hash(uint64_t handle) {
+        handle ^= handle >> 33;
+        handle *= 0xff51afd7ed558ccdULL;
+        handle ^= handle >> 33;
+        return static_cast<size_t>(handle);
+    }
+
+    struct RetiredTable {
+        std::unique_ptr<Table> table;
+        uint64_t epoch;
+    };
+
+    void reclaimRetired() {
+        if (retired_.empty()) {
+            return;
+        }
+        const uint64_t oldest_active = HandleLookupEpochs::oldestActive();
+        retired_.erase(std::remove_if(retired_.begin(), retired_.end(),
+                                      [oldest_active](const RetiredTable &retired) { return retired.epoch < oldest_active; }),
+                       retired_.end());
+    }
+
+    void rehash(size_t capacity) {
+        std::unique_ptr<Table> table(new Table(capacity));
+        if (current_ != nullptr) {
+            const Table &old_table = *current_;
+            for (size_t i = 0; i <= old_table.mask; ++i) {
+                const uint64_t key = old_table.slots[i].key.load(std::memory_order_relaxed);
+                if (key == kEmptyKey || key == kTombstoneKey) {
+                    continue;
+                }
+                size_t index = hash(key) & table->mask;
+                while (table->slots[index].key.load(std::memory_order_relaxed) != kEmptyKey) {
+                    index = (index + 1) & table->mask;
+                }
+                table->slots[index].value.store(old_table.slots[i].value.load(std::memory_order_relaxed), std::memory_order_relaxed);
+                table->slots[index].key.store(key, std::memory_order_relaxed);
+            }
+        }
+        used_ = live_;
+        table_.store(table.get(), std::memory_order_seq_cst);
+        if (current_ != nullptr) {
+            retired_.push_back({std::move(current_), HandleLookupEpochs::advance()});
+        }
+        current_ = std::move(table);
+        reclaimRetired();
+    }
+
+    std::atomic<const Table *> table_{nullptr};
+    std::unique_ptr<Table> current_;
+    std::vector<RetiredTable> retired_;  // replaced arrays, until no reader can still probe them
+    size_t live_ = 0;
+    size_t used_ = 0;  // live entries and tombstones
+};
+
 template <typename HandleType, typename InfoType>
 class HandleInfoBase {
    public:
@@ -146,7 +393,7 @@ class HandleInfoBase {
     /// Returns an enum indicating null, invalid (not found), or success.
     ValidateXrHandleResult verifyHandle(HandleType const *handle_to_check);
 
-    /// Lookup a handle.
+    /// Lookup a handle, without taking the dispatch mutex.
     /// Throws if not found.
     InfoType *get(HandleType handle);
 
@@ -163,14 +410,18 @@ class HandleInfoBase {
     /// Throws if not found.
     void erase(HandleType handle);
 
+    /// Remove all entries matching the predicate, called with a value_t.
+    template <typename Pred>
+    void eraseIf(Pred &&pred);
+
     /// Get a constant reference to the whole map as well as a lock for this object's dispatch mutex.
     std::pair<UniqueLock, map_t const &> lockMapConst();
 
-    /// Get a  reference to the whole map as well as a lock for this object's dispatch mutex.
-    std::pair<UniqueLock, map_t &> lockMap();
-
    protected:
+    /// Owns the infos, only accessed with dispatch_mutex_ held.
     map_t info_map_;
+    /// Lock-free index of info_map_ used by the per-call lookups, updated with dispatch_mutex_ held.
+    HandleLookupTable<InfoType> lookup_table_;
     std::mutex dispatch_mutex_;
 };
 
@@ -218,8 +469,17 @@ inline std::pair<UniqueLock, typename HandleInfoBase<HT, IT>::map_t const &> Han
 }
 
 template <typename HT, typename IT>
-inline std::pair<UniqueLock, typename HandleInfoBase<HT, IT>::map_t &> HandleInfoBase<HT, IT>::lockMap() {
-    return {UniqueLock(dispatch_mutex_), info_map_};
+template <typename Pred>
+inline void HandleInfoBase<HT, IT>::eraseIf(Pred &&pred) {
+    UniqueLock lock(dispatch_mutex_);
+    for (auto it = info_map_.begin(); it != info_map_.end();) {
+        if (pred(*it)) {
+            lookup_table_.erase(MakeHandleGeneric(it->first));
+            it = info_map_.erase(it);
+        } else {
+            ++it;
+        }
+    }
 }
 
 template <typename HandleType, typename InfoType>
@@ -235,10 +495,7 @@ inline ValidateXrHandleResult HandleInfoBase<HandleType, InfoType>::verifyHandle
         }
 
         // Try to find the handle in the appropriate map
-        UniqueLock lock(dispatch_mutex_);
-        auto entry_returned = info_map_.find(*handle_to_check);
-        // If it is not a valid handle, it should return the end of the map.
-        if (info_map_.end() == entry_returned) {
+        if (nullptr == lookup_table_.find(MakeHandleGeneric(*handle_to_check))) {
             return VALIDATE_XR_HANDLE_INVALID;
         }
         return VALIDATE_XR_HANDLE_SUCCESS;
@@ -253,12 +510,11 @@ inline InfoType *HandleInfoBase<HandleType, InfoType>::get(HandleType handle) {
         reportInternalError("Null handle passed to HandleInfoBase::get()");
     }
     // Try to find the handle in the appropriate map
-    UniqueLock lock(dispatch_mutex_);
-    auto entry_returned = info_map_.find(handle);
-    if (entry_returned == info_map_.end()) {
+    InfoType *info = lookup_table_.find(MakeHandleGeneric(handle));
+    if (nullptr == info) {
         reportInternalError("Handle passed to HandleInfoBase::insert() not inserted");
     }
-    return entry_returned->second.get();
+    return info;
 }
 
 template <typename HandleType, typename InfoType>
@@ -286,6 +542,7 @@ inline void HandleInfoBase<HandleType, InfoType>::insert(HandleType handle, std:
     if (entry_returned != info_map_.end()) {
         reportInternalError("Handle passed to HandleInfoBase::insert() already inserted");
     }
+    lookup_table_.insert(MakeHandleGeneric(handle), info.get());
     info_map_[handle] = std::move(info);
 }
 
@@ -299,6 +556,7 @@ inline void HandleInfoBase<HandleType, InfoType>::erase(HandleType handle) {
     if (entry_returned == info_map_.end()) {
         reportInternalError("Handle passed to HandleInfoBase::insert() not inserted");
     }
+    lookup_table_.erase(MakeHandleGeneric(handle));
     info_map_.erase(handle);
 }
 
@@ -309,12 +567,10 @@ inline std::pair<GenValidUsageXrHandleInfo *, GenValidUsageXrInstanceInfo *> Han
         reportInternalError("Null handle passed to HandleInfoBase::getWithInstanceInfo()");
     }
     // Try to find the handle in the appropriate map
-    UniqueLock lock(this->dispatch_mutex_);
-    auto entry_returned = this->info_map_.find(handle);
-    if (entry_returned == this->info_map_.end()) {
+    GenValidUsageXrHandleInfo *info = this->lookup_table_.find(MakeHandleGeneric(handle));
+    if (nullptr == info) {
         reportInternalError("Handle passed to HandleInfoBase::getWithInstanceInfo() not inserted");
     }
-    GenValidUsageXrHandleInfo *info = entry_returned->second.get();
     GenValidUsageXrInstanceInfo *instance_info = info->instance_info;
     return {info, instance_info};
 }
@@ -322,8 +578,7 @@ inline std::pair<GenValidUsageXrHandleInfo *, GenValidUsageXrInstanceInfo *> Han
 template <typename HandleType>
 inline void HandleInfo<HandleType>::removeHandlesForInstance(GenValidUsageXrInstanceInfo *search_value) {
     typedef typename base_t::value_t value_t;
-    UniqueLock lock(this->dispatch_mutex_);
-    map_erase_if(this->info_map_, [=](value_t const &data) { return data.second && data.second->instance_info == search_value; });
+    this->eraseIf([=](value_t const &data) { return data.second && data.second->instance_info == search_value; });
 }
 
 #endif  // VALIDATION_UTILS_H_
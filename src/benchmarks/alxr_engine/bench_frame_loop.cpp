@@ -0,0 +1,80 @@
+#include "alxr_engine.h"
+#include "benchmark_common.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <string_view>
+
+// Time of one alxr_process_frame call, a whole Lobby frame of the engine's render loop (events, input poll, view
+// location, Vulkan rendering and frame submission) against the mock runtime's virtual clock, so the engine's own
+// cost per frame is measured without waiting on a display. Runtime side costs can be added with the "latencies"
+// of an XR_MOCK_RUNTIME_CONFIG file. Needs a Vulkan device, e.g. lavapipe on a machine without a GPU.
+
+namespace {
+
+constexpr const std::uint64_t FrameCount = 3'000;
+constexpr const std::uint64_t MaxStartCalls = 1'000;
+
+void SetEnvIfUnset(const char* const name, const char* const value) {
+#ifdef _WIN32
+    if (std::getenv(name) == nullptr)
+        _putenv_s(name, value);
+#else
+    setenv(name, value, /*overwrite*/ 0);
+#endif
+}
+
+// The ALVR client callbacks, no server is connected.
+void InputSend(const TrackingInfo*) {}
+void ViewsConfigSend(const ALXREyeInfo*) {}
+void RequestIDR() {}
+std::uint64_t PathStringToHash(const char* const path) {
+    return std::hash<std::string_view>{}(path);
+}
+}
+
+int main()
+{
+    SetEnvIfUnset("XR_RUNTIME_JSON", MOCK_RUNTIME_JSON);
+
+    ALXRClientCtx ctx{};
+    ctx.inputSend = &InputSend;
+    ctx.viewsConfigSend = &ViewsConfigSend;
+    ctx.pathStringToHash = &PathStringToHash;
+    ctx.requestIDR = &RequestIDR;
+    ctx.graphicsApi = ALXRGraphicsApi::Vulkan2;
+    ctx.decoderType = ALXRDecoderType::VAAPI;
+    ctx.displayColorSpace = ALXRColorSpace::Default;
+    ctx.noFTServer = true;
+    ctx.noPassthrough = true;
+    ALXRSystemProperties systemProperties{};
+    if (!alxr_init(&ctx, &systemProperties)) {
+        std::fprintf(stderr, "alxr_init failed, no Vulkan device?\n");
+        return 1;
+    }
+
+    // Process events until the session is running, the first frames create the swapchains and pipelines.
+    bool exitRenderLoop = false;
+    bool requestRestart = false;
+    for (std::uint64_t call = 0; call < MaxStartCalls && !alxr_is_session_running() && !exitRenderLoop; ++call)
+        alxr_process_frame(&exitRenderLoop, &requestRestart);
+    if (!alxr_is_session_running() || exitRenderLoop) {
+        std::fprintf(stderr, "session did not start running\n");
+        alxr_destroy();
+        return 1;
+    }
+
+    const double nsPerFrame = Benchmark::NsPerCall(FrameCount, [&]() {
+        alxr_process_frame(&exitRenderLoop, &requestRestart);
+        Benchmark::g_sink = exitRenderLoop;
+    });
+    alxr_destroy();
+    if (exitRenderLoop) {
+        std::fprintf(stderr, "render loop exited during the measurement, exit_after_frames too low?\n");
+        return 1;
+    }
+    Benchmark::Report("alxr_process_frame (Lobby, Vulkan)", nsPerFrame);
+    return 0;
+}
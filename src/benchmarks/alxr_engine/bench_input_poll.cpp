@@ -0,0 +1,119 @@
+#include "pch.h"
+#include "common.h"
+#include "interaction_manager.h"
+#include "benchmark_common.h"
+
+#include <cstdlib>
+
+// Time of InteractionManager::PollActions, one xrSyncActions plus the state queries of the actions bound by
+// the active interaction profile, against the mock runtime. The runtime side cost of each call can be simulated
+// with the "latencies" of an XR_MOCK_RUNTIME_CONFIG file, the runtime calls made per poll are logged by
+// PollActions every 3000 polls. Built twice, the _per_hand variant (ALXR_ENGINE_DISABLE_COMBINED_ACTION_QUERIES)
+// queries every bound action for each hand and is the baseline for the combined queries of the actions at rest.
+
+namespace {
+
+constexpr const std::uint64_t PollCount = 30'000;
+
+void SetEnvIfUnset(const char* const name, const char* const value) {
+#ifdef _WIN32
+    if (std::getenv(name) == nullptr)
+        _putenv_s(name, value);
+#else
+    setenv(name, value, /*overwrite*/ 0);
+#endif
+}
+
+// Pumps the event queue until the session reaches targetState.
+void WaitForSessionState(const XrInstance instance, const XrSessionState targetState) {
+    XrSessionState state = XR_SESSION_STATE_UNKNOWN;
+    while (state != targetState) {
+        XrEventDataBuffer event{ .type = XR_TYPE_EVENT_DATA_BUFFER, .next = nullptr };
+        const XrResult result = xrPollEvent(instance, &event);
+        CHECK_XRRESULT(result, "xrPollEvent");
+        CHECK_MSG(result == XR_SUCCESS, "Session state change did not arrive");
+        if (event.type == XR_TYPE_EVENT_DATA_SESSION_STATE_CHANGED)
+            state = reinterpret_cast<const XrEventDataSessionStateChanged&>(event).state;
+    }
+}
+}
+
+int main()
+{
+    SetEnvIfUnset("XR_RUNTIME_JSON", MOCK_RUNTIME_JSON);
+    Log::SetLevel(Log::Level::Verbose);
+
+    const std::array<const char*, 1> extensions{ XR_MND_HEADLESS_EXTENSION_NAME };
+    XrInstanceCreateInfo instanceInfo{
+        .type = XR_TYPE_INSTANCE_CREATE_INFO,
+        .next = nullptr,
+        .applicationInfo {
+            .applicationVersion = 1,
+            .engineVersion = 1,
+            .apiVersion = XR_CURRENT_API_VERSION
+        },
+        .enabledExtensionCount = static_cast<std::uint32_t>(extensions.size()),
+        .enabledExtensionNames = extensions.data()
+    };
+    std::strcpy(instanceInfo.applicationInfo.applicationName, "alxr_input_poll_benchmark");
+    std::strcpy(instanceInfo.applicationInfo.engineName, "alxr_engine");
+    XrInstance instance{ XR_NULL_HANDLE };
+    CHECK_XRCMD(xrCreateInstance(&instanceInfo, &instance));
+
+    const XrSystemGetInfo systemInfo{
+        .type = XR_TYPE_SYSTEM_GET_INFO,
+        .next = nullptr,
+        .formFactor = XR_FORM_FACTOR_HEAD_MOUNTED_DISPLAY
+    };
+    XrSystemId systemId{ XR_NULL_SYSTEM_ID };
+    CHECK_XRCMD(xrGetSystem(instance, &systemInfo, &systemId));
+
+    // No graphics binding, a headless session.
+    const XrSessionCreateInfo sessionInfo{
+        .type = XR_TYPE_SESSION_CREATE_INFO,
+        .next = nullptr,
+        .systemId = systemId
+    };
+    XrSession session{ XR_NULL_HANDLE };
+    CHECK_XRCMD(xrCreateSession(instance, &sessionInfo, &session));
+
+    const ALXR::ALXRPaths alxrPaths{
+        .head          = 1,
+        .left_hand     = 2,
+        .right_hand    = 3,
+        .left_haptics  = 4,
+        .right_haptics = 5
+    };
+    auto interactionManager = std::make_unique<ALXR::InteractionManager>
+    (
+        instance, session, alxrPaths, ALXR::TogglePTModeFn{},
+        [](const ALXR::InteractionProfile& profile) { return &profile != &ALXR::EyeGazeProfile && profile.IsCore(); }
+    );
+
+    WaitForSessionState(instance, XR_SESSION_STATE_READY);
+    const XrSessionBeginInfo beginInfo{
+        .type = XR_TYPE_SESSION_BEGIN_INFO,
+        .next = nullptr,
+        .primaryViewConfigurationType = XR_VIEW_CONFIGURATION_TYPE_PRIMARY_STEREO
+    };
+    CHECK_XRCMD(xrBeginSession(session, &beginInfo));
+    WaitForSessionState(instance, XR_SESSION_STATE_FOCUSED);
+    interactionManager->SetActiveFromCurrentProfile();
+
+    ALXR::InteractionManager::ControllerInfoList controllerInfo{};
+    const double nsPerPoll = Benchmark::NsPerCall(PollCount, [&]() {
+        controllerInfo = {};
+        interactionManager->PollActions(controllerInfo);
+        Benchmark::g_sink = controllerInfo[Side::LEFT].buttons | controllerInfo[Side::RIGHT].buttons;
+    });
+#ifdef ALXR_ENGINE_DISABLE_COMBINED_ACTION_QUERIES
+    Benchmark::Report("InteractionManager::PollActions (per hand queries)", nsPerPoll);
+#else
+    Benchmark::Report("InteractionManager::PollActions", nsPerPoll);
+#endif
+
+    interactionManager.reset();
+    CHECK_XRCMD(xrDestroySession(session));
+    CHECK_XRCMD(xrDestroyInstance(instance));
+    return 0;
+}
@@ -0,0 +1,156 @@
+// Copyright (c) 2017-2024, The Khronos Group Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+// Handle lookup throughput of the lock-free HandleLookupTable used by core_validation, against the
+// std::unordered_map under a mutex it replaced, with every thread looking up a small set of live handles as
+// the per-call validation does. The churn runs add a writer creating and destroying other handles meanwhile, and
+// report the most replaced arrays waiting for the readers to leave find() before being freed.
+
+#include "benchmark_common.h"
+#include "validation_utils.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+void reportInternalError(std::string const &message) {
+    std::cerr << "INTERNAL VALIDATION LAYER ERROR: " << message << std::endl;
+    throw std::runtime_error("Internal validation layer error: " + message);
+}
+
+namespace {
+
+constexpr uint64_t kLiveHandleCount = 64;
+constexpr uint64_t kLookupsPerThread = 2'000'000;
+
+using Info = GenValidUsageXrHandleInfo;
+
+// Handle values spaced like heap pointers.
+uint64_t MakeHandle(uint64_t index) { return 0x10000 + index * 0x40; }
+
+class LockFreeIndex {
+   public:
+    Info *Find(uint64_t handle) const { return table_.find(handle); }
+    // Writers are serialized by the caller, as by dispatch_mutex_ in HandleInfoBase.
+    void Insert(uint64_t handle, Info *info) { table_.insert(handle, info); }
+    void Erase(uint64_t handle) { table_.erase(handle); }
+    size_t RetiredCount() const { return table_.retiredCount(); }
+
+   private:
+    HandleLookupTable<Info> table_;
+};
+
+class MutexMapIndex {
+   public:
+    Info *Find(uint64_t handle) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        const auto found = map_.find(handle);
+        return found == map_.end() ? nullptr : found->second;
+    }
+    void Insert(uint64_t handle, Info *info) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        map_.emplace(handle, info);
+    }
+    void Erase(uint64_t handle) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        map_.erase(handle);
+    }
+    size_t RetiredCount() const { return 0; }
+
+   private:
+    std::mutex mutex_;
+    std::unordered_map<uint64_t, Info *> map_;
+};
+
+struct LookupResult {
+    double mlookups_per_s;  // over all reader threads, -1 if a lookup found the wrong info.
+    size_t max_retired;     // most replaced arrays waiting to be freed at once.
+};
+
+template <typename Index>
+LookupResult MeasureLookups(unsigned reader_count, bool with_churn) {
+    std::vector<Info> infos(kLiveHandleCount);
+    Index index;
+    for (uint64_t i = 0; i < kLiveHandleCount; ++i) {
+        index.Insert(MakeHandle(i), &infos[i]);
+    }
+
+    std::atomic<bool> stop_churn{false};
+    std::thread churn_thread;
+    Info churn_info{};
+    size_t max_retired = 0;
+    if (with_churn) {
+        // The only writer once the readers start.
+        churn_thread = std::thread([&]() {
+            for (uint64_t handle = MakeHandle(kLiveHandleCount); !stop_churn.load(std::memory_order_relaxed); handle += 0x40) {
+                index.Insert(handle, &churn_info);
+                index.Erase(handle);
+                max_retired = std::max(max_retired, index.RetiredCount());
+            }
+        });
+    }
+
+    std::atomic<bool> wrong_lookup{false};
+    std::vector<std::thread> readers;
+    const auto start = Benchmark::Clock::now();
+    for (unsigned reader = 0; reader < reader_count; ++reader) {
+        readers.emplace_back([&, reader]() {
+            uint64_t checksum = 0;
+            for (uint64_t lookup = 0; lookup < kLookupsPerThread; ++lookup) {
+                const uint64_t i = (lookup + reader) % kLiveHandleCount;
+                const Info *info = index.Find(MakeHandle(i));
+                if (info != &infos[i]) {
+                    wrong_lookup = true;
+                }
+                checksum += reinterpret_cast<uintptr_t>(info);
+            }
+            Benchmark::g_sink = checksum;
+        });
+    }
+    for (auto &reader : readers) {
+        reader.join();
+    }
+    const std::chrono::duration<double> elapsed = Benchmark::Clock::now() - start;
+    stop_churn = true;
+    if (churn_thread.joinable()) {
+        churn_thread.join();
+    }
+    if (wrong_lookup) {
+        return {-1.0, max_retired};
+    }
+    return {static_cast<double>(reader_count * kLookupsPerThread) / elapsed.count() / 1e6, max_retired};
+}
+
+}  // namespace
+
+int main() {
+    const unsigned max_readers = std::max(4u, std::thread::hardware_concurrency());
+    std::printf("%u live handles, %llu lookups per reader thread, Mlookups/s over all readers\n",
+                static_cast<unsigned>(kLiveHandleCount), static_cast<unsigned long long>(kLookupsPerThread));
+    std::printf("%-8s %-6s %16s %16s %12s\n", "readers", "churn", "HandleLookupTable", "mutex+map", "max retired");
+    bool failed = false;
+    for (unsigned readers = 1; readers <= max_readers; readers *= 2) {
+        for (const bool churn : {false, true}) {
+            const LookupResult lock_free = MeasureLookups<LockFreeIndex>(readers, churn);
+            const LookupResult mutex_map = MeasureLookups<MutexMapIndex>(readers, churn);
+            std::printf("%-8u %-6s %16.1f %16.1f %12zu\n", readers, churn ? "yes" : "no", lock_free.mlookups_per_s,
+                        mutex_map.mlookups_per_s, lock_free.max_retired);
+            failed = failed || lock_free.mlookups_per_s < 0.0 || mutex_map.mlookups_per_s < 0.0;
+        }
+    }
+    if (failed) {
+        std::fprintf(stderr, "A lookup returned the info of another handle\n");
+        return 1;
+    }
+    return 0;
+}
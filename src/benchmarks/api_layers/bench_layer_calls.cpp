@@ -0,0 +1,244 @@
+// Copyright (c) 2017-2024, The Khronos Group Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+// Per-frame calls of an application through the loader to the mock runtime, with and without core_validation,
+// from several threads at once: xrLocateSpace of a controller space and xrGetActionStateFloat/Boolean, the calls
+// whose handle validation goes through HandleLookupTable. The difference between the two columns is the cost of
+// the layer, which should not grow with the thread count.
+
+#include "benchmark_common.h"
+
+#include <openxr/openxr.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr uint64_t kCallsPerThread = 200'000;
+constexpr const char *kCoreValidationLayer = "XR_APILAYER_LUNARG_core_validation";
+
+void SetEnvIfUnset(const char *name, const char *value) {
+#ifdef _WIN32
+    if (std::getenv(name) == nullptr) {
+        _putenv_s(name, value);
+    }
+#else
+    setenv(name, value, /*overwrite*/ 0);
+#endif
+}
+
+void Check(XrResult result, const char *call) {
+    if (XR_FAILED(result)) {
+        std::fprintf(stderr, "%s failed: %d\n", call, static_cast<int>(result));
+        std::exit(1);
+    }
+}
+
+XrPath StringToPath(XrInstance instance, const char *path_string) {
+    XrPath path = XR_NULL_PATH;
+    Check(xrStringToPath(instance, path_string, &path), "xrStringToPath");
+    return path;
+}
+
+// A focused headless session with a pose, a float and a boolean action bound to both touch controllers.
+struct Session {
+    XrInstance instance = XR_NULL_HANDLE;
+    XrSession session = XR_NULL_HANDLE;
+    XrActionSet action_set = XR_NULL_HANDLE;
+    XrAction pose_action = XR_NULL_HANDLE;
+    XrAction float_action = XR_NULL_HANDLE;
+    XrAction bool_action = XR_NULL_HANDLE;
+    XrPath hand_paths[2] = {XR_NULL_PATH, XR_NULL_PATH};
+    XrSpace hand_spaces[2] = {XR_NULL_HANDLE, XR_NULL_HANDLE};
+    XrSpace local_space = XR_NULL_HANDLE;
+
+    explicit Session(bool with_core_validation) {
+        const char *extensions[] = {XR_MND_HEADLESS_EXTENSION_NAME};
+        XrInstanceCreateInfo instance_info{XR_TYPE_INSTANCE_CREATE_INFO};
+        std::strcpy(instance_info.applicationInfo.applicationName, "api_layer_calls_benchmark");
+        instance_info.applicationInfo.apiVersion = XR_CURRENT_API_VERSION;
+        instance_info.enabledExtensionCount = 1;
+        instance_info.enabledExtensionNames = extensions;
+        if (with_core_validation) {
+            instance_info.enabledApiLayerCount = 1;
+            instance_info.enabledApiLayerNames = &kCoreValidationLayer;
+        }
+        Check(xrCreateInstance(&instance_info, &instance), "xrCreateInstance");
+
+        XrSystemGetInfo system_info{XR_TYPE_SYSTEM_GET_INFO};
+        system_info.formFactor = XR_FORM_FACTOR_HEAD_MOUNTED_DISPLAY;
+        XrSystemId system_id = XR_NULL_SYSTEM_ID;
+        Check(xrGetSystem(instance, &system_info, &system_id), "xrGetSystem");
+        XrSessionCreateInfo session_info{XR_TYPE_SESSION_CREATE_INFO};
+        session_info.systemId = system_id;
+        Check(xrCreateSession(instance, &session_info, &session), "xrCreateSession");
+
+        hand_paths[0] = StringToPath(instance, "/user/hand/left");
+        hand_paths[1] = StringToPath(instance, "/user/hand/right");
+        XrActionSetCreateInfo set_info{XR_TYPE_ACTION_SET_CREATE_INFO};
+        std::strcpy(set_info.actionSetName, "benchmark");
+        std::strcpy(set_info.localizedActionSetName, "Benchmark");
+        Check(xrCreateActionSet(instance, &set_info, &action_set), "xrCreateActionSet");
+        pose_action = CreateAction(XR_ACTION_TYPE_POSE_INPUT, "grip_pose");
+        float_action = CreateAction(XR_ACTION_TYPE_FLOAT_INPUT, "trigger_value");
+        bool_action = CreateAction(XR_ACTION_TYPE_BOOLEAN_INPUT, "thumbstick_click");
+
+        const XrActionSuggestedBinding bindings[] = {
+            {pose_action, StringToPath(instance, "/user/hand/left/input/grip/pose")},
+            {pose_action, StringToPath(instance, "/user/hand/right/input/grip/pose")},
+            {float_action, StringToPath(instance, "/user/hand/left/input/trigger/value")},
+            {float_action, StringToPath(instance, "/user/hand/right/input/trigger/value")},
+            {bool_action, StringToPath(instance, "/user/hand/left/input/thumbstick/click")},
+            {bool_action, StringToPath(instance, "/user/hand/right/input/thumbstick/click")},
+        };
+        XrInteractionProfileSuggestedBinding suggested{XR_TYPE_INTERACTION_PROFILE_SUGGESTED_BINDING};
+        suggested.interactionProfile = StringToPath(instance, "/interaction_profiles/oculus/touch_controller");
+        suggested.countSuggestedBindings = static_cast<uint32_t>(std::size(bindings));
+        suggested.suggestedBindings = bindings;
+        Check(xrSuggestInteractionProfileBindings(instance, &suggested), "xrSuggestInteractionProfileBindings");
+        XrSessionActionSetsAttachInfo attach_info{XR_TYPE_SESSION_ACTION_SETS_ATTACH_INFO};
+        attach_info.countActionSets = 1;
+        attach_info.actionSets = &action_set;
+        Check(xrAttachSessionActionSets(session, &attach_info), "xrAttachSessionActionSets");
+
+        for (int hand = 0; hand < 2; ++hand) {
+            XrActionSpaceCreateInfo space_info{XR_TYPE_ACTION_SPACE_CREATE_INFO};
+            space_info.action = pose_action;
+            space_info.subactionPath = hand_paths[hand];
+            space_info.poseInActionSpace.orientation.w = 1.0f;
+            Check(xrCreateActionSpace(session, &space_info, &hand_spaces[hand]), "xrCreateActionSpace");
+        }
+        XrReferenceSpaceCreateInfo local_info{XR_TYPE_REFERENCE_SPACE_CREATE_INFO};
+        local_info.referenceSpaceType = XR_REFERENCE_SPACE_TYPE_LOCAL;
+        local_info.poseInReferenceSpace.orientation.w = 1.0f;
+        Check(xrCreateReferenceSpace(session, &local_info, &local_space), "xrCreateReferenceSpace");
+
+        WaitForSessionState(XR_SESSION_STATE_READY);
+        XrSessionBeginInfo begin_info{XR_TYPE_SESSION_BEGIN_INFO};
+        begin_info.primaryViewConfigurationType = XR_VIEW_CONFIGURATION_TYPE_PRIMARY_STEREO;
+        Check(xrBeginSession(session, &begin_info), "xrBeginSession");
+        WaitForSessionState(XR_SESSION_STATE_FOCUSED);
+
+        const XrActiveActionSet active_set{action_set, XR_NULL_PATH};
+        XrActionsSyncInfo sync_info{XR_TYPE_ACTIONS_SYNC_INFO};
+        sync_info.countActiveActionSets = 1;
+        sync_info.activeActionSets = &active_set;
+        Check(xrSyncActions(session, &sync_info), "xrSyncActions");
+    }
+
+    ~Session() {
+        // Destroys the session, action set and spaces with it.
+        xrDestroyInstance(instance);
+    }
+
+    Session(const Session &) = delete;
+    Session &operator=(const Session &) = delete;
+
+    XrAction CreateAction(XrActionType type, const char *name) {
+        XrActionCreateInfo action_info{XR_TYPE_ACTION_CREATE_INFO};
+        action_info.actionType = type;
+        std::strcpy(action_info.actionName, name);
+        std::strcpy(action_info.localizedActionName, name);
+        action_info.countSubactionPaths = 2;
+        action_info.subactionPaths = hand_paths;
+        XrAction action = XR_NULL_HANDLE;
+        Check(xrCreateAction(action_set, &action_info, &action), "xrCreateAction");
+        return action;
+    }
+
+    void WaitForSessionState(XrSessionState target_state) {
+        XrSessionState state = XR_SESSION_STATE_UNKNOWN;
+        while (state != target_state) {
+            XrEventDataBuffer event{XR_TYPE_EVENT_DATA_BUFFER};
+            const XrResult result = xrPollEvent(instance, &event);
+            Check(result, "xrPollEvent");
+            if (result != XR_SUCCESS) {
+                std::fprintf(stderr, "Session state change did not arrive\n");
+                std::exit(1);
+            }
+            if (event.type == XR_TYPE_EVENT_DATA_SESSION_STATE_CHANGED) {
+                state = reinterpret_cast<const XrEventDataSessionStateChanged &>(event).state;
+            }
+        }
+    }
+};
+
+// Mean ns per call of each thread, with thread_count threads calling at once.
+template <typename Fn>
+double MeasureCalls(unsigned thread_count, Fn &&call) {
+    std::vector<std::thread> threads;
+    std::vector<double> ns_per_call(thread_count);
+    for (unsigned thread = 0; thread < thread_count; ++thread) {
+        threads.emplace_back([&, thread]() { ns_per_call[thread] = Benchmark::NsPerCall(kCallsPerThread, [&]() { call(thread); }); });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    double sum = 0.0;
+    for (const double ns : ns_per_call) {
+        sum += ns;
+    }
+    return sum / thread_count;
+}
+
+struct CallTimes {
+    double locate_space;
+    double action_state;
+};
+
+CallTimes MeasureSession(const Session &session, unsigned thread_count) {
+    constexpr XrTime kTime = 1'000'000'000;
+    const double locate_space = MeasureCalls(thread_count, [&](unsigned thread) {
+        XrSpaceLocation location{XR_TYPE_SPACE_LOCATION};
+        Check(xrLocateSpace(session.hand_spaces[thread % 2], session.local_space, kTime, &location), "xrLocateSpace");
+        Benchmark::g_sink = location.locationFlags;
+    });
+    const double action_state = MeasureCalls(thread_count, [&](unsigned thread) {
+        XrActionStateGetInfo get_info{XR_TYPE_ACTION_STATE_GET_INFO};
+        get_info.subactionPath = session.hand_paths[thread % 2];
+        get_info.action = session.float_action;
+        XrActionStateFloat float_state{XR_TYPE_ACTION_STATE_FLOAT};
+        Check(xrGetActionStateFloat(session.session, &get_info, &float_state), "xrGetActionStateFloat");
+        get_info.action = session.bool_action;
+        XrActionStateBoolean bool_state{XR_TYPE_ACTION_STATE_BOOLEAN};
+        Check(xrGetActionStateBoolean(session.session, &get_info, &bool_state), "xrGetActionStateBoolean");
+        Benchmark::g_sink = float_state.isActive + bool_state.isActive;
+    });
+    // Two calls per action state iteration.
+    return {locate_space, action_state / 2.0};
+}
+
+}  // namespace
+
+int main() {
+    SetEnvIfUnset("XR_RUNTIME_JSON", MOCK_RUNTIME_JSON);
+    SetEnvIfUnset("XR_API_LAYER_PATH", API_LAYER_PATH);
+
+    const unsigned max_threads = std::max(4u, std::thread::hardware_concurrency());
+    std::vector<CallTimes> without_layer;
+    {
+        const Session session(/*with_core_validation*/ false);
+        for (unsigned threads = 1; threads <= max_threads; threads *= 2) {
+            without_layer.push_back(MeasureSession(session, threads));
+        }
+    }
+    std::printf("ns per call and thread, %llu calls per thread\n", static_cast<unsigned long long>(kCallsPerThread));
+    std::printf("%-8s %-24s %14s %14s\n", "threads", "call", "no layer", "core_valid.");
+    const Session session(/*with_core_validation*/ true);
+    size_t run = 0;
+    for (unsigned threads = 1; threads <= max_threads; threads *= 2, ++run) {
+        const CallTimes with_layer = MeasureSession(session, threads);
+        std::printf("%-8u %-24s %14.1f %14.1f\n", threads, "xrLocateSpace", without_layer[run].locate_space,
+                    with_layer.locate_space);
+        std::printf("%-8u %-24s %14.1f %14.1f\n", threads, "xrGetActionState*", without_layer[run].action_state,
+                    with_layer.action_state);
+    }
+    return 0;
+}
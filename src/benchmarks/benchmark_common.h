@@ -0,0 +1,32 @@
+#pragma once
+#ifndef BENCHMARK_COMMON_H
+#define BENCHMARK_COMMON_H
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+
+namespace Benchmark {
+
+using Clock = std::chrono::steady_clock;
+
+// Written with the results of the measured code so the compiler cannot drop it.
+inline volatile std::uint64_t g_sink = 0;
+
+// Mean time of fn in ns over iterations calls, after a tenth as many warm up calls.
+template < typename Fn >
+inline double NsPerCall(const std::uint64_t iterations, Fn&& fn) {
+    for (std::uint64_t i = 0; i < iterations / 10; ++i)
+        fn();
+    const Clock::time_point start = Clock::now();
+    for (std::uint64_t i = 0; i < iterations; ++i)
+        fn();
+    const std::chrono::duration<double, std::nano> elapsed = Clock::now() - start;
+    return elapsed.count() / static_cast<double>(iterations);
+}
+
+inline void Report(const char* const name, const double nsPerCall) {
+    std::printf("%-56s %12.1f ns\n", name, nsPerCall);
+}
+}
+#endif
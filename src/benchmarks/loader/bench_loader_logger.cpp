@@ -0,0 +1,66 @@
+// Copyright (c) 2017-2024, The Khronos Group Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+// Cost of the loader's log calls for a verbose message, first while no recorder wants verbose messages so
+// the message is filtered before anything is built, then with a recorder which accepts and drops them, the
+// cost every message paid before the filter.
+
+#include "benchmark_common.h"
+#include "loader_logger.hpp"
+
+#include <openxr/openxr.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+
+namespace {
+
+constexpr uint64_t kCallCount = 5'000'000;
+
+class DroppingLoaderLogRecorder : public LoaderLogRecorder {
+   public:
+    DroppingLoaderLogRecorder()
+        : LoaderLogRecorder(XR_LOADER_LOG_STDOUT, nullptr, XR_LOADER_LOG_MESSAGE_SEVERITY_VERBOSE_BIT,
+                            XR_LOADER_LOG_MESSAGE_TYPE_GENERAL_BIT) {
+        _unique_id = 0xbe0c4;
+    }
+    bool LogMessage(XrLoaderLogMessageSeverityFlagBits /*message_severity*/, XrLoaderLogMessageTypeFlags /*message_type*/,
+                    const XrLoaderLogMessengerCallbackData* callback_data) override {
+        Benchmark::g_sink = Benchmark::g_sink + callback_data->message[0];
+        return false;
+    }
+};
+
+void MeasureVerboseMessages(const char* when) {
+    const std::string layer_name = "XR_APILAYER_BENCHMARK_layer";
+    const std::string literal_name = std::string("LogVerboseMessage literal, ") + when;
+    Benchmark::Report(literal_name.c_str(), Benchmark::NsPerCall(kCallCount, []() {
+                          LoaderLogger::LogVerboseMessage("xrLocateSpace", "Entering loader trampoline");
+                      }));
+    const std::string built_name = std::string("LogVerboseMessage built message, ") + when;
+    Benchmark::Report(built_name.c_str(), Benchmark::NsPerCall(kCallCount, [&]() {
+                          LoaderLogger::LogVerboseMessage("xrCreateInstance",
+                                                          [&]() { return "Loading layer " + layer_name + " for the instance"; });
+                      }));
+}
+
+}  // namespace
+
+int main() {
+#ifdef _WIN32
+    _putenv_s("XR_LOADER_DEBUG", "");
+#else
+    unsetenv("XR_LOADER_DEBUG");
+#endif
+    MeasureVerboseMessages("filtered");
+
+    std::unique_ptr<LoaderLogRecorder> recorder(new DroppingLoaderLogRecorder());
+    recorder->Start();
+    LoaderLogger::GetInstance().AddLogRecorder(std::move(recorder));
+    MeasureVerboseMessages("recorded");
+    return 0;
+}
@@ -0,0 +1,112 @@
+// Copyright (c) 2017-2024, The Khronos Group Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+// Time of the API layer manifest discovery behind xrEnumerateApiLayerProperties, over a directory of generated
+// explicit layer manifests. The manifest cache is set up once per process, so run it once without and once with
+// --cache and compare; the first call with --cache and no cache file yet parses and stores every manifest.
+
+#include "benchmark_common.h"
+
+#include <openxr/openxr.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+namespace {
+
+constexpr uint32_t kLayerCount = 64;
+constexpr uint64_t kDiscoveryCount = 500;
+
+void SetEnv(const char* name, const std::string& value) {
+#ifdef _WIN32
+    _putenv_s(name, value.c_str());
+#else
+    setenv(name, value.c_str(), 1);
+#endif
+}
+
+void UnsetEnv(const char* name) {
+#ifdef _WIN32
+    _putenv_s(name, "");
+#else
+    unsetenv(name);
+#endif
+}
+
+// Explicit layer manifests in the shape of the SDK layers, all pointing at one empty library file since discovery
+// only checks that the library exists.
+void WriteLayerManifests(const std::filesystem::path& dir) {
+    std::filesystem::create_directories(dir);
+    std::ofstream(dir / "libXrApiLayer_benchmark.so");
+    for (uint32_t i = 0; i < kLayerCount; ++i) {
+        const std::string name = "XR_APILAYER_BENCHMARK_layer_" + std::to_string(i);
+        std::ofstream manifest(dir / (name + ".json"));
+        manifest << "{\n"
+                    "    \"file_format_version\": \"1.0.0\",\n"
+                    "    \"api_layer\": {\n"
+                    "        \"name\": \""
+                 << name
+                 << "\",\n"
+                    "        \"library_path\": \"./libXrApiLayer_benchmark.so\",\n"
+                    "        \"api_version\": \"1.0\",\n"
+                    "        \"implementation_version\": \"1\",\n"
+                    "        \"description\": \"Generated manifest for loader_manifest_discovery_benchmark\",\n"
+                    "        \"instance_extensions\": [\n"
+                    "            { \"name\": \"XR_EXT_debug_utils\", \"extension_version\": \"4\" }\n"
+                    "        ],\n"
+                    "        \"functions\": {\n"
+                    "            \"xrNegotiateLoaderApiLayerInterface\": \"xrNegotiateLoaderApiLayerInterface\"\n"
+                    "        },\n"
+                    "        \"disable_environment\": \"DISABLE_XR_APILAYER_BENCHMARK_"
+                 << i
+                 << "\"\n"
+                    "    }\n"
+                    "}\n";
+    }
+}
+
+uint32_t EnumerateLayers() {
+    uint32_t count = 0;
+    if (XR_FAILED(xrEnumerateApiLayerProperties(0, &count, nullptr))) {
+        std::fprintf(stderr, "xrEnumerateApiLayerProperties failed\n");
+        std::exit(1);
+    }
+    return count;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    const bool use_cache = argc > 1 && std::strcmp(argv[1], "--cache") == 0;
+
+    const std::filesystem::path dir = std::filesystem::temp_directory_path() / "loader_manifest_discovery_benchmark";
+    std::filesystem::remove_all(dir);
+    WriteLayerManifests(dir / "layers");
+    SetEnv("XR_API_LAYER_PATH", (dir / "layers").string());
+    if (use_cache) {
+        SetEnv("XR_LOADER_MANIFEST_CACHE", (dir / "manifest_cache.bin").string());
+    } else {
+        UnsetEnv("XR_LOADER_MANIFEST_CACHE");
+    }
+
+    const auto start = Benchmark::Clock::now();
+    const uint32_t layer_count = EnumerateLayers();
+    const std::chrono::duration<double, std::nano> first_call = Benchmark::Clock::now() - start;
+    if (layer_count < kLayerCount) {
+        std::fprintf(stderr, "Only %u of the %u generated layers were found\n", layer_count, kLayerCount);
+        return 1;
+    }
+
+    std::printf("%u API layer manifests, manifest cache %s\n", layer_count, use_cache ? "enabled" : "disabled");
+    Benchmark::Report("first discovery", first_call.count());
+    Benchmark::Report("discovery", Benchmark::NsPerCall(kDiscoveryCount, []() { Benchmark::g_sink = EnumerateLayers(); }));
+
+    std::filesystem::remove_all(dir);
+    return 0;
+}
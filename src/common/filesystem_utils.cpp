@@ -121,6 +121,21 @@ bool FileSysUtilsFindFilesInPath(const std::string& path, std::vector<std::strin
     return true;
 }
 
+bool FileSysUtilsGetFileStamp(const std::string& path, uint64_t& modified_time, uint64_t& file_size) {
+    std::error_code ec;
+    const auto write_time = FS_PREFIX::last_write_time(path, ec);
+    if (ec) {
+        return false;
+    }
+    const auto size = FS_PREFIX::file_size(path, ec);
+    if (ec) {
+        return false;
+    }
+    modified_time = static_cast<uint64_t>(write_time.time_since_epoch().count());
+    file_size = static_cast<uint64_t>(size);
+    return true;
+}
+
 #elif defined(XR_OS_WINDOWS)
 
 // For pre C++17 compiler that doesn't support experimental filesystem
@@ -227,6 +242,16 @@ bool FileSysUtilsFindFilesInPath(const std::string& path, std::vector<std::strin
     return false;
 }
 
+bool FileSysUtilsGetFileStamp(const std::string& path, uint64_t& modified_time, uint64_t& file_size) {
+    WIN32_FILE_ATTRIBUTE_DATA data{};
+    if (!GetFileAttributesExW(utf8_to_wide(path).c_str(), GetFileExInfoStandard, &data)) {
+        return false;
+    }
+    modified_time = (static_cast<uint64_t>(data.ftLastWriteTime.dwHighDateTime) << 32) | data.ftLastWriteTime.dwLowDateTime;
+    file_size = (static_cast<uint64_t>(data.nFileSizeHigh) << 32) | data.nFileSizeLow;
+    return true;
+}
+
 #else  // XR_OS_LINUX/XR_OS_APPLE fallback
 
 // simple POSIX-compatible implementation of the <filesystem> pieces used by OpenXR
@@ -319,4 +344,19 @@ bool FileSysUtilsFindFilesInPath(const std::string& path, std::vector<std::strin
     return true;
 }
 
+bool FileSysUtilsGetFileStamp(const std::string& path, uint64_t& modified_time, uint64_t& file_size) {
+    struct stat path_stat;
+    if (stat(path.c_str(), &path_stat) != 0) {
+        return false;
+    }
+#if defined(XR_OS_APPLE)
+    const struct timespec& mtime = path_stat.st_mtimespec;
+#else
+    const struct timespec& mtime = path_stat.st_mtim;
+#endif
+    modified_time = static_cast<uint64_t>(mtime.tv_sec) * 1000000000ull + static_cast<uint64_t>(mtime.tv_nsec);
+    file_size = static_cast<uint64_t>(path_stat.st_size);
+    return true;
+}
+
 #endif
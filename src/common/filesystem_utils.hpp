@@ -9,6 +9,7 @@
 
 #pragma once
 
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -44,3 +45,6 @@ bool FileSysUtilsParsePathList(std::string& path_list, std::vector<std::string>&
 
 // Record all the filenames for files found in the provided path.
 bool FileSysUtilsFindFilesInPath(const std::string& path, std::vector<std::string>& files);
+
+// Get the last modification time (in an unspecified but stable unit) and size of a file, following symbolic links.
+bool FileSysUtilsGetFileStamp(const std::string& path, uint64_t& modified_time, uint64_t& file_size);
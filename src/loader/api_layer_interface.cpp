@@ -403,13 +403,13 @@ XrResult ApiLayerInterface::LoadApiLayers(const std::string& openxr_command, uin
             continue;
         }
 
-        {
+        LoaderLogger::LogInfoMessage(openxr_command, [&] {
             std::ostringstream oss;
             oss << "ApiLayerInterface::LoadApiLayers succeeded loading layer " << manifest_file->LayerName()
                 << " using interface version " << api_layer_info.layerInterfaceVersion << " and OpenXR API version "
                 << XR_VERSION_MAJOR(api_layer_info.layerApiVersion) << "." << XR_VERSION_MINOR(api_layer_info.layerApiVersion);
-            LoaderLogger::LogInfoMessage(openxr_command, oss.str());
-        }
+            return oss.str();
+        });
 
         // Grab the list of extensions this layer supports for easy filtering after the
         // xrCreateInstance call
@@ -455,9 +455,7 @@ ApiLayerInterface::ApiLayerInterface(const std::string& layer_name, LoaderPlatfo
       _supported_extensions(supported_extensions) {}
 
 ApiLayerInterface::~ApiLayerInterface() {
-    std::string info_message = "ApiLayerInterface being destroyed for layer ";
-    info_message += _layer_name;
-    LoaderLogger::LogInfoMessage("", info_message);
+    LoaderLogger::LogInfoMessage("", [this] { return "ApiLayerInterface being destroyed for layer " + _layer_name; });
     LoaderPlatformLibraryClose(_layer_library);
 }
 
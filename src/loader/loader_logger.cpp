@@ -22,6 +22,7 @@
 #include <mutex>
 #include <sstream>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <utility>
 #include <vector>
@@ -139,15 +140,28 @@ LoaderLogger::LoaderLogger() {
     }
 }
 
+void LoaderLogger::UpdateMessageMasks() {
+    XrLoaderLogMessageSeverityFlags message_severities = 0;
+    XrLoaderLogMessageTypeFlags message_types = 0;
+    for (const std::unique_ptr<LoaderLogRecorder>& recorder : _recorders) {
+        message_severities |= recorder->MessageSeverities();
+        message_types |= recorder->MessageTypes();
+    }
+    _message_severities.store(message_severities, std::memory_order_relaxed);
+    _message_types.store(message_types, std::memory_order_relaxed);
+}
+
 void LoaderLogger::AddLogRecorder(std::unique_ptr<LoaderLogRecorder>&& recorder) {
     std::unique_lock<std::shared_timed_mutex> lock(_mutex);
     _recorders.push_back(std::move(recorder));
+    UpdateMessageMasks();
 }
 
 void LoaderLogger::AddLogRecorderForXrInstance(XrInstance instance, std::unique_ptr<LoaderLogRecorder>&& recorder) {
     std::unique_lock<std::shared_timed_mutex> lock(_mutex);
     _recordersByInstance[instance].insert(recorder->UniqueId());
     _recorders.emplace_back(std::move(recorder));
+    UpdateMessageMasks();
 }
 
 void LoaderLogger::RemoveLogRecorder(uint64_t unique_id) {
@@ -160,6 +174,7 @@ void LoaderLogger::RemoveLogRecorder(uint64_t unique_id) {
             messengersForInstance.erase(unique_id);
         }
     }
+    UpdateMessageMasks();
 }
 
 void LoaderLogger::RemoveLogRecordersForXrInstance(XrInstance instance) {
@@ -170,16 +185,25 @@ void LoaderLogger::RemoveLogRecordersForXrInstance(XrInstance instance) {
             return recorders.find(recorder->UniqueId()) != recorders.end();
         });
         _recordersByInstance.erase(instance);
+        UpdateMessageMasks();
     }
 }
 
 bool LoaderLogger::LogMessage(XrLoaderLogMessageSeverityFlagBits message_severity, XrLoaderLogMessageTypeFlags message_type,
-                              const std::string& message_id, const std::string& command_name, const std::string& message,
+                              std::string_view message_id, std::string_view command_name, std::string_view message,
                               const std::vector<XrSdkLogObjectInfo>& objects) {
+    if (!IsEnabled(message_severity, message_type)) {
+        return false;
+    }
+
+    // Recorders expect null-terminated strings.
+    const std::string message_id_str{message_id};
+    const std::string command_name_str{command_name};
+    const std::string message_str{message};
     XrLoaderLogMessengerCallbackData callback_data = {};
-    callback_data.message_id = message_id.c_str();
-    callback_data.command_name = command_name.c_str();
-    callback_data.message = message.c_str();
+    callback_data.message_id = message_id_str.c_str();
+    callback_data.command_name = command_name_str.c_str();
+    callback_data.message = message_str.c_str();
 
     auto names_and_labels = data_.PopulateNamesAndLabels(objects);
     callback_data.objects = names_and_labels.sdk_objects.empty() ? nullptr : names_and_labels.sdk_objects.data();
@@ -206,6 +230,9 @@ bool LoaderLogger::LogDebugUtilsMessage(XrDebugUtilsMessageSeverityFlagsEXT mess
     bool exit_app = false;
     XrLoaderLogMessageSeverityFlags log_message_severity = DebugUtilsSeveritiesToLoaderLogMessageSeverities(message_severity);
     XrLoaderLogMessageTypeFlags log_message_type = DebugUtilsMessageTypesToLoaderLogMessageTypes(message_type);
+    if (!IsEnabled(log_message_severity, log_message_type)) {
+        return exit_app;
+    }
 
     AugmentedCallbackData augmented_data;
     data_.WrapCallbackData(&augmented_data, callback_data);
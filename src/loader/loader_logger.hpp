@@ -9,9 +9,12 @@
 
 #pragma once
 
+#include <atomic>
 #include <memory>
 #include <mutex>
 #include <string>
+#include <string_view>
+#include <type_traits>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
@@ -129,38 +132,63 @@ class LoaderLogger {
     void InsertLabel(XrSession session, const XrDebugUtilsLabelEXT* label_info);
     void DeleteSessionLabels(XrSession session);
 
+    //! True if at least one recorder may want messages of this severity and type. Lock-free, meant to be checked
+    //! before building a message.
+    bool IsEnabled(XrLoaderLogMessageSeverityFlagBits message_severity, XrLoaderLogMessageTypeFlags message_type) const {
+        return (_message_severities.load(std::memory_order_relaxed) & message_severity) == message_severity &&
+               (_message_types.load(std::memory_order_relaxed) & message_type) == message_type;
+    }
+
     bool LogMessage(XrLoaderLogMessageSeverityFlagBits message_severity, XrLoaderLogMessageTypeFlags message_type,
-                    const std::string& message_id, const std::string& command_name, const std::string& message,
+                    std::string_view message_id, std::string_view command_name, std::string_view message,
                     const std::vector<XrSdkLogObjectInfo>& objects = {});
-    static bool LogErrorMessage(const std::string& command_name, const std::string& message,
-                                const std::vector<XrSdkLogObjectInfo>& objects = {}) {
+
+    //! Same as LogMessage, but the message is only built by calling make_message if a recorder wants it.
+    template <typename MessageFn, typename = std::enable_if_t<std::is_invocable_r_v<std::string, MessageFn>>>
+    bool LogMessage(XrLoaderLogMessageSeverityFlagBits message_severity, XrLoaderLogMessageTypeFlags message_type,
+                    std::string_view message_id, std::string_view command_name, MessageFn&& make_message,
+                    const std::vector<XrSdkLogObjectInfo>& objects = {}) {
+        if (!IsEnabled(message_severity, message_type)) {
+            return false;
+        }
+        const std::string message = make_message();
+        return LogMessage(message_severity, message_type, message_id, command_name, std::string_view{message}, objects);
+    }
+
+    // Each of these also takes a callable returning the message as std::string instead of the message, see LogMessage.
+    template <typename Message>
+    static bool LogErrorMessage(std::string_view command_name, Message&& message, const std::vector<XrSdkLogObjectInfo>& objects = {}) {
         return GetInstance().LogMessage(XR_LOADER_LOG_MESSAGE_SEVERITY_ERROR_BIT, XR_LOADER_LOG_MESSAGE_TYPE_GENERAL_BIT,
-                                        "OpenXR-Loader", command_name, message, objects);
+                                        "OpenXR-Loader", command_name, std::forward<Message>(message), objects);
     }
-    static bool LogWarningMessage(const std::string& command_name, const std::string& message,
+    template <typename Message>
+    static bool LogWarningMessage(std::string_view command_name, Message&& message,
                                   const std::vector<XrSdkLogObjectInfo>& objects = {}) {
         return GetInstance().LogMessage(XR_LOADER_LOG_MESSAGE_SEVERITY_WARNING_BIT, XR_LOADER_LOG_MESSAGE_TYPE_GENERAL_BIT,
-                                        "OpenXR-Loader", command_name, message, objects);
+                                        "OpenXR-Loader", command_name, std::forward<Message>(message), objects);
     }
-    static bool LogInfoMessage(const std::string& command_name, const std::string& message,
-                               const std::vector<XrSdkLogObjectInfo>& objects = {}) {
+    template <typename Message>
+    static bool LogInfoMessage(std::string_view command_name, Message&& message, const std::vector<XrSdkLogObjectInfo>& objects = {}) {
         return GetInstance().LogMessage(XR_LOADER_LOG_MESSAGE_SEVERITY_INFO_BIT, XR_LOADER_LOG_MESSAGE_TYPE_GENERAL_BIT,
-                                        "OpenXR-Loader", command_name, message, objects);
+                                        "OpenXR-Loader", command_name, std::forward<Message>(message), objects);
     }
-    static bool LogVerboseMessage(const std::string& command_name, const std::string& message,
+    template <typename Message>
+    static bool LogVerboseMessage(std::string_view command_name, Message&& message,
                                   const std::vector<XrSdkLogObjectInfo>& objects = {}) {
         return GetInstance().LogMessage(XR_LOADER_LOG_MESSAGE_SEVERITY_VERBOSE_BIT, XR_LOADER_LOG_MESSAGE_TYPE_GENERAL_BIT,
-                                        "OpenXR-Loader", command_name, message, objects);
+                                        "OpenXR-Loader", command_name, std::forward<Message>(message), objects);
     }
-    static bool LogValidationErrorMessage(const std::string& vuid, const std::string& command_name, const std::string& message,
+    template <typename Message>
+    static bool LogValidationErrorMessage(std::string_view vuid, std::string_view command_name, Message&& message,
                                           const std::vector<XrSdkLogObjectInfo>& objects = {}) {
         return GetInstance().LogMessage(XR_LOADER_LOG_MESSAGE_SEVERITY_ERROR_BIT, XR_LOADER_LOG_MESSAGE_TYPE_SPECIFICATION_BIT,
-                                        vuid, command_name, message, objects);
+                                        vuid, command_name, std::forward<Message>(message), objects);
     }
-    static bool LogValidationWarningMessage(const std::string& vuid, const std::string& command_name, const std::string& message,
+    template <typename Message>
+    static bool LogValidationWarningMessage(std::string_view vuid, std::string_view command_name, Message&& message,
                                             const std::vector<XrSdkLogObjectInfo>& objects = {}) {
         return GetInstance().LogMessage(XR_LOADER_LOG_MESSAGE_SEVERITY_WARNING_BIT, XR_LOADER_LOG_MESSAGE_TYPE_SPECIFICATION_BIT,
-                                        vuid, command_name, message, objects);
+                                        vuid, command_name, std::forward<Message>(message), objects);
     }
 
     // Extension-specific logging functions
@@ -174,8 +202,16 @@ class LoaderLogger {
    private:
     LoaderLogger();
 
+    // Recomputes the union of the severities and types of all recorders, _mutex must be held exclusively.
+    void UpdateMessageMasks();
+
     std::shared_timed_mutex _mutex;
 
+    // Union of the severities and types of all recorders, so that messages nobody wants are dropped before
+    // any string is built or lock taken.
+    std::atomic<XrLoaderLogMessageSeverityFlags> _message_severities{0};
+    std::atomic<XrLoaderLogMessageTypeFlags> _message_types{0};
+
     // List of *all* available recorder objects (including created specifically for an Instance)
     std::vector<std::unique_ptr<LoaderLogRecorder>> _recorders;
 
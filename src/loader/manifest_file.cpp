@@ -28,11 +28,13 @@
 #include <openxr/openxr.h>
 
 #include <algorithm>
+#include <chrono>
 #include <cstdlib>
 #include <cstdio>
 #include <cstring>
 #include <fstream>
 #include <memory>
+#include <mutex>
 #include <sstream>
 #include <stdexcept>
 #include <string>
@@ -449,6 +451,286 @@ static void ReadLayerDataFilesInRegistry(const std::string &registry_location, s
 
 #endif  // XR_OS_WINDOWS
 
+// Opt-in cache of parsed manifest files, enabled by setting XR_LOADER_MANIFEST_CACHE to "1" (cache file in the
+// user cache directory) or to the path of the cache file. Entries are keyed by the manifest path and validated
+// against its modification time and size, any change re-parses the manifest. Only the values read from the JSON
+// are cached, the environment and filesystem dependent checks are still made every time a manifest is used.
+#define OPENXR_MANIFEST_CACHE_ENV_VAR "XR_LOADER_MANIFEST_CACHE"
+#define OPENXR_MANIFEST_CACHE_FILENAME "openxr_manifest_cache.bin"
+
+namespace {
+
+struct ManifestFileStamp {
+    uint64_t modified_time = 0;
+    uint64_t file_size = 0;
+    bool valid = false;
+
+    bool operator==(const ManifestFileStamp &rhs) const {
+        return valid && rhs.valid && modified_time == rhs.modified_time && file_size == rhs.file_size;
+    }
+};
+
+class ManifestCacheWriter {
+   public:
+    void Write(uint8_t value) { _data.push_back(static_cast<char>(value)); }
+    void Write(uint32_t value) { _data.append(reinterpret_cast<const char *>(&value), sizeof(value)); }
+    void Write(uint64_t value) { _data.append(reinterpret_cast<const char *>(&value), sizeof(value)); }
+    void Write(const std::string &value) {
+        Write(static_cast<uint32_t>(value.size()));
+        _data.append(value);
+    }
+    const std::string &Data() const { return _data; }
+
+   private:
+    std::string _data;
+};
+
+class ManifestCacheReader {
+   public:
+    explicit ManifestCacheReader(const std::string &data) : _data(data) {}
+
+    template <typename T>
+    bool Read(T &value) {
+        if (_data.size() - _pos < sizeof(T)) {
+            return false;
+        }
+        std::memcpy(&value, _data.data() + _pos, sizeof(T));
+        _pos += sizeof(T);
+        return true;
+    }
+    bool Read(std::string &value) {
+        uint32_t size = 0;
+        if (!Read(size) || _data.size() - _pos < size) {
+            return false;
+        }
+        value.assign(_data, _pos, size);
+        _pos += size;
+        return true;
+    }
+    bool AtEnd() const { return _pos == _data.size(); }
+
+   private:
+    const std::string &_data;
+    size_t _pos = 0;
+};
+
+class ManifestCache {
+   public:
+    static ManifestCache &Instance() {
+        static ManifestCache cache;
+        return cache;
+    }
+
+    bool Enabled() const { return !_cache_filename.empty(); }
+
+    // stamp is filled in (when enabled) for a later Store call on a miss.
+    bool Lookup(ManifestFileType type, const std::string &filename, ManifestFileStamp &stamp, ManifestFileFields &fields) {
+        if (!Enabled()) {
+            return false;
+        }
+        stamp.valid = FileSysUtilsGetFileStamp(filename, stamp.modified_time, stamp.file_size);
+        std::lock_guard<std::mutex> lock(_mutex);
+        const auto found = _entries.find(MakeKey(type, filename));
+        if (found != _entries.end()) {
+            if (found->second.stamp == stamp) {
+                fields = found->second.fields;
+                ++_hits;
+                return true;
+            }
+            _entries.erase(found);
+            _dirty = true;
+        }
+        ++_misses;
+        return false;
+    }
+
+    void Store(ManifestFileType type, const std::string &filename, const ManifestFileStamp &stamp,
+               const ManifestFileFields &fields) {
+        if (!Enabled() || !stamp.valid) {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(_mutex);
+        _entries[MakeKey(type, filename)] = Entry{stamp, fields};
+        _dirty = true;
+    }
+
+    // Writes the cache file if anything changed and logs the discovery time.
+    void Flush(const std::string &openxr_command, const char *caller, std::chrono::steady_clock::time_point start_time) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_dirty) {
+            _dirty = !Save();
+        }
+        const auto elapsed_us =
+            std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start_time).count();
+        std::ostringstream oss;
+        oss << caller << " - manifest discovery took " << elapsed_us << "us";
+        if (Enabled()) {
+            oss << ", manifest cache " << _hits << " hits / " << _misses << " misses";
+        }
+        LoaderLogger::LogInfoMessage(openxr_command, oss.str());
+        _hits = 0;
+        _misses = 0;
+    }
+
+   private:
+    static constexpr uint32_t kMagic = 0x434d5258;  // "XRMC"
+    static constexpr uint32_t kVersion = 1;
+
+    struct Entry {
+        ManifestFileStamp stamp;
+        ManifestFileFields fields;
+    };
+
+    ManifestCache() {
+        const std::string setting = PlatformUtilsGetSecureEnv(OPENXR_MANIFEST_CACHE_ENV_VAR);
+        if (setting.empty() || setting == "0") {
+            return;
+        }
+        if (setting != "1") {
+            _cache_filename = setting;
+        } else {
+#if defined(XR_OS_WINDOWS)
+            const std::string cache_dir = PlatformUtilsGetSecureEnv("LOCALAPPDATA");
+#elif defined(XR_OS_LINUX) || defined(XR_OS_APPLE)
+            std::string cache_dir = PlatformUtilsGetSecureEnv("XDG_CACHE_HOME");
+            if (cache_dir.empty()) {
+                const std::string home = PlatformUtilsGetSecureEnv("HOME");
+                if (!home.empty()) {
+                    cache_dir = home + "/.cache";
+                }
+            }
+#else
+            const std::string cache_dir;
+#endif
+            if (cache_dir.empty() || !FileSysUtilsIsDirectory(cache_dir) ||
+                !FileSysUtilsCombinePaths(cache_dir, OPENXR_MANIFEST_CACHE_FILENAME, _cache_filename)) {
+                LoaderLogger::LogWarningMessage("", "ManifestCache - no user cache directory found, manifest cache is disabled");
+                _cache_filename.clear();
+                return;
+            }
+        }
+        Load();
+    }
+
+    static std::string MakeKey(ManifestFileType type, const std::string &filename) {
+        return (type == MANIFEST_TYPE_RUNTIME ? "R:" : "L:") + filename;
+    }
+
+    void Load() {
+        std::ifstream file(_cache_filename, std::ios::in | std::ios::binary);
+        if (!file.is_open()) {
+            return;
+        }
+        std::ostringstream contents;
+        contents << file.rdbuf();
+        const std::string data = contents.str();
+
+        ManifestCacheReader reader(data);
+        uint32_t magic = 0;
+        uint32_t version = 0;
+        uint32_t count = 0;
+        bool ok = reader.Read(magic) && magic == kMagic && reader.Read(version) && version == kVersion && reader.Read(count);
+        for (uint32_t i = 0; ok && i < count; ++i) {
+            std::string key;
+            Entry entry;
+            ManifestFileFields &fields = entry.fields;
+            uint32_t ext_count = 0;
+            uint32_t func_count = 0;
+            ok = reader.Read(key) && reader.Read(entry.stamp.modified_time) && reader.Read(entry.stamp.file_size) &&
+                 reader.Read(fields.library_path) && reader.Read(ext_count);
+            for (uint32_t e = 0; ok && e < ext_count; ++e) {
+                ExtensionListing ext{};
+                ok = reader.Read(ext.name) && reader.Read(ext.extension_version);
+                fields.instance_extensions.push_back(ext);
+            }
+            ok = ok && reader.Read(func_count);
+            for (uint32_t f = 0; ok && f < func_count; ++f) {
+                std::pair<std::string, std::string> func;
+                ok = reader.Read(func.first) && reader.Read(func.second);
+                fields.functions_renamed.push_back(func);
+            }
+            uint8_t has_enable_environment = 0;
+            uint8_t has_disable_environment = 0;
+            ok = ok && reader.Read(fields.layer_name) && reader.Read(fields.api_version) &&
+                 reader.Read(fields.implementation_version) && reader.Read(fields.description) &&
+                 reader.Read(has_enable_environment) && reader.Read(fields.enable_environment) &&
+                 reader.Read(has_disable_environment) && reader.Read(fields.disable_environment);
+            fields.has_enable_environment = has_enable_environment != 0;
+            fields.has_disable_environment = has_disable_environment != 0;
+            entry.stamp.valid = true;
+            if (ok) {
+                _entries.emplace(std::move(key), std::move(entry));
+            }
+        }
+        if (!ok || !reader.AtEnd()) {
+            LoaderLogger::LogWarningMessage("", "ManifestCache - ignoring invalid cache file " + _cache_filename);
+            _entries.clear();
+            _dirty = true;
+        }
+    }
+
+    bool Save() const {
+        ManifestCacheWriter writer;
+        writer.Write(kMagic);
+        writer.Write(kVersion);
+        writer.Write(static_cast<uint32_t>(_entries.size()));
+        for (const auto &key_entry : _entries) {
+            const Entry &entry = key_entry.second;
+            const ManifestFileFields &fields = entry.fields;
+            writer.Write(key_entry.first);
+            writer.Write(entry.stamp.modified_time);
+            writer.Write(entry.stamp.file_size);
+            writer.Write(fields.library_path);
+            writer.Write(static_cast<uint32_t>(fields.instance_extensions.size()));
+            for (const auto &ext : fields.instance_extensions) {
+                writer.Write(ext.name);
+                writer.Write(ext.extension_version);
+            }
+            writer.Write(static_cast<uint32_t>(fields.functions_renamed.size()));
+            for (const auto &func : fields.functions_renamed) {
+                writer.Write(func.first);
+                writer.Write(func.second);
+            }
+            writer.Write(fields.layer_name);
+            writer.Write(fields.api_version);
+            writer.Write(fields.implementation_version);
+            writer.Write(fields.description);
+            writer.Write(static_cast<uint8_t>(fields.has_enable_environment));
+            writer.Write(fields.enable_environment);
+            writer.Write(static_cast<uint8_t>(fields.has_disable_environment));
+            writer.Write(fields.disable_environment);
+        }
+
+        // Write to a temporary file and rename it over the cache so concurrent readers never see a partial file.
+        const std::string temp_filename = _cache_filename + ".tmp";
+        {
+            std::ofstream file(temp_filename, std::ios::out | std::ios::binary | std::ios::trunc);
+            if (!file.is_open() || !file.write(writer.Data().data(), writer.Data().size())) {
+                LoaderLogger::LogWarningMessage("", "ManifestCache - failed to write cache file " + temp_filename);
+                return false;
+            }
+        }
+#if defined(XR_OS_WINDOWS)
+        std::remove(_cache_filename.c_str());
+#endif
+        if (std::rename(temp_filename.c_str(), _cache_filename.c_str()) != 0) {
+            std::remove(temp_filename.c_str());
+            LoaderLogger::LogWarningMessage("", "ManifestCache - failed to replace cache file " + _cache_filename);
+            return false;
+        }
+        return true;
+    }
+
+    std::mutex _mutex;
+    std::string _cache_filename;
+    std::unordered_map<std::string, Entry> _entries;
+    bool _dirty = false;
+    uint32_t _hits = 0;
+    uint32_t _misses = 0;
+};
+
+}  // namespace
+
 ManifestFile::ManifestFile(ManifestFileType type, const std::string &filename, const std::string &library_path)
     : _filename(filename), _type(type), _library_path(library_path) {}
 
@@ -528,11 +810,11 @@ static void ParseExtension(Json::Value const &ext, std::vector<ExtensionListing>
     }
 }
 
-void ManifestFile::ParseCommon(Json::Value const &root_node) {
+void ManifestFile::ParseCommon(Json::Value const &root_node, const std::string &filename, ManifestFileFields &fields) {
     const Json::Value &inst_exts = root_node["instance_extensions"];
     if (!inst_exts.isNull() && inst_exts.isArray()) {
         for (const auto &ext : inst_exts) {
-            ParseExtension(ext, _instance_extensions);
+            ParseExtension(ext, fields.instance_extensions);
         }
     }
     const Json::Value &funcs_renamed = root_node["functions"];
@@ -540,21 +822,36 @@ void ManifestFile::ParseCommon(Json::Value const &root_node) {
         for (Json::ValueConstIterator func_it = funcs_renamed.begin(); func_it != funcs_renamed.end(); ++func_it) {
             if (!(*func_it).isString()) {
                 LoaderLogger::LogWarningMessage(
-                    "", "ManifestFile::ParseCommon " + _filename + " \"functions\" section contains non-string values.");
+                    "", "ManifestFile::ParseCommon " + filename + " \"functions\" section contains non-string values.");
                 continue;
             }
             std::string original_name = func_it.key().asString();
             std::string new_name = (*func_it).asString();
-            _functions_renamed.emplace(original_name, new_name);
+            fields.functions_renamed.emplace_back(original_name, new_name);
         }
     }
 }
 
+void ManifestFile::SetCommon(const ManifestFileFields &fields) {
+    _instance_extensions = fields.instance_extensions;
+    for (const auto &func : fields.functions_renamed) {
+        _functions_renamed.emplace(func.first, func.second);
+    }
+}
+
 void RuntimeManifestFile::CreateIfValid(std::string const &filename,
                                         std::vector<std::unique_ptr<RuntimeManifestFile>> &manifest_files) {
-    std::ifstream json_stream(filename, std::ifstream::in);
+    LoaderLogger::LogInfoMessage("", [&filename] { return "RuntimeManifestFile::CreateIfValid - attempting to load " + filename; });
+
+    ManifestCache &cache = ManifestCache::Instance();
+    ManifestFileStamp stamp;
+    ManifestFileFields fields;
+    if (cache.Lookup(MANIFEST_TYPE_RUNTIME, filename, stamp, fields)) {
+        CreateFromFields(fields, filename, manifest_files);
+        return;
+    }
 
-    LoaderLogger::LogInfoMessage("", "RuntimeManifestFile::CreateIfValid - attempting to load " + filename);
+    std::ifstream json_stream(filename, std::ifstream::in);
     std::ostringstream error_ss("RuntimeManifestFile::CreateIfValid ");
     if (!json_stream.is_open()) {
         error_ss << "failed to open " << filename << ".  Does it exist?";
@@ -574,17 +871,28 @@ void RuntimeManifestFile::CreateIfValid(std::string const &filename,
         return;
     }
 
-    CreateIfValid(root_node, filename, manifest_files);
+    if (!ParseFields(root_node, filename, fields)) {
+        return;
+    }
+    cache.Store(MANIFEST_TYPE_RUNTIME, filename, stamp, fields);
+    CreateFromFields(fields, filename, manifest_files);
 }
 
 void RuntimeManifestFile::CreateIfValid(const Json::Value &root_node, const std::string &filename,
                                         std::vector<std::unique_ptr<RuntimeManifestFile>> &manifest_files) {
+    ManifestFileFields fields;
+    if (ParseFields(root_node, filename, fields)) {
+        CreateFromFields(fields, filename, manifest_files);
+    }
+}
+
+bool RuntimeManifestFile::ParseFields(const Json::Value &root_node, const std::string &filename, ManifestFileFields &fields) {
     std::ostringstream error_ss("RuntimeManifestFile::CreateIfValid ");
     JsonVersion file_version = {};
     if (!ManifestFile::IsValidJson(root_node, file_version)) {
         error_ss << "isValidJson indicates " << filename << " is not a valid manifest file.";
         LoaderLogger::LogErrorMessage("", error_ss.str());
-        return;
+        return false;
     }
     const Json::Value &runtime_root_node = root_node["runtime"];
     // The Runtime manifest file needs the "runtime" root as well as a sub-node for "library_path".  If any of those aren't there,
@@ -592,10 +900,20 @@ void RuntimeManifestFile::CreateIfValid(const Json::Value &root_node, const std:
     if (runtime_root_node.isNull() || runtime_root_node["library_path"].isNull() || !runtime_root_node["library_path"].isString()) {
         error_ss << filename << " is missing required fields.  Verify all proper fields exist.";
         LoaderLogger::LogErrorMessage("", error_ss.str());
-        return;
+        return false;
     }
 
-    std::string lib_path = runtime_root_node["library_path"].asString();
+    fields.library_path = runtime_root_node["library_path"].asString();
+
+    // Add any extensions and renamed functions
+    ParseCommon(runtime_root_node, filename, fields);
+    return true;
+}
+
+void RuntimeManifestFile::CreateFromFields(const ManifestFileFields &fields, const std::string &filename,
+                                           std::vector<std::unique_ptr<RuntimeManifestFile>> &manifest_files) {
+    std::ostringstream error_ss("RuntimeManifestFile::CreateIfValid ");
+    std::string lib_path = fields.library_path;
 
     // If the library_path variable has no directory symbol, it's just a file name and should be accessible on the
     // global library path.
@@ -626,12 +944,13 @@ void RuntimeManifestFile::CreateIfValid(const Json::Value &root_node, const std:
 
     // Add any extensions to it after the fact.
     // Handle any renamed functions
-    manifest_files.back()->ParseCommon(runtime_root_node);
+    manifest_files.back()->SetCommon(fields);
 }
 
 // Find all manifest files in the appropriate search paths/registries for the given type.
 XrResult RuntimeManifestFile::FindManifestFiles(const std::string &openxr_command,
                                                 std::vector<std::unique_ptr<RuntimeManifestFile>> &manifest_files) {
+    const auto start_time = std::chrono::steady_clock::now();
     XrResult result = XR_SUCCESS;
     std::string filename = PlatformUtilsGetSecureEnv(OPENXR_RUNTIME_JSON_ENV_VAR);
     if (!filename.empty()) {
@@ -684,6 +1003,7 @@ XrResult RuntimeManifestFile::FindManifestFiles(const std::string &openxr_comman
 #endif  // !defined(XR_OS_WINDOWS) && !defined(XR_OS_LINUX)
     }
     RuntimeManifestFile::CreateIfValid(filename, manifest_files);
+    ManifestCache::Instance().Flush(openxr_command, "RuntimeManifestFile::FindManifestFiles", start_time);
 
     return result;
 }
@@ -766,6 +1086,13 @@ void ApiLayerManifestFile::AddManifestFilesAndroid(const std::string &openxr_com
 void ApiLayerManifestFile::CreateIfValid(ManifestFileType type, const std::string &filename, std::istream &json_stream,
                                          LibraryLocator locate_library,
                                          std::vector<std::unique_ptr<ApiLayerManifestFile>> &manifest_files) {
+    ManifestFileFields fields;
+    if (ParseFields(json_stream, filename, fields)) {
+        CreateFromFields(type, fields, filename, locate_library, manifest_files);
+    }
+}
+
+bool ApiLayerManifestFile::ParseFields(std::istream &json_stream, const std::string &filename, ManifestFileFields &fields) {
     std::ostringstream error_ss("ApiLayerManifestFile::CreateIfValid ");
     Json::CharReaderBuilder builder;
     std::string errors;
@@ -777,13 +1104,13 @@ void ApiLayerManifestFile::CreateIfValid(ManifestFileType type, const std::strin
         }
         error_ss << " Is it a valid layer manifest file?";
         LoaderLogger::LogErrorMessage("", error_ss.str());
-        return;
+        return false;
     }
     JsonVersion file_version = {};
     if (!ManifestFile::IsValidJson(root_node, file_version)) {
         error_ss << "isValidJson indicates " << filename << " is not a valid manifest file.";
         LoaderLogger::LogErrorMessage("", error_ss.str());
-        return;
+        return false;
     }
 
     Json::Value layer_root_node = root_node["api_layer"];
@@ -796,28 +1123,51 @@ void ApiLayerManifestFile::CreateIfValid(ManifestFileType type, const std::strin
         layer_root_node["implementation_version"].isNull() || !layer_root_node["implementation_version"].isString()) {
         error_ss << filename << " is missing required fields.  Verify all proper fields exist.";
         LoaderLogger::LogErrorMessage("", error_ss.str());
-        return;
+        return false;
+    }
+    if (!layer_root_node["disable_environment"].isNull() && layer_root_node["disable_environment"].isString()) {
+        fields.has_disable_environment = true;
+        fields.disable_environment = layer_root_node["disable_environment"].asString();
+    }
+    if (!layer_root_node["enable_environment"].isNull() && layer_root_node["enable_environment"].isString()) {
+        fields.has_enable_environment = true;
+        fields.enable_environment = layer_root_node["enable_environment"].asString();
     }
+    fields.layer_name = layer_root_node["name"].asString();
+    fields.api_version = layer_root_node["api_version"].asString();
+    fields.implementation_version = layer_root_node["implementation_version"].asString();
+    fields.library_path = layer_root_node["library_path"].asString();
+    if (!layer_root_node["description"].isNull() && layer_root_node["description"].isString()) {
+        fields.description = layer_root_node["description"].asString();
+    }
+
+    // Add any extensions and renamed functions
+    ParseCommon(layer_root_node, filename, fields);
+    return true;
+}
+
+void ApiLayerManifestFile::CreateFromFields(ManifestFileType type, const ManifestFileFields &fields, const std::string &filename,
+                                            LibraryLocator locate_library,
+                                            std::vector<std::unique_ptr<ApiLayerManifestFile>> &manifest_files) {
+    std::ostringstream error_ss("ApiLayerManifestFile::CreateIfValid ");
     if (MANIFEST_TYPE_IMPLICIT_API_LAYER == type) {
         bool enabled = true;
         // Implicit layers require the disable environment variable.
-        if (layer_root_node["disable_environment"].isNull() || !layer_root_node["disable_environment"].isString()) {
+        if (!fields.has_disable_environment) {
             error_ss << "Implicit layer " << filename << " is missing \"disable_environment\"";
             LoaderLogger::LogErrorMessage("", error_ss.str());
             return;
         }
         // Check if there's an enable environment variable provided
-        if (!layer_root_node["enable_environment"].isNull() && layer_root_node["enable_environment"].isString()) {
-            std::string env_var = layer_root_node["enable_environment"].asString();
+        if (fields.has_enable_environment) {
             // If it's not set in the environment, disable the layer
-            if (!PlatformUtilsGetEnvSet(env_var.c_str())) {
+            if (!PlatformUtilsGetEnvSet(fields.enable_environment.c_str())) {
                 enabled = false;
             }
         }
         // Check for the disable environment variable, which must be provided in the JSON
-        std::string env_var = layer_root_node["disable_environment"].asString();
         // If the env var is set, disable the layer. Disable env var overrides enable above
-        if (PlatformUtilsGetEnvSet(env_var.c_str())) {
+        if (PlatformUtilsGetEnvSet(fields.disable_environment.c_str())) {
             enabled = false;
         }
 
@@ -828,10 +1178,8 @@ void ApiLayerManifestFile::CreateIfValid(ManifestFileType type, const std::strin
             return;
         }
     }
-    std::string layer_name = layer_root_node["name"].asString();
-    std::string api_version_string = layer_root_node["api_version"].asString();
     JsonVersion api_version = {};
-    const int num_fields = sscanf(api_version_string.c_str(), "%u.%u", &api_version.major, &api_version.minor);
+    const int num_fields = sscanf(fields.api_version.c_str(), "%u.%u", &api_version.major, &api_version.minor);
     api_version.patch = 0;
 
     if ((num_fields != 2) || (api_version.major == 0 && api_version.minor == 0) ||
@@ -841,8 +1189,8 @@ void ApiLayerManifestFile::CreateIfValid(ManifestFileType type, const std::strin
         return;
     }
 
-    uint32_t implementation_version = atoi(layer_root_node["implementation_version"].asString().c_str());
-    std::string library_path = layer_root_node["library_path"].asString();
+    uint32_t implementation_version = atoi(fields.implementation_version.c_str());
+    std::string library_path = fields.library_path;
 
     // If the library_path variable has no directory symbol, it's just a file name and should be accessible on the
     // global library path.
@@ -866,21 +1214,24 @@ void ApiLayerManifestFile::CreateIfValid(ManifestFileType type, const std::strin
         }
     }
 
-    std::string description;
-    if (!layer_root_node["description"].isNull() && layer_root_node["description"].isString()) {
-        description = layer_root_node["description"].asString();
-    }
-
     // Add this layer manifest file
-    manifest_files.emplace_back(
-        new ApiLayerManifestFile(type, filename, layer_name, description, api_version, implementation_version, library_path));
+    manifest_files.emplace_back(new ApiLayerManifestFile(type, filename, fields.layer_name, fields.description, api_version,
+                                                         implementation_version, library_path));
 
     // Add any extensions to it after the fact.
-    manifest_files.back()->ParseCommon(layer_root_node);
+    manifest_files.back()->SetCommon(fields);
 }
 
 void ApiLayerManifestFile::CreateIfValid(ManifestFileType type, const std::string &filename,
                                          std::vector<std::unique_ptr<ApiLayerManifestFile>> &manifest_files) {
+    ManifestCache &cache = ManifestCache::Instance();
+    ManifestFileStamp stamp;
+    ManifestFileFields fields;
+    if (cache.Lookup(type, filename, stamp, fields)) {
+        CreateFromFields(type, fields, filename, &ApiLayerManifestFile::LocateLibraryRelativeToJson, manifest_files);
+        return;
+    }
+
     std::ifstream json_stream(filename, std::ifstream::in);
     if (!json_stream.is_open()) {
         std::ostringstream error_ss("ApiLayerManifestFile::CreateIfValid ");
@@ -888,7 +1239,11 @@ void ApiLayerManifestFile::CreateIfValid(ManifestFileType type, const std::strin
         LoaderLogger::LogErrorMessage("", error_ss.str());
         return;
     }
-    CreateIfValid(type, filename, json_stream, &ApiLayerManifestFile::LocateLibraryRelativeToJson, manifest_files);
+    if (!ParseFields(json_stream, filename, fields)) {
+        return;
+    }
+    cache.Store(type, filename, stamp, fields);
+    CreateFromFields(type, fields, filename, &ApiLayerManifestFile::LocateLibraryRelativeToJson, manifest_files);
 }
 
 bool ApiLayerManifestFile::LocateLibraryRelativeToJson(
@@ -935,6 +1290,7 @@ void ApiLayerManifestFile::PopulateApiLayerProperties(XrApiLayerProperties &prop
 // Find all layer manifest files in the appropriate search paths/registries for the given type.
 XrResult ApiLayerManifestFile::FindManifestFiles(const std::string &openxr_command, ManifestFileType type,
                                                  std::vector<std::unique_ptr<ApiLayerManifestFile>> &manifest_files) {
+    const auto start_time = std::chrono::steady_clock::now();
     std::string relative_path;
     std::string override_env_var;
     std::string registry_location;
@@ -979,6 +1335,7 @@ XrResult ApiLayerManifestFile::FindManifestFiles(const std::string &openxr_comma
     for (std::string &cur_file : filenames) {
         ApiLayerManifestFile::CreateIfValid(type, cur_file, manifest_files);
     }
+    ManifestCache::Instance().Flush(openxr_command, "ApiLayerManifestFile::FindManifestFiles", start_time);
 
 #if defined(XR_KHR_LOADER_INIT_SUPPORT) && defined(XR_USE_PLATFORM_ANDROID)
     ApiLayerManifestFile::AddManifestFilesAndroid(openxr_command, type, manifest_files);
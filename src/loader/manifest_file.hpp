@@ -16,6 +16,7 @@
 #include <vector>
 #include <iosfwd>
 #include <unordered_map>
+#include <utility>
 
 namespace Json {
 class Value;
@@ -39,6 +40,24 @@ struct ExtensionListing {
     uint32_t extension_version;
 };
 
+// The values read from a manifest file that passed the JSON structure checks, before any
+// environment or filesystem dependent validation. This is what the manifest cache stores.
+struct ManifestFileFields {
+    std::string library_path;
+    std::vector<ExtensionListing> instance_extensions;
+    std::vector<std::pair<std::string, std::string>> functions_renamed;
+
+    // API layer manifests only
+    std::string layer_name;
+    std::string api_version;
+    std::string implementation_version;
+    std::string description;
+    bool has_enable_environment = false;
+    std::string enable_environment;
+    bool has_disable_environment = false;
+    std::string disable_environment;
+};
+
 // ManifestFile class -
 // Base class responsible for finding and parsing manifest files.
 class ManifestFile {
@@ -55,7 +74,8 @@ class ManifestFile {
 
    protected:
     ManifestFile(ManifestFileType type, const std::string &filename, const std::string &library_path);
-    void ParseCommon(Json::Value const &root_node);
+    static void ParseCommon(Json::Value const &root_node, const std::string &filename, ManifestFileFields &fields);
+    void SetCommon(const ManifestFileFields &fields);
     static bool IsValidJson(const Json::Value &root, JsonVersion &version);
 
    private:
@@ -79,6 +99,9 @@ class RuntimeManifestFile : public ManifestFile {
     static void CreateIfValid(const std::string &filename, std::vector<std::unique_ptr<RuntimeManifestFile>> &manifest_files);
     static void CreateIfValid(const Json::Value &root_node, const std::string &filename,
                               std::vector<std::unique_ptr<RuntimeManifestFile>> &manifest_files);
+    static bool ParseFields(const Json::Value &root_node, const std::string &filename, ManifestFileFields &fields);
+    static void CreateFromFields(const ManifestFileFields &fields, const std::string &filename,
+                                 std::vector<std::unique_ptr<RuntimeManifestFile>> &manifest_files);
 };
 
 using LibraryLocator = bool (*)(const std::string &json_filename, const std::string &library_path, std::string &out_combined_path);
@@ -103,6 +126,9 @@ class ApiLayerManifestFile : public ManifestFile {
                               LibraryLocator locate_library, std::vector<std::unique_ptr<ApiLayerManifestFile>> &manifest_files);
     static void CreateIfValid(ManifestFileType type, const std::string &filename,
                               std::vector<std::unique_ptr<ApiLayerManifestFile>> &manifest_files);
+    static bool ParseFields(std::istream &json_stream, const std::string &filename, ManifestFileFields &fields);
+    static void CreateFromFields(ManifestFileType type, const ManifestFileFields &fields, const std::string &filename,
+                                 LibraryLocator locate_library, std::vector<std::unique_ptr<ApiLayerManifestFile>> &manifest_files);
     /// @return false if we could not find the library.
     static bool LocateLibraryRelativeToJson(const std::string &json_filename, const std::string &library_path,
                                             std::string &out_combined_path);
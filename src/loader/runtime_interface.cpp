@@ -194,15 +194,17 @@ XrResult RuntimeInterface::TryLoadingSingleRuntime(const std::string& openxr_com
         return res;
     }
 
-    std::string info_message = "RuntimeInterface::LoadRuntime succeeded loading runtime defined in manifest file ";
-    info_message += manifest_file->Filename();
-    info_message += " using interface version ";
-    info_message += std::to_string(runtime_info.runtimeInterfaceVersion);
-    info_message += " and OpenXR API version ";
-    info_message += std::to_string(XR_VERSION_MAJOR(runtime_info.runtimeApiVersion));
-    info_message += ".";
-    info_message += std::to_string(XR_VERSION_MINOR(runtime_info.runtimeApiVersion));
-    LoaderLogger::LogInfoMessage(openxr_command, info_message);
+    LoaderLogger::LogInfoMessage(openxr_command, [&] {
+        std::string info_message = "RuntimeInterface::LoadRuntime succeeded loading runtime defined in manifest file ";
+        info_message += manifest_file->Filename();
+        info_message += " using interface version ";
+        info_message += std::to_string(runtime_info.runtimeInterfaceVersion);
+        info_message += " and OpenXR API version ";
+        info_message += std::to_string(XR_VERSION_MAJOR(runtime_info.runtimeApiVersion));
+        info_message += ".";
+        info_message += std::to_string(XR_VERSION_MINOR(runtime_info.runtimeApiVersion));
+        return info_message;
+    });
 
     // Use this runtime
     GetInstance().reset(new RuntimeInterface(runtime_library, runtime_info.getInstanceProcAddr));
@@ -0,0 +1,2069 @@
+// Copyright (c) 2017-2024, The Khronos Group Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// A deterministic OpenXR runtime for exercising applications without a headset or GPU, see
+// README.md.  It implements the core API used by a typical application frame loop, scripted
+// head/controller/hand tracking, headless sessions (XR_MND_headless) and, when built with Vulkan
+// support, Vulkan sessions (XR_KHR_vulkan_enable2) with swapchains backed by plain VkImages so
+// that a CPU Vulkan implementation such as lavapipe can be used.
+
+#include "mock_runtime.h"
+
+#include <openxr/openxr_loader_negotiation.h>
+#include <openxr/openxr_reflection.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <string_view>
+#include <thread>
+
+#if defined(__GNUC__) && __GNUC__ >= 4
+#define RUNTIME_EXPORT __attribute__((visibility("default")))
+#elif defined(_WIN32)
+#define RUNTIME_EXPORT __declspec(dllexport)
+#else
+#define RUNTIME_EXPORT
+#endif
+
+namespace {
+
+/// XrTime of the runtime's time origin, time 0 is not a valid XrTime.
+constexpr XrTime kTimeOrigin = 1000000000;
+constexpr uint32_t kMaxLayerCount = 16;
+constexpr uint32_t kMaxSwapchainImageSize = 4096;
+constexpr uint32_t kViewCount = 2;
+constexpr const char *kRuntimeName = "Mock Runtime";
+constexpr const char *kLeftHandPath = "/user/hand/left";
+constexpr const char *kRightHandPath = "/user/hand/right";
+
+using SteadyClock = std::chrono::steady_clock;
+
+struct ExtensionInfo {
+    const char *name;
+    uint32_t version;
+};
+
+std::vector<ExtensionInfo> SupportedExtensions(const MockRuntimeConfig &config) {
+    std::vector<ExtensionInfo> extensions;
+#ifdef XR_USE_TIMESPEC
+    extensions.push_back({XR_KHR_CONVERT_TIMESPEC_TIME_EXTENSION_NAME, XR_KHR_convert_timespec_time_SPEC_VERSION});
+#endif  // XR_USE_TIMESPEC
+#ifdef XR_USE_PLATFORM_WIN32
+    extensions.push_back({XR_KHR_WIN32_CONVERT_PERFORMANCE_COUNTER_TIME_EXTENSION_NAME,
+                          XR_KHR_win32_convert_performance_counter_time_SPEC_VERSION});
+#endif  // XR_USE_PLATFORM_WIN32
+#ifdef XR_USE_GRAPHICS_API_VULKAN
+    extensions.push_back({XR_KHR_VULKAN_ENABLE2_EXTENSION_NAME, XR_KHR_vulkan_enable2_SPEC_VERSION});
+#endif  // XR_USE_GRAPHICS_API_VULKAN
+    if (config.headless) {
+        extensions.push_back({XR_MND_HEADLESS_EXTENSION_NAME, XR_MND_headless_SPEC_VERSION});
+    }
+    if (config.handTracking) {
+        extensions.push_back({XR_EXT_HAND_TRACKING_EXTENSION_NAME, XR_EXT_hand_tracking_SPEC_VERSION});
+    }
+    return extensions;
+}
+
+/// Implements the two call idiom, fill(i) writes element i once the capacity is known to suffice.
+template <typename Fill>
+XrResult FillTwoCall(uint32_t capacityInput, uint32_t *countOutput, const void *output, uint32_t count, Fill &&fill) {
+    if (countOutput == nullptr || (capacityInput != 0 && output == nullptr)) {
+        return XR_ERROR_VALIDATION_FAILURE;
+    }
+    *countOutput = count;
+    if (capacityInput == 0) {
+        return XR_SUCCESS;
+    }
+    if (capacityInput < count) {
+        return XR_ERROR_SIZE_INSUFFICIENT;
+    }
+    for (uint32_t i = 0; i < count; ++i) {
+        fill(i);
+    }
+    return XR_SUCCESS;
+}
+
+XrResult CopyString(const std::string &value, uint32_t capacityInput, uint32_t *countOutput, char *buffer) {
+    return FillTwoCall(capacityInput, countOutput, buffer, static_cast<uint32_t>(value.size() + 1), [&](uint32_t i) {
+        buffer[i] = i < value.size() ? value[i] : '\0';
+    });
+}
+
+#ifdef XR_USE_GRAPHICS_API_VULKAN
+const XrBaseInStructure *FindNext(const void *next, XrStructureType type) {
+    for (auto *it = reinterpret_cast<const XrBaseInStructure *>(next); it != nullptr; it = it->next) {
+        if (it->type == type) {
+            return it;
+        }
+    }
+    return nullptr;
+}
+#endif  // XR_USE_GRAPHICS_API_VULKAN
+
+XrBaseOutStructure *FindNextOut(void *next, XrStructureType type) {
+    for (auto *it = reinterpret_cast<XrBaseOutStructure *>(next); it != nullptr; it = it->next) {
+        if (it->type == type) {
+            return it;
+        }
+    }
+    return nullptr;
+}
+
+bool IsPoseValid(const XrPosef &pose) {
+    const XrQuaternionf &q = pose.orientation;
+    const float lengthSq = q.x * q.x + q.y * q.y + q.z * q.z + q.w * q.w;
+    return std::fabs(lengthSq - 1.0f) < 0.01f;
+}
+
+//
+// Clock
+//
+
+int64_t DisplayPeriod(const MockRuntime &rt) {
+    return static_cast<int64_t>(std::llround(1e9 / static_cast<double>(rt.config.displayRefreshRate)));
+}
+
+/// In virtual clock mode XrTime is anchored to the monotonic clock at the last xrWaitFrame, so
+/// conversions stay consistent with predicted display times while frames run faster than real time.
+XrTime SteadyToXrTime(const MockRuntime &rt, SteadyClock::time_point tp) {
+    if (rt.config.clock == MockRuntimeConfig::ClockMode::Virtual) {
+        return rt.virtualTime + std::chrono::duration_cast<std::chrono::nanoseconds>(tp - rt.virtualTimeWall).count();
+    }
+    return kTimeOrigin + std::chrono::duration_cast<std::chrono::nanoseconds>(tp - rt.clockStart).count();
+}
+
+SteadyClock::time_point XrTimeToSteady(const MockRuntime &rt, XrTime time) {
+    if (rt.config.clock == MockRuntimeConfig::ClockMode::Virtual) {
+        return rt.virtualTimeWall +
+               std::chrono::duration_cast<SteadyClock::duration>(std::chrono::nanoseconds(time - rt.virtualTime));
+    }
+    return rt.clockStart + std::chrono::duration_cast<SteadyClock::duration>(std::chrono::nanoseconds(time - kTimeOrigin));
+}
+
+XrTime Now(const MockRuntime &rt) { return SteadyToXrTime(rt, SteadyClock::now()); }
+
+double TrackSeconds(XrTime time) { return static_cast<double>(time - kTimeOrigin) * 1e-9; }
+
+//
+// Paths
+//
+
+bool IsValidPathString(std::string_view path) {
+    if (path.size() < 2 || path.size() >= XR_MAX_PATH_LENGTH || path.front() != '/' || path.back() == '/') {
+        return false;
+    }
+    char prev = '\0';
+    for (const char c : path) {
+        const bool allowed = (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') || c == '-' || c == '_' || c == '.' || c == '/';
+        if (!allowed || (c == '/' && prev == '/')) {
+            return false;
+        }
+        prev = c;
+    }
+    return true;
+}
+
+XrPath InternPath(MockRuntime &rt, const std::string &path) {
+    const auto it = rt.pathIds.find(path);
+    if (it != rt.pathIds.end()) {
+        return it->second;
+    }
+    rt.paths.push_back(path);
+    const XrPath id = static_cast<XrPath>(rt.paths.size() - 1);
+    rt.pathIds.emplace(path, id);
+    return id;
+}
+
+bool IsPathValid(const MockRuntime &rt, XrPath path) { return path != XR_NULL_PATH && path < rt.paths.size(); }
+
+/// "/user/hand/left/input/trigger/value" -> "/user/hand/left", "/user/head/input/..." -> "/user/head".
+std::string TopLevelUserPath(const std::string &bindingPath) {
+    const std::size_t components = bindingPath.rfind("/user/hand/", 0) == 0 ? 3 : 2;
+    std::size_t end = 0;
+    for (std::size_t i = 0; i < components; ++i) {
+        end = bindingPath.find('/', end + 1);
+        if (end == std::string::npos) {
+            return bindingPath;
+        }
+    }
+    return bindingPath.substr(0, end);
+}
+
+//
+// Events
+//
+
+void QueueSessionState(MockRuntime &rt, uint64_t sessionHandle, MockSession &session, XrSessionState state) {
+    session.state = state;
+    XrEventDataBuffer buffer{XR_TYPE_EVENT_DATA_BUFFER};
+    auto &event = *reinterpret_cast<XrEventDataSessionStateChanged *>(&buffer);
+    event = {XR_TYPE_EVENT_DATA_SESSION_STATE_CHANGED};
+    event.session = IntToHandle<XrSession>(sessionHandle);
+    event.state = state;
+    event.time = Now(rt);
+    rt.events.push_back(buffer);
+}
+
+/// Walks the session down to STOPPING, both for application and runtime initiated exits.
+void BeginSessionExit(MockRuntime &rt, uint64_t sessionHandle, MockSession &session) {
+    session.exitRequested = true;
+    if (session.state == XR_SESSION_STATE_FOCUSED) {
+        QueueSessionState(rt, sessionHandle, session, XR_SESSION_STATE_VISIBLE);
+    }
+    if (session.state == XR_SESSION_STATE_VISIBLE) {
+        QueueSessionState(rt, sessionHandle, session, XR_SESSION_STATE_SYNCHRONIZED);
+    }
+    QueueSessionState(rt, sessionHandle, session, XR_SESSION_STATE_STOPPING);
+}
+
+//
+// Tracking
+//
+
+XrPosef HandPose(const MockRuntime &rt, int hand, XrTime time) { return rt.config.hands[hand].Sample(TrackSeconds(time)); }
+
+XrPosef HeadPose(const MockRuntime &rt, XrTime time) { return rt.config.head.Sample(TrackSeconds(time)); }
+
+int HandIndex(const MockRuntime &rt, XrPath path) {
+    if (IsPathValid(rt, path) && rt.paths[path] == kRightHandPath) {
+        return 1;
+    }
+    return 0;
+}
+
+bool IsActionBound(const MockSession &session, uint64_t action, XrPath subactionPath) {
+    if (subactionPath != XR_NULL_PATH) {
+        return session.boundActions.count({action, subactionPath}) != 0;
+    }
+    const auto it = session.boundActions.lower_bound({action, XR_NULL_PATH});
+    return it != session.boundActions.end() && it->first == action;
+}
+
+struct SpaceLocation {
+    XrPosef pose = PoseIdentity();
+    bool tracked = false;
+};
+
+SpaceLocation LocateInWorld(MockRuntime &rt, const MockSpace &space, XrTime time) {
+    if (space.action == 0) {
+        switch (space.referenceSpaceType) {
+            case XR_REFERENCE_SPACE_TYPE_VIEW:
+                return {PoseMultiply(HeadPose(rt, time), space.poseInParent), true};
+            default:
+                return {space.poseInParent, true};
+        }
+    }
+    const MockSession *session = rt.Find<MockSession>(space.parent, MockObjectType::Session);
+    if (session == nullptr || session->state != XR_SESSION_STATE_FOCUSED) {
+        return {};
+    }
+    XrPath hand = space.subactionPath;
+    if (hand == XR_NULL_PATH) {
+        // Unqualified action spaces follow the first hand the action is bound to.
+        const auto it = session->boundActions.lower_bound({space.action, XR_NULL_PATH});
+        if (it == session->boundActions.end() || it->first != space.action) {
+            return {};
+        }
+        hand = it->second;
+    } else if (!IsActionBound(*session, space.action, hand)) {
+        return {};
+    }
+    return {PoseMultiply(HandPose(rt, HandIndex(rt, hand), time), space.poseInParent), true};
+}
+
+/// Angular velocity which rotates a into b over dt seconds.
+XrVector3f AngularVelocity(const XrQuaternionf &a, const XrQuaternionf &b, float dt) {
+    XrQuaternionf delta = QuatMultiply(b, QuatConjugate(a));
+    if (delta.w < 0.0f) {
+        delta = {-delta.x, -delta.y, -delta.z, -delta.w};
+    }
+    const float sinHalf = std::sqrt(delta.x * delta.x + delta.y * delta.y + delta.z * delta.z);
+    if (sinHalf < 1e-6f) {
+        return {0.0f, 0.0f, 0.0f};
+    }
+    const float angle = 2.0f * std::atan2(sinHalf, delta.w);
+    const float scale = angle / (sinHalf * dt);
+    return {delta.x * scale, delta.y * scale, delta.z * scale};
+}
+
+//
+// Hand joints, a flat open hand in hand space: fingers along -Z, back of the hand along +Y.
+//
+
+XrPosef RestJointPose(XrHandEXT hand, uint32_t joint) {
+    const float side = hand == XR_HAND_LEFT_EXT ? 1.0f : -1.0f;  // the thumb is on +X for the left hand
+    XrPosef pose = PoseIdentity();
+    if (joint == XR_HAND_JOINT_PALM_EXT) {
+        pose.position = {0.0f, 0.0f, -0.01f};
+    } else if (joint == XR_HAND_JOINT_WRIST_EXT) {
+        pose.position = {0.0f, 0.0f, 0.06f};
+    } else if (joint <= XR_HAND_JOINT_THUMB_TIP_EXT) {
+        static const XrVector3f thumb[] = {{0.03f, 0.0f, 0.02f}, {0.05f, 0.0f, -0.01f}, {0.065f, 0.0f, -0.04f}, {0.075f, 0.0f, -0.06f}};
+        const XrVector3f &p = thumb[joint - XR_HAND_JOINT_THUMB_METACARPAL_EXT];
+        pose.position = {p.x * side, p.y, p.z};
+    } else {
+        static const float fingerX[] = {0.022f, 0.0f, -0.02f, -0.038f};
+        static const float fingerLength[] = {1.0f, 1.08f, 1.0f, 0.8f};
+        static const float jointZ[] = {0.03f, -0.04f, -0.085f, -0.11f, -0.13f};
+        const uint32_t finger = (joint - XR_HAND_JOINT_INDEX_METACARPAL_EXT) / 5;
+        const uint32_t segment = (joint - XR_HAND_JOINT_INDEX_METACARPAL_EXT) % 5;
+        const float z = segment == 0 ? jointZ[0] : jointZ[segment] * fingerLength[finger];
+        pose.position = {fingerX[finger] * side, 0.0f, z};
+    }
+    return pose;
+}
+
+//
+// Object destruction
+//
+
+void DestroySwapchain(MockRuntime &rt, MockSwapchain &swapchain) {
+#ifdef XR_USE_GRAPHICS_API_VULKAN
+    const MockSession *session = rt.Find<MockSession>(swapchain.parent, MockObjectType::Session);
+    if (session != nullptr && !session->headless) {
+        MockVulkanDestroySwapchainImages(session->vulkan, swapchain);
+    }
+#else
+    (void)rt;
+    (void)swapchain;
+#endif  // XR_USE_GRAPHICS_API_VULKAN
+}
+
+void DestroyChildren(MockRuntime &rt, uint64_t parent) {
+    for (auto it = rt.objects.begin(); it != rt.objects.end();) {
+        if (it->second->parent != parent) {
+            ++it;
+            continue;
+        }
+        if (it->second->type == MockObjectType::Swapchain) {
+            DestroySwapchain(rt, static_cast<MockSwapchain &>(*it->second));
+        }
+        const uint64_t child = it->first;
+        it = rt.objects.erase(it);
+        DestroyChildren(rt, child);
+        it = rt.objects.begin();
+    }
+}
+
+void PrintSessionStats(const MockRuntime &rt, const MockSession &session) {
+    if (!rt.config.verbose) {
+        return;
+    }
+    fprintf(stderr, "mock runtime: session frames waited %llu, begun %llu, ended %llu, discarded %llu\n",
+            static_cast<unsigned long long>(session.framesWaited), static_cast<unsigned long long>(session.framesBegun),
+            static_cast<unsigned long long>(session.framesEnded), static_cast<unsigned long long>(session.framesDiscarded));
+}
+
+void PrintCallStats(const MockRuntime &rt) {
+    if (!rt.config.verbose) {
+        return;
+    }
+    for (std::size_t i = 0; i < kMockTimedCallCount; ++i) {
+        const uint64_t count = rt.callCounts[i].load(std::memory_order_relaxed);
+        if (count != 0) {
+            fprintf(stderr, "mock runtime: %s called %llu times\n", MockTimedCallName(static_cast<MockTimedCall>(i)),
+                    static_cast<unsigned long long>(count));
+        }
+    }
+}
+
+#define LOCK_RUNTIME()                    \
+    MockRuntime &rt = MockRuntime::Get(); \
+    std::lock_guard<std::mutex> lock(rt.mutex)
+
+#define CHECK_INSTANCE(handle)                                  \
+    if ((handle) == XR_NULL_HANDLE || (handle) != rt.instance) { \
+        return XR_ERROR_HANDLE_INVALID;                          \
+    }
+
+template <typename T>
+struct ObjectTypeOf;
+template <>
+struct ObjectTypeOf<MockSession> {
+    static constexpr MockObjectType value = MockObjectType::Session;
+};
+template <>
+struct ObjectTypeOf<MockSpace> {
+    static constexpr MockObjectType value = MockObjectType::Space;
+};
+template <>
+struct ObjectTypeOf<MockActionSet> {
+    static constexpr MockObjectType value = MockObjectType::ActionSet;
+};
+template <>
+struct ObjectTypeOf<MockAction> {
+    static constexpr MockObjectType value = MockObjectType::Action;
+};
+template <>
+struct ObjectTypeOf<MockSwapchain> {
+    static constexpr MockObjectType value = MockObjectType::Swapchain;
+};
+template <>
+struct ObjectTypeOf<MockHandTracker> {
+    static constexpr MockObjectType value = MockObjectType::HandTracker;
+};
+
+template <typename T, typename HandleType>
+T *Lookup(MockRuntime &rt, HandleType handle) {
+    return rt.Find<T>(HandleToInt(handle), ObjectTypeOf<T>::value);
+}
+
+}  // namespace
+
+MockRuntime &MockRuntime::Get() {
+    static MockRuntime runtime;
+    return runtime;
+}
+
+MockRuntime::MockRuntime() : config(MockRuntimeConfig::Load()) {}
+
+void MockRuntime::ResetInstance() {
+    DestroyChildren(*this, 0);
+    objects.clear();
+    instance = XR_NULL_HANDLE;
+    enabledExtensions.clear();
+    events.clear();
+    paths.assign(1, std::string());
+    pathIds.clear();
+    suggestedBindings.clear();
+    vulkanRequirementsQueried = false;
+#ifdef XR_USE_GRAPHICS_API_VULKAN
+    vulkanInstance = VK_NULL_HANDLE;
+    vulkanGetInstanceProcAddr = nullptr;
+#endif  // XR_USE_GRAPHICS_API_VULKAN
+}
+
+void MockSimulateCall(MockTimedCall call) {
+    MockRuntime &rt = MockRuntime::Get();
+    const std::size_t index = static_cast<std::size_t>(call);
+    rt.callCounts[index].fetch_add(1, std::memory_order_relaxed);
+    const std::chrono::nanoseconds latency = rt.config.latencies[index];
+    if (latency.count() <= 0) {
+        return;
+    }
+    const auto deadline = SteadyClock::now() + latency;
+    if (latency > std::chrono::milliseconds(2)) {
+        std::this_thread::sleep_until(deadline - std::chrono::milliseconds(1));
+    }
+    while (SteadyClock::now() < deadline) {
+        std::this_thread::yield();
+    }
+}
+
+namespace {
+
+//
+// Instance
+//
+
+XRAPI_ATTR XrResult XRAPI_CALL MockEnumerateApiLayerProperties(uint32_t propertyCapacityInput, uint32_t *propertyCountOutput,
+                                                               XrApiLayerProperties *properties) {
+    return FillTwoCall(propertyCapacityInput, propertyCountOutput, properties, 0, [](uint32_t) {});
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL MockEnumerateInstanceExtensionProperties(const char *layerName, uint32_t propertyCapacityInput,
+                                                                        uint32_t *propertyCountOutput,
+                                                                        XrExtensionProperties *properties) {
+    if (layerName != nullptr) {
+        return XR_ERROR_API_LAYER_NOT_PRESENT;
+    }
+    LOCK_RUNTIME();
+    const std::vector<ExtensionInfo> extensions = SupportedExtensions(rt.config);
+    return FillTwoCall(propertyCapacityInput, propertyCountOutput, properties, static_cast<uint32_t>(extensions.size()),
+                       [&](uint32_t i) {
+                           strncpy(properties[i].extensionName, extensions[i].name, XR_MAX_EXTENSION_NAME_SIZE - 1);
+                           properties[i].extensionName[XR_MAX_EXTENSION_NAME_SIZE - 1] = '\0';
+                           properties[i].extensionVersion = extensions[i].version;
+                       });
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL MockCreateInstance(const XrInstanceCreateInfo *createInfo, XrInstance *instance) {
+    if (createInfo == nullptr || instance == nullptr || createInfo->type != XR_TYPE_INSTANCE_CREATE_INFO) {
+        return XR_ERROR_VALIDATION_FAILURE;
+    }
+    if (XR_VERSION_MAJOR(createInfo->applicationInfo.apiVersion) != 1) {
+        return XR_ERROR_API_VERSION_UNSUPPORTED;
+    }
+    LOCK_RUNTIME();
+    if (rt.instance != XR_NULL_HANDLE) {
+        return XR_ERROR_LIMIT_REACHED;
+    }
+    // Re-read the configuration so each instance of a test process can use a different script.
+    rt.config = MockRuntimeConfig::Load();
+    const std::vector<ExtensionInfo> supported = SupportedExtensions(rt.config);
+    std::set<std::string> enabled;
+    for (uint32_t i = 0; i < createInfo->enabledExtensionCount; ++i) {
+        const char *name = createInfo->enabledExtensionNames[i];
+        const auto it = std::find_if(supported.begin(), supported.end(),
+                                     [name](const ExtensionInfo &ext) { return std::strcmp(ext.name, name) == 0; });
+        if (it == supported.end()) {
+            return XR_ERROR_EXTENSION_NOT_PRESENT;
+        }
+        enabled.emplace(name);
+    }
+
+    rt.ResetInstance();
+    rt.enabledExtensions = std::move(enabled);
+    rt.instance = IntToHandle<XrInstance>(rt.nextHandle++);
+    rt.clockStart = SteadyClock::now();
+    rt.virtualTime = kTimeOrigin;
+    rt.virtualTimeWall = rt.clockStart;
+    for (auto &count : rt.callCounts) {
+        count.store(0, std::memory_order_relaxed);
+    }
+    *instance = rt.instance;
+    return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL MockDestroyInstance(XrInstance instance) {
+    LOCK_RUNTIME();
+    CHECK_INSTANCE(instance);
+    PrintCallStats(rt);
+    rt.ResetInstance();
+    return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL MockGetInstanceProperties(XrInstance instance, XrInstanceProperties *instanceProperties) {
+    LOCK_RUNTIME();
+    CHECK_INSTANCE(instance);
+    if (instanceProperties == nullptr || instanceProperties->type != XR_TYPE_INSTANCE_PROPERTIES) {
+        return XR_ERROR_VALIDATION_FAILURE;
+    }
+    instanceProperties->runtimeVersion = XR_MAKE_VERSION(1, 0, 0);
+    strncpy(instanceProperties->runtimeName, kRuntimeName, XR_MAX_RUNTIME_NAME_SIZE - 1);
+    instanceProperties->runtimeName[XR_MAX_RUNTIME_NAME_SIZE - 1] = '\0';
+    return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL MockPollEvent(XrInstance instance, XrEventDataBuffer *eventData) {
+    MockSimulateCall(MockTimedCall::xrPollEvent);
+    LOCK_RUNTIME();
+    CHECK_INSTANCE(instance);
+    if (eventData == nullptr) {
+        return XR_ERROR_VALIDATION_FAILURE;
+    }
+    if (rt.events.empty()) {
+        return XR_EVENT_UNAVAILABLE;
+    }
+    *eventData = rt.events.front();
+    rt.events.pop_front();
+    return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL MockResultToString(XrInstance instance, XrResult value, char buffer[XR_MAX_RESULT_STRING_SIZE]) {
+    LOCK_RUNTIME();
+    CHECK_INSTANCE(instance);
+    const char *name = nullptr;
+    switch (value) {
+#define MOCK_RESULT_CASE(result, _) \
+    case result:                    \
+        name = #result;             \
+        break;
+        XR_LIST_ENUM_XrResult(MOCK_RESULT_CASE)
+#undef MOCK_RESULT_CASE
+        default:
+            break;
+    }
+    if (name != nullptr) {
+        snprintf(buffer, XR_MAX_RESULT_STRING_SIZE, "%s", name);
+    } else {
+        snprintf(buffer, XR_MAX_RESULT_STRING_SIZE, XR_SUCCEEDED(value) ? "XR_UNKNOWN_SUCCESS_%d" : "XR_UNKNOWN_FAILURE_%d",
+                 static_cast<int>(value));
+    }
+    return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL MockStructureTypeToString(XrInstance instance, XrStructureType value,
+                                                         char buffer[XR_MAX_STRUCTURE_NAME_SIZE]) {
+    LOCK_RUNTIME();
+    CHECK_INSTANCE(instance);
+    const char *name = nullptr;
+    switch (value) {
+#define MOCK_STRUCTURE_TYPE_CASE(type, _) \
+    case type:                            \
+        name = #type;                     \
+        break;
+        XR_LIST_ENUM_XrStructureType(MOCK_STRUCTURE_TYPE_CASE)
+#undef MOCK_STRUCTURE_TYPE_CASE
+        default:
+            break;
+    }
+    if (name != nullptr) {
+        snprintf(buffer, XR_MAX_STRUCTURE_NAME_SIZE, "%s", name);
+    } else {
+        snprintf(buffer, XR_MAX_STRUCTURE_NAME_SIZE, "XR_UNKNOWN_STRUCTURE_TYPE_%d", static_cast<int>(value));
+    }
+    return XR_SUCCESS;
+}
+
+//
+// System
+//
+
+XRAPI_ATTR XrResult XRAPI_CALL MockGetSystem(XrInstance instance, const XrSystemGetInfo *getInfo, XrSystemId *systemId) {
+    LOCK_RUNTIME();
+    CHECK_INSTANCE(instance);
+    if (getInfo == nullptr || systemId == nullptr || getInfo->type != XR_TYPE_SYSTEM_GET_INFO) {
+        return XR_ERROR_VALIDATION_FAILURE;
+    }
+    if (getInfo->formFactor != XR_FORM_FACTOR_HEAD_MOUNTED_DISPLAY) {
+        return XR_ERROR_FORM_FACTOR_UNSUPPORTED;
+    }
+    *systemId = kMockSystemId;
+    return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL MockGetSystemProperties(XrInstance instance, XrSystemId systemId, XrSystemProperties *properties) {
+    LOCK_RUNTIME();
+    CHECK_INSTANCE(instance);
+    if (systemId != kMockSystemId) {
+        return XR_ERROR_SYSTEM_INVALID;
+    }
+    if (properties == nullptr || properties->type != XR_TYPE_SYSTEM_PROPERTIES) {
+        return XR_ERROR_VALIDATION_FAILURE;
+    }
+    properties->systemId = kMockSystemId;
+    properties->vendorId = 0;
+    strncpy(properties->systemName, rt.config.systemName.c_str(), XR_MAX_SYSTEM_NAME_SIZE - 1);
+    properties->systemName[XR_MAX_SYSTEM_NAME_SIZE - 1] = '\0';
+    properties->graphicsProperties = {kMaxSwapchainImageSize, kMaxSwapchainImageSize, kMaxLayerCount};
+    properties->trackingProperties = {XR_TRUE, XR_TRUE};
+    if (auto *handTracking = reinterpret_cast<XrSystemHandTrackingPropertiesEXT *>(
+            FindNextOut(properties->next, XR_TYPE_SYSTEM_HAND_TRACKING_PROPERTIES_EXT))) {
+        handTracking->supportsHandTracking = rt.IsExtensionEnabled(XR_EXT_HAND_TRACKING_EXTENSION_NAME) ? XR_TRUE : XR_FALSE;
+    }
+    return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL MockEnumerateViewConfigurations(XrInstance instance, XrSystemId systemId,
+                                                               uint32_t viewConfigurationTypeCapacityInput,
+                                                               uint32_t *viewConfigurationTypeCountOutput,
+                                                               XrViewConfigurationType *viewConfigurationTypes) {
+    LOCK_RUNTIME();
+    CHECK_INSTANCE(instance);
+    if (systemId != kMockSystemId) {
+        return XR_ERROR_SYSTEM_INVALID;
+    }
+    return FillTwoCall(viewConfigurationTypeCapacityInput, viewConfigurationTypeCountOutput, viewConfigurationTypes, 1,
+                       [&](uint32_t i) { viewConfigurationTypes[i] = XR_VIEW_CONFIGURATION_TYPE_PRIMARY_STEREO; });
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL MockGetViewConfigurationProperties(XrInstance instance, XrSystemId systemId,
+                                                                  XrViewConfigurationType viewConfigurationType,
+                                                                  XrViewConfigurationProperties *configurationProperties) {
+    LOCK_RUNTIME();
+    CHECK_INSTANCE(instance);
+    if (systemId != kMockSystemId) {
+        return XR_ERROR_SYSTEM_INVALID;
+    }
+    if (viewConfigurationType != XR_VIEW_CONFIGURATION_TYPE_PRIMARY_STEREO) {
+        return XR_ERROR_VIEW_CONFIGURATION_TYPE_UNSUPPORTED;
+    }
+    if (configurationProperties == nullptr || configurationProperties->type != XR_TYPE_VIEW_CONFIGURATION_PROPERTIES) {
+        return XR_ERROR_VALIDATION_FAILURE;
+    }
+    configurationProperties->viewConfigurationType = viewConfigurationType;
+    configurationProperties->fovMutable = XR_FALSE;
+    return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL MockEnumerateViewConfigurationViews(XrInstance instance, XrSystemId systemId,
+                                                                   XrViewConfigurationType viewConfigurationType,
+                                                                   uint32_t viewCapacityInput, uint32_t *viewCountOutput,
+                                                                   XrViewConfigurationView *views) {
+    LOCK_RUNTIME();
+    CHECK_INSTANCE(instance);
+    if (systemId != kMockSystemId) {
+        return XR_ERROR_SYSTEM_INVALID;
+    }
+    if (viewConfigurationType != XR_VIEW_CONFIGURATION_TYPE_PRIMARY_STEREO) {
+        return XR_ERROR_VIEW_CONFIGURATION_TYPE_UNSUPPORTED;
+    }
+    for (uint32_t i = 0; views != nullptr && i < viewCapacityInput; ++i) {
+        if (views[i].type != XR_TYPE_VIEW_CONFIGURATION_VIEW) {
+            return XR_ERROR_VALIDATION_FAILURE;
+        }
+    }
+    return FillTwoCall(viewCapacityInput, viewCountOutput, views, kViewCount, [&](uint32_t i) {
+        views[i].recommendedImageRectWidth = rt.config.recommendedImageWidth;
+        views[i].maxImageRectWidth = kMaxSwapchainImageSize;
+        views[i].recommendedImageRectHeight = rt.config.recommendedImageHeight;
+        views[i].maxImageRectHeight = kMaxSwapchainImageSize;
+        views[i].recommendedSwapchainSampleCount = 1;
+        views[i].maxSwapchainSampleCount = 1;
+    });
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL MockEnumerateEnvironmentBlendModes(XrInstance instance, XrSystemId systemId,
+                                                                  XrViewConfigurationType viewConfigurationType,
+                                                                  uint32_t environmentBlendModeCapacityInput,
+                                                                  uint32_t *environmentBlendModeCountOutput,
+                                                                  XrEnvironmentBlendMode *environmentBlendModes) {
+    LOCK_RUNTIME();
+    CHECK_INSTANCE(instance);
+    if (systemId != kMockSystemId) {
+        return XR_ERROR_SYSTEM_INVALID;
+    }
+    if (viewConfigurationType != XR_VIEW_CONFIGURATION_TYPE_PRIMARY_STEREO) {
+        return XR_ERROR_VIEW_CONFIGURATION_TYPE_UNSUPPORTED;
+    }
+    return FillTwoCall(environmentBlendModeCapacityInput, environmentBlendModeCountOutput, environmentBlendModes, 1,
+                       [&](uint32_t i) { environmentBlendModes[i] = XR_ENVIRONMENT_BLEND_MODE_OPAQUE; });
+}
+
+//
+// Time conversion
+//
+
+#ifdef XR_USE_TIMESPEC
+XRAPI_ATTR XrResult XRAPI_CALL MockConvertTimespecTimeToTimeKHR(XrInstance instance, const struct timespec *timespecTime,
+                                                                XrTime *time) {
+    LOCK_RUNTIME();
+    CHECK_INSTANCE(instance);
+    if (timespecTime == nullptr || time == nullptr) {
+        return XR_ERROR_VALIDATION_FAILURE;
+    }
+    // steady_clock is CLOCK_MONOTONIC, the clock the extension specifies.
+    const auto tp = SteadyClock::time_point(std::chrono::duration_cast<SteadyClock::duration>(
+        std::chrono::seconds(timespecTime->tv_sec) + std::chrono::nanoseconds(timespecTime->tv_nsec)));
+    *time = SteadyToXrTime(rt, tp);
+    return *time > 0 ? XR_SUCCESS : XR_ERROR_TIME_INVALID;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL MockConvertTimeToTimespecTimeKHR(XrInstance instance, XrTime time, struct timespec *timespecTime) {
+    LOCK_RUNTIME();
+    CHECK_INSTANCE(instance);
+    if (timespecTime == nullptr) {
+        return XR_ERROR_VALIDATION_FAILURE;
+    }
+    if (time <= 0) {
+        return XR_ERROR_TIME_INVALID;
+    }
+    const int64_t ns =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(XrTimeToSteady(rt, time).time_since_epoch()).count();
+    timespecTime->tv_sec = static_cast<decltype(timespecTime->tv_sec)>(ns / 1000000000);
+    timespecTime->tv_nsec = static_cast<decltype(timespecTime->tv_nsec)>(ns % 1000000000);
+    return XR_SUCCESS;
+}
+#endif  // XR_USE_TIMESPEC
+
+#ifdef XR_USE_PLATFORM_WIN32
+int64_t PerformanceFrequency() {
+    LARGE_INTEGER frequency;
+    QueryPerformanceFrequency(&frequency);
+    return frequency.QuadPart;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL MockConvertWin32PerformanceCounterToTimeKHR(XrInstance instance,
+                                                                           const LARGE_INTEGER *performanceCounter,
+                                                                           XrTime *time) {
+    LOCK_RUNTIME();
+    CHECK_INSTANCE(instance);
+    if (performanceCounter == nullptr || time == nullptr) {
+        return XR_ERROR_VALIDATION_FAILURE;
+    }
+    // steady_clock counts QueryPerformanceCounter ticks since the counter's origin.
+    const int64_t frequency = PerformanceFrequency();
+    const int64_t counter = performanceCounter->QuadPart;
+    const int64_t ns = (counter / frequency) * 1000000000 + (counter % frequency) * 1000000000 / frequency;
+    *time = SteadyToXrTime(rt, SteadyClock::time_point(std::chrono::duration_cast<SteadyClock::duration>(std::chrono::nanoseconds(ns))));
+    return *time > 0 ? XR_SUCCESS : XR_ERROR_TIME_INVALID;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL MockConvertTimeToWin32PerformanceCounterKHR(XrInstance instance, XrTime time,
+                                                                           LARGE_INTEGER *performanceCounter) {
+    LOCK_RUNTIME();
+    CHECK_INSTANCE(instance);
+    if (performanceCounter == nullptr) {
+        return XR_ERROR_VALIDATION_FAILURE;
+    }
+    if (time <= 0) {
+        return XR_ERROR_TIME_INVALID;
+    }
+    const int64_t frequency = PerformanceFrequency();
+    const int64_t ns =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(XrTimeToSteady(rt, time).time_since_epoch()).count();
+    performanceCounter->QuadPart = (ns / 1000000000) * frequency + (ns % 1000000000) * frequency / 1000000000;
+    return XR_SUCCESS;
+}
+#endif  // XR_USE_PLATFORM_WIN32
+
+//
+// Paths
+//
+
+XRAPI_ATTR XrResult XRAPI_CALL MockStringToPath(XrInstance instance, const char *pathString, XrPath *path) {
+    LOCK_RUNTIME();
+    CHECK_INSTANCE(instance);
+    if (pathString == nullptr || path == nullptr) {
+        return XR_ERROR_VALIDATION_FAILURE;
+    }
+    if (!IsValidPathString(pathString)) {
+        return XR_ERROR_PATH_FORMAT_INVALID;
+    }
+    *path = InternPath(rt, pathString);
+    return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL MockPathToString(XrInstance instance, XrPath path, uint32_t bufferCapacityInput,
+                                                uint32_t *bufferCountOutput, char *buffer) {
+    LOCK_RUNTIME();
+    CHECK_INSTANCE(instance);
+    if (!IsPathValid(rt, path)) {
+        return XR_ERROR_PATH_INVALID;
+    }
+    return CopyString(rt.paths[path], bufferCapacityInput, bufferCountOutput, buffer);
+}
+
+//
+// Session
+//
+
+XRAPI_ATTR XrResult XRAPI_CALL MockCreateSession(XrInstance instance, const XrSessionCreateInfo *createInfo, XrSession *session) {
+    LOCK_RUNTIME();
+    CHECK_INSTANCE(instance);
+    if (createInfo == nullptr || session == nullptr || createInfo->type != XR_TYPE_SESSION_CREATE_INFO) {
+        return XR_ERROR_VALIDATION_FAILURE;
+    }
+    if (createInfo->systemId != kMockSystemId) {
+        return XR_ERROR_SYSTEM_INVALID;
+    }
+    for (const auto &object : rt.objects) {
+        if (object.second->type == MockObjectType::Session) {
+            return XR_ERROR_LIMIT_REACHED;
+        }
+    }
+
+    auto newSession = std::make_unique<MockSession>();
+#ifdef XR_USE_GRAPHICS_API_VULKAN
+    if (const auto *binding = reinterpret_cast<const XrGraphicsBindingVulkan2KHR *>(
+            FindNext(createInfo->next, XR_TYPE_GRAPHICS_BINDING_VULKAN2_KHR))) {
+        if (!rt.IsExtensionEnabled(XR_KHR_VULKAN_ENABLE2_EXTENSION_NAME)) {
+            return XR_ERROR_VALIDATION_FAILURE;
+        }
+        if (!rt.vulkanRequirementsQueried) {
+            return XR_ERROR_GRAPHICS_REQUIREMENTS_CALL_MISSING;
+        }
+        if (binding->instance == VK_NULL_HANDLE || binding->instance != rt.vulkanInstance ||
+            binding->physicalDevice == VK_NULL_HANDLE || binding->device == VK_NULL_HANDLE ||
+            rt.vulkanGetInstanceProcAddr == nullptr) {
+            return XR_ERROR_GRAPHICS_DEVICE_INVALID;
+        }
+        newSession->headless = false;
+        newSession->vulkan = {binding->instance, binding->physicalDevice, binding->device, rt.vulkanGetInstanceProcAddr};
+    }
+#endif  // XR_USE_GRAPHICS_API_VULKAN
+    if (newSession->headless && !rt.IsExtensionEnabled(XR_MND_HEADLESS_EXTENSION_NAME)) {
+        return XR_ERROR_GRAPHICS_DEVICE_INVALID;
+    }
+
+    MockSession &sessionRef = *newSession;
+    const uint64_t handle = rt.Add(std::move(newSession));
+    QueueSessionState(rt, handle, sessionRef, XR_SESSION_STATE_IDLE);
+    QueueSessionState(rt, handle, sessionRef, XR_SESSION_STATE_READY);
+    *session = IntToHandle<XrSession>(handle);
+    return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL MockDestroySession(XrSession session) {
+    LOCK_RUNTIME();
+    MockSession *sessionObj = Lookup<MockSession>(rt, session);
+    if (sessionObj == nullptr) {
+        return XR_ERROR_HANDLE_INVALID;
+    }
+    PrintSessionStats(rt, *sessionObj);
+    const uint64_t handle = HandleToInt(session);
+    DestroyChildren(rt, handle);
+    rt.objects.erase(handle);
+    // Drop pending events of the destroyed session.
+    rt.events.erase(std::remove_if(rt.events.begin(), rt.events.end(),
+                                   [session](const XrEventDataBuffer &event) {
+                                       return event.type == XR_TYPE_EVENT_DATA_SESSION_STATE_CHANGED &&
+                                              reinterpret_cast<const XrEventDataSessionStateChanged &>(event).session == session;
+                                   }),
+                    rt.events.end());
+    return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL MockBeginSession(XrSession session, const XrSessionBeginInfo *beginInfo) {
+    LOCK_RUNTIME();
+    MockSession *sessionObj = Lookup<MockSession>(rt, session);
+    if (sessionObj == nullptr) {
+        return XR_ERROR_HANDLE_INVALID;
+    }
+    if (beginInfo == nullptr || beginInfo->type != XR_TYPE_SESSION_BEGIN_INFO) {
+        return XR_ERROR_VALIDATION_FAILURE;
+    }
+    if (sessionObj->running) {
+        return XR_ERROR_SESSION_RUNNING;
+    }
+    if (sessionObj->state != XR_SESSION_STATE_READY) {
+        return XR_ERROR_SESSION_NOT_READY;
+    }
+    if (!sessionObj->headless && beginInfo->primaryViewConfigurationType != XR_VIEW_CONFIGURATION_TYPE_PRIMARY_STEREO) {
+        return XR_ERROR_VIEW_CONFIGURATION_TYPE_UNSUPPORTED;
+    }
+    const uint64_t handle = HandleToInt(session);
+    sessionObj->running = true;
+    QueueSessionState(rt, handle, *sessionObj, XR_SESSION_STATE_SYNCHRONIZED);
+    QueueSessionState(rt, handle, *sessionObj, XR_SESSION_STATE_VISIBLE);
+    QueueSessionState(rt, handle, *sessionObj, XR_SESSION_STATE_FOCUSED);
+    return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL MockEndSession(XrSession session) {
+    LOCK_RUNTIME();
+    MockSession *sessionObj = Lookup<MockSession>(rt, session);
+    if (sessionObj == nullptr) {
+        return XR_ERROR_HANDLE_INVALID;
+    }
+    if (!sessionObj->running) {
+        return XR_ERROR_SESSION_NOT_RUNNING;
+    }
+    if (sessionObj->state != XR_SESSION_STATE_STOPPING) {
+        return XR_ERROR_SESSION_NOT_STOPPING;
+    }
+    const uint64_t handle = HandleToInt(session);
+    sessionObj->running = false;
+    sessionObj->frameInProgress = false;
+    QueueSessionState(rt, handle, *sessionObj, XR_SESSION_STATE_IDLE);
+    if (sessionObj->exitRequested) {
+        QueueSessionState(rt, handle, *sessionObj, XR_SESSION_STATE_EXITING);
+    }
+    return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL MockRequestExitSession(XrSession session) {
+    LOCK_RUNTIME();
+    MockSession *sessionObj = Lookup<MockSession>(rt, session);
+    if (sessionObj == nullptr) {
+        return XR_ERROR_HANDLE_INVALID;
+    }
+    if (!sessionObj->running) {
+        return XR_ERROR_SESSION_NOT_RUNNING;
+    }
+    if (sessionObj->state != XR_SESSION_STATE_STOPPING) {
+        BeginSessionExit(rt, HandleToInt(session), *sessionObj);
+    }
+    return XR_SUCCESS;
+}
+
+//
+// Frame loop
+//
+
+XRAPI_ATTR XrResult XRAPI_CALL MockWaitFrame(XrSession session, const XrFrameWaitInfo *frameWaitInfo, XrFrameState *frameState) {
+    MockSimulateCall(MockTimedCall::xrWaitFrame);
+    MockRuntime &rt = MockRuntime::Get();
+    std::unique_lock<std::mutex> lock(rt.mutex);
+    MockSession *sessionObj = Lookup<MockSession>(rt, session);
+    if (sessionObj == nullptr) {
+        return XR_ERROR_HANDLE_INVALID;
+    }
+    if ((frameWaitInfo != nullptr && frameWaitInfo->type != XR_TYPE_FRAME_WAIT_INFO) || frameState == nullptr ||
+        frameState->type != XR_TYPE_FRAME_STATE) {
+        return XR_ERROR_VALIDATION_FAILURE;
+    }
+    if (!sessionObj->running) {
+        return XR_ERROR_SESSION_NOT_RUNNING;
+    }
+
+    const int64_t period = DisplayPeriod(rt);
+    XrTime displayTime = 0;
+    if (rt.config.clock == MockRuntimeConfig::ClockMode::Virtual) {
+        rt.virtualTime += period;
+        rt.virtualTimeWall = SteadyClock::now();
+        displayTime = rt.virtualTime + period;
+    } else {
+        // Block until the next vsync of the display period, without holding the runtime lock.
+        const XrTime now = Now(rt);
+        const XrTime vsync = kTimeOrigin + ((now - kTimeOrigin) / period + 1) * period;
+        const SteadyClock::time_point wakeUp = XrTimeToSteady(rt, vsync);
+        lock.unlock();
+        std::this_thread::sleep_until(wakeUp);
+        lock.lock();
+        sessionObj = Lookup<MockSession>(rt, session);
+        if (sessionObj == nullptr) {
+            return XR_ERROR_HANDLE_INVALID;
+        }
+        displayTime = vsync + period;
+    }
+    ++sessionObj->framesWaited;
+    frameState->predictedDisplayTime = displayTime;
+    frameState->predictedDisplayPeriod = period;
+    frameState->shouldRender =
+        (sessionObj->state == XR_SESSION_STATE_VISIBLE || sessionObj->state == XR_SESSION_STATE_FOCUSED) ? XR_TRUE : XR_FALSE;
+    return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL MockBeginFrame(XrSession session, const XrFrameBeginInfo *frameBeginInfo) {
+    MockSimulateCall(MockTimedCall::xrBeginFrame);
+    LOCK_RUNTIME();
+    MockSession *sessionObj = Lookup<MockSession>(rt, session);
+    if (sessionObj == nullptr) {
+        return XR_ERROR_HANDLE_INVALID;
+    }
+    if (frameBeginInfo != nullptr && frameBeginInfo->type != XR_TYPE_FRAME_BEGIN_INFO) {
+        return XR_ERROR_VALIDATION_FAILURE;
+    }
+    if (!sessionObj->running) {
+        return XR_ERROR_SESSION_NOT_RUNNING;
+    }
+    if (sessionObj->framesBegun >= sessionObj->framesWaited) {
+        return XR_ERROR_CALL_ORDER_INVALID;
+    }
+    ++sessionObj->framesBegun;
+    if (sessionObj->frameInProgress) {
+        ++sessionObj->framesDiscarded;
+        return XR_FRAME_DISCARDED;
+    }
+    sessionObj->frameInProgress = true;
+    return XR_SUCCESS;
+}
+
+XrResult ValidateLayer(MockRuntime &rt, const XrCompositionLayerBaseHeader *layer) {
+    if (layer == nullptr) {
+        return XR_ERROR_LAYER_INVALID;
+    }
+    const auto isReleased = [&rt](XrSwapchain swapchain) {
+        const MockSwapchain *swapchainObj = Lookup<MockSwapchain>(rt, swapchain);
+        return swapchainObj != nullptr && swapchainObj->everReleased;
+    };
+    switch (layer->type) {
+        case XR_TYPE_COMPOSITION_LAYER_PROJECTION: {
+            const auto *projection = reinterpret_cast<const XrCompositionLayerProjection *>(layer);
+            if (Lookup<MockSpace>(rt, projection->space) == nullptr) {
+                return XR_ERROR_HANDLE_INVALID;
+            }
+            if (projection->viewCount != kViewCount || projection->views == nullptr) {
+                return XR_ERROR_VALIDATION_FAILURE;
+            }
+            for (uint32_t i = 0; i < projection->viewCount; ++i) {
+                if (!isReleased(projection->views[i].subImage.swapchain)) {
+                    return XR_ERROR_LAYER_INVALID;
+                }
+            }
+            return XR_SUCCESS;
+        }
+        case XR_TYPE_COMPOSITION_LAYER_QUAD: {
+            const auto *quad = reinterpret_cast<const XrCompositionLayerQuad *>(layer);
+            return isReleased(quad->subImage.swapchain) ? XR_SUCCESS : XR_ERROR_LAYER_INVALID;
+        }
+        default:
+            // Other layer types come from extensions this runtime does not enable, e.g. passthrough.
+            return XR_ERROR_LAYER_INVALID;
+    }
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL MockEndFrame(XrSession session, const XrFrameEndInfo *frameEndInfo) {
+    MockSimulateCall(MockTimedCall::xrEndFrame);
+    LOCK_RUNTIME();
+    MockSession *sessionObj = Lookup<MockSession>(rt, session);
+    if (sessionObj == nullptr) {
+        return XR_ERROR_HANDLE_INVALID;
+    }
+    if (frameEndInfo == nullptr || frameEndInfo->type != XR_TYPE_FRAME_END_INFO) {
+        return XR_ERROR_VALIDATION_FAILURE;
+    }
+    if (!sessionObj->running) {
+        return XR_ERROR_SESSION_NOT_RUNNING;
+    }
+    if (!sessionObj->frameInProgress) {
+        return XR_ERROR_CALL_ORDER_INVALID;
+    }
+    if (frameEndInfo->displayTime <= 0) {
+        return XR_ERROR_TIME_INVALID;
+    }
+    if (frameEndInfo->environmentBlendMode != XR_ENVIRONMENT_BLEND_MODE_OPAQUE) {
+        return XR_ERROR_ENVIRONMENT_BLEND_MODE_UNSUPPORTED;
+    }
+    if (frameEndInfo->layerCount > kMaxLayerCount) {
+        return XR_ERROR_LAYER_LIMIT_EXCEEDED;
+    }
+    if (frameEndInfo->layerCount != 0 && frameEndInfo->layers == nullptr) {
+        return XR_ERROR_VALIDATION_FAILURE;
+    }
+    for (uint32_t i = 0; i < frameEndInfo->layerCount; ++i) {
+        const XrResult result = ValidateLayer(rt, frameEndInfo->layers[i]);
+        if (XR_FAILED(result)) {
+            return result;
+        }
+    }
+    sessionObj->frameInProgress = false;
+    ++sessionObj->framesEnded;
+    if (rt.config.exitAfterFrames != 0 && sessionObj->framesEnded == rt.config.exitAfterFrames && !sessionObj->exitRequested) {
+        BeginSessionExit(rt, HandleToInt(session), *sessionObj);
+    }
+    return XR_SUCCESS;
+}
+
+//
+// Spaces
+//
+
+XRAPI_ATTR XrResult XRAPI_CALL MockEnumerateReferenceSpaces(XrSession session, uint32_t spaceCapacityInput,
+                                                            uint32_t *spaceCountOutput, XrReferenceSpaceType *spaces) {
+    LOCK_RUNTIME();
+    if (Lookup<MockSession>(rt, session) == nullptr) {
+        return XR_ERROR_HANDLE_INVALID;
+    }
+    static const XrReferenceSpaceType kSpaces[] = {XR_REFERENCE_SPACE_TYPE_VIEW, XR_REFERENCE_SPACE_TYPE_LOCAL,
+                                                   XR_REFERENCE_SPACE_TYPE_STAGE};
+    return FillTwoCall(spaceCapacityInput, spaceCountOutput, spaces, 3, [&](uint32_t i) { spaces[i] = kSpaces[i]; });
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL MockCreateReferenceSpace(XrSession session, const XrReferenceSpaceCreateInfo *createInfo,
+                                                        XrSpace *space) {
+    LOCK_RUNTIME();
+    if (Lookup<MockSession>(rt, session) == nullptr) {
+        return XR_ERROR_HANDLE_INVALID;
+    }
+    if (createInfo == nullptr || space == nullptr || createInfo->type != XR_TYPE_REFERENCE_SPACE_CREATE_INFO) {
+        return XR_ERROR_VALIDATION_FAILURE;
+    }
+    switch (createInfo->referenceSpaceType) {
+        case XR_REFERENCE_SPACE_TYPE_VIEW:
+        case XR_REFERENCE_SPACE_TYPE_LOCAL:
+        case XR_REFERENCE_SPACE_TYPE_STAGE:
+            break;
+        default:
+            return XR_ERROR_REFERENCE_SPACE_UNSUPPORTED;
+    }
+    if (!IsPoseValid(createInfo->poseInReferenceSpace)) {
+        return XR_ERROR_POSE_INVALID;
+    }
+    auto newSpace = std::make_unique<MockSpace>();
+    newSpace->parent = HandleToInt(session);
+    newSpace->referenceSpaceType = createInfo->referenceSpaceType;
+    newSpace->poseInParent = createInfo->poseInReferenceSpace;
+    *space = IntToHandle<XrSpace>(rt.Add(std::move(newSpace)));
+    return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL MockGetReferenceSpaceBoundsRect(XrSession session, XrReferenceSpaceType referenceSpaceType,
+                                                               XrExtent2Df *bounds) {
+    LOCK_RUNTIME();
+    if (Lookup<MockSession>(rt, session) == nullptr) {
+        return XR_ERROR_HANDLE_INVALID;
+    }
+    if (bounds == nullptr) {
+        return XR_ERROR_VALIDATION_FAILURE;
+    }
+    switch (referenceSpaceType) {
+        case XR_REFERENCE_SPACE_TYPE_STAGE:
+            *bounds = {2.0f, 2.0f};
+            return XR_SUCCESS;
+        case XR_REFERENCE_SPACE_TYPE_VIEW:
+        case XR_REFERENCE_SPACE_TYPE_LOCAL:
+            *bounds = {0.0f, 0.0f};
+            return XR_SPACE_BOUNDS_UNAVAILABLE;
+        default:
+            return XR_ERROR_REFERENCE_SPACE_UNSUPPORTED;
+    }
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL MockCreateActionSpace(XrSession session, const XrActionSpaceCreateInfo *createInfo, XrSpace *space) {
+    LOCK_RUNTIME();
+    if (Lookup<MockSession>(rt, session) == nullptr) {
+        return XR_ERROR_HANDLE_INVALID;
+    }
+    if (createInfo == nullptr || space == nullptr || createInfo->type != XR_TYPE_ACTION_SPACE_CREATE_INFO) {
+        return XR_ERROR_VALIDATION_FAILURE;
+    }
+    const MockAction *action = Lookup<MockAction>(rt, createInfo->action);
+    if (action == nullptr) {
+        return XR_ERROR_HANDLE_INVALID;
+    }
+    if (action->actionType != XR_ACTION_TYPE_POSE_INPUT) {
+        return XR_ERROR_ACTION_TYPE_MISMATCH;
+    }
+    if (createInfo->subactionPath != XR_NULL_PATH &&
+        std::find(action->subactionPaths.begin(), action->subactionPaths.end(), createInfo->subactionPath) ==
+            action->subactionPaths.end()) {
+        return XR_ERROR_PATH_UNSUPPORTED;
+    }
+    if (!IsPoseValid(createInfo->poseInActionSpace)) {
+        return XR_ERROR_POSE_INVALID;
+    }
+    auto newSpace = std::make_unique<MockSpace>();
+    newSpace->parent = HandleToInt(session);
+    newSpace->action = HandleToInt(createInfo->action);
+    newSpace->subactionPath = createInfo->subactionPath;
+    newSpace->poseInParent = createInfo->poseInActionSpace;
+    *space = IntToHandle<XrSpace>(rt.Add(std::move(newSpace)));
+    return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL MockLocateSpace(XrSpace space, XrSpace baseSpace, XrTime time, XrSpaceLocation *location) {
+    MockSimulateCall(MockTimedCall::xrLocateSpace);
+    LOCK_RUNTIME();
+    const MockSpace *spaceObj = Lookup<MockSpace>(rt, space);
+    const MockSpace *baseObj = Lookup<MockSpace>(rt, baseSpace);
+    if (spaceObj == nullptr || baseObj == nullptr) {
+        return XR_ERROR_HANDLE_INVALID;
+    }
+    if (location == nullptr || location->type != XR_TYPE_SPACE_LOCATION) {
+        return XR_ERROR_VALIDATION_FAILURE;
+    }
+    if (time <= 0) {
+        return XR_ERROR_TIME_INVALID;
+    }
+    const auto relate = [&](XrTime t) {
+        const SpaceLocation a = LocateInWorld(rt, *spaceObj, t);
+        const SpaceLocation b = LocateInWorld(rt, *baseObj, t);
+        return SpaceLocation{PoseMultiply(PoseInverse(b.pose), a.pose), a.tracked && b.tracked};
+    };
+    const SpaceLocation relation = relate(time);
+    if (!relation.tracked) {
+        location->locationFlags = 0;
+        location->pose = PoseIdentity();
+    } else {
+        location->locationFlags = XR_SPACE_LOCATION_ORIENTATION_VALID_BIT | XR_SPACE_LOCATION_POSITION_VALID_BIT |
+                                  XR_SPACE_LOCATION_ORIENTATION_TRACKED_BIT | XR_SPACE_LOCATION_POSITION_TRACKED_BIT;
+        location->pose = relation.pose;
+    }
+    if (auto *velocity = reinterpret_cast<XrSpaceVelocity *>(FindNextOut(location->next, XR_TYPE_SPACE_VELOCITY))) {
+        velocity->velocityFlags = 0;
+        velocity->linearVelocity = {0.0f, 0.0f, 0.0f};
+        velocity->angularVelocity = {0.0f, 0.0f, 0.0f};
+        if (relation.tracked) {
+            // Central difference of the scripted motion.
+            constexpr XrTime kDelta = 1000000;
+            constexpr float kDeltaSeconds = 2.0f * static_cast<float>(kDelta) * 1e-9f;
+            const XrPosef before = relate(time - kDelta).pose;
+            const XrPosef after = relate(time + kDelta).pose;
+            velocity->linearVelocity = {(after.position.x - before.position.x) / kDeltaSeconds,
+                                        (after.position.y - before.position.y) / kDeltaSeconds,
+                                        (after.position.z - before.position.z) / kDeltaSeconds};
+            velocity->angularVelocity = AngularVelocity(before.orientation, after.orientation, kDeltaSeconds);
+            velocity->velocityFlags = XR_SPACE_VELOCITY_LINEAR_VALID_BIT | XR_SPACE_VELOCITY_ANGULAR_VALID_BIT;
+        }
+    }
+    return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL MockDestroySpace(XrSpace space) {
+    LOCK_RUNTIME();
+    if (Lookup<MockSpace>(rt, space) == nullptr) {
+        return XR_ERROR_HANDLE_INVALID;
+    }
+    rt.objects.erase(HandleToInt(space));
+    return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL MockLocateViews(XrSession session, const XrViewLocateInfo *viewLocateInfo, XrViewState *viewState,
+                                               uint32_t viewCapacityInput, uint32_t *viewCountOutput, XrView *views) {
+    MockSimulateCall(MockTimedCall::xrLocateViews);
+    LOCK_RUNTIME();
+    if (Lookup<MockSession>(rt, session) == nullptr) {
+        return XR_ERROR_HANDLE_INVALID;
+    }
+    if (viewLocateInfo == nullptr || viewState == nullptr || viewLocateInfo->type != XR_TYPE_VIEW_LOCATE_INFO ||
+        viewState->type != XR_TYPE_VIEW_STATE) {
+        return XR_ERROR_VALIDATION_FAILURE;
+    }
+    const MockSpace *spaceObj = Lookup<MockSpace>(rt, viewLocateInfo->space);
+    if (spaceObj == nullptr) {
+        return XR_ERROR_HANDLE_INVALID;
+    }
+    if (viewLocateInfo->viewConfigurationType != XR_VIEW_CONFIGURATION_TYPE_PRIMARY_STEREO) {
+        return XR_ERROR_VIEW_CONFIGURATION_TYPE_UNSUPPORTED;
+    }
+    if (viewLocateInfo->displayTime <= 0) {
+        return XR_ERROR_TIME_INVALID;
+    }
+    for (uint32_t i = 0; views != nullptr && i < viewCapacityInput; ++i) {
+        if (views[i].type != XR_TYPE_VIEW) {
+            return XR_ERROR_VALIDATION_FAILURE;
+        }
+    }
+    const XrTime time = viewLocateInfo->displayTime;
+    const SpaceLocation base = LocateInWorld(rt, *spaceObj, time);
+    const XrPosef headInBase = PoseMultiply(PoseInverse(base.pose), HeadPose(rt, time));
+    const XrFovf &leftFov = rt.config.leftEyeFov;
+    const XrResult result = FillTwoCall(viewCapacityInput, viewCountOutput, views, kViewCount, [&](uint32_t i) {
+        const float side = i == 0 ? -1.0f : 1.0f;
+        const XrPosef eyeInHead{{0.0f, 0.0f, 0.0f, 1.0f}, {side * rt.config.ipd * 0.5f, 0.0f, 0.0f}};
+        views[i].pose = PoseMultiply(headInBase, eyeInHead);
+        views[i].fov = i == 0 ? leftFov : XrFovf{-leftFov.angleRight, -leftFov.angleLeft, leftFov.angleUp, leftFov.angleDown};
+    });
+    viewState->viewStateFlags = base.tracked ? (XR_VIEW_STATE_ORIENTATION_VALID_BIT | XR_VIEW_STATE_POSITION_VALID_BIT |
+                                                XR_VIEW_STATE_ORIENTATION_TRACKED_BIT | XR_VIEW_STATE_POSITION_TRACKED_BIT)
+                                             : 0;
+    return result;
+}
+
+//
+// Actions
+//
+
+XRAPI_ATTR XrResult XRAPI_CALL MockCreateActionSet(XrInstance instance, const XrActionSetCreateInfo *createInfo,
+                                                   XrActionSet *actionSet) {
+    LOCK_RUNTIME();
+    CHECK_INSTANCE(instance);
+    if (createInfo == nullptr || actionSet == nullptr || createInfo->type != XR_TYPE_ACTION_SET_CREATE_INFO) {
+        return XR_ERROR_VALIDATION_FAILURE;
+    }
+    for (const auto &object : rt.objects) {
+        if (object.second->type == MockObjectType::ActionSet &&
+            static_cast<const MockActionSet &>(*object.second).name == createInfo->actionSetName) {
+            return XR_ERROR_NAME_DUPLICATED;
+        }
+    }
+    auto newSet = std::make_unique<MockActionSet>();
+    newSet->name = createInfo->actionSetName;
+    *actionSet = IntToHandle<XrActionSet>(rt.Add(std::move(newSet)));
+    return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL MockDestroyActionSet(XrActionSet actionSet) {
+    LOCK_RUNTIME();
+    if (Lookup<MockActionSet>(rt, actionSet) == nullptr) {
+        return XR_ERROR_HANDLE_INVALID;
+    }
+    const uint64_t handle = HandleToInt(actionSet);
+    DestroyChildren(rt, handle);
+    rt.objects.erase(handle);
+    return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL MockCreateAction(XrActionSet actionSet, const XrActionCreateInfo *createInfo, XrAction *action) {
+    LOCK_RUNTIME();
+    const MockActionSet *setObj = Lookup<MockActionSet>(rt, actionSet);
+    if (setObj == nullptr) {
+        return XR_ERROR_HANDLE_INVALID;
+    }
+    if (createInfo == nullptr || action == nullptr || createInfo->type != XR_TYPE_ACTION_CREATE_INFO ||
+        (createInfo->countSubactionPaths != 0 && createInfo->subactionPaths == nullptr)) {
+        return XR_ERROR_VALIDATION_FAILURE;
+    }
+    if (setObj->attached) {
+        return XR_ERROR_ACTIONSETS_ALREADY_ATTACHED;
+    }
+    const uint64_t setHandle = HandleToInt(actionSet);
+    for (const auto &object : rt.objects) {
+        if (object.second->type == MockObjectType::Action && object.second->parent == setHandle &&
+            static_cast<const MockAction &>(*object.second).name == createInfo->actionName) {
+            return XR_ERROR_NAME_DUPLICATED;
+        }
+    }
+    auto newAction = std::make_unique<MockAction>();
+    newAction->parent = setHandle;
+    newAction->name = createInfo->actionName;
+    newAction->actionType = createInfo->actionType;
+    for (uint32_t i = 0; i < createInfo->countSubactionPaths; ++i) {
+        if (!IsPathValid(rt, createInfo->subactionPaths[i])) {
+            return XR_ERROR_PATH_INVALID;
+        }
+        newAction->subactionPaths.push_back(createInfo->subactionPaths[i]);
+    }
+    *action = IntToHandle<XrAction>(rt.Add(std::move(newAction)));
+    return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL MockDestroyAction(XrAction action) {
+    LOCK_RUNTIME();
+    if (Lookup<MockAction>(rt, action) == nullptr) {
+        return XR_ERROR_HANDLE_INVALID;
+    }
+    rt.objects.erase(HandleToInt(action));
+    return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL MockSuggestInteractionProfileBindings(XrInstance instance,
+                                                                     const XrInteractionProfileSuggestedBinding *suggestedBindings) {
+    LOCK_RUNTIME();
+    CHECK_INSTANCE(instance);
+    if (suggestedBindings == nullptr || suggestedBindings->type != XR_TYPE_INTERACTION_PROFILE_SUGGESTED_BINDING ||
+        suggestedBindings->countSuggestedBindings == 0 || suggestedBindings->suggestedBindings == nullptr) {
+        return XR_ERROR_VALIDATION_FAILURE;
+    }
+    if (!IsPathValid(rt, suggestedBindings->interactionProfile)) {
+        return XR_ERROR_PATH_INVALID;
+    }
+    std::vector<std::pair<uint64_t, XrPath>> bindings;
+    for (uint32_t i = 0; i < suggestedBindings->countSuggestedBindings; ++i) {
+        const XrActionSuggestedBinding &binding = suggestedBindings->suggestedBindings[i];
+        const MockAction *action = Lookup<MockAction>(rt, binding.action);
+        if (action == nullptr) {
+            return XR_ERROR_HANDLE_INVALID;
+        }
+        const MockActionSet *set = rt.Find<MockActionSet>(action->parent, MockObjectType::ActionSet);
+        if (set != nullptr && set->attached) {
+            return XR_ERROR_ACTIONSETS_ALREADY_ATTACHED;
+        }
+        if (!IsPathValid(rt, binding.binding)) {
+            return XR_ERROR_PATH_INVALID;
+        }
+        bindings.emplace_back(HandleToInt(binding.action), binding.binding);
+    }
+    rt.suggestedBindings[suggestedBindings->interactionProfile] = std::move(bindings);
+    return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL MockAttachSessionActionSets(XrSession session, const XrSessionActionSetsAttachInfo *attachInfo) {
+    LOCK_RUNTIME();
+    MockSession *sessionObj = Lookup<MockSession>(rt, session);
+    if (sessionObj == nullptr) {
+        return XR_ERROR_HANDLE_INVALID;
+    }
+    if (attachInfo == nullptr || attachInfo->type != XR_TYPE_SESSION_ACTION_SETS_ATTACH_INFO ||
+        attachInfo->countActionSets == 0 || attachInfo->actionSets == nullptr) {
+        return XR_ERROR_VALIDATION_FAILURE;
+    }
+    if (sessionObj->actionSetsAttached) {
+        return XR_ERROR_ACTIONSETS_ALREADY_ATTACHED;
+    }
+    std::set<uint64_t> sets;
+    for (uint32_t i = 0; i < attachInfo->countActionSets; ++i) {
+        if (Lookup<MockActionSet>(rt, attachInfo->actionSets[i]) == nullptr) {
+            return XR_ERROR_HANDLE_INVALID;
+        }
+        sets.insert(HandleToInt(attachInfo->actionSets[i]));
+    }
+    for (const uint64_t set : sets) {
+        rt.Find<MockActionSet>(set, MockObjectType::ActionSet)->attached = true;
+    }
+    sessionObj->actionSetsAttached = true;
+
+    // The configured interaction profile becomes current if the application suggested bindings for it.
+    const auto profileIt = rt.pathIds.find(rt.config.interactionProfile);
+    const auto bindingsIt = profileIt == rt.pathIds.end() ? rt.suggestedBindings.end() : rt.suggestedBindings.find(profileIt->second);
+    if (bindingsIt == rt.suggestedBindings.end()) {
+        return XR_SUCCESS;
+    }
+    sessionObj->interactionProfile = bindingsIt->first;
+    for (const auto &binding : bindingsIt->second) {
+        const MockAction *action = rt.Find<MockAction>(binding.first, MockObjectType::Action);
+        if (action == nullptr || sets.count(action->parent) == 0) {
+            continue;
+        }
+        sessionObj->boundActions.emplace(binding.first, InternPath(rt, TopLevelUserPath(rt.paths[binding.second])));
+    }
+    XrEventDataBuffer buffer{XR_TYPE_EVENT_DATA_BUFFER};
+    auto &event = *reinterpret_cast<XrEventDataInteractionProfileChanged *>(&buffer);
+    event = {XR_TYPE_EVENT_DATA_INTERACTION_PROFILE_CHANGED};
+    event.session = session;
+    rt.events.push_back(buffer);
+    return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL MockGetCurrentInteractionProfile(XrSession session, XrPath topLevelUserPath,
+                                                                XrInteractionProfileState *interactionProfile) {
+    LOCK_RUNTIME();
+    const MockSession *sessionObj = Lookup<MockSession>(rt, session);
+    if (sessionObj == nullptr) {
+        return XR_ERROR_HANDLE_INVALID;
+    }
+    if (interactionProfile == nullptr || interactionProfile->type != XR_TYPE_INTERACTION_PROFILE_STATE) {
+        return XR_ERROR_VALIDATION_FAILURE;
+    }
+    if (!IsPathValid(rt, topLevelUserPath)) {
+        return XR_ERROR_PATH_INVALID;
+    }
+    if (!sessionObj->actionSetsAttached) {
+        return XR_ERROR_ACTIONSET_NOT_ATTACHED;
+    }
+    const std::string &userPath = rt.paths[topLevelUserPath];
+    const bool isHand = userPath == kLeftHandPath || userPath == kRightHandPath;
+    interactionProfile->interactionProfile = isHand ? sessionObj->interactionProfile : XR_NULL_PATH;
+    return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL MockSyncActions(XrSession session, const XrActionsSyncInfo *syncInfo) {
+    MockSimulateCall(MockTimedCall::xrSyncActions);
+    LOCK_RUNTIME();
+    MockSession *sessionObj = Lookup<MockSession>(rt, session);
+    if (sessionObj == nullptr) {
+        return XR_ERROR_HANDLE_INVALID;
+    }
+    if (syncInfo == nullptr || syncInfo->type != XR_TYPE_ACTIONS_SYNC_INFO ||
+        (syncInfo->countActiveActionSets != 0 && syncInfo->activeActionSets == nullptr)) {
+        return XR_ERROR_VALIDATION_FAILURE;
+    }
+    for (uint32_t i = 0; i < syncInfo->countActiveActionSets; ++i) {
+        const MockActionSet *set = Lookup<MockActionSet>(rt, syncInfo->activeActionSets[i].actionSet);
+        if (set == nullptr) {
+            return XR_ERROR_HANDLE_INVALID;
+        }
+        if (!set->attached) {
+            return XR_ERROR_ACTIONSET_NOT_ATTACHED;
+        }
+    }
+    sessionObj->actionsSynced = sessionObj->state == XR_SESSION_STATE_FOCUSED;
+    return sessionObj->actionsSynced ? XR_SUCCESS : XR_SESSION_NOT_FOCUSED;
+}
+
+/// Shared validation of the xrGetActionState* calls, returns the action's activity in *isActive.
+XrResult GetActionState(MockRuntime &rt, XrSession session, const XrActionStateGetInfo *getInfo, XrActionType expectedType,
+                        XrBool32 *isActive) {
+    const MockSession *sessionObj = Lookup<MockSession>(rt, session);
+    if (sessionObj == nullptr) {
+        return XR_ERROR_HANDLE_INVALID;
+    }
+    if (getInfo == nullptr || getInfo->type != XR_TYPE_ACTION_STATE_GET_INFO) {
+        return XR_ERROR_VALIDATION_FAILURE;
+    }
+    const MockAction *action = Lookup<MockAction>(rt, getInfo->action);
+    if (action == nullptr) {
+        return XR_ERROR_HANDLE_INVALID;
+    }
+    const MockActionSet *set = rt.Find<MockActionSet>(action->parent, MockObjectType::ActionSet);
+    if (set == nullptr || !set->attached) {
+        return XR_ERROR_ACTIONSET_NOT_ATTACHED;
+    }
+    if (action->actionType != expectedType) {
+        return XR_ERROR_ACTION_TYPE_MISMATCH;
+    }
+    if (getInfo->subactionPath != XR_NULL_PATH &&
+        std::find(action->subactionPaths.begin(), action->subactionPaths.end(), getInfo->subactionPath) ==
+            action->subactionPaths.end()) {
+        return XR_ERROR_PATH_UNSUPPORTED;
+    }
+    *isActive = sessionObj->actionsSynced && sessionObj->state == XR_SESSION_STATE_FOCUSED &&
+                        IsActionBound(*sessionObj, HandleToInt(getInfo->action), getInfo->subactionPath)
+                    ? XR_TRUE
+                    : XR_FALSE;
+    return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL MockGetActionStateBoolean(XrSession session, const XrActionStateGetInfo *getInfo,
+                                                         XrActionStateBoolean *state) {
+    MockSimulateCall(MockTimedCall::xrGetActionStateBoolean);
+    LOCK_RUNTIME();
+    if (state == nullptr || state->type != XR_TYPE_ACTION_STATE_BOOLEAN) {
+        return XR_ERROR_VALIDATION_FAILURE;
+    }
+    XrBool32 isActive = XR_FALSE;
+    const XrResult result = GetActionState(rt, session, getInfo, XR_ACTION_TYPE_BOOLEAN_INPUT, &isActive);
+    if (XR_SUCCEEDED(result)) {
+        state->currentState = XR_FALSE;
+        state->changedSinceLastSync = XR_FALSE;
+        state->lastChangeTime = 0;
+        state->isActive = isActive;
+    }
+    return result;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL MockGetActionStateFloat(XrSession session, const XrActionStateGetInfo *getInfo,
+                                                       XrActionStateFloat *state) {
+    MockSimulateCall(MockTimedCall::xrGetActionStateFloat);
+    LOCK_RUNTIME();
+    if (state == nullptr || state->type != XR_TYPE_ACTION_STATE_FLOAT) {
+        return XR_ERROR_VALIDATION_FAILURE;
+    }
+    XrBool32 isActive = XR_FALSE;
+    const XrResult result = GetActionState(rt, session, getInfo, XR_ACTION_TYPE_FLOAT_INPUT, &isActive);
+    if (XR_SUCCEEDED(result)) {
+        state->currentState = 0.0f;
+        state->changedSinceLastSync = XR_FALSE;
+        state->lastChangeTime = 0;
+        state->isActive = isActive;
+    }
+    return result;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL MockGetActionStateVector2f(XrSession session, const XrActionStateGetInfo *getInfo,
+                                                          XrActionStateVector2f *state) {
+    MockSimulateCall(MockTimedCall::xrGetActionStateVector2f);
+    LOCK_RUNTIME();
+    if (state == nullptr || state->type != XR_TYPE_ACTION_STATE_VECTOR2F) {
+        return XR_ERROR_VALIDATION_FAILURE;
+    }
+    XrBool32 isActive = XR_FALSE;
+    const XrResult result = GetActionState(rt, session, getInfo, XR_ACTION_TYPE_VECTOR2F_INPUT, &isActive);
+    if (XR_SUCCEEDED(result)) {
+        state->currentState = {0.0f, 0.0f};
+        state->changedSinceLastSync = XR_FALSE;
+        state->lastChangeTime = 0;
+        state->isActive = isActive;
+    }
+    return result;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL MockGetActionStatePose(XrSession session, const XrActionStateGetInfo *getInfo,
+                                                      XrActionStatePose *state) {
+    MockSimulateCall(MockTimedCall::xrGetActionStatePose);
+    LOCK_RUNTIME();
+    if (state == nullptr || state->type != XR_TYPE_ACTION_STATE_POSE) {
+        return XR_ERROR_VALIDATION_FAILURE;
+    }
+    XrBool32 isActive = XR_FALSE;
+    const XrResult result = GetActionState(rt, session, getInfo, XR_ACTION_TYPE_POSE_INPUT, &isActive);
+    if (XR_SUCCEEDED(result)) {
+        state->isActive = isActive;
+    }
+    return result;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL MockEnumerateBoundSourcesForAction(XrSession session,
+                                                                  const XrBoundSourcesForActionEnumerateInfo *enumerateInfo,
+                                                                  uint32_t sourceCapacityInput, uint32_t *sourceCountOutput,
+                                                                  XrPath *sources) {
+    LOCK_RUNTIME();
+    const MockSession *sessionObj = Lookup<MockSession>(rt, session);
+    if (sessionObj == nullptr) {
+        return XR_ERROR_HANDLE_INVALID;
+    }
+    if (enumerateInfo == nullptr || enumerateInfo->type != XR_TYPE_BOUND_SOURCES_FOR_ACTION_ENUMERATE_INFO) {
+        return XR_ERROR_VALIDATION_FAILURE;
+    }
+    if (Lookup<MockAction>(rt, enumerateInfo->action) == nullptr) {
+        return XR_ERROR_HANDLE_INVALID;
+    }
+    std::vector<XrPath> bound;
+    const auto it = rt.suggestedBindings.find(sessionObj->interactionProfile);
+    if (it != rt.suggestedBindings.end()) {
+        for (const auto &binding : it->second) {
+            if (binding.first == HandleToInt(enumerateInfo->action)) {
+                bound.push_back(binding.second);
+            }
+        }
+    }
+    return FillTwoCall(sourceCapacityInput, sourceCountOutput, sources, static_cast<uint32_t>(bound.size()),
+                       [&](uint32_t i) { sources[i] = bound[i]; });
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL MockGetInputSourceLocalizedName(XrSession session, const XrInputSourceLocalizedNameGetInfo *getInfo,
+                                                               uint32_t bufferCapacityInput, uint32_t *bufferCountOutput,
+                                                               char *buffer) {
+    LOCK_RUNTIME();
+    if (Lookup<MockSession>(rt, session) == nullptr) {
+        return XR_ERROR_HANDLE_INVALID;
+    }
+    if (getInfo == nullptr || getInfo->type != XR_TYPE_INPUT_SOURCE_LOCALIZED_NAME_GET_INFO) {
+        return XR_ERROR_VALIDATION_FAILURE;
+    }
+    if (!IsPathValid(rt, getInfo->sourcePath)) {
+        return XR_ERROR_PATH_INVALID;
+    }
+    return CopyString(rt.paths[getInfo->sourcePath], bufferCapacityInput, bufferCountOutput, buffer);
+}
+
+/// Shared validation of the haptic calls, nothing is played back.
+XrResult ValidateHapticAction(MockRuntime &rt, XrSession session, const XrHapticActionInfo *hapticActionInfo) {
+    if (Lookup<MockSession>(rt, session) == nullptr) {
+        return XR_ERROR_HANDLE_INVALID;
+    }
+    if (hapticActionInfo == nullptr || hapticActionInfo->type != XR_TYPE_HAPTIC_ACTION_INFO) {
+        return XR_ERROR_VALIDATION_FAILURE;
+    }
+    const MockAction *action = Lookup<MockAction>(rt, hapticActionInfo->action);
+    if (action == nullptr) {
+        return XR_ERROR_HANDLE_INVALID;
+    }
+    return action->actionType == XR_ACTION_TYPE_VIBRATION_OUTPUT ? XR_SUCCESS : XR_ERROR_ACTION_TYPE_MISMATCH;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL MockApplyHapticFeedback(XrSession session, const XrHapticActionInfo *hapticActionInfo,
+                                                       const XrHapticBaseHeader *hapticFeedback) {
+    LOCK_RUNTIME();
+    if (hapticFeedback == nullptr) {
+        return XR_ERROR_VALIDATION_FAILURE;
+    }
+    return ValidateHapticAction(rt, session, hapticActionInfo);
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL MockStopHapticFeedback(XrSession session, const XrHapticActionInfo *hapticActionInfo) {
+    LOCK_RUNTIME();
+    return ValidateHapticAction(rt, session, hapticActionInfo);
+}
+
+//
+// Swapchains
+//
+
+XRAPI_ATTR XrResult XRAPI_CALL MockEnumerateSwapchainFormats(XrSession session, uint32_t formatCapacityInput,
+                                                             uint32_t *formatCountOutput, int64_t *formats) {
+    LOCK_RUNTIME();
+    const MockSession *sessionObj = Lookup<MockSession>(rt, session);
+    if (sessionObj == nullptr) {
+        return XR_ERROR_HANDLE_INVALID;
+    }
+    static const std::vector<int64_t> kNoFormats;
+#ifdef XR_USE_GRAPHICS_API_VULKAN
+    const std::vector<int64_t> &supported = sessionObj->headless ? kNoFormats : MockVulkanSwapchainFormats();
+#else
+    const std::vector<int64_t> &supported = kNoFormats;
+#endif  // XR_USE_GRAPHICS_API_VULKAN
+    return FillTwoCall(formatCapacityInput, formatCountOutput, formats, static_cast<uint32_t>(supported.size()),
+                       [&](uint32_t i) { formats[i] = supported[i]; });
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL MockCreateSwapchain(XrSession session, const XrSwapchainCreateInfo *createInfo,
+                                                   XrSwapchain *swapchain) {
+    LOCK_RUNTIME();
+    const MockSession *sessionObj = Lookup<MockSession>(rt, session);
+    if (sessionObj == nullptr) {
+        return XR_ERROR_HANDLE_INVALID;
+    }
+    if (createInfo == nullptr || swapchain == nullptr || createInfo->type != XR_TYPE_SWAPCHAIN_CREATE_INFO ||
+        createInfo->width == 0 || createInfo->height == 0 || createInfo->arraySize == 0 || createInfo->mipCount == 0) {
+        return XR_ERROR_VALIDATION_FAILURE;
+    }
+    if (createInfo->width > kMaxSwapchainImageSize || createInfo->height > kMaxSwapchainImageSize) {
+        return XR_ERROR_SIZE_INSUFFICIENT;
+    }
+    if (createInfo->faceCount != 1 || createInfo->sampleCount != 1 || createInfo->createFlags != 0) {
+        return XR_ERROR_FEATURE_UNSUPPORTED;
+    }
+#ifdef XR_USE_GRAPHICS_API_VULKAN
+    if (sessionObj->headless) {
+        return XR_ERROR_SWAPCHAIN_FORMAT_UNSUPPORTED;
+    }
+    const std::vector<int64_t> &formats = MockVulkanSwapchainFormats();
+    if (std::find(formats.begin(), formats.end(), createInfo->format) == formats.end()) {
+        return XR_ERROR_SWAPCHAIN_FORMAT_UNSUPPORTED;
+    }
+    auto newSwapchain = std::make_unique<MockSwapchain>();
+    newSwapchain->parent = HandleToInt(session);
+    newSwapchain->createInfo = *createInfo;
+    newSwapchain->createInfo.next = nullptr;
+    newSwapchain->imageCount = rt.config.swapchainImageCount;
+    const XrResult result = MockVulkanCreateSwapchainImages(sessionObj->vulkan, *newSwapchain);
+    if (XR_FAILED(result)) {
+        return result;
+    }
+    *swapchain = IntToHandle<XrSwapchain>(rt.Add(std::move(newSwapchain)));
+    return XR_SUCCESS;
+#else
+    return XR_ERROR_SWAPCHAIN_FORMAT_UNSUPPORTED;
+#endif  // XR_USE_GRAPHICS_API_VULKAN
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL MockDestroySwapchain(XrSwapchain swapchain) {
+    LOCK_RUNTIME();
+    MockSwapchain *swapchainObj = Lookup<MockSwapchain>(rt, swapchain);
+    if (swapchainObj == nullptr) {
+        return XR_ERROR_HANDLE_INVALID;
+    }
+    DestroySwapchain(rt, *swapchainObj);
+    rt.objects.erase(HandleToInt(swapchain));
+    return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL MockEnumerateSwapchainImages(XrSwapchain swapchain, uint32_t imageCapacityInput,
+                                                            uint32_t *imageCountOutput, XrSwapchainImageBaseHeader *images) {
+    LOCK_RUNTIME();
+    const MockSwapchain *swapchainObj = Lookup<MockSwapchain>(rt, swapchain);
+    if (swapchainObj == nullptr) {
+        return XR_ERROR_HANDLE_INVALID;
+    }
+#ifdef XR_USE_GRAPHICS_API_VULKAN
+    if (images != nullptr && imageCapacityInput != 0 && images->type != XR_TYPE_SWAPCHAIN_IMAGE_VULKAN2_KHR) {
+        return XR_ERROR_VALIDATION_FAILURE;
+    }
+    auto *vulkanImages = reinterpret_cast<XrSwapchainImageVulkan2KHR *>(images);
+    return FillTwoCall(imageCapacityInput, imageCountOutput, images, swapchainObj->imageCount,
+                       [&](uint32_t i) { vulkanImages[i].image = swapchainObj->vulkanImages[i].image; });
+#else
+    (void)images;
+    return FillTwoCall(imageCapacityInput, imageCountOutput, images, 0, [](uint32_t) {});
+#endif  // XR_USE_GRAPHICS_API_VULKAN
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL MockAcquireSwapchainImage(XrSwapchain swapchain, const XrSwapchainImageAcquireInfo *acquireInfo,
+                                                         uint32_t *index) {
+    MockSimulateCall(MockTimedCall::xrAcquireSwapchainImage);
+    LOCK_RUNTIME();
+    MockSwapchain *swapchainObj = Lookup<MockSwapchain>(rt, swapchain);
+    if (swapchainObj == nullptr) {
+        return XR_ERROR_HANDLE_INVALID;
+    }
+    if (index == nullptr || (acquireInfo != nullptr && acquireInfo->type != XR_TYPE_SWAPCHAIN_IMAGE_ACQUIRE_INFO)) {
+        return XR_ERROR_VALIDATION_FAILURE;
+    }
+    if (swapchainObj->acquired.size() + swapchainObj->waited.size() >= swapchainObj->imageCount) {
+        return XR_ERROR_CALL_ORDER_INVALID;
+    }
+    *index = swapchainObj->nextAcquire;
+    swapchainObj->acquired.push_back(*index);
+    swapchainObj->nextAcquire = (swapchainObj->nextAcquire + 1) % swapchainObj->imageCount;
+    return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL MockWaitSwapchainImage(XrSwapchain swapchain, const XrSwapchainImageWaitInfo *waitInfo) {
+    MockSimulateCall(MockTimedCall::xrWaitSwapchainImage);
+    LOCK_RUNTIME();
+    MockSwapchain *swapchainObj = Lookup<MockSwapchain>(rt, swapchain);
+    if (swapchainObj == nullptr) {
+        return XR_ERROR_HANDLE_INVALID;
+    }
+    if (waitInfo == nullptr || waitInfo->type != XR_TYPE_SWAPCHAIN_IMAGE_WAIT_INFO) {
+        return XR_ERROR_VALIDATION_FAILURE;
+    }
+    // Nothing reads the images, so they are available as soon as they are acquired.
+    if (swapchainObj->acquired.empty() || !swapchainObj->waited.empty()) {
+        return XR_ERROR_CALL_ORDER_INVALID;
+    }
+    swapchainObj->waited.push_back(swapchainObj->acquired.front());
+    swapchainObj->acquired.pop_front();
+    return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL MockReleaseSwapchainImage(XrSwapchain swapchain, const XrSwapchainImageReleaseInfo *releaseInfo) {
+    MockSimulateCall(MockTimedCall::xrReleaseSwapchainImage);
+    LOCK_RUNTIME();
+    MockSwapchain *swapchainObj = Lookup<MockSwapchain>(rt, swapchain);
+    if (swapchainObj == nullptr) {
+        return XR_ERROR_HANDLE_INVALID;
+    }
+    if (releaseInfo != nullptr && releaseInfo->type != XR_TYPE_SWAPCHAIN_IMAGE_RELEASE_INFO) {
+        return XR_ERROR_VALIDATION_FAILURE;
+    }
+    if (swapchainObj->waited.empty()) {
+        return XR_ERROR_CALL_ORDER_INVALID;
+    }
+    swapchainObj->waited.pop_front();
+    swapchainObj->everReleased = true;
+    return XR_SUCCESS;
+}
+
+//
+// XR_EXT_hand_tracking
+//
+
+XRAPI_ATTR XrResult XRAPI_CALL MockCreateHandTrackerEXT(XrSession session, const XrHandTrackerCreateInfoEXT *createInfo,
+                                                        XrHandTrackerEXT *handTracker) {
+    LOCK_RUNTIME();
+    if (Lookup<MockSession>(rt, session) == nullptr) {
+        return XR_ERROR_HANDLE_INVALID;
+    }
+    if (createInfo == nullptr || handTracker == nullptr || createInfo->type != XR_TYPE_HAND_TRACKER_CREATE_INFO_EXT ||
+        (createInfo->hand != XR_HAND_LEFT_EXT && createInfo->hand != XR_HAND_RIGHT_EXT)) {
+        return XR_ERROR_VALIDATION_FAILURE;
+    }
+    if (createInfo->handJointSet != XR_HAND_JOINT_SET_DEFAULT_EXT) {
+        return XR_ERROR_FEATURE_UNSUPPORTED;
+    }
+    auto tracker = std::make_unique<MockHandTracker>();
+    tracker->parent = HandleToInt(session);
+    tracker->hand = createInfo->hand;
+    *handTracker = IntToHandle<XrHandTrackerEXT>(rt.Add(std::move(tracker)));
+    return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL MockDestroyHandTrackerEXT(XrHandTrackerEXT handTracker) {
+    LOCK_RUNTIME();
+    if (Lookup<MockHandTracker>(rt, handTracker) == nullptr) {
+        return XR_ERROR_HANDLE_INVALID;
+    }
+    rt.objects.erase(HandleToInt(handTracker));
+    return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL MockLocateHandJointsEXT(XrHandTrackerEXT handTracker, const XrHandJointsLocateInfoEXT *locateInfo,
+                                                       XrHandJointLocationsEXT *locations) {
+    MockSimulateCall(MockTimedCall::xrLocateHandJointsEXT);
+    LOCK_RUNTIME();
+    const MockHandTracker *tracker = Lookup<MockHandTracker>(rt, handTracker);
+    if (tracker == nullptr) {
+        return XR_ERROR_HANDLE_INVALID;
+    }
+    if (locateInfo == nullptr || locations == nullptr || locateInfo->type != XR_TYPE_HAND_JOINTS_LOCATE_INFO_EXT ||
+        locations->type != XR_TYPE_HAND_JOINT_LOCATIONS_EXT || locations->jointCount != XR_HAND_JOINT_COUNT_EXT ||
+        locations->jointLocations == nullptr) {
+        return XR_ERROR_VALIDATION_FAILURE;
+    }
+    const MockSpace *baseObj = Lookup<MockSpace>(rt, locateInfo->baseSpace);
+    if (baseObj == nullptr) {
+        return XR_ERROR_HANDLE_INVALID;
+    }
+    if (locateInfo->time <= 0) {
+        return XR_ERROR_TIME_INVALID;
+    }
+    auto *velocities = reinterpret_cast<XrHandJointVelocitiesEXT *>(FindNextOut(locations->next, XR_TYPE_HAND_JOINT_VELOCITIES_EXT));
+    if (velocities != nullptr && (velocities->jointCount != XR_HAND_JOINT_COUNT_EXT || velocities->jointVelocities == nullptr)) {
+        return XR_ERROR_VALIDATION_FAILURE;
+    }
+
+    const MockSession *sessionObj = rt.Find<MockSession>(tracker->parent, MockObjectType::Session);
+    const SpaceLocation base = LocateInWorld(rt, *baseObj, locateInfo->time);
+    const bool active = sessionObj != nullptr && sessionObj->state == XR_SESSION_STATE_FOCUSED && base.tracked;
+    const int hand = tracker->hand == XR_HAND_LEFT_EXT ? 0 : 1;
+    const XrPosef handInBase = PoseMultiply(PoseInverse(base.pose), HandPose(rt, hand, locateInfo->time));
+    locations->isActive = active ? XR_TRUE : XR_FALSE;
+    for (uint32_t joint = 0; joint < XR_HAND_JOINT_COUNT_EXT; ++joint) {
+        XrHandJointLocationEXT &location = locations->jointLocations[joint];
+        if (!active) {
+            location = {0, PoseIdentity(), 0.0f};
+        } else {
+            location.locationFlags = XR_SPACE_LOCATION_ORIENTATION_VALID_BIT | XR_SPACE_LOCATION_POSITION_VALID_BIT |
+                                     XR_SPACE_LOCATION_ORIENTATION_TRACKED_BIT | XR_SPACE_LOCATION_POSITION_TRACKED_BIT;
+            location.pose = PoseMultiply(handInBase, RestJointPose(tracker->hand, joint));
+            location.radius = joint == XR_HAND_JOINT_PALM_EXT || joint == XR_HAND_JOINT_WRIST_EXT ? 0.02f : 0.01f;
+        }
+        if (velocities != nullptr) {
+            velocities->jointVelocities[joint] = {0, {0.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 0.0f}};
+        }
+    }
+    return XR_SUCCESS;
+}
+
+//
+// Dispatch
+//
+
+XRAPI_ATTR XrResult XRAPI_CALL MockGetInstanceProcAddr(XrInstance instance, const char *name, PFN_xrVoidFunction *function);
+
+struct FunctionEntry {
+    const char *name;
+    PFN_xrVoidFunction function;
+    const char *extension;  ///< nullptr for core functions
+};
+
+#define MOCK_FN(xrName, impl, ext) \
+    { xrName, reinterpret_cast<PFN_xrVoidFunction>(&impl), ext }
+
+const std::vector<FunctionEntry> &FunctionTable() {
+    static const std::vector<FunctionEntry> table = {
+        MOCK_FN("xrGetInstanceProcAddr", MockGetInstanceProcAddr, nullptr),
+        MOCK_FN("xrEnumerateApiLayerProperties", MockEnumerateApiLayerProperties, nullptr),
+        MOCK_FN("xrEnumerateInstanceExtensionProperties", MockEnumerateInstanceExtensionProperties, nullptr),
+        MOCK_FN("xrCreateInstance", MockCreateInstance, nullptr),
+        MOCK_FN("xrDestroyInstance", MockDestroyInstance, nullptr),
+        MOCK_FN("xrGetInstanceProperties", MockGetInstanceProperties, nullptr),
+        MOCK_FN("xrPollEvent", MockPollEvent, nullptr),
+        MOCK_FN("xrResultToString", MockResultToString, nullptr),
+        MOCK_FN("xrStructureTypeToString", MockStructureTypeToString, nullptr),
+        MOCK_FN("xrGetSystem", MockGetSystem, nullptr),
+        MOCK_FN("xrGetSystemProperties", MockGetSystemProperties, nullptr),
+        MOCK_FN("xrEnumerateEnvironmentBlendModes", MockEnumerateEnvironmentBlendModes, nullptr),
+        MOCK_FN("xrCreateSession", MockCreateSession, nullptr),
+        MOCK_FN("xrDestroySession", MockDestroySession, nullptr),
+        MOCK_FN("xrEnumerateReferenceSpaces", MockEnumerateReferenceSpaces, nullptr),
+        MOCK_FN("xrCreateReferenceSpace", MockCreateReferenceSpace, nullptr),
+        MOCK_FN("xrGetReferenceSpaceBoundsRect", MockGetReferenceSpaceBoundsRect, nullptr),
+        MOCK_FN("xrCreateActionSpace", MockCreateActionSpace, nullptr),
+        MOCK_FN("xrLocateSpace", MockLocateSpace, nullptr),
+        MOCK_FN("xrDestroySpace", MockDestroySpace, nullptr),
+        MOCK_FN("xrEnumerateViewConfigurations", MockEnumerateViewConfigurations, nullptr),
+        MOCK_FN("xrGetViewConfigurationProperties", MockGetViewConfigurationProperties, nullptr),
+        MOCK_FN("xrEnumerateViewConfigurationViews", MockEnumerateViewConfigurationViews, nullptr),
+        MOCK_FN("xrEnumerateSwapchainFormats", MockEnumerateSwapchainFormats, nullptr),
+        MOCK_FN("xrCreateSwapchain", MockCreateSwapchain, nullptr),
+        MOCK_FN("xrDestroySwapchain", MockDestroySwapchain, nullptr),
+        MOCK_FN("xrEnumerateSwapchainImages", MockEnumerateSwapchainImages, nullptr),
+        MOCK_FN("xrAcquireSwapchainImage", MockAcquireSwapchainImage, nullptr),
+        MOCK_FN("xrWaitSwapchainImage", MockWaitSwapchainImage, nullptr),
+        MOCK_FN("xrReleaseSwapchainImage", MockReleaseSwapchainImage, nullptr),
+        MOCK_FN("xrBeginSession", MockBeginSession, nullptr),
+        MOCK_FN("xrEndSession", MockEndSession, nullptr),
+        MOCK_FN("xrRequestExitSession", MockRequestExitSession, nullptr),
+        MOCK_FN("xrWaitFrame", MockWaitFrame, nullptr),
+        MOCK_FN("xrBeginFrame", MockBeginFrame, nullptr),
+        MOCK_FN("xrEndFrame", MockEndFrame, nullptr),
+        MOCK_FN("xrLocateViews", MockLocateViews, nullptr),
+        MOCK_FN("xrStringToPath", MockStringToPath, nullptr),
+        MOCK_FN("xrPathToString", MockPathToString, nullptr),
+        MOCK_FN("xrCreateActionSet", MockCreateActionSet, nullptr),
+        MOCK_FN("xrDestroyActionSet", MockDestroyActionSet, nullptr),
+        MOCK_FN("xrCreateAction", MockCreateAction, nullptr),
+        MOCK_FN("xrDestroyAction", MockDestroyAction, nullptr),
+        MOCK_FN("xrSuggestInteractionProfileBindings", MockSuggestInteractionProfileBindings, nullptr),
+        MOCK_FN("xrAttachSessionActionSets", MockAttachSessionActionSets, nullptr),
+        MOCK_FN("xrGetCurrentInteractionProfile", MockGetCurrentInteractionProfile, nullptr),
+        MOCK_FN("xrGetActionStateBoolean", MockGetActionStateBoolean, nullptr),
+        MOCK_FN("xrGetActionStateFloat", MockGetActionStateFloat, nullptr),
+        MOCK_FN("xrGetActionStateVector2f", MockGetActionStateVector2f, nullptr),
+        MOCK_FN("xrGetActionStatePose", MockGetActionStatePose, nullptr),
+        MOCK_FN("xrSyncActions", MockSyncActions, nullptr),
+        MOCK_FN("xrEnumerateBoundSourcesForAction", MockEnumerateBoundSourcesForAction, nullptr),
+        MOCK_FN("xrGetInputSourceLocalizedName", MockGetInputSourceLocalizedName, nullptr),
+        MOCK_FN("xrApplyHapticFeedback", MockApplyHapticFeedback, nullptr),
+        MOCK_FN("xrStopHapticFeedback", MockStopHapticFeedback, nullptr),
+#ifdef XR_USE_TIMESPEC
+        MOCK_FN("xrConvertTimespecTimeToTimeKHR", MockConvertTimespecTimeToTimeKHR, XR_KHR_CONVERT_TIMESPEC_TIME_EXTENSION_NAME),
+        MOCK_FN("xrConvertTimeToTimespecTimeKHR", MockConvertTimeToTimespecTimeKHR, XR_KHR_CONVERT_TIMESPEC_TIME_EXTENSION_NAME),
+#endif  // XR_USE_TIMESPEC
+#ifdef XR_USE_PLATFORM_WIN32
+        MOCK_FN("xrConvertWin32PerformanceCounterToTimeKHR", MockConvertWin32PerformanceCounterToTimeKHR,
+                XR_KHR_WIN32_CONVERT_PERFORMANCE_COUNTER_TIME_EXTENSION_NAME),
+        MOCK_FN("xrConvertTimeToWin32PerformanceCounterKHR", MockConvertTimeToWin32PerformanceCounterKHR,
+                XR_KHR_WIN32_CONVERT_PERFORMANCE_COUNTER_TIME_EXTENSION_NAME),
+#endif  // XR_USE_PLATFORM_WIN32
+        MOCK_FN("xrCreateHandTrackerEXT", MockCreateHandTrackerEXT, XR_EXT_HAND_TRACKING_EXTENSION_NAME),
+        MOCK_FN("xrDestroyHandTrackerEXT", MockDestroyHandTrackerEXT, XR_EXT_HAND_TRACKING_EXTENSION_NAME),
+        MOCK_FN("xrLocateHandJointsEXT", MockLocateHandJointsEXT, XR_EXT_HAND_TRACKING_EXTENSION_NAME),
+    };
+    return table;
+}
+
+#undef MOCK_FN
+
+XRAPI_ATTR XrResult XRAPI_CALL MockGetInstanceProcAddr(XrInstance instance, const char *name, PFN_xrVoidFunction *function) {
+    if (name == nullptr || function == nullptr) {
+        return XR_ERROR_VALIDATION_FAILURE;
+    }
+    *function = nullptr;
+    const std::vector<FunctionEntry> &table = FunctionTable();
+    const auto it = std::find_if(table.begin(), table.end(),
+                                 [name](const FunctionEntry &entry) { return std::strcmp(entry.name, name) == 0; });
+
+    LOCK_RUNTIME();
+    if (instance == XR_NULL_HANDLE) {
+        // Only the functions which do not need an instance may be queried without one.
+        const bool global = it != table.end() && (std::strcmp(name, "xrEnumerateApiLayerProperties") == 0 ||
+                                                  std::strcmp(name, "xrEnumerateInstanceExtensionProperties") == 0 ||
+                                                  std::strcmp(name, "xrCreateInstance") == 0);
+        if (!global) {
+            return XR_ERROR_HANDLE_INVALID;
+        }
+        *function = it->function;
+        return XR_SUCCESS;
+    }
+    CHECK_INSTANCE(instance);
+    if (it != table.end()) {
+        if (it->extension != nullptr && !rt.IsExtensionEnabled(it->extension)) {
+            return XR_ERROR_FUNCTION_UNSUPPORTED;
+        }
+        *function = it->function;
+        return XR_SUCCESS;
+    }
+#ifdef XR_USE_GRAPHICS_API_VULKAN
+    if (rt.IsExtensionEnabled(XR_KHR_VULKAN_ENABLE2_EXTENSION_NAME)) {
+        return MockVulkanGetInstanceProcAddr(name, function);
+    }
+#endif  // XR_USE_GRAPHICS_API_VULKAN
+    return XR_ERROR_FUNCTION_UNSUPPORTED;
+}
+
+#undef LOCK_RUNTIME
+#undef CHECK_INSTANCE
+
+}  // namespace
+
+extern "C" RUNTIME_EXPORT XRAPI_ATTR XrResult XRAPI_CALL xrNegotiateLoaderRuntimeInterface(const XrNegotiateLoaderInfo *loaderInfo,
+                                                                                           XrNegotiateRuntimeRequest *runtimeRequest) {
+    if (loaderInfo == nullptr || runtimeRequest == nullptr || loaderInfo->structType != XR_LOADER_INTERFACE_STRUCT_LOADER_INFO ||
+        loaderInfo->structVersion != XR_LOADER_INFO_STRUCT_VERSION || loaderInfo->structSize != sizeof(XrNegotiateLoaderInfo) ||
+        runtimeRequest->structType != XR_LOADER_INTERFACE_STRUCT_RUNTIME_REQUEST ||
+        runtimeRequest->structVersion != XR_RUNTIME_INFO_STRUCT_VERSION ||
+        runtimeRequest->structSize != sizeof(XrNegotiateRuntimeRequest)) {
+        return XR_ERROR_INITIALIZATION_FAILED;
+    }
+    if (loaderInfo->minInterfaceVersion > XR_CURRENT_LOADER_RUNTIME_VERSION ||
+        loaderInfo->maxInterfaceVersion < XR_CURRENT_LOADER_RUNTIME_VERSION ||
+        XR_VERSION_MAJOR(loaderInfo->minApiVersion) > XR_VERSION_MAJOR(XR_CURRENT_API_VERSION) ||
+        XR_VERSION_MAJOR(loaderInfo->maxApiVersion) < XR_VERSION_MAJOR(XR_CURRENT_API_VERSION)) {
+        return XR_ERROR_INITIALIZATION_FAILED;
+    }
+    runtimeRequest->runtimeInterfaceVersion = XR_CURRENT_LOADER_RUNTIME_VERSION;
+    runtimeRequest->runtimeApiVersion = XR_CURRENT_API_VERSION;
+    runtimeRequest->getInstanceProcAddr = MockGetInstanceProcAddr;
+    return XR_SUCCESS;
+}
@@ -0,0 +1,359 @@
+// Copyright (c) 2017-2024, The Khronos Group Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Internal declarations shared by the translation units of the mock runtime.
+
+#pragma once
+
+#include "xr_dependencies.h"
+
+#include <openxr/openxr.h>
+#include <openxr/openxr_platform.h>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/// Runtime calls which can be given a simulated cost with the "latencies" object of the config file,
+/// their call counts are also part of the statistics printed by a verbose runtime.
+#define MOCK_RUNTIME_TIMED_CALLS(_) \
+    _(xrPollEvent)                  \
+    _(xrWaitFrame)                  \
+    _(xrBeginFrame)                 \
+    _(xrEndFrame)                   \
+    _(xrLocateViews)                \
+    _(xrLocateSpace)                \
+    _(xrSyncActions)                \
+    _(xrGetActionStateBoolean)      \
+    _(xrGetActionStateFloat)        \
+    _(xrGetActionStateVector2f)     \
+    _(xrGetActionStatePose)         \
+    _(xrAcquireSwapchainImage)      \
+    _(xrWaitSwapchainImage)         \
+    _(xrReleaseSwapchainImage)      \
+    _(xrLocateHandJointsEXT)
+
+enum class MockTimedCall : std::size_t {
+#define MOCK_RUNTIME_TIMED_CALL_ENUM(name) name,
+    MOCK_RUNTIME_TIMED_CALLS(MOCK_RUNTIME_TIMED_CALL_ENUM)
+#undef MOCK_RUNTIME_TIMED_CALL_ENUM
+    Count
+};
+
+constexpr std::size_t kMockTimedCallCount = static_cast<std::size_t>(MockTimedCall::Count);
+
+const char *MockTimedCallName(MockTimedCall call);
+
+/// The only system of the runtime, a head mounted display.
+constexpr XrSystemId kMockSystemId = 1;
+
+//
+// Pose math, OpenXR conventions: right handed, poses map from the local to the parent space.
+//
+
+inline XrQuaternionf QuatMultiply(const XrQuaternionf &a, const XrQuaternionf &b) {
+    return {a.w * b.x + a.x * b.w + a.y * b.z - a.z * b.y, a.w * b.y - a.x * b.z + a.y * b.w + a.z * b.x,
+            a.w * b.z + a.x * b.y - a.y * b.x + a.z * b.w, a.w * b.w - a.x * b.x - a.y * b.y - a.z * b.z};
+}
+
+inline XrQuaternionf QuatConjugate(const XrQuaternionf &q) { return {-q.x, -q.y, -q.z, q.w}; }
+
+inline XrQuaternionf QuatNormalize(const XrQuaternionf &q) {
+    const float len = std::sqrt(q.x * q.x + q.y * q.y + q.z * q.z + q.w * q.w);
+    if (len <= 0.0f) {
+        return {0.0f, 0.0f, 0.0f, 1.0f};
+    }
+    return {q.x / len, q.y / len, q.z / len, q.w / len};
+}
+
+inline XrVector3f QuatRotate(const XrQuaternionf &q, const XrVector3f &v) {
+    const XrQuaternionf p{v.x, v.y, v.z, 0.0f};
+    const XrQuaternionf r = QuatMultiply(QuatMultiply(q, p), QuatConjugate(q));
+    return {r.x, r.y, r.z};
+}
+
+/// Rotation of yaw (about +Y), then pitch (about +X), then roll (about +Z), in radians.
+inline XrQuaternionf QuatFromYawPitchRoll(float yaw, float pitch, float roll) {
+    const XrQuaternionf qy{0.0f, std::sin(yaw * 0.5f), 0.0f, std::cos(yaw * 0.5f)};
+    const XrQuaternionf qp{std::sin(pitch * 0.5f), 0.0f, 0.0f, std::cos(pitch * 0.5f)};
+    const XrQuaternionf qr{0.0f, 0.0f, std::sin(roll * 0.5f), std::cos(roll * 0.5f)};
+    return QuatMultiply(QuatMultiply(qy, qp), qr);
+}
+
+inline XrQuaternionf QuatSlerp(const XrQuaternionf &a, XrQuaternionf b, float t) {
+    float cosTheta = a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w;
+    if (cosTheta < 0.0f) {
+        b = {-b.x, -b.y, -b.z, -b.w};
+        cosTheta = -cosTheta;
+    }
+    float wa = 1.0f - t;
+    float wb = t;
+    if (cosTheta < 0.9995f) {
+        const float theta = std::acos(cosTheta);
+        const float sinTheta = std::sin(theta);
+        wa = std::sin((1.0f - t) * theta) / sinTheta;
+        wb = std::sin(t * theta) / sinTheta;
+    }
+    return QuatNormalize({wa * a.x + wb * b.x, wa * a.y + wb * b.y, wa * a.z + wb * b.z, wa * a.w + wb * b.w});
+}
+
+inline XrPosef PoseIdentity() { return {{0.0f, 0.0f, 0.0f, 1.0f}, {0.0f, 0.0f, 0.0f}}; }
+
+/// Returns the pose of b's local space in a's parent space, i.e. a * b.
+inline XrPosef PoseMultiply(const XrPosef &a, const XrPosef &b) {
+    const XrVector3f p = QuatRotate(a.orientation, b.position);
+    return {QuatMultiply(a.orientation, b.orientation),
+            {a.position.x + p.x, a.position.y + p.y, a.position.z + p.z}};
+}
+
+inline XrPosef PoseInverse(const XrPosef &a) {
+    const XrQuaternionf inv = QuatConjugate(a.orientation);
+    const XrVector3f p = QuatRotate(inv, a.position);
+    return {inv, {-p.x, -p.y, -p.z}};
+}
+
+//
+// Configuration, see README.md for the file format.
+//
+
+struct MockPoseKey {
+    double time = 0.0;  ///< seconds
+    XrPosef pose = PoseIdentity();
+};
+
+/// A keyframed pose animation, positions are linearly interpolated and orientations slerped.
+struct MockPoseTrack {
+    std::vector<MockPoseKey> keys;
+    bool loop = true;
+
+    XrPosef Sample(double seconds) const;
+};
+
+struct MockRuntimeConfig {
+    enum class ClockMode {
+        /// Time only advances in xrWaitFrame, by exactly one display period and without blocking.
+        Virtual,
+        /// xrWaitFrame blocks until the next display period of the monotonic clock.
+        Realtime,
+    };
+
+    ClockMode clock = ClockMode::Virtual;
+    float displayRefreshRate = 90.0f;
+    uint32_t recommendedImageWidth = 1440;
+    uint32_t recommendedImageHeight = 1584;
+    uint32_t swapchainImageCount = 3;
+    float ipd = 0.063f;
+    /// Field of view of the left eye, the right eye is mirrored.
+    XrFovf leftEyeFov{-0.942478f, 0.698132f, 0.733038f, -0.942478f};
+    std::string systemName = "Mock Runtime HMD";
+    std::string interactionProfile = "/interaction_profiles/oculus/touch_controller";
+    bool handTracking = true;
+    bool headless = true;
+    int vulkanDeviceIndex = -1;
+    std::string vulkanDeviceName;
+    /// Runtime initiated session exit after this many frames have been submitted, 0 never exits.
+    uint64_t exitAfterFrames = 0;
+    bool verbose = false;
+
+    MockPoseTrack head;
+    std::array<MockPoseTrack, 2> hands;  ///< left, right controller grip poses
+    std::array<std::chrono::nanoseconds, kMockTimedCallCount> latencies{};
+
+    /// Loads the file named by the XR_MOCK_RUNTIME_CONFIG environment variable, or returns the
+    /// defaults when it is not set.  Errors are reported on stderr and leave the defaults in place.
+    static MockRuntimeConfig Load();
+};
+
+//
+// Runtime state, every entry point holds MockRuntime::mutex while it touches any of it.
+//
+
+enum class MockObjectType { Session, Space, ActionSet, Action, Swapchain, HandTracker };
+
+struct MockObject {
+    explicit MockObject(MockObjectType objectType) : type(objectType) {}
+    virtual ~MockObject() = default;
+    const MockObjectType type;
+    uint64_t parent = 0;  ///< handle value of the owning session/action set, 0 for instance children
+};
+
+struct MockActionSet : MockObject {
+    MockActionSet() : MockObject(MockObjectType::ActionSet) {}
+    std::string name;
+    bool attached = false;
+};
+
+struct MockAction : MockObject {
+    MockAction() : MockObject(MockObjectType::Action) {}
+    std::string name;
+    XrActionType actionType = XR_ACTION_TYPE_BOOLEAN_INPUT;
+    std::vector<XrPath> subactionPaths;
+};
+
+struct MockSpace : MockObject {
+    MockSpace() : MockObject(MockObjectType::Space) {}
+    XrReferenceSpaceType referenceSpaceType = XR_REFERENCE_SPACE_TYPE_LOCAL;
+    uint64_t action = 0;  ///< non-zero for action spaces
+    XrPath subactionPath = XR_NULL_PATH;
+    XrPosef poseInParent = PoseIdentity();
+};
+
+struct MockHandTracker : MockObject {
+    MockHandTracker() : MockObject(MockObjectType::HandTracker) {}
+    XrHandEXT hand = XR_HAND_LEFT_EXT;
+};
+
+#ifdef XR_USE_GRAPHICS_API_VULKAN
+struct MockVulkanImage {
+    VkImage image = VK_NULL_HANDLE;
+    VkDeviceMemory memory = VK_NULL_HANDLE;
+};
+#endif  // XR_USE_GRAPHICS_API_VULKAN
+
+struct MockSwapchain : MockObject {
+    MockSwapchain() : MockObject(MockObjectType::Swapchain) {}
+    XrSwapchainCreateInfo createInfo{XR_TYPE_SWAPCHAIN_CREATE_INFO};
+    uint32_t imageCount = 0;
+    uint32_t nextAcquire = 0;
+    std::deque<uint32_t> acquired;  ///< acquired but not yet waited for
+    std::deque<uint32_t> waited;    ///< waited for but not yet released
+    bool everReleased = false;
+#ifdef XR_USE_GRAPHICS_API_VULKAN
+    std::vector<MockVulkanImage> vulkanImages;
+#endif  // XR_USE_GRAPHICS_API_VULKAN
+};
+
+#ifdef XR_USE_GRAPHICS_API_VULKAN
+struct MockVulkanBinding {
+    VkInstance instance = VK_NULL_HANDLE;
+    VkPhysicalDevice physicalDevice = VK_NULL_HANDLE;
+    VkDevice device = VK_NULL_HANDLE;
+    PFN_vkGetInstanceProcAddr getInstanceProcAddr = nullptr;
+};
+#endif  // XR_USE_GRAPHICS_API_VULKAN
+
+struct MockSession : MockObject {
+    MockSession() : MockObject(MockObjectType::Session) {}
+    XrSessionState state = XR_SESSION_STATE_UNKNOWN;
+    bool running = false;
+    bool exitRequested = false;
+    bool headless = true;
+#ifdef XR_USE_GRAPHICS_API_VULKAN
+    MockVulkanBinding vulkan;
+#endif  // XR_USE_GRAPHICS_API_VULKAN
+    XrPath interactionProfile = XR_NULL_PATH;
+    bool actionSetsAttached = false;
+    bool actionsSynced = false;
+    /// (action, top level user path) pairs bound by the current interaction profile.
+    std::set<std::pair<uint64_t, XrPath>> boundActions;
+    uint64_t framesWaited = 0;
+    uint64_t framesBegun = 0;
+    uint64_t framesEnded = 0;
+    uint64_t framesDiscarded = 0;
+    bool frameInProgress = false;
+};
+
+class MockRuntime {
+   public:
+    static MockRuntime &Get();
+
+    MockRuntime();
+
+    std::mutex mutex;
+    MockRuntimeConfig config;
+    std::array<std::atomic<uint64_t>, kMockTimedCallCount> callCounts{};
+
+    // Clock state, see MockRuntimeConfig::ClockMode.
+    std::chrono::steady_clock::time_point clockStart;
+    XrTime virtualTime = 0;
+    std::chrono::steady_clock::time_point virtualTimeWall;
+
+    // Instance state, at most one instance exists at a time.
+    XrInstance instance = XR_NULL_HANDLE;
+    std::set<std::string> enabledExtensions;
+    std::deque<XrEventDataBuffer> events;
+    std::vector<std::string> paths{std::string()};  ///< indexed by XrPath, entry 0 is XR_NULL_PATH
+    std::unordered_map<std::string, XrPath> pathIds;
+    /// Suggested bindings, interaction profile -> (action, binding path).
+    std::map<XrPath, std::vector<std::pair<uint64_t, XrPath>>> suggestedBindings;
+    std::unordered_map<uint64_t, std::unique_ptr<MockObject>> objects;
+    uint64_t nextHandle = 1;
+    bool vulkanRequirementsQueried = false;
+#ifdef XR_USE_GRAPHICS_API_VULKAN
+    VkInstance vulkanInstance = VK_NULL_HANDLE;
+    PFN_vkGetInstanceProcAddr vulkanGetInstanceProcAddr = nullptr;
+#endif  // XR_USE_GRAPHICS_API_VULKAN
+
+    bool IsExtensionEnabled(const char *name) const { return enabledExtensions.count(name) != 0; }
+
+    template <typename T>
+    T *Find(uint64_t handle, MockObjectType type) {
+        const auto it = objects.find(handle);
+        if (it == objects.end() || it->second->type != type) {
+            return nullptr;
+        }
+        return static_cast<T *>(it->second.get());
+    }
+
+    uint64_t Add(std::unique_ptr<MockObject> object) {
+        const uint64_t handle = nextHandle++;
+        objects.emplace(handle, std::move(object));
+        return handle;
+    }
+
+    void ResetInstance();
+};
+
+template <typename HandleType>
+inline uint64_t HandleToInt(HandleType handle) {
+#if XR_PTR_SIZE == 8
+    return reinterpret_cast<uint64_t>(handle);
+#else
+    return static_cast<uint64_t>(handle);
+#endif
+}
+
+template <typename HandleType>
+inline HandleType IntToHandle(uint64_t value) {
+#if XR_PTR_SIZE == 8
+    return reinterpret_cast<HandleType>(value);
+#else
+    return static_cast<HandleType>(value);
+#endif
+}
+
+/// Blocks the calling thread for the configured cost of a call and counts it.
+void MockSimulateCall(MockTimedCall call);
+
+#ifdef XR_USE_GRAPHICS_API_VULKAN
+// mock_runtime_vulkan.cpp, all called with MockRuntime::mutex held.
+XrResult MockVulkanGetInstanceProcAddr(const char *name, PFN_xrVoidFunction *function);
+const std::vector<int64_t> &MockVulkanSwapchainFormats();
+XrResult MockVulkanCreateSwapchainImages(const MockVulkanBinding &binding, MockSwapchain &swapchain);
+void MockVulkanDestroySwapchainImages(const MockVulkanBinding &binding, MockSwapchain &swapchain);
+#endif  // XR_USE_GRAPHICS_API_VULKAN
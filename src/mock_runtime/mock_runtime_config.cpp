@@ -0,0 +1,246 @@
+// Copyright (c) 2017-2024, The Khronos Group Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mock_runtime.h"
+
+#include <json/json.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+namespace {
+
+constexpr float kDegToRad = 3.14159265358979f / 180.0f;
+
+const char *const kTimedCallNames[] = {
+#define MOCK_RUNTIME_TIMED_CALL_NAME(name) #name,
+    MOCK_RUNTIME_TIMED_CALLS(MOCK_RUNTIME_TIMED_CALL_NAME)
+#undef MOCK_RUNTIME_TIMED_CALL_NAME
+};
+static_assert(sizeof(kTimedCallNames) / sizeof(kTimedCallNames[0]) == kMockTimedCallCount, "timed call names out of sync");
+
+MockPoseKey MakeKey(double time, XrVector3f position, float yawDegrees) {
+    MockPoseKey key;
+    key.time = time;
+    key.pose.position = position;
+    key.pose.orientation = QuatFromYawPitchRoll(yawDegrees * kDegToRad, 0.0f, 0.0f);
+    return key;
+}
+
+/// A slow look around at standing eye height, and both controllers held in front of the body.
+void SetDefaultTracks(MockRuntimeConfig &config) {
+    config.head.keys = {MakeKey(0.0, {0.0f, 1.6f, 0.0f}, 0.0f), MakeKey(1.0, {0.0f, 1.6f, 0.0f}, 20.0f),
+                        MakeKey(3.0, {0.0f, 1.6f, 0.0f}, -20.0f), MakeKey(4.0, {0.0f, 1.6f, 0.0f}, 0.0f)};
+    config.hands[0].keys = {MakeKey(0.0, {-0.2f, 1.3f, -0.35f}, 0.0f), MakeKey(2.0, {-0.25f, 1.35f, -0.3f}, 10.0f),
+                            MakeKey(4.0, {-0.2f, 1.3f, -0.35f}, 0.0f)};
+    config.hands[1].keys = {MakeKey(0.0, {0.2f, 1.3f, -0.35f}, 0.0f), MakeKey(2.0, {0.25f, 1.35f, -0.3f}, -10.0f),
+                            MakeKey(4.0, {0.2f, 1.3f, -0.35f}, 0.0f)};
+}
+
+bool ReadFloats(const Json::Value &value, float *out, Json::ArrayIndex count) {
+    if (!value.isArray() || value.size() != count) {
+        return false;
+    }
+    for (Json::ArrayIndex i = 0; i < count; ++i) {
+        if (!value[i].isNumeric()) {
+            return false;
+        }
+        out[i] = value[i].asFloat();
+    }
+    return true;
+}
+
+bool ReadTrack(const Json::Value &value, const char *name, MockPoseTrack &track) {
+    if (value.isNull()) {
+        return true;
+    }
+    const Json::Value &keys = value["keys"];
+    if (!keys.isArray() || keys.empty()) {
+        fprintf(stderr, "mock runtime: \"%s\" needs a non-empty \"keys\" array\n", name);
+        return false;
+    }
+    MockPoseTrack result;
+    result.loop = value.get("loop", true).asBool();
+    for (const Json::Value &key : keys) {
+        MockPoseKey poseKey;
+        poseKey.time = key.get("time", 0.0).asDouble();
+        float position[3] = {0.0f, 0.0f, 0.0f};
+        float orientation[4] = {0.0f, 0.0f, 0.0f, 1.0f};
+        float yawPitchRoll[3] = {0.0f, 0.0f, 0.0f};
+        if (key.isMember("position") && !ReadFloats(key["position"], position, 3)) {
+            fprintf(stderr, "mock runtime: \"%s\" key position must be [x, y, z]\n", name);
+            return false;
+        }
+        if (key.isMember("orientation")) {
+            if (!ReadFloats(key["orientation"], orientation, 4)) {
+                fprintf(stderr, "mock runtime: \"%s\" key orientation must be [x, y, z, w]\n", name);
+                return false;
+            }
+            poseKey.pose.orientation = QuatNormalize({orientation[0], orientation[1], orientation[2], orientation[3]});
+        } else if (key.isMember("yaw_pitch_roll")) {
+            if (!ReadFloats(key["yaw_pitch_roll"], yawPitchRoll, 3)) {
+                fprintf(stderr, "mock runtime: \"%s\" key yaw_pitch_roll must be [yaw, pitch, roll] degrees\n", name);
+                return false;
+            }
+            poseKey.pose.orientation = QuatFromYawPitchRoll(yawPitchRoll[0] * kDegToRad, yawPitchRoll[1] * kDegToRad,
+                                                            yawPitchRoll[2] * kDegToRad);
+        }
+        poseKey.pose.position = {position[0], position[1], position[2]};
+        if (!result.keys.empty() && poseKey.time < result.keys.back().time) {
+            fprintf(stderr, "mock runtime: \"%s\" keys must be in time order\n", name);
+            return false;
+        }
+        result.keys.push_back(poseKey);
+    }
+    track = std::move(result);
+    return true;
+}
+
+bool Parse(const Json::Value &root, MockRuntimeConfig &config) {
+    if (!root.isObject()) {
+        fprintf(stderr, "mock runtime: config root must be an object\n");
+        return false;
+    }
+    const std::string clock = root.get("clock", "virtual").asString();
+    if (clock == "virtual") {
+        config.clock = MockRuntimeConfig::ClockMode::Virtual;
+    } else if (clock == "realtime") {
+        config.clock = MockRuntimeConfig::ClockMode::Realtime;
+    } else {
+        fprintf(stderr, "mock runtime: unknown clock \"%s\", expected \"virtual\" or \"realtime\"\n", clock.c_str());
+        return false;
+    }
+    config.displayRefreshRate = root.get("display_refresh_rate", config.displayRefreshRate).asFloat();
+    if (!(config.displayRefreshRate > 0.0f)) {
+        fprintf(stderr, "mock runtime: display_refresh_rate must be positive\n");
+        return false;
+    }
+    if (root.isMember("recommended_image_size")) {
+        float size[2];
+        if (!ReadFloats(root["recommended_image_size"], size, 2) || size[0] < 1.0f || size[1] < 1.0f) {
+            fprintf(stderr, "mock runtime: recommended_image_size must be [width, height]\n");
+            return false;
+        }
+        config.recommendedImageWidth = static_cast<uint32_t>(size[0]);
+        config.recommendedImageHeight = static_cast<uint32_t>(size[1]);
+    }
+    config.swapchainImageCount = std::max(1u, root.get("swapchain_image_count", config.swapchainImageCount).asUInt());
+    config.ipd = root.get("ipd", config.ipd).asFloat();
+    if (root.isMember("fov")) {
+        float fov[4];
+        if (!ReadFloats(root["fov"], fov, 4)) {
+            fprintf(stderr, "mock runtime: fov must be [left, right, up, down] degrees\n");
+            return false;
+        }
+        config.leftEyeFov = {fov[0] * kDegToRad, fov[1] * kDegToRad, fov[2] * kDegToRad, fov[3] * kDegToRad};
+    }
+    config.systemName = root.get("system_name", config.systemName).asString();
+    config.interactionProfile = root.get("interaction_profile", config.interactionProfile).asString();
+    config.handTracking = root.get("hand_tracking", config.handTracking).asBool();
+    config.headless = root.get("headless", config.headless).asBool();
+    config.vulkanDeviceIndex = root.get("vulkan_device_index", config.vulkanDeviceIndex).asInt();
+    config.vulkanDeviceName = root.get("vulkan_device_name", config.vulkanDeviceName).asString();
+    config.exitAfterFrames = root.get("exit_after_frames", Json::UInt64(config.exitAfterFrames)).asUInt64();
+    config.verbose = root.get("verbose", config.verbose).asBool();
+
+    if (!ReadTrack(root["head"], "head", config.head) || !ReadTrack(root["left_hand"], "left_hand", config.hands[0]) ||
+        !ReadTrack(root["right_hand"], "right_hand", config.hands[1])) {
+        return false;
+    }
+
+    const Json::Value &latencies = root["latencies"];
+    if (!latencies.isNull()) {
+        if (!latencies.isObject()) {
+            fprintf(stderr, "mock runtime: latencies must be an object of call name to microseconds\n");
+            return false;
+        }
+        for (const std::string &name : latencies.getMemberNames()) {
+            const auto it = std::find_if(std::begin(kTimedCallNames), std::end(kTimedCallNames),
+                                         [&name](const char *callName) { return name == callName; });
+            if (it == std::end(kTimedCallNames) || !latencies[name].isNumeric()) {
+                fprintf(stderr, "mock runtime: ignoring latency of \"%s\"\n", name.c_str());
+                continue;
+            }
+            const double microseconds = std::max(0.0, latencies[name].asDouble());
+            config.latencies[static_cast<std::size_t>(it - std::begin(kTimedCallNames))] =
+                std::chrono::nanoseconds(static_cast<int64_t>(microseconds * 1000.0));
+        }
+    }
+    return true;
+}
+
+}  // namespace
+
+const char *MockTimedCallName(MockTimedCall call) { return kTimedCallNames[static_cast<std::size_t>(call)]; }
+
+XrPosef MockPoseTrack::Sample(double seconds) const {
+    if (keys.empty()) {
+        return PoseIdentity();
+    }
+    const double duration = keys.back().time;
+    if (loop && duration > 0.0) {
+        seconds = std::fmod(seconds, duration);
+        if (seconds < 0.0) {
+            seconds += duration;
+        }
+    }
+    if (seconds <= keys.front().time) {
+        return keys.front().pose;
+    }
+    const auto next = std::upper_bound(keys.begin(), keys.end(), seconds,
+                                       [](double time, const MockPoseKey &key) { return time < key.time; });
+    if (next == keys.end()) {
+        return keys.back().pose;
+    }
+    const MockPoseKey &prev = *(next - 1);
+    const double span = next->time - prev.time;
+    const float t = span > 0.0 ? static_cast<float>((seconds - prev.time) / span) : 1.0f;
+    const XrVector3f &a = prev.pose.position;
+    const XrVector3f &b = next->pose.position;
+    return {QuatSlerp(prev.pose.orientation, next->pose.orientation, t),
+            {a.x + (b.x - a.x) * t, a.y + (b.y - a.y) * t, a.z + (b.z - a.z) * t}};
+}
+
+MockRuntimeConfig MockRuntimeConfig::Load() {
+    MockRuntimeConfig config;
+    SetDefaultTracks(config);
+
+    const char *const path = std::getenv("XR_MOCK_RUNTIME_CONFIG");
+    if (path == nullptr || *path == '\0') {
+        return config;
+    }
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        fprintf(stderr, "mock runtime: unable to open config file %s, using defaults\n", path);
+        return config;
+    }
+    Json::CharReaderBuilder builder;
+    Json::Value root;
+    std::string errors;
+    if (!Json::parseFromStream(builder, file, &root, &errors)) {
+        fprintf(stderr, "mock runtime: failed to parse %s, using defaults: %s\n", path, errors.c_str());
+        return config;
+    }
+    MockRuntimeConfig parsed = config;
+    if (!Parse(root, parsed)) {
+        fprintf(stderr, "mock runtime: invalid config file %s, using defaults\n", path);
+        return config;
+    }
+    return parsed;
+}
@@ -0,0 +1,315 @@
+// Copyright (c) 2017-2024, The Khronos Group Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// XR_KHR_vulkan_enable2 for the mock runtime.  The application's Vulkan instance and device are
+// created through the application supplied vkGetInstanceProcAddr, so any installed ICD works; on
+// machines without a GPU that is typically lavapipe.  Swapchain images are plain device local
+// VkImages which nothing ever reads.
+
+#include "mock_runtime.h"
+
+#ifdef XR_USE_GRAPHICS_API_VULKAN
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+namespace {
+
+/// Selects the physical device named by the config (index, then name substring), else the first.
+VkPhysicalDevice SelectPhysicalDevice(const MockRuntimeConfig &config, VkInstance instance,
+                                      PFN_vkGetInstanceProcAddr getInstanceProcAddr) {
+    auto enumerateDevices =
+        reinterpret_cast<PFN_vkEnumeratePhysicalDevices>(getInstanceProcAddr(instance, "vkEnumeratePhysicalDevices"));
+    auto getProperties =
+        reinterpret_cast<PFN_vkGetPhysicalDeviceProperties>(getInstanceProcAddr(instance, "vkGetPhysicalDeviceProperties"));
+    if (enumerateDevices == nullptr || getProperties == nullptr) {
+        return VK_NULL_HANDLE;
+    }
+    uint32_t count = 0;
+    if (enumerateDevices(instance, &count, nullptr) != VK_SUCCESS || count == 0) {
+        return VK_NULL_HANDLE;
+    }
+    std::vector<VkPhysicalDevice> devices(count);
+    if (enumerateDevices(instance, &count, devices.data()) != VK_SUCCESS) {
+        return VK_NULL_HANDLE;
+    }
+    devices.resize(count);
+    if (config.vulkanDeviceIndex >= 0) {
+        return static_cast<uint32_t>(config.vulkanDeviceIndex) < count ? devices[config.vulkanDeviceIndex] : VK_NULL_HANDLE;
+    }
+    if (!config.vulkanDeviceName.empty()) {
+        for (const VkPhysicalDevice device : devices) {
+            VkPhysicalDeviceProperties properties{};
+            getProperties(device, &properties);
+            if (std::strstr(properties.deviceName, config.vulkanDeviceName.c_str()) != nullptr) {
+                return device;
+            }
+        }
+        return VK_NULL_HANDLE;
+    }
+    return devices.front();
+}
+
+#define LOCK_RUNTIME()                    \
+    MockRuntime &rt = MockRuntime::Get(); \
+    std::lock_guard<std::mutex> lock(rt.mutex)
+
+#define CHECK_INSTANCE_AND_SYSTEM(handle, systemId)              \
+    if ((handle) == XR_NULL_HANDLE || (handle) != rt.instance) { \
+        return XR_ERROR_HANDLE_INVALID;                          \
+    }                                                            \
+    if ((systemId) != kMockSystemId) {                           \
+        return XR_ERROR_SYSTEM_INVALID;                          \
+    }
+
+XRAPI_ATTR XrResult XRAPI_CALL MockGetVulkanGraphicsRequirements2KHR(XrInstance instance, XrSystemId systemId,
+                                                                     XrGraphicsRequirementsVulkanKHR *graphicsRequirements) {
+    LOCK_RUNTIME();
+    CHECK_INSTANCE_AND_SYSTEM(instance, systemId);
+    if (graphicsRequirements == nullptr || graphicsRequirements->type != XR_TYPE_GRAPHICS_REQUIREMENTS_VULKAN2_KHR) {
+        return XR_ERROR_VALIDATION_FAILURE;
+    }
+    graphicsRequirements->minApiVersionSupported = XR_MAKE_VERSION(1, 0, 0);
+    graphicsRequirements->maxApiVersionSupported = XR_MAKE_VERSION(1, 3, 0);
+    rt.vulkanRequirementsQueried = true;
+    return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL MockCreateVulkanInstanceKHR(XrInstance instance, const XrVulkanInstanceCreateInfoKHR *createInfo,
+                                                           VkInstance *vulkanInstance, VkResult *vulkanResult) {
+    LOCK_RUNTIME();
+    if (createInfo == nullptr) {
+        return XR_ERROR_VALIDATION_FAILURE;
+    }
+    CHECK_INSTANCE_AND_SYSTEM(instance, createInfo->systemId);
+    if (createInfo->type != XR_TYPE_VULKAN_INSTANCE_CREATE_INFO_KHR || createInfo->createFlags != 0 ||
+        createInfo->pfnGetInstanceProcAddr == nullptr || createInfo->vulkanCreateInfo == nullptr || vulkanInstance == nullptr ||
+        vulkanResult == nullptr) {
+        return XR_ERROR_VALIDATION_FAILURE;
+    }
+    if (!rt.vulkanRequirementsQueried) {
+        return XR_ERROR_GRAPHICS_REQUIREMENTS_CALL_MISSING;
+    }
+    auto createInstance =
+        reinterpret_cast<PFN_vkCreateInstance>(createInfo->pfnGetInstanceProcAddr(VK_NULL_HANDLE, "vkCreateInstance"));
+    if (createInstance == nullptr) {
+        return XR_ERROR_RUNTIME_FAILURE;
+    }
+    // No Vulkan extensions are needed, images are never shared outside of the application's device.
+    *vulkanResult = createInstance(createInfo->vulkanCreateInfo, createInfo->vulkanAllocator, vulkanInstance);
+    if (*vulkanResult == VK_SUCCESS) {
+        rt.vulkanInstance = *vulkanInstance;
+        rt.vulkanGetInstanceProcAddr = createInfo->pfnGetInstanceProcAddr;
+    }
+    return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL MockGetVulkanGraphicsDevice2KHR(XrInstance instance, const XrVulkanGraphicsDeviceGetInfoKHR *getInfo,
+                                                               VkPhysicalDevice *vulkanPhysicalDevice) {
+    LOCK_RUNTIME();
+    if (getInfo == nullptr) {
+        return XR_ERROR_VALIDATION_FAILURE;
+    }
+    CHECK_INSTANCE_AND_SYSTEM(instance, getInfo->systemId);
+    if (getInfo->type != XR_TYPE_VULKAN_GRAPHICS_DEVICE_GET_INFO_KHR || getInfo->vulkanInstance == VK_NULL_HANDLE ||
+        vulkanPhysicalDevice == nullptr) {
+        return XR_ERROR_VALIDATION_FAILURE;
+    }
+    if (getInfo->vulkanInstance != rt.vulkanInstance || rt.vulkanGetInstanceProcAddr == nullptr) {
+        return XR_ERROR_GRAPHICS_DEVICE_INVALID;
+    }
+    *vulkanPhysicalDevice = SelectPhysicalDevice(rt.config, rt.vulkanInstance, rt.vulkanGetInstanceProcAddr);
+    if (*vulkanPhysicalDevice == VK_NULL_HANDLE) {
+        fprintf(stderr, "mock runtime: no Vulkan physical device matches the configuration\n");
+        return XR_ERROR_RUNTIME_FAILURE;
+    }
+    return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL MockCreateVulkanDeviceKHR(XrInstance instance, const XrVulkanDeviceCreateInfoKHR *createInfo,
+                                                         VkDevice *vulkanDevice, VkResult *vulkanResult) {
+    LOCK_RUNTIME();
+    if (createInfo == nullptr) {
+        return XR_ERROR_VALIDATION_FAILURE;
+    }
+    CHECK_INSTANCE_AND_SYSTEM(instance, createInfo->systemId);
+    if (createInfo->type != XR_TYPE_VULKAN_DEVICE_CREATE_INFO_KHR || createInfo->createFlags != 0 ||
+        createInfo->pfnGetInstanceProcAddr == nullptr || createInfo->vulkanPhysicalDevice == VK_NULL_HANDLE ||
+        createInfo->vulkanCreateInfo == nullptr || vulkanDevice == nullptr || vulkanResult == nullptr) {
+        return XR_ERROR_VALIDATION_FAILURE;
+    }
+    if (rt.vulkanInstance == VK_NULL_HANDLE) {
+        return XR_ERROR_GRAPHICS_DEVICE_INVALID;
+    }
+    auto createDevice =
+        reinterpret_cast<PFN_vkCreateDevice>(createInfo->pfnGetInstanceProcAddr(rt.vulkanInstance, "vkCreateDevice"));
+    if (createDevice == nullptr) {
+        return XR_ERROR_RUNTIME_FAILURE;
+    }
+    *vulkanResult = createDevice(createInfo->vulkanPhysicalDevice, createInfo->vulkanCreateInfo, createInfo->vulkanAllocator,
+                                 vulkanDevice);
+    return XR_SUCCESS;
+}
+
+#undef CHECK_INSTANCE_AND_SYSTEM
+#undef LOCK_RUNTIME
+
+struct DeviceFunctions {
+    PFN_vkCreateImage createImage = nullptr;
+    PFN_vkDestroyImage destroyImage = nullptr;
+    PFN_vkGetImageMemoryRequirements getImageMemoryRequirements = nullptr;
+    PFN_vkAllocateMemory allocateMemory = nullptr;
+    PFN_vkFreeMemory freeMemory = nullptr;
+    PFN_vkBindImageMemory bindImageMemory = nullptr;
+    PFN_vkGetPhysicalDeviceMemoryProperties getPhysicalDeviceMemoryProperties = nullptr;
+};
+
+bool LoadDeviceFunctions(const MockVulkanBinding &binding, DeviceFunctions &fns) {
+    auto getDeviceProcAddr =
+        reinterpret_cast<PFN_vkGetDeviceProcAddr>(binding.getInstanceProcAddr(binding.instance, "vkGetDeviceProcAddr"));
+    if (getDeviceProcAddr == nullptr) {
+        return false;
+    }
+    fns.createImage = reinterpret_cast<PFN_vkCreateImage>(getDeviceProcAddr(binding.device, "vkCreateImage"));
+    fns.destroyImage = reinterpret_cast<PFN_vkDestroyImage>(getDeviceProcAddr(binding.device, "vkDestroyImage"));
+    fns.getImageMemoryRequirements =
+        reinterpret_cast<PFN_vkGetImageMemoryRequirements>(getDeviceProcAddr(binding.device, "vkGetImageMemoryRequirements"));
+    fns.allocateMemory = reinterpret_cast<PFN_vkAllocateMemory>(getDeviceProcAddr(binding.device, "vkAllocateMemory"));
+    fns.freeMemory = reinterpret_cast<PFN_vkFreeMemory>(getDeviceProcAddr(binding.device, "vkFreeMemory"));
+    fns.bindImageMemory = reinterpret_cast<PFN_vkBindImageMemory>(getDeviceProcAddr(binding.device, "vkBindImageMemory"));
+    fns.getPhysicalDeviceMemoryProperties = reinterpret_cast<PFN_vkGetPhysicalDeviceMemoryProperties>(
+        binding.getInstanceProcAddr(binding.instance, "vkGetPhysicalDeviceMemoryProperties"));
+    return fns.createImage != nullptr && fns.destroyImage != nullptr && fns.getImageMemoryRequirements != nullptr &&
+           fns.allocateMemory != nullptr && fns.freeMemory != nullptr && fns.bindImageMemory != nullptr &&
+           fns.getPhysicalDeviceMemoryProperties != nullptr;
+}
+
+VkImageUsageFlags ToVulkanUsage(XrSwapchainUsageFlags usage) {
+    VkImageUsageFlags result = 0;
+    if (usage & XR_SWAPCHAIN_USAGE_COLOR_ATTACHMENT_BIT) result |= VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+    if (usage & XR_SWAPCHAIN_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT) result |= VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
+    if (usage & XR_SWAPCHAIN_USAGE_UNORDERED_ACCESS_BIT) result |= VK_IMAGE_USAGE_STORAGE_BIT;
+    if (usage & XR_SWAPCHAIN_USAGE_TRANSFER_SRC_BIT) result |= VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+    if (usage & XR_SWAPCHAIN_USAGE_TRANSFER_DST_BIT) result |= VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+    if (usage & XR_SWAPCHAIN_USAGE_SAMPLED_BIT) result |= VK_IMAGE_USAGE_SAMPLED_BIT;
+    if (usage & XR_SWAPCHAIN_USAGE_INPUT_ATTACHMENT_BIT_KHR) result |= VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT;
+    // The compositor would sample the images.
+    return result | VK_IMAGE_USAGE_SAMPLED_BIT;
+}
+
+}  // namespace
+
+XrResult MockVulkanGetInstanceProcAddr(const char *name, PFN_xrVoidFunction *function) {
+    struct Entry {
+        const char *name;
+        PFN_xrVoidFunction function;
+    };
+    static const Entry kFunctions[] = {
+        {"xrGetVulkanGraphicsRequirements2KHR", reinterpret_cast<PFN_xrVoidFunction>(&MockGetVulkanGraphicsRequirements2KHR)},
+        {"xrCreateVulkanInstanceKHR", reinterpret_cast<PFN_xrVoidFunction>(&MockCreateVulkanInstanceKHR)},
+        {"xrGetVulkanGraphicsDevice2KHR", reinterpret_cast<PFN_xrVoidFunction>(&MockGetVulkanGraphicsDevice2KHR)},
+        {"xrCreateVulkanDeviceKHR", reinterpret_cast<PFN_xrVoidFunction>(&MockCreateVulkanDeviceKHR)},
+    };
+    for (const Entry &entry : kFunctions) {
+        if (std::strcmp(entry.name, name) == 0) {
+            *function = entry.function;
+            return XR_SUCCESS;
+        }
+    }
+    return XR_ERROR_FUNCTION_UNSUPPORTED;
+}
+
+const std::vector<int64_t> &MockVulkanSwapchainFormats() {
+    static const std::vector<int64_t> kFormats = {VK_FORMAT_R8G8B8A8_SRGB, VK_FORMAT_B8G8R8A8_SRGB, VK_FORMAT_R8G8B8A8_UNORM,
+                                                  VK_FORMAT_B8G8R8A8_UNORM};
+    return kFormats;
+}
+
+XrResult MockVulkanCreateSwapchainImages(const MockVulkanBinding &binding, MockSwapchain &swapchain) {
+    DeviceFunctions fns;
+    if (!LoadDeviceFunctions(binding, fns)) {
+        return XR_ERROR_RUNTIME_FAILURE;
+    }
+    VkPhysicalDeviceMemoryProperties memoryProperties{};
+    fns.getPhysicalDeviceMemoryProperties(binding.physicalDevice, &memoryProperties);
+
+    const XrSwapchainCreateInfo &info = swapchain.createInfo;
+    VkImageCreateInfo imageInfo{VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO};
+    imageInfo.imageType = VK_IMAGE_TYPE_2D;
+    imageInfo.format = static_cast<VkFormat>(info.format);
+    imageInfo.extent = {info.width, info.height, 1};
+    imageInfo.mipLevels = info.mipCount;
+    imageInfo.arrayLayers = info.arraySize;
+    imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+    imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+    imageInfo.usage = ToVulkanUsage(info.usageFlags);
+    imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+    swapchain.vulkanImages.reserve(swapchain.imageCount);
+    for (uint32_t i = 0; i < swapchain.imageCount; ++i) {
+        MockVulkanImage image;
+        if (fns.createImage(binding.device, &imageInfo, nullptr, &image.image) != VK_SUCCESS) {
+            MockVulkanDestroySwapchainImages(binding, swapchain);
+            return XR_ERROR_RUNTIME_FAILURE;
+        }
+        VkMemoryRequirements requirements{};
+        fns.getImageMemoryRequirements(binding.device, image.image, &requirements);
+        uint32_t typeIndex = memoryProperties.memoryTypeCount;
+        for (uint32_t t = 0; t < memoryProperties.memoryTypeCount; ++t) {
+            const bool allowed = (requirements.memoryTypeBits & (1u << t)) != 0;
+            const bool deviceLocal = (memoryProperties.memoryTypes[t].propertyFlags & VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT) != 0;
+            if (allowed && (deviceLocal || typeIndex == memoryProperties.memoryTypeCount)) {
+                typeIndex = t;
+                if (deviceLocal) {
+                    break;
+                }
+            }
+        }
+        VkMemoryAllocateInfo allocateInfo{VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO};
+        allocateInfo.allocationSize = requirements.size;
+        allocateInfo.memoryTypeIndex = typeIndex;
+        if (typeIndex == memoryProperties.memoryTypeCount ||
+            fns.allocateMemory(binding.device, &allocateInfo, nullptr, &image.memory) != VK_SUCCESS ||
+            fns.bindImageMemory(binding.device, image.image, image.memory, 0) != VK_SUCCESS) {
+            swapchain.vulkanImages.push_back(image);
+            MockVulkanDestroySwapchainImages(binding, swapchain);
+            return XR_ERROR_OUT_OF_MEMORY;
+        }
+        swapchain.vulkanImages.push_back(image);
+    }
+    return XR_SUCCESS;
+}
+
+void MockVulkanDestroySwapchainImages(const MockVulkanBinding &binding, MockSwapchain &swapchain) {
+    DeviceFunctions fns;
+    if (swapchain.vulkanImages.empty() || !LoadDeviceFunctions(binding, fns)) {
+        return;
+    }
+    // The application must not destroy a swapchain while its images are in use on the GPU.
+    for (const MockVulkanImage &image : swapchain.vulkanImages) {
+        if (image.image != VK_NULL_HANDLE) {
+            fns.destroyImage(binding.device, image.image, nullptr);
+        }
+        if (image.memory != VK_NULL_HANDLE) {
+            fns.freeMemory(binding.device, image.memory, nullptr);
+        }
+    }
+    swapchain.vulkanImages.clear();
+}
+
+#endif  // XR_USE_GRAPHICS_API_VULKAN
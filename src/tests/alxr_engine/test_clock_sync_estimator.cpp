@@ -0,0 +1,105 @@
+#include "pch.h"
+#include "clock_sync_estimator.h"
+#include "test_common.h"
+#include <random>
+
+using ALXR::ClockSyncEstimator;
+
+namespace {
+
+// Synthetic time sync round trips: the server clock runs offsetUs(t) ahead of the client clock, each
+// direction takes a base one way delay plus random queueing delay.
+struct SyncTrace {
+    std::int64_t  offsetUs = 0;
+    double        driftPpm = 0.0;
+    std::uint64_t oneWayUs = 1'000;
+    std::uint64_t maxQueueUs = 4'000;
+    std::uint64_t intervalUs = 100'000;
+    std::uint64_t startUs = 10'000'000;
+
+    std::mt19937_64 rng{ 1234 };
+
+    std::int64_t OffsetAt(const std::uint64_t clientTimeUs) const {
+        return offsetUs + static_cast<std::int64_t>(driftPpm * 1e-6 * static_cast<double>(clientTimeUs - startUs));
+    }
+
+    // Feeds samples for durationUs of client time and returns the client time reached. A non zero
+    // spikeEvery adds spikeUs to the server timestamp of every spikeEvery-th sample.
+    std::uint64_t Run(ClockSyncEstimator& estimator, const std::uint64_t fromUs, const std::uint64_t durationUs,
+                      const std::uint32_t spikeEvery = 0, const std::int64_t spikeUs = 0) {
+        std::uniform_int_distribution<std::uint64_t> queueDist(0, maxQueueUs);
+        std::uint64_t clientSendUs = fromUs;
+        for (std::uint32_t idx = 0; clientSendUs < fromUs + durationUs; ++idx, clientSendUs += intervalUs) {
+            const std::uint64_t forwardUs = oneWayUs + queueDist(rng);
+            const std::uint64_t backwardUs = oneWayUs + queueDist(rng);
+            std::int64_t serverTimeUs = static_cast<std::int64_t>(clientSendUs + forwardUs) + OffsetAt(clientSendUs + forwardUs);
+            if (spikeEvery != 0 && idx % spikeEvery == spikeEvery - 1)
+                serverTimeUs += spikeUs;
+            estimator.AddSample(clientSendUs, static_cast<std::uint64_t>(serverTimeUs), clientSendUs + forwardUs + backwardUs);
+        }
+        return clientSendUs;
+    }
+};
+
+void TestStableOffset()
+{
+    ClockSyncEstimator estimator;
+    SyncTrace trace{ .offsetUs = -250'000 };
+    const std::uint64_t endUs = trace.Run(estimator, trace.startUs, 60'000'000);
+    const auto estimate = estimator.GetEstimate(endUs);
+    TEST_CHECK(std::abs(estimate.offsetUs - trace.OffsetAt(endUs)) < 500);
+    TEST_CHECK(std::abs(estimate.driftPpm) < 20.0);
+    TEST_CHECK(estimate.sampleCount > 0 && estimate.confidence > 0.0f);
+}
+
+void TestDrift()
+{
+    ClockSyncEstimator estimator;
+    SyncTrace trace{ .offsetUs = 40'000, .driftPpm = 100.0 };
+    const std::uint64_t endUs = trace.Run(estimator, trace.startUs, 120'000'000);
+    const auto estimate = estimator.GetEstimate(endUs);
+    TEST_CHECK(std::abs(estimate.driftPpm - trace.driftPpm) < 20.0);
+    TEST_CHECK(std::abs(estimate.offsetUs - trace.OffsetAt(endUs)) < 500);
+    // extrapolated between syncs.
+    const std::uint64_t laterUs = endUs + 2'000'000;
+    TEST_CHECK(std::abs(estimator.OffsetAt(laterUs) - trace.OffsetAt(laterUs)) < 600);
+}
+
+void TestSpikes()
+{
+    ClockSyncEstimator estimator;
+    SyncTrace trace{ .offsetUs = 5'000, .maxQueueUs = 500, .intervalUs = 1'000'000 };
+    // every 7th second a sample with a low RTT but a wrong server timestamp, e.g. a server side stall.
+    const std::uint64_t endUs = trace.Run(estimator, trace.startUs, 60'000'000, 7, 30'000);
+    const auto estimate = estimator.GetEstimate(endUs);
+    TEST_CHECK(std::abs(estimate.offsetUs - trace.OffsetAt(endUs)) < 500);
+    TEST_CHECK(estimate.rejectedCount > 0);
+
+    // RTT spikes: a burst of heavily queued round trips does not move the estimate.
+    SyncTrace congested = trace;
+    congested.maxQueueUs = 50'000;
+    congested.oneWayUs = 20'000;
+    const std::uint64_t congestedEndUs = congested.Run(estimator, endUs, 5'000'000);
+    TEST_CHECK(std::abs(estimator.OffsetAt(congestedEndUs) - trace.OffsetAt(congestedEndUs)) < 500);
+}
+
+void TestReset()
+{
+    ClockSyncEstimator estimator;
+    SyncTrace trace{ .offsetUs = 1'000'000 };
+    const std::uint64_t endUs = trace.Run(estimator, trace.startUs, 10'000'000);
+    estimator.Reset();
+    TEST_CHECK(estimator.GetEstimate(endUs).sampleCount == 0);
+    TEST_CHECK(estimator.OffsetAt(endUs) == 0);
+
+    // the samples before the reset are not mixed into the new fit.
+    SyncTrace next{ .offsetUs = -3'000'000, .startUs = endUs };
+    const std::uint64_t nextEndUs = next.Run(estimator, endUs, 10'000'000);
+    TEST_CHECK(std::abs(estimator.OffsetAt(nextEndUs) - next.OffsetAt(nextEndUs)) < 500);
+}
+}
+
+int main()
+{
+    return ALXR::Test::RunTests(TestStableOffset, TestDrift, TestSpikes, TestReset);
+}
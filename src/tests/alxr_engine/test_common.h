@@ -0,0 +1,30 @@
+#pragma once
+#ifndef ALXR_TEST_COMMON_H
+#define ALXR_TEST_COMMON_H
+
+#include <cstdio>
+
+namespace ALXR::Test {
+
+inline int g_failureCount = 0;
+
+inline void Check(const bool passed, const char* const expr, const char* const file, const int line) {
+    if (passed)
+        return;
+    ++g_failureCount;
+    std::fprintf(stderr, "%s:%d: check failed: %s\n", file, line, expr);
+}
+
+// Runs each test case and returns the process exit code, non-zero if any check failed.
+template < typename... TestFns >
+inline int RunTests(TestFns&&... testFns) {
+    (testFns(), ...);
+    if (g_failureCount != 0)
+        std::fprintf(stderr, "%d check(s) failed\n", g_failureCount);
+    return g_failureCount == 0 ? 0 : 1;
+}
+}
+
+#define TEST_CHECK(expr) ALXR::Test::Check(static_cast<bool>(expr), #expr, __FILE__, __LINE__)
+
+#endif
@@ -0,0 +1,137 @@
+#include "pch.h"
+#include "common.h"
+#include "event_reaction_worker.h"
+#include "test_common.h"
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <stdexcept>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+using ALXR::EventReactionWorker;
+using namespace std::chrono_literals;
+
+namespace {
+
+// Applies finished reactions until count have been applied, false if that takes more than a few seconds.
+bool ApplyUntil(EventReactionWorker& worker, const std::size_t count)
+{
+    std::size_t appliedCount = 0;
+    for (int attempt = 0; attempt < 5000 && appliedCount < count; ++attempt) {
+        appliedCount += worker.ApplyCompleted();
+        if (appliedCount < count)
+            std::this_thread::sleep_for(1ms);
+    }
+    return appliedCount == count;
+}
+
+void TestAppliesInSubmissionOrderOnCaller()
+{
+    EventReactionWorker worker;
+    const std::thread::id renderThread = std::this_thread::get_id();
+    std::vector<int> applied;
+    std::atomic<int> workedOnRenderThread{ 0 };
+    bool appliedOffRenderThread = false;
+    for (int reaction = 0; reaction < 8; ++reaction) {
+        worker.Submit("test", [&, reaction]() -> EventReactionWorker::ApplyFn {
+            if (std::this_thread::get_id() == renderThread)
+                ++workedOnRenderThread;
+            return [&, reaction]() {
+                appliedOffRenderThread |= std::this_thread::get_id() != renderThread;
+                applied.push_back(reaction);
+            };
+        });
+    }
+    TEST_CHECK(worker.PendingCount() == 8);
+    TEST_CHECK(ApplyUntil(worker, 8));
+    TEST_CHECK((applied == std::vector<int>{ 0, 1, 2, 3, 4, 5, 6, 7 }));
+    TEST_CHECK(workedOnRenderThread == 0);
+    TEST_CHECK(!appliedOffRenderThread);
+    TEST_CHECK(worker.PendingCount() == 0);
+}
+
+void TestUnfinishedReactionHoldsBackLaterOnes()
+{
+    EventReactionWorker worker;
+    std::promise<void> release;
+    std::shared_future<void> released = release.get_future().share();
+    std::vector<int> applied;
+    worker.Submit("blocked", [&, released]() -> EventReactionWorker::ApplyFn {
+        released.wait();
+        return [&]() { applied.push_back(0); };
+    });
+    worker.Submit("second", [&]() -> EventReactionWorker::ApplyFn {
+        return [&]() { applied.push_back(1); };
+    });
+    // without an apply function, still counted as applied.
+    worker.Submit("no result", [&]() -> EventReactionWorker::ApplyFn { return {}; });
+
+    TEST_CHECK(worker.ApplyCompleted() == 0);
+    TEST_CHECK(applied.empty());
+    TEST_CHECK(worker.PendingCount() == 3);
+
+    release.set_value();
+    TEST_CHECK(ApplyUntil(worker, 3));
+    TEST_CHECK((applied == std::vector<int>{ 0, 1 }));
+}
+
+void TestWorkExceptionRethrownOnApply()
+{
+    EventReactionWorker worker;
+    bool laterApplied = false;
+    worker.Submit("throws", []() -> EventReactionWorker::ApplyFn { throw std::runtime_error("work failed"); });
+    worker.Submit("later", [&]() -> EventReactionWorker::ApplyFn { return [&]() { laterApplied = true; }; });
+
+    bool rethrown = false;
+    for (int attempt = 0; attempt < 5000 && !rethrown; ++attempt) {
+        try {
+            worker.ApplyCompleted();
+            std::this_thread::sleep_for(1ms);
+        } catch (const std::runtime_error& error) {
+            rethrown = std::string_view{ error.what() } == "work failed";
+        }
+    }
+    TEST_CHECK(rethrown);
+    // the failed reaction is consumed, the later one is applied by the next call.
+    TEST_CHECK(!laterApplied);
+    TEST_CHECK(ApplyUntil(worker, 1));
+    TEST_CHECK(laterApplied);
+}
+
+void TestStopRunsPendingWorkAndDropsResults()
+{
+    EventReactionWorker worker;
+    std::atomic<int> worked{ 0 };
+    bool applied = false;
+    for (int reaction = 0; reaction < 4; ++reaction) {
+        worker.Submit("test", [&]() -> EventReactionWorker::ApplyFn {
+            std::this_thread::sleep_for(1ms);
+            ++worked;
+            return [&]() { applied = true; };
+        });
+    }
+    worker.Stop();
+    TEST_CHECK(worked == 4);
+    TEST_CHECK(worker.PendingCount() == 0);
+    TEST_CHECK(worker.ApplyCompleted() == 0);
+    TEST_CHECK(!applied);
+
+    // a submit after Stop starts the worker again.
+    worker.Submit("restart", [&]() -> EventReactionWorker::ApplyFn { return [&]() { applied = true; }; });
+    TEST_CHECK(ApplyUntil(worker, 1));
+    TEST_CHECK(applied);
+}
+}
+
+int main()
+{
+    return ALXR::Test::RunTests(
+        TestAppliesInSubmissionOrderOnCaller,
+        TestUnfinishedReactionHoldsBackLaterOnes,
+        TestWorkExceptionRethrownOnApply,
+        TestStopRunsPendingWorkAndDropsResults
+    );
+}
@@ -0,0 +1,77 @@
+#include "pch.h"
+#include "foveation.h"
+#include "test_common.h"
+
+namespace {
+
+struct FoveationConfig {
+    XrVector2f eyeSize;
+    XrVector2f centerSize;
+    XrVector2f centerShift;
+    XrVector2f edgeRatio;
+};
+
+constexpr const FoveationConfig Configs[] = {
+    { { 1832, 1920 }, { 0.4f, 0.35f }, { 0.4f, 0.1f }, { 4.f, 5.f } },
+    { { 2064, 2208 }, { 0.6f, 0.6f },  { 0.0f, 0.0f }, { 2.f, 2.f } },
+    { { 1440, 1584 }, { 0.3f, 0.3f },  { 0.8f, 0.5f }, { 6.f, 6.f } },
+};
+
+// Largest absolute uv difference between the lookup table and the analytic decode, evaluated on a
+// samplesPerAxis^2 grid over the full (both eyes) video texture.
+float LUTMaxError(const ALXR::FoveatedDecodeLUT& lut, const ALXR::FoveatedDecodeParams& fp, const std::uint32_t samplesPerAxis)
+{
+    float maxError = 0.0f;
+    for (std::uint32_t y = 0; y < samplesPerAxis; ++y) {
+        for (std::uint32_t x = 0; x < samplesPerAxis; ++x) {
+            const XrVector2f uv{ (x + 0.5f) / samplesPerAxis, (y + 0.5f) / samplesPerAxis };
+            const bool isRightEye = uv.x > 0.5f;
+            const auto expected = ALXR::DecodeFoveationUV(fp, uv, isRightEye);
+            const auto actual   = lut.DecodeFoveationUV(uv, isRightEye);
+            maxError = std::max({ maxError, std::abs(expected.x - actual.x), std::abs(expected.y - actual.y) });
+        }
+    }
+    return maxError;
+}
+
+// The default 512x512 table stays well under half a source texel of the largest eye size.
+void TestLUTMaxError()
+{
+    for (const auto& config : Configs) {
+        const auto fp = ALXR::MakeFoveatedDecodeParams(config.eyeSize, config.centerSize, config.centerShift, config.edgeRatio);
+        const auto lut = ALXR::MakeFoveatedDecodeLUT(fp);
+        TEST_CHECK(lut.width == 512 && lut.height == 512 && lut.texels.size() == 512 * 512);
+        const float maxError = LUTMaxError(lut, fp, 1024);
+        std::printf("eye %gx%g: max uv error %g\n", config.eyeSize.x, config.eyeSize.y, maxError);
+        TEST_CHECK(maxError < 0.5f / config.eyeSize.x && maxError < 0.5f / config.eyeSize.y);
+    }
+}
+
+// The decode maps the compressed frame onto the whole eye: monotonic along each axis and the
+// right eye mirrors the left.
+void TestDecodeShape()
+{
+    for (const auto& config : Configs) {
+        const auto fp = ALXR::MakeFoveatedDecodeParams(config.eyeSize, config.centerSize, config.centerShift, config.edgeRatio);
+        float prevX = -1.0f, prevY = -1.0f;
+        bool monotonic = true;
+        for (std::uint32_t idx = 0; idx <= 256; ++idx) {
+            const float t = idx / 256.0f;
+            const auto decoded = ALXR::DecodeFoveationEyeUV(fp, { t, t });
+            monotonic = monotonic && decoded.x >= prevX && decoded.y >= prevY;
+            prevX = decoded.x;
+            prevY = decoded.y;
+        }
+        TEST_CHECK(monotonic);
+
+        const auto left  = ALXR::DecodeFoveationUV(fp, { 0.1f, 0.3f }, false);
+        const auto right = ALXR::DecodeFoveationUV(fp, { 0.9f, 0.3f }, true);
+        TEST_CHECK(std::abs(left.x - (1.0f - right.x)) < 1e-6f && std::abs(left.y - right.y) < 1e-6f);
+    }
+}
+}
+
+int main()
+{
+    return ALXR::Test::RunTests(TestLUTMaxError, TestDecodeShape);
+}
@@ -0,0 +1,90 @@
+#include "pch.h"
+#include "alloc_counter.h"
+#include "test_common.h"
+
+#include <memory>
+#include <optional>
+
+using ALXR::FrameAllocStats;
+
+namespace {
+
+// Keeps the test allocations from being elided.
+std::unique_ptr<int> g_lastAllocation{};
+
+// A frame of the render loop, allocating allocCount times and optionally logging at logLevel.
+std::uint64_t RunFrame(FrameAllocStats& stats, const std::uint64_t allocCount, const std::optional<Log::Level> logLevel = {})
+{
+    stats.BeginFrame();
+    for (std::uint64_t i = 0; i < allocCount; ++i)
+        g_lastAllocation = std::make_unique<int>(static_cast<int>(i));
+    if (logLevel)
+        Log::Write(*logLevel, "frame log");
+    return stats.EndFrame();
+}
+
+void TestCountsAllocations()
+{
+    static_assert(ALXR::AllocCounter::Enabled);
+    const std::uint64_t before = ALXR::AllocCounter::ThreadAllocations();
+    g_lastAllocation = std::make_unique<int>(1);
+    g_lastAllocation = std::make_unique<int>(2);
+    TEST_CHECK(ALXR::AllocCounter::ThreadAllocations() - before == 2);
+}
+
+void TestWarmupFramesMayAllocate()
+{
+    FrameAllocStats stats;
+    for (std::uint64_t frame = 0; frame < FrameAllocStats::WarmupFrameCount; ++frame)
+        TEST_CHECK(RunFrame(stats, 1) == 0);
+    TEST_CHECK(stats.allocFrameCount == FrameAllocStats::WarmupFrameCount);
+    TEST_CHECK(stats.steadyAllocFrameCount == 0);
+
+    TEST_CHECK(RunFrame(stats, 0) == 0);
+    TEST_CHECK(RunFrame(stats, 3) == 3);
+    TEST_CHECK(stats.steadyAllocFrameCount == 1);
+    TEST_CHECK(stats.allocCount == FrameAllocStats::WarmupFrameCount + 3);
+    TEST_CHECK(stats.maxFrameAllocCount == 3);
+}
+
+void TestLoggingFramesMayAllocate()
+{
+    Log::SetLevel(Log::Level::Info);
+    FrameAllocStats stats;
+    for (std::uint64_t frame = 0; frame < FrameAllocStats::WarmupFrameCount; ++frame)
+        RunFrame(stats, 0);
+    TEST_CHECK(RunFrame(stats, 2, Log::Level::Warning) == 0);
+    TEST_CHECK(RunFrame(stats, 2) == 2);
+    // a message filtered out by the level is not written, the frame's allocations still count.
+    TEST_CHECK(RunFrame(stats, 2, Log::Level::Verbose) == 2);
+    TEST_CHECK(stats.steadyAllocFrameCount == 2);
+}
+
+void TestRewarm()
+{
+    FrameAllocStats stats;
+    for (std::uint64_t frame = 0; frame < FrameAllocStats::WarmupFrameCount; ++frame)
+        RunFrame(stats, 0);
+    stats.Rewarm();
+    TEST_CHECK(RunFrame(stats, 1) == 0);
+
+    // a reset of the counts does not restart or end the warm up.
+    stats.Reset();
+    TEST_CHECK(stats.frameCount == 0);
+    for (std::uint64_t frame = 1; frame < FrameAllocStats::WarmupFrameCount; ++frame)
+        TEST_CHECK(RunFrame(stats, 1) == 0);
+    TEST_CHECK(RunFrame(stats, 1) == 1);
+    stats.Reset();
+    TEST_CHECK(RunFrame(stats, 1) == 1);
+}
+}
+
+int main()
+{
+    return ALXR::Test::RunTests(
+        TestCountsAllocations,
+        TestWarmupFramesMayAllocate,
+        TestLoggingFramesMayAllocate,
+        TestRewarm
+    );
+}
@@ -0,0 +1,86 @@
+#include "alxr_engine.h"
+#include "test_common.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <string_view>
+
+// Runs the real Lobby render loop of the engine (Vulkan graphics plugin) against the mock runtime and checks
+// no steady state frame allocated, see FrameAllocStats. Needs a Vulkan device, e.g. lavapipe, otherwise skipped.
+
+namespace {
+
+constexpr const std::uint64_t WarmupFrameCount = 90; // FrameAllocStats::WarmupFrameCount
+constexpr const std::uint64_t SteadyFrameCount = 600;
+constexpr const std::uint64_t MaxProcessFrameCalls = 10'000;
+constexpr const int SkipReturnCode = 77;
+
+void SetEnvIfUnset(const char* const name, const char* const value) {
+#ifdef _WIN32
+    if (std::getenv(name) == nullptr)
+        _putenv_s(name, value);
+#else
+    setenv(name, value, /*overwrite*/ 0);
+#endif
+}
+
+// The ALVR client callbacks, no server is connected.
+void InputSend(const TrackingInfo*) {}
+void ViewsConfigSend(const ALXREyeInfo*) {}
+void RequestIDR() {}
+std::uint64_t PathStringToHash(const char* const path) {
+    return std::hash<std::string_view>{}(path);
+}
+
+ALXRFrameAllocStats g_lobbyStats{};
+
+void TestLobbyFramesDoNotAllocate()
+{
+    TEST_CHECK(g_lobbyStats.frameCount >= WarmupFrameCount + SteadyFrameCount);
+    TEST_CHECK(g_lobbyStats.steadyAllocFrameCount == 0);
+    std::printf("Lobby: %llu frames, %llu allocated (%llu in steady state), %llu allocations, max %llu per frame\n",
+        static_cast<unsigned long long>(g_lobbyStats.frameCount),
+        static_cast<unsigned long long>(g_lobbyStats.allocFrameCount),
+        static_cast<unsigned long long>(g_lobbyStats.steadyAllocFrameCount),
+        static_cast<unsigned long long>(g_lobbyStats.allocCount),
+        static_cast<unsigned long long>(g_lobbyStats.maxFrameAllocCount));
+}
+}
+
+int main()
+{
+    SetEnvIfUnset("XR_RUNTIME_JSON", MOCK_RUNTIME_JSON);
+
+    ALXRClientCtx ctx{};
+    ctx.inputSend = &InputSend;
+    ctx.viewsConfigSend = &ViewsConfigSend;
+    ctx.pathStringToHash = &PathStringToHash;
+    ctx.requestIDR = &RequestIDR;
+    ctx.graphicsApi = ALXRGraphicsApi::Vulkan2;
+    ctx.decoderType = ALXRDecoderType::VAAPI;
+    ctx.displayColorSpace = ALXRColorSpace::Default;
+    ctx.noFTServer = true;
+    ctx.noPassthrough = true;
+    ALXRSystemProperties systemProperties{};
+    if (!alxr_init(&ctx, &systemProperties)) {
+        std::fprintf(stderr, "alxr_init failed, no Vulkan device? skipped\n");
+        return SkipReturnCode;
+    }
+
+    bool exitRenderLoop = false;
+    bool requestRestart = false;
+    for (std::uint64_t call = 0; call < MaxProcessFrameCalls && !exitRenderLoop; ++call) {
+        alxr_process_frame(&exitRenderLoop, &requestRestart);
+        if (!alxr_get_frame_alloc_stats(/*videoStream*/ false, &g_lobbyStats)) {
+            std::fprintf(stderr, "engine built without ENABLE_FRAME_ALLOC_COUNTER\n");
+            alxr_destroy();
+            return 1;
+        }
+        if (g_lobbyStats.frameCount >= WarmupFrameCount + SteadyFrameCount)
+            break;
+    }
+    alxr_destroy();
+    return ALXR::Test::RunTests(TestLobbyFramesDoNotAllocate);
+}
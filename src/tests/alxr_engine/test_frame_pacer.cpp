@@ -0,0 +1,119 @@
+#include "pch.h"
+#include "frame_pacer.h"
+#include "test_common.h"
+
+using ALXR::FramePacer;
+using ALXR::FramePacerTimer;
+using namespace std::chrono_literals;
+
+namespace {
+
+// Fake clock: time only moves when the pacer sleeps (landing OverSleep after the target) or yields (one Tick).
+constexpr const FramePacer::nanoseconds Tick{ 1'000 };
+FramePacer::time_point g_now{ 1s };
+FramePacer::nanoseconds g_overSleep{ 0 };
+std::uint64_t g_sleepCount = 0;
+
+FramePacer MakeFakePacer(const FramePacer::nanoseconds period, const FramePacer::nanoseconds overSleep = {})
+{
+    g_now = FramePacer::time_point{ 1s };
+    g_overSleep = overSleep;
+    g_sleepCount = 0;
+    FramePacer pacer{ FramePacerTimer {
+        .now        = [] { return g_now; },
+        .sleepUntil = [](const FramePacer::time_point target) { ++g_sleepCount; g_now = std::max(g_now, target + g_overSleep); },
+        .yield      = [] { g_now += Tick; },
+    }};
+    pacer.SetPeriod(period);
+    return pacer;
+}
+
+void TestDeadlinesKeepPhase()
+{
+    constexpr const FramePacer::nanoseconds Period{ 2'000'000 };
+    FramePacer pacer = MakeFakePacer(Period);
+
+    // the first call starts the phase and returns immediately.
+    const FramePacer::time_point first = pacer.WaitNext();
+    TEST_CHECK(first == g_now);
+    for (std::int64_t frame = 1; frame <= 100; ++frame) {
+        g_now += 100us; // frame work
+        const FramePacer::time_point deadline = pacer.WaitNext();
+        TEST_CHECK(deadline == first + frame * Period);
+        TEST_CHECK(g_now - deadline < Tick);
+    }
+    const FramePacer::Stats stats = pacer.GetStats();
+    TEST_CHECK(stats.frameCount == 100);
+    TEST_CHECK(stats.missedDeadlines == 0);
+    TEST_CHECK(stats.maxErrorUs < 1.0);
+    TEST_CHECK(g_sleepCount == 100);
+    // no oversleep, the margin decays towards the minimum.
+    TEST_CHECK(stats.spinMarginUs < 60.0);
+}
+
+void TestLateCallerSkipsMissedDeadlines()
+{
+    constexpr const FramePacer::nanoseconds Period{ 1'000'000 };
+    FramePacer pacer = MakeFakePacer(Period);
+
+    const FramePacer::time_point first = pacer.WaitNext();
+    g_now += 3500us;
+    // deadlines 1 and 2 are more than a period behind and skipped, deadline 3 is late by half a period.
+    TEST_CHECK(pacer.WaitNext() == first + 3 * Period);
+    TEST_CHECK(g_sleepCount == 0);
+    TEST_CHECK(pacer.WaitNext() == first + 4 * Period);
+
+    const FramePacer::Stats stats = pacer.GetStats();
+    TEST_CHECK(stats.frameCount == 2);
+    TEST_CHECK(stats.missedDeadlines == 2);
+    TEST_CHECK(stats.maxErrorUs == 500.0);
+}
+
+void TestSpinMarginAdaptsToOverSleep()
+{
+    FramePacer pacer = MakeFakePacer(FramePacer::nanoseconds{ 10'000'000 }, 300us);
+    pacer.WaitNext();
+    pacer.WaitNext();
+    // woke 200us before the deadline with the initial 500us margin and spun the rest, margin grows to 2x oversleep.
+    TEST_CHECK(pacer.GetStats().maxErrorUs < 1.0);
+    TEST_CHECK(pacer.GetStats().spinMarginUs == 600.0);
+
+    // an oversleep past the margin is a late wake up, the margin is clamped to the maximum.
+    g_overSleep = 3ms;
+    pacer.WaitNext();
+    TEST_CHECK(pacer.GetStats().maxErrorUs == 2400.0);
+    TEST_CHECK(pacer.GetStats().spinMarginUs == 2000.0);
+}
+
+void TestSetPeriodKeepsPhase()
+{
+    FramePacer pacer = MakeFakePacer(FramePacer::nanoseconds{ 1'000'000 });
+    const FramePacer::time_point first = pacer.WaitNext();
+    pacer.WaitNext();
+    pacer.SetPeriod(FramePacer::nanoseconds{ 2'000'000 });
+    TEST_CHECK(pacer.WaitNext() - first == FramePacer::nanoseconds{ 3'000'000 });
+}
+
+void TestReset()
+{
+    FramePacer pacer = MakeFakePacer(FramePacer::nanoseconds{ 1'000'000 });
+    pacer.WaitNext();
+    pacer.WaitNext();
+    g_now += 100us;
+    pacer.Reset();
+    const FramePacer::time_point now = g_now;
+    TEST_CHECK(pacer.WaitNext() == now);
+    TEST_CHECK(pacer.WaitNext() == now + FramePacer::nanoseconds{ 1'000'000 });
+}
+}
+
+int main()
+{
+    return ALXR::Test::RunTests(
+        TestDeadlinesKeepPhase,
+        TestLateCallerSkipsMissedDeadlines,
+        TestSpinMarginAdaptsToOverSleep,
+        TestSetPeriodKeepsPhase,
+        TestReset
+    );
+}
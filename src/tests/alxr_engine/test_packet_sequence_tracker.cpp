@@ -0,0 +1,155 @@
+#include "pch.h"
+#include "packet_sequence_tracker.h"
+#include "test_common.h"
+
+using ALXR::PacketSequenceTracker;
+
+namespace {
+
+// Processes [from, to), skipping the counters in skip, and returns the packets declared lost.
+template < std::size_t N = 0 >
+std::uint64_t ProcessRange
+(
+    PacketSequenceTracker& tracker,
+    const std::uint32_t from, const std::uint32_t to,
+    const std::array<std::uint32_t, N>& skip = {},
+    std::vector<PacketSequenceTracker::LostRange>* lostRanges = nullptr
+)
+{
+    std::uint64_t lostCount = 0;
+    for (std::uint32_t seq = from; seq != to; ++seq) {
+        if (std::find(skip.begin(), skip.end(), seq) != skip.end())
+            continue;
+        for (const auto& range : tracker.Process(seq)) {
+            lostCount += std::uint64_t(range.to - range.from) + 1;
+            if (lostRanges)
+                lostRanges->push_back(range);
+        }
+    }
+    return lostCount;
+}
+
+void TestInOrder()
+{
+    PacketSequenceTracker tracker;
+    TEST_CHECK(ProcessRange(tracker, 0, 5000) == 0);
+    const auto& counters = tracker.GetCounters();
+    TEST_CHECK(counters.lost == 0 && counters.reordered == 0 && counters.duplicated == 0 && counters.late == 0);
+}
+
+void TestReorder()
+{
+    PacketSequenceTracker tracker;
+    ProcessRange(tracker, 0, 10);
+    // 10 and 11 swapped, 20 arrives ReorderDepth - 1 packets late.
+    tracker.Process(11);
+    tracker.Process(10);
+    ProcessRange(tracker, 12, 20 + PacketSequenceTracker::ReorderDepth - 1, std::array<std::uint32_t, 1>{ 20 });
+    tracker.Process(20);
+    TEST_CHECK(ProcessRange(tracker, 20 + PacketSequenceTracker::ReorderDepth - 1, 1000) == 0);
+    const auto& counters = tracker.GetCounters();
+    TEST_CHECK(counters.reordered == 2);
+    TEST_CHECK(counters.lost == 0 && counters.late == 0 && counters.duplicated == 0);
+}
+
+void TestDuplicate()
+{
+    PacketSequenceTracker tracker;
+    ProcessRange(tracker, 0, 100);
+    tracker.Process(99);
+    tracker.Process(50);
+    TEST_CHECK(tracker.Process(99).empty());
+    ProcessRange(tracker, 100, 300);
+    const auto& counters = tracker.GetCounters();
+    TEST_CHECK(counters.duplicated == 3);
+    TEST_CHECK(counters.lost == 0 && counters.reordered == 0 && counters.late == 0);
+}
+
+void TestLossAndLate()
+{
+    PacketSequenceTracker tracker;
+    std::vector<PacketSequenceTracker::LostRange> lostRanges;
+    const std::array<std::uint32_t, 4> skip{ 10, 11, 12, 40 };
+    TEST_CHECK(ProcessRange(tracker, 0, 500, skip, &lostRanges) == 4);
+    // declared one at a time as the highest counter moves ReorderDepth past each of them.
+    TEST_CHECK(lostRanges.size() == skip.size());
+    for (std::size_t idx = 0; idx < std::min(lostRanges.size(), skip.size()); ++idx)
+        TEST_CHECK(lostRanges[idx].from == skip[idx] && lostRanges[idx].to == skip[idx]);
+
+    // declared lost, still recognised when it turns up.
+    TEST_CHECK(tracker.Process(11).empty());
+    // older than the whole window.
+    TEST_CHECK(tracker.Process(500 - PacketSequenceTracker::Window - 10).empty());
+    const auto& counters = tracker.GetCounters();
+    TEST_CHECK(counters.late == 2);
+    TEST_CHECK(counters.lost == 4 && counters.reordered == 0 && counters.duplicated == 0);
+}
+
+void TestWrapAround()
+{
+    PacketSequenceTracker tracker;
+    constexpr const std::uint32_t Start = 0xFFFF'FF00;
+    std::vector<PacketSequenceTracker::LostRange> lostRanges;
+    const std::array<std::uint32_t, 2> skip{ 0xFFFF'FFFF, 0 };
+    TEST_CHECK(ProcessRange(tracker, Start, 0x200, skip, &lostRanges) == 2);
+    TEST_CHECK(lostRanges.size() == 2);
+    TEST_CHECK(lostRanges.size() == 2 && lostRanges[0].from == 0xFFFF'FFFF && lostRanges[1].to == 0);
+    const auto& counters = tracker.GetCounters();
+    TEST_CHECK(counters.reordered == 0 && counters.duplicated == 0 && counters.late == 0);
+}
+
+void TestJumpBeyondWindow()
+{
+    PacketSequenceTracker tracker;
+    ProcessRange(tracker, 0, 100);
+    const std::uint32_t jumpTo = 100 + 4 * PacketSequenceTracker::Window;
+    const auto lost = tracker.Process(jumpTo);
+    TEST_CHECK(lost.size() == 1);
+    TEST_CHECK(!lost.empty() && lost[0].from == 100 && lost[0].to == jumpTo - PacketSequenceTracker::ReorderDepth);
+    // the rest of the gap is declared lost as the counter moves on.
+    TEST_CHECK(ProcessRange(tracker, jumpTo + 1, jumpTo + 1000) == PacketSequenceTracker::ReorderDepth - 1);
+}
+
+void TestReset()
+{
+    PacketSequenceTracker tracker;
+    ProcessRange(tracker, 0, 100, std::array<std::uint32_t, 1>{ 5 });
+    TEST_CHECK(tracker.GetCounters().lost == 1);
+    tracker.Reset();
+    // a new stream starting at an unrelated counter is not a loss.
+    TEST_CHECK(tracker.Process(1'000'000).empty());
+    TEST_CHECK(tracker.GetCounters().lost == 0);
+    TEST_CHECK(ProcessRange(tracker, 1'000'001, 1'001'000) == 0);
+}
+
+std::vector<PacketSequenceTracker::LostRange> g_reportedRanges{};
+std::uint32_t g_videoErrorReports = 0;
+
+void TestReportLostRanges()
+{
+    const ALXR::PacketLossReportFns reportFns{
+        .videoErrorReportSend = []() { ++g_videoErrorReports; },
+        .lostRangeSend = [](const std::uint32_t from, const std::uint32_t to) { g_reportedRanges.push_back({ from, to }); }
+    };
+    const std::array<PacketSequenceTracker::LostRange, 2> lostRanges{{ { 10, 12 }, { 20, 20 } }};
+    TEST_CHECK(ALXR::ReportLostRanges({}, reportFns) == 0);
+    TEST_CHECK(g_videoErrorReports == 0 && g_reportedRanges.empty());
+
+    // one video error report for all the ranges of a Process call.
+    TEST_CHECK(ALXR::ReportLostRanges(lostRanges, reportFns) == 4);
+    TEST_CHECK(g_videoErrorReports == 1);
+    TEST_CHECK(g_reportedRanges.size() == 2);
+    TEST_CHECK(g_reportedRanges.size() == 2 && g_reportedRanges[0].from == 10 && g_reportedRanges[0].to == 12 &&
+               g_reportedRanges[1].from == 20 && g_reportedRanges[1].to == 20);
+
+    // the range callback is optional.
+    TEST_CHECK(ALXR::ReportLostRanges(lostRanges, { .videoErrorReportSend = reportFns.videoErrorReportSend }) == 4);
+    TEST_CHECK(g_videoErrorReports == 2 && g_reportedRanges.size() == 2);
+}
+}
+
+int main()
+{
+    return ALXR::Test::RunTests(TestInOrder, TestReorder, TestDuplicate, TestLossAndLate,
+                                TestWrapAround, TestJumpBeyondWindow, TestReset, TestReportLostRanges);
+}
@@ -0,0 +1,183 @@
+#include "pch.h"
+#include "common.h"
+#include "pose_history.h"
+#include "test_common.h"
+
+#include <cmath>
+
+using ALXR::PoseHistory;
+using LookupResult = PoseHistory::LookupResult;
+
+namespace {
+
+constexpr const std::uint64_t Ms = 1'000'000;
+constexpr const float Epsilon = 1e-5f;
+
+bool Near(const float a, const float b) { return std::abs(a - b) < Epsilon; }
+
+// Both eyes at x metres, turned yaw radians about +y, the left fov angle is -1 - x.
+PoseHistory::Sample MakeSample(const std::uint64_t frameIndex, const float x, const float yaw = 0.0f)
+{
+    XrView view{ .type = XR_TYPE_VIEW, .next = nullptr };
+    view.pose = {
+        .orientation = { 0.0f, std::sin(yaw * 0.5f), 0.0f, std::cos(yaw * 0.5f) },
+        .position    = { x, 1.6f, 0.0f },
+    };
+    view.fov = { .angleLeft = -1.0f - x, .angleRight = 1.0f, .angleUp = 1.0f, .angleDown = -1.0f };
+    return {
+        .frameIndex  = frameIndex,
+        .displayTime = static_cast<XrTime>(frameIndex) + 7,
+        .views       = { view, view },
+    };
+}
+
+float PositionOf(const PoseHistory::Sample& sample) { return sample.views[0].pose.position.x; }
+
+void TestOutOfOrderPush()
+{
+    PoseHistory history;
+    history.Push(MakeSample(10 * Ms, 1.0f));
+    history.Push(MakeSample(30 * Ms, 3.0f));
+    history.Push(MakeSample(20 * Ms, 2.0f));
+
+    PoseHistory::Sample sample;
+    TEST_CHECK(history.Find(20 * Ms, sample) == LookupResult::Exact);
+    TEST_CHECK(PositionOf(sample) == 2.0f);
+    TEST_CHECK(history.Latest(sample) && sample.frameIndex == 30 * Ms);
+
+    // the same frame index again replaces the sample.
+    history.Push(MakeSample(20 * Ms, 5.0f));
+    TEST_CHECK(history.Find(20 * Ms, sample) == LookupResult::Exact);
+    TEST_CHECK(PositionOf(sample) == 5.0f);
+    TEST_CHECK(history.Find(10 * Ms, sample) == LookupResult::Exact && PositionOf(sample) == 1.0f);
+    TEST_CHECK(history.Find(30 * Ms, sample) == LookupResult::Exact && PositionOf(sample) == 3.0f);
+}
+
+void TestFullRingDropsOldest()
+{
+    PoseHistory history;
+    constexpr const std::uint64_t Step = 2 * Ms;
+    for (std::uint64_t i = 1; i <= PoseHistory::Capacity; ++i)
+        history.Push(MakeSample(i * Step, static_cast<float>(i)));
+
+    PoseHistory::Sample sample;
+    TEST_CHECK(history.Find(Step, sample) == LookupResult::Exact);
+
+    // older than every sample of a full history, not inserted.
+    history.Push(MakeSample(Step / 2, -1.0f));
+    TEST_CHECK(history.Find(Step / 2, sample) == LookupResult::Expired);
+    TEST_CHECK(sample.frameIndex == Step);
+
+    // a newer sample drops the oldest.
+    history.Push(MakeSample((PoseHistory::Capacity + 1) * Step, 0.0f));
+    TEST_CHECK(history.Find(Step, sample) == LookupResult::Expired);
+    TEST_CHECK(sample.frameIndex == 2 * Step);
+
+    // so does an out of order one, inserted in place.
+    history.Push(MakeSample(10 * Step + Ms, -2.0f));
+    TEST_CHECK(history.Find(2 * Step, sample) == LookupResult::Expired);
+    TEST_CHECK(sample.frameIndex == 3 * Step);
+    TEST_CHECK(history.Find(10 * Step + Ms, sample) == LookupResult::Exact);
+    TEST_CHECK(PositionOf(sample) == -2.0f);
+    TEST_CHECK(history.Find(11 * Step, sample) == LookupResult::Exact);
+    TEST_CHECK(history.Latest(sample) && sample.frameIndex == (PoseHistory::Capacity + 1) * Step);
+}
+
+void TestInterpolation()
+{
+    constexpr const float QuarterTurn = 1.57079633f;
+    PoseHistory history;
+    history.Push(MakeSample(100 * Ms, 0.0f, 0.0f));
+    history.Push(MakeSample(140 * Ms, 1.0f, QuarterTurn));
+
+    PoseHistory::Sample sample;
+    TEST_CHECK(history.Find(110 * Ms, sample) == LookupResult::Interpolated);
+    TEST_CHECK(sample.frameIndex == 110 * Ms);
+    TEST_CHECK(sample.displayTime == static_cast<XrTime>(110 * Ms) + 7);
+    for (const XrView& view : sample.views) {
+        TEST_CHECK(Near(view.pose.position.x, 0.25f));
+        TEST_CHECK(Near(view.pose.position.y, 1.6f));
+        TEST_CHECK(Near(view.fov.angleLeft, -1.25f));
+        TEST_CHECK(Near(view.fov.angleRight, 1.0f));
+        // slerped, a quarter of a quarter turn about +y.
+        TEST_CHECK(Near(view.pose.orientation.y, std::sin(QuarterTurn * 0.125f)));
+        TEST_CHECK(Near(view.pose.orientation.w, std::cos(QuarterTurn * 0.125f)));
+        TEST_CHECK(Near(view.pose.orientation.x, 0.0f) && Near(view.pose.orientation.z, 0.0f));
+    }
+}
+
+void TestInterpolationGap()
+{
+    PoseHistory history;
+    history.Push(MakeSample(100 * Ms, 0.0f));
+    // exactly MaxInterpolationGapNs apart is still interpolated.
+    history.Push(MakeSample(100 * Ms + PoseHistory::MaxInterpolationGapNs, 1.0f));
+    // one ns more is a stalled tracking thread.
+    history.Push(MakeSample(100 * Ms + 2 * PoseHistory::MaxInterpolationGapNs + 1, 2.0f));
+
+    PoseHistory::Sample sample;
+    TEST_CHECK(history.Find(100 * Ms + PoseHistory::MaxInterpolationGapNs / 2, sample) == LookupResult::Interpolated);
+    TEST_CHECK(Near(PositionOf(sample), 0.5f));
+
+    const std::uint64_t gapStart = 100 * Ms + PoseHistory::MaxInterpolationGapNs;
+    TEST_CHECK(history.Find(gapStart + 10 * Ms, sample) == LookupResult::Nearest);
+    TEST_CHECK(PositionOf(sample) == 1.0f);
+    TEST_CHECK(history.Find(gapStart + 40 * Ms, sample) == LookupResult::Nearest);
+    TEST_CHECK(PositionOf(sample) == 2.0f);
+}
+
+void TestFallbacks()
+{
+    PoseHistory history;
+    PoseHistory::Sample sample;
+    TEST_CHECK(history.Find(10 * Ms, sample) == LookupResult::Miss);
+    TEST_CHECK(!history.Latest(sample));
+
+    history.Push(MakeSample(10 * Ms, 1.0f));
+    history.Push(MakeSample(20 * Ms, 2.0f));
+    TEST_CHECK(history.Find(5 * Ms, sample) == LookupResult::Expired);
+    TEST_CHECK(sample.frameIndex == 10 * Ms);
+    TEST_CHECK(history.Find(25 * Ms, sample) == LookupResult::Newest);
+    TEST_CHECK(sample.frameIndex == 20 * Ms);
+    TEST_CHECK(history.Find(20 * Ms, sample) == LookupResult::Exact);
+    TEST_CHECK(history.Find(15 * Ms, sample) == LookupResult::Interpolated);
+
+    ALXRPoseHistoryStats stats;
+    history.GetStats(stats);
+    TEST_CHECK(stats.lookups == 5);
+    TEST_CHECK(stats.misses == 1 && stats.expired == 1 && stats.newest == 1 && stats.exact == 1 && stats.interpolated == 1);
+    TEST_CHECK(stats.nearest == 0);
+}
+
+void TestClear()
+{
+    PoseHistory history;
+    history.Push(MakeSample(10 * Ms, 1.0f));
+    PoseHistory::Sample sample;
+    TEST_CHECK(history.Find(10 * Ms, sample) == LookupResult::Exact);
+
+    history.Clear();
+    TEST_CHECK(!history.Latest(sample));
+    TEST_CHECK(history.Find(10 * Ms, sample) == LookupResult::Miss);
+    ALXRPoseHistoryStats stats;
+    history.GetStats(stats);
+    TEST_CHECK(stats.lookups == 2 && stats.exact == 1 && stats.misses == 1);
+
+    // samples older than the cleared ones are accepted again.
+    history.Push(MakeSample(5 * Ms, 0.5f));
+    TEST_CHECK(history.Find(5 * Ms, sample) == LookupResult::Exact);
+    TEST_CHECK(history.Latest(sample) && sample.frameIndex == 5 * Ms);
+}
+}
+
+int main()
+{
+    return ALXR::Test::RunTests(
+        TestOutOfOrderPush,
+        TestFullRingDropsOldest,
+        TestInterpolation,
+        TestInterpolationGap,
+        TestFallbacks,
+        TestClear
+    );
+}
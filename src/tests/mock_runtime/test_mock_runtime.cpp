@@ -0,0 +1,345 @@
+// Copyright (c) 2017-2024, The Khronos Group Inc.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+// Behaviour of the mock runtime that the frame loop benchmarks and tests rely on, through the loader: the session
+// state sequence, the virtual clock's predicted display times, frame call order validation, the runtime initiated
+// exit of exit_after_frames, and actions and action spaces bound through the configured interaction profile.
+
+#include "test_common.h"
+
+#include <openxr/openxr.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr XrTime kTimeOrigin = 1000000000;
+
+void SetEnv(const char *name, const char *value) {
+#ifdef _WIN32
+    _putenv_s(name, value);
+#else
+    setenv(name, value, /*overwrite*/ 1);
+#endif
+}
+
+void SetEnvIfUnset(const char *name, const char *value) {
+    if (std::getenv(name) == nullptr) {
+        SetEnv(name, value);
+    }
+}
+
+void Check(XrResult result, const char *call) {
+    if (XR_FAILED(result)) {
+        std::fprintf(stderr, "%s failed: %d\n", call, static_cast<int>(result));
+        std::exit(1);
+    }
+}
+
+/// Points XR_MOCK_RUNTIME_CONFIG at a file with the given JSON for the instances created in its scope.
+class ScopedConfig {
+   public:
+    explicit ScopedConfig(const std::string &json)
+        : path_((std::filesystem::temp_directory_path() / "alxr_mock_runtime_test_config.json").string()) {
+        std::ofstream(path_) << json;
+        SetEnv("XR_MOCK_RUNTIME_CONFIG", path_.c_str());
+    }
+    ~ScopedConfig() {
+        SetEnv("XR_MOCK_RUNTIME_CONFIG", "");
+        std::error_code error;
+        std::filesystem::remove(path_, error);
+    }
+    ScopedConfig(const ScopedConfig &) = delete;
+    ScopedConfig &operator=(const ScopedConfig &) = delete;
+
+   private:
+    std::string path_;
+};
+
+/// A headless session, not begun.
+struct Session {
+    XrInstance instance = XR_NULL_HANDLE;
+    XrSession session = XR_NULL_HANDLE;
+
+    Session() {
+        const char *extensions[] = {XR_MND_HEADLESS_EXTENSION_NAME};
+        XrInstanceCreateInfo instance_info{XR_TYPE_INSTANCE_CREATE_INFO};
+        std::strcpy(instance_info.applicationInfo.applicationName, "mock_runtime_test");
+        instance_info.applicationInfo.apiVersion = XR_CURRENT_API_VERSION;
+        instance_info.enabledExtensionCount = 1;
+        instance_info.enabledExtensionNames = extensions;
+        Check(xrCreateInstance(&instance_info, &instance), "xrCreateInstance");
+
+        XrSystemGetInfo system_info{XR_TYPE_SYSTEM_GET_INFO};
+        system_info.formFactor = XR_FORM_FACTOR_HEAD_MOUNTED_DISPLAY;
+        XrSystemId system_id = XR_NULL_SYSTEM_ID;
+        Check(xrGetSystem(instance, &system_info, &system_id), "xrGetSystem");
+        XrSessionCreateInfo session_info{XR_TYPE_SESSION_CREATE_INFO};
+        session_info.systemId = system_id;
+        Check(xrCreateSession(instance, &session_info, &session), "xrCreateSession");
+    }
+
+    ~Session() { xrDestroyInstance(instance); }
+
+    Session(const Session &) = delete;
+    Session &operator=(const Session &) = delete;
+
+    /// Session states queued since the last call, in order.
+    std::vector<XrSessionState> PollStates() {
+        std::vector<XrSessionState> states;
+        XrEventDataBuffer event{XR_TYPE_EVENT_DATA_BUFFER};
+        while (xrPollEvent(instance, &event) == XR_SUCCESS) {
+            if (event.type == XR_TYPE_EVENT_DATA_SESSION_STATE_CHANGED) {
+                states.push_back(reinterpret_cast<const XrEventDataSessionStateChanged &>(event).state);
+            }
+            event = {XR_TYPE_EVENT_DATA_BUFFER};
+        }
+        return states;
+    }
+
+    XrResult Begin() {
+        XrSessionBeginInfo begin_info{XR_TYPE_SESSION_BEGIN_INFO};
+        begin_info.primaryViewConfigurationType = XR_VIEW_CONFIGURATION_TYPE_PRIMARY_STEREO;
+        return xrBeginSession(session, &begin_info);
+    }
+
+    XrFrameState WaitFrame() {
+        XrFrameState frame_state{XR_TYPE_FRAME_STATE};
+        Check(xrWaitFrame(session, nullptr, &frame_state), "xrWaitFrame");
+        return frame_state;
+    }
+
+    XrResult EndFrame(XrTime display_time) {
+        XrFrameEndInfo end_info{XR_TYPE_FRAME_END_INFO};
+        end_info.displayTime = display_time;
+        end_info.environmentBlendMode = XR_ENVIRONMENT_BLEND_MODE_OPAQUE;
+        return xrEndFrame(session, &end_info);
+    }
+
+    void RunFrame() {
+        const XrFrameState frame_state = WaitFrame();
+        Check(xrBeginFrame(session, nullptr), "xrBeginFrame");
+        Check(EndFrame(frame_state.predictedDisplayTime), "xrEndFrame");
+    }
+
+    XrPath StringToPath(const char *path_string) {
+        XrPath path = XR_NULL_PATH;
+        Check(xrStringToPath(instance, path_string, &path), "xrStringToPath");
+        return path;
+    }
+};
+
+void TestSessionStates() {
+    Session session;
+    TEST_CHECK((session.PollStates() == std::vector<XrSessionState>{XR_SESSION_STATE_IDLE, XR_SESSION_STATE_READY}));
+    XrFrameState frame_state{XR_TYPE_FRAME_STATE};
+    TEST_CHECK(xrWaitFrame(session.session, nullptr, &frame_state) == XR_ERROR_SESSION_NOT_RUNNING);
+
+    TEST_CHECK(session.Begin() == XR_SUCCESS);
+    TEST_CHECK((session.PollStates() == std::vector<XrSessionState>{XR_SESSION_STATE_SYNCHRONIZED, XR_SESSION_STATE_VISIBLE,
+                                                                    XR_SESSION_STATE_FOCUSED}));
+    TEST_CHECK(session.Begin() == XR_ERROR_SESSION_RUNNING);
+    // Only the runtime or xrRequestExitSession may start the exit.
+    TEST_CHECK(xrEndSession(session.session) == XR_ERROR_SESSION_NOT_STOPPING);
+
+    TEST_CHECK(xrRequestExitSession(session.session) == XR_SUCCESS);
+    TEST_CHECK((session.PollStates() == std::vector<XrSessionState>{XR_SESSION_STATE_VISIBLE, XR_SESSION_STATE_SYNCHRONIZED,
+                                                                    XR_SESSION_STATE_STOPPING}));
+    TEST_CHECK(xrEndSession(session.session) == XR_SUCCESS);
+    TEST_CHECK((session.PollStates() == std::vector<XrSessionState>{XR_SESSION_STATE_IDLE, XR_SESSION_STATE_EXITING}));
+}
+
+void TestVirtualClock() {
+    Session session;
+    Check(session.Begin(), "xrBeginSession");
+    session.PollStates();
+
+    // 90 Hz by default; display times advance by exactly one period per xrWaitFrame, however long the frame takes.
+    constexpr XrDuration kPeriod = 11111111;
+    for (int64_t frame = 1; frame <= 100; ++frame) {
+        const XrFrameState frame_state = session.WaitFrame();
+        TEST_CHECK(frame_state.predictedDisplayPeriod == kPeriod);
+        TEST_CHECK(frame_state.predictedDisplayTime == kTimeOrigin + (frame + 1) * kPeriod);
+        TEST_CHECK(frame_state.shouldRender == XR_TRUE);
+        TEST_CHECK(xrBeginFrame(session.session, nullptr) == XR_SUCCESS);
+        TEST_CHECK(session.EndFrame(frame_state.predictedDisplayTime) == XR_SUCCESS);
+    }
+}
+
+void TestFrameCallOrder() {
+    Session session;
+    Check(session.Begin(), "xrBeginSession");
+
+    TEST_CHECK(xrBeginFrame(session.session, nullptr) == XR_ERROR_CALL_ORDER_INVALID);
+    TEST_CHECK(session.EndFrame(kTimeOrigin) == XR_ERROR_CALL_ORDER_INVALID);
+
+    // A second begin without an end discards the frame in progress.
+    const XrFrameState first = session.WaitFrame();
+    TEST_CHECK(xrBeginFrame(session.session, nullptr) == XR_SUCCESS);
+    const XrFrameState second = session.WaitFrame();
+    TEST_CHECK(second.predictedDisplayTime == first.predictedDisplayTime + first.predictedDisplayPeriod);
+    TEST_CHECK(xrBeginFrame(session.session, nullptr) == XR_FRAME_DISCARDED);
+    TEST_CHECK(session.EndFrame(0) == XR_ERROR_TIME_INVALID);
+    TEST_CHECK(session.EndFrame(second.predictedDisplayTime) == XR_SUCCESS);
+    TEST_CHECK(session.EndFrame(second.predictedDisplayTime) == XR_ERROR_CALL_ORDER_INVALID);
+}
+
+void TestExitAfterFrames() {
+    const ScopedConfig config(R"({ "exit_after_frames": 3, "display_refresh_rate": 60 })");
+    Session session;
+    Check(session.Begin(), "xrBeginSession");
+    session.PollStates();
+
+    TEST_CHECK(session.WaitFrame().predictedDisplayPeriod == 16666667);
+    Check(xrBeginFrame(session.session, nullptr), "xrBeginFrame");
+    Check(session.EndFrame(kTimeOrigin), "xrEndFrame");
+    session.RunFrame();
+    TEST_CHECK(session.PollStates().empty());
+    session.RunFrame();
+    TEST_CHECK((session.PollStates() == std::vector<XrSessionState>{XR_SESSION_STATE_VISIBLE, XR_SESSION_STATE_SYNCHRONIZED,
+                                                                    XR_SESSION_STATE_STOPPING}));
+    TEST_CHECK(xrEndSession(session.session) == XR_SUCCESS);
+    TEST_CHECK((session.PollStates() == std::vector<XrSessionState>{XR_SESSION_STATE_IDLE, XR_SESSION_STATE_EXITING}));
+}
+
+void TestActions() {
+    Session session;
+    const XrPath hand_paths[2] = {session.StringToPath("/user/hand/left"), session.StringToPath("/user/hand/right")};
+
+    XrActionSetCreateInfo set_info{XR_TYPE_ACTION_SET_CREATE_INFO};
+    std::strcpy(set_info.actionSetName, "test");
+    std::strcpy(set_info.localizedActionSetName, "Test");
+    XrActionSet action_set = XR_NULL_HANDLE;
+    Check(xrCreateActionSet(session.instance, &set_info, &action_set), "xrCreateActionSet");
+    const auto create_action = [&](XrActionType type, const char *name) {
+        XrActionCreateInfo action_info{XR_TYPE_ACTION_CREATE_INFO};
+        action_info.actionType = type;
+        std::strcpy(action_info.actionName, name);
+        std::strcpy(action_info.localizedActionName, name);
+        action_info.countSubactionPaths = 2;
+        action_info.subactionPaths = hand_paths;
+        XrAction action = XR_NULL_HANDLE;
+        Check(xrCreateAction(action_set, &action_info, &action), "xrCreateAction");
+        return action;
+    };
+    const XrAction pose_action = create_action(XR_ACTION_TYPE_POSE_INPUT, "grip_pose");
+    const XrAction unbound_pose_action = create_action(XR_ACTION_TYPE_POSE_INPUT, "aim_pose");
+    const XrAction trigger_action = create_action(XR_ACTION_TYPE_FLOAT_INPUT, "trigger_value");
+    const XrAction x_action = create_action(XR_ACTION_TYPE_BOOLEAN_INPUT, "x_click");
+    // Suggested only for a profile other than the configured one, never bound.
+    const XrAction select_action = create_action(XR_ACTION_TYPE_BOOLEAN_INPUT, "select_click");
+
+    const XrActionSuggestedBinding touch_bindings[] = {
+        {pose_action, session.StringToPath("/user/hand/left/input/grip/pose")},
+        {pose_action, session.StringToPath("/user/hand/right/input/grip/pose")},
+        {trigger_action, session.StringToPath("/user/hand/left/input/trigger/value")},
+        {trigger_action, session.StringToPath("/user/hand/right/input/trigger/value")},
+        {x_action, session.StringToPath("/user/hand/left/input/x/click")},
+    };
+    XrInteractionProfileSuggestedBinding suggested{XR_TYPE_INTERACTION_PROFILE_SUGGESTED_BINDING};
+    suggested.interactionProfile = session.StringToPath("/interaction_profiles/oculus/touch_controller");
+    suggested.countSuggestedBindings = static_cast<uint32_t>(std::size(touch_bindings));
+    suggested.suggestedBindings = touch_bindings;
+    Check(xrSuggestInteractionProfileBindings(session.instance, &suggested), "xrSuggestInteractionProfileBindings");
+    const XrActionSuggestedBinding simple_binding{select_action, session.StringToPath("/user/hand/left/input/select/click")};
+    suggested.interactionProfile = session.StringToPath("/interaction_profiles/khr/simple_controller");
+    suggested.countSuggestedBindings = 1;
+    suggested.suggestedBindings = &simple_binding;
+    Check(xrSuggestInteractionProfileBindings(session.instance, &suggested), "xrSuggestInteractionProfileBindings");
+
+    XrActionStateGetInfo get_info{XR_TYPE_ACTION_STATE_GET_INFO};
+    get_info.action = trigger_action;
+    XrActionStateFloat float_state{XR_TYPE_ACTION_STATE_FLOAT};
+    TEST_CHECK(xrGetActionStateFloat(session.session, &get_info, &float_state) == XR_ERROR_ACTIONSET_NOT_ATTACHED);
+
+    XrSessionActionSetsAttachInfo attach_info{XR_TYPE_SESSION_ACTION_SETS_ATTACH_INFO};
+    attach_info.countActionSets = 1;
+    attach_info.actionSets = &action_set;
+    Check(xrAttachSessionActionSets(session.session, &attach_info), "xrAttachSessionActionSets");
+
+    const XrActiveActionSet active_set{action_set, XR_NULL_PATH};
+    XrActionsSyncInfo sync_info{XR_TYPE_ACTIONS_SYNC_INFO};
+    sync_info.countActiveActionSets = 1;
+    sync_info.activeActionSets = &active_set;
+    // Not focused yet.
+    TEST_CHECK(xrSyncActions(session.session, &sync_info) == XR_SESSION_NOT_FOCUSED);
+    TEST_CHECK(xrGetActionStateFloat(session.session, &get_info, &float_state) == XR_SUCCESS);
+    TEST_CHECK(float_state.isActive == XR_FALSE);
+
+    Check(session.Begin(), "xrBeginSession");
+    session.PollStates();
+    TEST_CHECK(xrSyncActions(session.session, &sync_info) == XR_SUCCESS);
+
+    XrInteractionProfileState profile_state{XR_TYPE_INTERACTION_PROFILE_STATE};
+    Check(xrGetCurrentInteractionProfile(session.session, hand_paths[0], &profile_state), "xrGetCurrentInteractionProfile");
+    TEST_CHECK(profile_state.interactionProfile == session.StringToPath("/interaction_profiles/oculus/touch_controller"));
+
+    TEST_CHECK(xrGetActionStateFloat(session.session, &get_info, &float_state) == XR_SUCCESS);
+    TEST_CHECK(float_state.isActive == XR_TRUE);
+    TEST_CHECK(float_state.currentState == 0.0f);
+    XrActionStateBoolean bool_state{XR_TYPE_ACTION_STATE_BOOLEAN};
+    TEST_CHECK(xrGetActionStateBoolean(session.session, &get_info, &bool_state) == XR_ERROR_ACTION_TYPE_MISMATCH);
+
+    // x is only bound on the left hand.
+    get_info.action = x_action;
+    TEST_CHECK(xrGetActionStateBoolean(session.session, &get_info, &bool_state) == XR_SUCCESS);
+    TEST_CHECK(bool_state.isActive == XR_TRUE);
+    get_info.subactionPath = hand_paths[0];
+    TEST_CHECK(xrGetActionStateBoolean(session.session, &get_info, &bool_state) == XR_SUCCESS);
+    TEST_CHECK(bool_state.isActive == XR_TRUE);
+    TEST_CHECK(bool_state.currentState == XR_FALSE);
+    get_info.subactionPath = hand_paths[1];
+    TEST_CHECK(xrGetActionStateBoolean(session.session, &get_info, &bool_state) == XR_SUCCESS);
+    TEST_CHECK(bool_state.isActive == XR_FALSE);
+    get_info.subactionPath = session.StringToPath("/user/head");
+    TEST_CHECK(xrGetActionStateBoolean(session.session, &get_info, &bool_state) == XR_ERROR_PATH_UNSUPPORTED);
+
+    get_info.action = select_action;
+    get_info.subactionPath = XR_NULL_PATH;
+    TEST_CHECK(xrGetActionStateBoolean(session.session, &get_info, &bool_state) == XR_SUCCESS);
+    TEST_CHECK(bool_state.isActive == XR_FALSE);
+
+    // The grip space of a bound hand is tracked, a space of an action without a binding is not.
+    XrReferenceSpaceCreateInfo local_info{XR_TYPE_REFERENCE_SPACE_CREATE_INFO};
+    local_info.referenceSpaceType = XR_REFERENCE_SPACE_TYPE_LOCAL;
+    local_info.poseInReferenceSpace.orientation.w = 1.0f;
+    XrSpace local_space = XR_NULL_HANDLE;
+    Check(xrCreateReferenceSpace(session.session, &local_info, &local_space), "xrCreateReferenceSpace");
+    XrActionSpaceCreateInfo space_info{XR_TYPE_ACTION_SPACE_CREATE_INFO};
+    space_info.action = pose_action;
+    space_info.subactionPath = hand_paths[1];
+    space_info.poseInActionSpace.orientation.w = 1.0f;
+    XrSpace grip_space = XR_NULL_HANDLE;
+    Check(xrCreateActionSpace(session.session, &space_info, &grip_space), "xrCreateActionSpace");
+    space_info.action = unbound_pose_action;
+    XrSpace unbound_space = XR_NULL_HANDLE;
+    Check(xrCreateActionSpace(session.session, &space_info, &unbound_space), "xrCreateActionSpace");
+    space_info.action = select_action;
+    XrSpace select_space = XR_NULL_HANDLE;
+    TEST_CHECK(xrCreateActionSpace(session.session, &space_info, &select_space) == XR_ERROR_ACTION_TYPE_MISMATCH);
+
+    constexpr XrSpaceLocationFlags kTrackedFlags =
+        XR_SPACE_LOCATION_ORIENTATION_VALID_BIT | XR_SPACE_LOCATION_POSITION_VALID_BIT |
+        XR_SPACE_LOCATION_ORIENTATION_TRACKED_BIT | XR_SPACE_LOCATION_POSITION_TRACKED_BIT;
+    XrSpaceLocation location{XR_TYPE_SPACE_LOCATION};
+    TEST_CHECK(xrLocateSpace(grip_space, local_space, kTimeOrigin, &location) == XR_SUCCESS);
+    TEST_CHECK(location.locationFlags == kTrackedFlags);
+    TEST_CHECK(xrLocateSpace(unbound_space, local_space, kTimeOrigin, &location) == XR_SUCCESS);
+    TEST_CHECK(location.locationFlags == 0);
+    TEST_CHECK(xrLocateSpace(grip_space, local_space, 0, &location) == XR_ERROR_TIME_INVALID);
+}
+
+}  // namespace
+
+int main() {
+    SetEnvIfUnset("XR_RUNTIME_JSON", MOCK_RUNTIME_JSON);
+    return ALXR::Test::RunTests(TestSessionStates, TestVirtualClock, TestFrameCallOrder, TestExitAfterFrames, TestActions);
+}